@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "buf_pool.h"
+
+// Shared scratch buffers (request bodies, stream chunks, upstream responses,
+// stored blobs) instead of per-call malloc, static singletons or large stack
+// arrays. Sizes and counts are fixed at build time (see APP_BUF_* below), so the
+// total is bounded and visible via app_buf_pool_stats().
+#define APP_BUF_SMALL 512
+#define APP_BUF_MEDIUM 4096
+#define APP_BUF_LARGE 8192
+
+void app_buf_pool_init(void);
+
+// Smallest free block of at least size bytes, NULL if none is free (the caller
+// answers 503 / falls back). Thread-safe; the label is the borrowing function.
+#define app_buf_borrow(size) app_buf_borrow_labeled((size), __func__)
+void *app_buf_borrow_labeled(size_t size, const char *label);
+// NULL is fine; anything not borrowed from the pool is logged and ignored
+void app_buf_return(void *buf);
+
+// Logs every block the calling task still holds (label + size); returns the count.
+// Used after each HTTP request when CORE_BUF_POOL_LEAK_CHECK is set.
+size_t app_buf_pool_check_leaks(const char *where);
+
+typedef struct
+{
+    size_t block_size;
+    uint16_t count;
+    uint16_t in_use;
+    uint16_t peak;
+    uint32_t borrows;
+    uint32_t misses;
+} app_buf_class_stats_t;
+
+// fills up to max entries, returns the number of classes
+size_t app_buf_pool_stats(app_buf_class_stats_t *out, size_t max);
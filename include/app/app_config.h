@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "esp_err.h"
+#include "config_registry.h"
+#include "settings_storage.h" // settings_wifi_t, SETTINGS_WIFI_*_MAX_LEN
+#include "core_config.h"
+
+// NVS keys (namespace NVS_NS_CFG) of the registry settings. They form one A/B
+// group (nvs_helpers.h): every write stores the whole set, so a reset never
+// leaves a mix of old and new values. At most 13 characters each.
+#define APP_CONFIG_NVS_GROUP "cfg_gen"
+#define APP_CONFIG_NVS_LOG_LEVEL "log_level"
+// WiFi credentials before the profile list (app_settings_persistence.h); they
+// stay in the group, carried over unchanged, until app_config_drop_legacy_wifi()
+#define APP_CONFIG_NVS_WIFI_SSID "sta_ssid"
+#define APP_CONFIG_NVS_WIFI_PASS "sta_pass"
+
+// Every runtime setting, one line each:
+// X(id, name, nvs_key, type, min, max, default number, default string, flags)
+// see config_registry.h for the meaning of min / max per type.
+// nvs_key NULL: not in the group. wifi.ssid / wifi.pass are the highest
+// priority WiFi profile (app_settings_persistence.h): read from it, written by
+// putting the profile at position 0.
+#define APP_CONFIG_KEYS(X)                                                                                   \
+    X(APP_CONFIG_WIFI_SSID, "wifi.ssid", NULL, CONFIG_TYPE_STR, 1U, SETTINGS_WIFI_SSID_MAX_LEN, 0U, "", 0U) \
+    X(APP_CONFIG_WIFI_PASS, "wifi.pass", NULL, CONFIG_TYPE_STR, 0U, SETTINGS_WIFI_PASS_MAX_LEN, 0U, "",     \
+      CONFIG_FLAG_SECRET)                                                                                    \
+    X(APP_CONFIG_LOG_LEVEL, "log_level", APP_CONFIG_NVS_LOG_LEVEL, CONFIG_TYPE_U32, 0U, 5U,                  \
+      CORE_LOG_LEVEL_DEFAULT, NULL, 0U)
+
+#define APP_CONFIG_ID_(id, name, nvs_key, type, min, max, def_num, def_str, flags) id,
+typedef enum
+{
+    APP_CONFIG_KEYS(APP_CONFIG_ID_) APP_CONFIG_COUNT
+} app_config_key_t;
+#undef APP_CONFIG_ID_
+
+const config_registry_t *app_config_registry(void);
+
+// Fills entries[i].value for entries[i].key: the stored value, or the default
+// if nothing (or nothing valid) is stored. All keys are read under one NVS lock.
+esp_err_t app_config_get_many(config_entry_t *entries, size_t count);
+
+// Validates every entry first (ESP_ERR_INVALID_ARG, nothing written), then
+// writes them as one transaction with the unchanged keys. Applies the new
+// values (log level) afterwards. WiFi keys go to the profile list first, a
+// transaction of its own; wifi.pass alone needs a saved profile
+// (ESP_ERR_INVALID_ARG otherwise).
+esp_err_t app_config_set_many(const config_entry_t *entries, size_t count);
+
+// Removes the stored values of keys (reads return the default), in one
+// transaction. wifi.ssid removes the highest priority profile, wifi.pass
+// clears its password.
+esp_err_t app_config_erase_many(const app_config_key_t *keys, size_t count);
+
+// The legacy WiFi pair (ESP_ERR_NOT_FOUND without an SSID), and its removal
+// in one transaction once the profile list holds it.
+esp_err_t app_config_get_legacy_wifi(settings_wifi_t *out);
+esp_err_t app_config_drop_legacy_wifi(void);
+
+// Applies stored settings at boot (log level); needs nvs_flash_init.
+void app_config_init(void);
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "esp_err.h"
+#include "gazetteer.h"
+
+// Maps the "gazetteer" flash partition once (esp_partition_mmap) and checks the image.
+// A missing or invalid partition is not fatal: lookups then report ESP_ERR_NOT_FOUND.
+esp_err_t app_gazetteer_init(void);
+
+// Opened image, valid for the lifetime of the firmware; NULL if none is available.
+const gazetteer_t *app_gazetteer_get(void);
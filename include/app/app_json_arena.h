@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// cJSON allocations of one task at a time go to a static bump arena
+// (CORE_JSON_ARENA_SIZE) instead of the shared heap. Installed once via
+// cJSON_InitHooks; other tasks and arena overflow fall back to malloc.
+void app_json_arena_init(void);
+
+// Scope for the calling task. Nested enter/leave pairs are fine; the arena is
+// reset on the outermost leave, so no cJSON item or printed string from inside
+// the scope may be used after it. If another task holds the arena, the scope
+// is a no-op and cJSON keeps using the heap.
+void app_json_arena_enter(void);
+void app_json_arena_leave(void);
+
+typedef struct
+{
+    size_t size;
+    size_t high_water; // peak bytes used by one scope since boot
+    uint32_t overflows; // allocations that went to the heap because the arena was full
+} app_json_arena_stats_t;
+
+void app_json_arena_stats(app_json_arena_stats_t *out);
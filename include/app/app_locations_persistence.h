@@ -1,8 +1,32 @@
 #pragma once
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
 #include "esp_err.h"
 #include "locations_model.h"
 
-esp_err_t app_locations_load(locations_model_t *out);
-esp_err_t app_locations_save(const locations_model_t *in);
-esp_err_t app_locations_clear(void);
\ No newline at end of file
+// What NVS holds, as the last load or save left it. The locations writer keeps
+// it next to its model, so a save diffs in RAM (by name, through the model's
+// name index) and only a load reads records from flash.
+typedef struct
+{
+    locations_model_t model; // stored content; iteration order is the index order
+    uint16_t *ids;           // record id per slot of model
+    uint16_t active_id;
+    size_t id_bits;
+    bool valid; // false after a failed load or save: load again before saving
+} app_locations_stored_t;
+
+bool app_locations_stored_init(app_locations_stored_t *stored, size_t capacity);
+void app_locations_stored_deinit(app_locations_stored_t *stored);
+
+// out must be initialized with locations_model_init(); its capacity bounds what
+// can be loaded. stored (same capacity) receives what was read.
+esp_err_t app_locations_load(locations_model_t *out, app_locations_stored_t *stored);
+// ESP_ERR_INVALID_STATE if stored is not valid. ESP_ERR_NOT_FINISHED if it failed
+// after writing had begun: what was queued stays queued and is flushed later,
+// so NVS ends up with either the old or the new list; load again to see which.
+// Any other error: nothing was written.
+esp_err_t app_locations_save(const locations_model_t *in, app_locations_stored_t *stored);
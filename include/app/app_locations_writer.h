@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "esp_err.h"
+#include "locations_batch.h"
+#include "locations_snapshot.h"
+
+// Single writer for the locations list: all mutations are queued to one task,
+// applied in arrival order and persisted together (see CORE_LOCATIONS_WRITE_COALESCE_MS).
+esp_err_t app_locations_writer_start(void);
+
+// Applies ops atomically (locations_batch_apply) and blocks until they are persisted.
+// ESP_OK                 applied and saved
+// ESP_ERR_INVALID_ARG    ops[*out_failed_index] broke a model rule; nothing applied
+// ESP_ERR_INVALID_STATE  writer not started
+// ESP_ERR_NOT_FINISHED   the save failed part way: the change may or may not persist;
+//                        the writer reloads, and snapshots show what NVS holds
+// other                  load / save error; nothing applied
+esp_err_t app_locations_writer_submit(const locations_batch_op_t *ops, size_t count, size_t *out_failed_index);
+
+// Last persisted list as an immutable snapshot; never waits for the writer.
+// NULL if nothing could be loaded yet. Release with locations_snapshot_release().
+locations_snapshot_t *app_locations_snapshot_acquire(void);
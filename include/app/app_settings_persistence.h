@@ -1,8 +1,42 @@
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include "esp_err.h"
 #include "settings_storage.h" // settings_wifi_t
+#include "wifi_profiles.h"
+
+// Saved WiFi networks (wifi_profiles.h), stored as one blob in the "cfg"
+// namespace. Reads come from a RAM cache; only the first read (or the first
+// after a failed write) touches NVS. Writes update the cache after they
+// succeed. Without a stored list the single pair from before profiles
+// (app_config_get_legacy_wifi) reads as a one-entry list; app_settings_init()
+// moves it over. Nothing saved: ESP_ERR_NOT_FOUND.
+esp_err_t app_settings_load_wifi_profiles(wifi_profiles_t *out);
 
+// Highest priority profile.
 esp_err_t app_settings_load_wifi(settings_wifi_t *out);
+// Saves in->ssid as the highest priority profile; on a full list the lowest one goes.
 esp_err_t app_settings_save_wifi(const settings_wifi_t *in);
+// Same at priority pos (0 first, past the end: last); ESP_ERR_NO_MEM on a full list.
+esp_err_t app_settings_put_wifi(const settings_wifi_t *in, size_t pos);
+// ESP_ERR_NOT_FOUND if ssid is not saved
+esp_err_t app_settings_remove_wifi(const char *ssid);
+// all profiles
 esp_err_t app_settings_clear_wifi(void);
+
+// Caches where ssid was joined for the next connect; writes only if it changed.
+esp_err_t app_settings_wifi_connected(const char *ssid, const wifi_profile_hint_t *hint);
+
+// Fills the cache once at boot (needs nvs_flash_init); nothing stored is not an error.
+esp_err_t app_settings_init(void);
+
+typedef struct
+{
+    uint32_t hits;          // reads served from RAM
+    uint32_t misses;        // reads that went to NVS
+    uint32_t invalidations; // writes (successful or not)
+} app_settings_cache_stats_t;
+
+void app_settings_cache_stats(app_settings_cache_stats_t *out);
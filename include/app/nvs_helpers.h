@@ -1,10 +1,100 @@
 #pragma once
 
 #include "esp_err.h"
+#include "nvs.h"
+#include "ab_txn.h"
+#include "latency_hist.h"
+#include "write_journal.h"
 #include <stddef.h>
 
 #define NVS_NS_CFG "cfg"
 
+// Keys in NVS_NS_CFG outside the settings registry (app_config.h):
+// locations list as one index plus one record per location (locations_records.h)
+#define NVS_KEY_LOC_INDEX "loc_idx"
+#define NVS_KEY_LOC_RECORD_FMT "loc_%u"
+// legacy layout: whole list as one JSON string; read once, erased on the next save
+#define NVS_KEY_LOCATIONS "locations"
+// saved WiFi networks as one blob (wifi_profiles.h)
+#define NVS_KEY_WIFI_PROFILES "wifi_prof"
+
+// All access to NVS_NS_CFG goes through here. Reads and writes use shared
+// handles (one read-only, one read-write) kept open for the process lifetime.
+//
+// Writes are write-behind: they land in a RAM journal (write_journal.h), reads
+// see them immediately, and the journal is committed to flash once no write
+// came in for CORE_NVS_WRITE_BEHIND_MS, on nvs_cfg_flush() and before
+// esp_restart(). Flash receives the writes in the order they were made, so a
+// power cut mid-flush leaves the state after some earlier write. Writes from
+// the last quiet period are lost on power loss. Timed flushes run on a small task
+// of their own; a failed one is retried after 0.5 s, doubling up to 30 s.
+// Before nvs_cfg_init() (or with the period set to 0) every write is committed
+// right away.
+//
+// Strings longer than CORE_NVS_COMPRESS_MIN are stored LZSS compressed as a
+// blob under "~<key>" (lzss.h) when that is smaller; nvs_cfg_get_str() hides
+// this, and plain strings written before stay readable. A key that has the
+// blob keeps it for later values, so each write is a single nvs_set.
+esp_err_t nvs_cfg_init(void);
+esp_err_t nvs_cfg_flush(void);
+
+// Counters since boot. Latencies are taken under the lock: read = every
+// nvs_cfg_get_*, write = every put (queueing, or flash on write-through),
+// flush = one journal run to flash including its commit.
+typedef struct
+{
+    write_journal_stats_t journal;
+    size_t pending;          // journal entries not on flash yet
+    uint32_t direct_commits; // writes too large for the journal
+    latency_hist_t read;
+    latency_hist_t write;
+    latency_hist_t flush;
+} nvs_cfg_stats_t;
+
+void nvs_cfg_stats(nvs_cfg_stats_t *out);
+
+// One stored key of any namespace in the default partition. bytes is the value
+// size (strings incl. NUL), entries the 32-byte flash entries it takes
+// (estimated from bytes: one header plus the data, like NVS lays them out).
+typedef struct
+{
+    char ns[NVS_KEY_NAME_MAX_SIZE];
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    nvs_type_t type;
+    uint32_t bytes;
+    uint16_t entries;
+} nvs_key_usage_t;
+
+// Fills up to max keys; *out_count is the number of keys stored, also when
+// that is more than max. Flash contents only, pending writes are not included.
+esp_err_t nvs_usage_keys(nvs_key_usage_t *out, size_t max, size_t *out_count);
+
+// Recursive lock around a read-modify-write sequence. Writes inside it are
+// scheduled together when the outermost nvs_cfg_unlock() runs.
+void nvs_cfg_lock(void);
+void nvs_cfg_unlock(void);
+
+// Same contract as nvs_get_str / nvs_get_blob (out NULL: length only;
+// ESP_ERR_NVS_NOT_FOUND also when the namespace does not exist yet).
+esp_err_t nvs_cfg_get_str(const char *key, char *out, size_t *len);
+esp_err_t nvs_cfg_get_blob(const char *key, void *out, size_t *len);
+esp_err_t nvs_cfg_set_str(const char *key, const char *value);
+esp_err_t nvs_cfg_set_blob(const char *key, const void *data, size_t len);
+// a missing key is not an error
+esp_err_t nvs_cfg_erase_key(const char *key);
+
+// A/B transactions (ab_txn.h): a group of keys changes as one. Readers take
+// the generation and then its keys under one nvs_cfg_lock(); before the
+// first write the plain keys are read.
+esp_err_t nvs_cfg_txn_generation(const char *group, uint32_t *out_gen);
+esp_err_t nvs_cfg_txn_get_str(uint32_t gen, const char *key, char *out, size_t *len);
+esp_err_t nvs_cfg_txn_write(const char *group, const ab_txn_item_t *items, size_t count);
+
 esp_err_t nvs_load_json(const char *key, char *out_buf, size_t out_len);
+esp_err_t nvs_json_len(const char *key, size_t *out_len); // incl. terminating NUL
 esp_err_t nvs_save_json(const char *key, const char *json);
-esp_err_t nvs_erase_key_cfg(const char *key);
\ No newline at end of file
+esp_err_t nvs_erase_key_cfg(const char *key);
+
+// Logs per-call latency of nvs_open/get/close against a pooled handle
+// (CORE_NVS_BENCH builds only; needs nvs_flash_init).
+void nvs_cfg_bench(void);
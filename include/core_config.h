@@ -40,7 +40,26 @@
 #define CORE_STATUS_API_ENABLED 0
 #endif
 
+#ifdef CONFIG_CORE_BUF_POOL_LEAK_CHECK
+#define CORE_BUF_POOL_LEAK_CHECK 1
+#else
+#define CORE_BUF_POOL_LEAK_CHECK 0
+#endif
+
+#ifdef CONFIG_CORE_NVS_BENCH
+#define CORE_NVS_BENCH 1
+#else
+#define CORE_NVS_BENCH 0
+#endif
+
 /* ---- values (always defined) ---- */
 #define CORE_AP_SSID CONFIG_CORE_AP_SSID
 #define CORE_LOG_LEVEL_DEFAULT CONFIG_CORE_LOG_LEVEL
 #define CORE_BLE_SCAN_INTERVAL_MS CONFIG_CORE_BLE_SCAN_INTERVAL_MS
+#define CORE_LOCATIONS_CAPACITY CONFIG_CORE_LOCATIONS_CAPACITY
+#define CORE_LOCATIONS_WRITE_COALESCE_MS CONFIG_CORE_LOCATIONS_WRITE_COALESCE_MS
+#define CORE_NVS_WRITE_BEHIND_MS CONFIG_CORE_NVS_WRITE_BEHIND_MS
+#define CORE_NVS_COMPRESS_MIN CONFIG_CORE_NVS_COMPRESS_MIN
+#define CORE_JSON_ARENA_SIZE CONFIG_CORE_JSON_ARENA_SIZE
+#define CORE_HTTP_KEEPALIVE_IDLE_S CONFIG_CORE_HTTP_KEEPALIVE_IDLE_S
+#define CORE_HTTP_KEEPALIVE_MAX_REQUESTS CONFIG_CORE_HTTP_KEEPALIVE_MAX_REQUESTS
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_http_server.h"
+
+// HTTP/1.1 keep-alive for API responses. The UI polls several endpoints; on
+// the SoftAP a fresh TCP connection per call costs a handshake and churns the
+// seven server sockets (max_open_sockets, LRU purge). A connection stays open
+// while it sees a request at least every CORE_HTTP_KEEPALIVE_IDLE_S and for at
+// most CORE_HTTP_KEEPALIVE_MAX_REQUESTS requests of any kind (API, UI, portal);
+// an API response on the last one says "Connection: close". An idle timeout of
+// 0 closes after every API response, as before.
+//
+// The hooks, handlers and the sweep (queued work) all run on the httpd task,
+// so the session table needs no lock.
+
+// at most as many sessions as httpd keeps sockets
+#define HTTP_CONN_MAX_SOCKETS 7
+
+typedef struct
+{
+    uint32_t open;        // sockets open now
+    uint32_t peak_open;
+    uint32_t opened;      // accepted connections
+    uint32_t closed;      // by the client, an error, LRU purge or us
+    uint32_t closed_idle; // idle timeout (sweep)
+    uint32_t closed_cap;  // request cap reached
+    uint32_t requests;    // all requests
+    uint32_t reused;      // requests on a connection that had served one before
+} http_conn_stats_t;
+
+// httpd_config_t hooks; close also closes the socket (httpd leaves that to close_fn)
+esp_err_t http_conn_on_open(httpd_handle_t hd, int sockfd);
+void http_conn_on_close(httpd_handle_t hd, int sockfd);
+
+// starts the idle sweep for a running server; without it connections only
+// close at the cap, by the client or by LRU purge
+esp_err_t http_conn_start(httpd_handle_t hd);
+
+// activity of every request, around the handler; http_register_uri does this
+// for all routes, error handlers call it themselves
+void http_conn_request_begin(httpd_req_t *req);
+void http_conn_request_end(httpd_req_t *req);
+
+// sets Connection / Keep-Alive only; call before the first byte of the response goes out
+void http_conn_set_headers(httpd_req_t *req);
+
+void http_conn_stats(http_conn_stats_t *out);
@@ -7,3 +7,42 @@
 bool http_read_body(httpd_req_t *req, char *buf, size_t buf_len, size_t *out_len);
 void http_send_json(httpd_req_t *req, int status_code, const char *json);
 void http_send_err(httpd_req_t *req, int status_code, const char *msg);
+// decodes %XX and '+' of a query value in place; false on a malformed escape or %00
+bool http_url_decode(char *s);
+
+// Registers uri with a wrapper that records the request with http_conn (idle
+// timeout, request cap) before and after its handler. Every route goes through
+// this; uri must stay valid while the server runs (static descriptors).
+esp_err_t http_register_uri(httpd_handle_t server, const httpd_uri_t *uri);
+
+// Runs handler inside the per-request scopes: cJSON allocates from the request
+// arena (app_json_arena.h) and, with CORE_BUF_POOL_LEAK_CHECK, every pool buffer
+// the handler borrowed must be back when it returns.
+esp_err_t http_scoped(httpd_req_t *req, esp_err_t (*handler)(httpd_req_t *));
+
+// defines <handler>_scoped for registration
+#define HTTP_SCOPED_HANDLER(handler)                     \
+    static esp_err_t handler##_scoped(httpd_req_t *req)  \
+    {                                                    \
+        return http_scoped(req, handler);                \
+    }
+
+// Chunked JSON response (Transfer-Encoding: chunked). Writes are collected in a
+// pool buffer (APP_BUF_SMALL) and go out as one chunk whenever the next write
+// would not fit.
+typedef struct
+{
+    httpd_req_t *req;
+    char *buf;
+    size_t cap;
+    size_t len;
+    esp_err_t err; // first error; later writes are dropped
+} http_stream_t;
+
+// ESP_ERR_NO_MEM in s->err if no buffer is free; nothing is sent then and the
+// caller still answers normally (http_stream_end only returns the error)
+void http_stream_begin(http_stream_t *s, httpd_req_t *req, int status_code);
+void http_stream_write(http_stream_t *s, const char *data, size_t len);
+void http_stream_write_str(http_stream_t *s, const char *str);
+// sends the rest and the terminating chunk, returns the buffer; returns the first error
+esp_err_t http_stream_end(http_stream_t *s);
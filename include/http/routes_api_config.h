@@ -0,0 +1,5 @@
+#pragma once
+
+#include "esp_http_server.h"
+
+void routes_api_config_register(httpd_handle_t server);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
 
 typedef enum
 {
@@ -13,5 +14,6 @@ typedef enum
 
 #define OPENMETEO_BUF_SIZE 8192
 
-openmeteo_status_t openmeteo_fetch_current(double lat, double lon, char *out_buf, size_t out_len);
-openmeteo_status_t openmeteo_fetch_forecast(double lat, double lon, int days, char *out_buf, size_t out_len);
\ No newline at end of file
+// coordinates in microdegrees (location_t), printed exactly into the request URL
+openmeteo_status_t openmeteo_fetch_current(int32_t lat_e6, int32_t lon_e6, char *out_buf, size_t out_len);
+openmeteo_status_t openmeteo_fetch_forecast(int32_t lat_e6, int32_t lon_e6, int days, char *out_buf, size_t out_len);
\ No newline at end of file
@@ -30,7 +30,8 @@ typedef struct
 esp_err_t wifi_sta_init(void);
 
 /**
- * Load credentials from NVS ("cfg": "sta_ssid"/"sta_pass") and try connect.
+ * Load the saved networks (app_settings_load_wifi_profiles) and try connect:
+ * cached channel + BSSID of each first, then scans, in priority order.
  * Does nothing if no SSID stored.
  */
 esp_err_t wifi_sta_connect_from_nvs(void);
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "locations_model.h"
+
+typedef enum
+{
+    LOCATIONS_BATCH_ADD = 0,
+    LOCATIONS_BATCH_REMOVE,
+    LOCATIONS_BATCH_RENAME,
+    LOCATIONS_BATCH_SET_ACTIVE,
+    LOCATIONS_BATCH_SET_COORDS,
+    LOCATIONS_BATCH_DEACTIVATE,
+    LOCATIONS_BATCH_CHECK_ETAG,
+} locations_batch_op_type_t;
+
+/* set_coords: keep this coordinate as it is */
+#define LOCATIONS_BATCH_KEEP_COORD INT32_MIN
+
+/*
+ * add uses the whole loc; the other ops address loc.name and use
+ * - rename:      new_name
+ * - set_coords:  loc.latitude_e6 / loc.longitude_e6 (or LOCATIONS_BATCH_KEEP_COORD)
+ * - deactivate:  nothing; no entry is active afterwards if loc.name was, fails if unknown
+ * - check_etag:  etag; fails unless it equals locations_model_etag() of the entry,
+ *                a precondition for the ops that follow
+ */
+typedef struct
+{
+    locations_batch_op_type_t type;
+    location_t loc;
+    char new_name[32];
+    uint32_t etag;
+} locations_batch_op_t;
+
+/*
+ * Applies ops in order with the usual locations_model rules, all or nothing:
+ * the ops run on a scratch copy that replaces the model only if every op succeeded.
+ * On failure *out_failed_index is the rejected op, or `count` if the scratch
+ * copy could not be allocated; the model is unchanged.
+ */
+bool locations_batch_apply(locations_model_t *model,
+                           const locations_batch_op_t *ops, size_t count,
+                           size_t *out_failed_index);
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Coordinates are stored as int32 microdegrees (1e-6 deg, ~0.11 m).
+ * Conversion from / to decimal text is exact; doubles only appear where
+ * a JSON parser hands over an already converted number.
+ */
+
+#define LOCATIONS_COORD_SCALE 1000000L
+#define LOCATIONS_COORD_LAT_MAX_E6 (90L * LOCATIONS_COORD_SCALE)
+#define LOCATIONS_COORD_LON_MAX_E6 (180L * LOCATIONS_COORD_SCALE)
+
+/* any int32: "-2147.483648" + '\0' */
+#define LOCATIONS_COORD_STR_MAX 13U
+
+bool locations_coord_lat_valid(int32_t lat_e6);
+bool locations_coord_lon_valid(int32_t lon_e6);
+
+/*
+ * Decimal text ("-12.3456789") to microdegrees, rounded half away from zero
+ * at the 7th fraction digit. No exponent; all `len` chars must be consumed.
+ * Fails beyond +/-180 deg.
+ */
+bool locations_coord_parse(const char *text, size_t len, int32_t *out_e6);
+
+/* nearest microdegree of a parsed JSON number; fails if not finite or beyond +/-180 deg */
+bool locations_coord_from_double(double deg, int32_t *out_e6);
+
+/* shortest exact decimal ("52.52", "-0.5", "0"); returns length, 0 if out is too small */
+size_t locations_coord_format(int32_t e6, char *out, size_t out_len);
@@ -2,23 +2,103 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
-#define LOCATIONS_MODEL_MAX_NUMBER 8
+/* upper bound for a model's capacity (slot links are 16 bit) */
+#define LOCATIONS_MODEL_MAX_NUMBER 512
 
+#define LOCATIONS_MODEL_NO_SLOT 0xFFFFU
+
+/* coordinates in microdegrees, see locations_coord.h */
 typedef struct
 {
     char name[32];
-    double latitude;
-    double longitude;
+    int32_t latitude_e6;
+    int32_t longitude_e6;
     bool is_active;
 } location_t;
 
 typedef struct
 {
-    location_t items[LOCATIONS_MODEL_MAX_NUMBER];
+    location_t loc;
+    uint16_t prev;
+    uint16_t next;
+    uint16_t cell_prev;
+    uint16_t cell_next;
+    uint16_t gen;
+    uint32_t cell;
+} locations_model_slot_t;
+
+/*
+ * Stable reference to a stored location: slot number plus the slot's generation.
+ * Slots never move, so a handle stays valid across other adds / removes / renames
+ * and in copies of the model (snapshots); it goes stale once its location is removed
+ * or the model is cleared, even if the slot is reused.
+ */
+typedef struct
+{
+    uint16_t slot;
+    uint16_t gen;
+} locations_handle_t;
+
+/*
+ * Location store.
+ * - slots, name index and grid buckets share one allocation made by locations_model_init()
+ * - name index is open addressing (linear probing, load factor <= 0.5)
+ * - slots are chained in insertion order, so iteration order is stable
+ *   and add / find / remove are O(1)
+ * - each slot has a generation counter, odd while in use and bumped on every
+ *   add / remove, which makes locations_handle_t detect reuse
+ * - the active location is tracked as a slot number; its is_active flag mirrors it
+ *   and is only changed together with it, so at most one entry is active
+ * - slots are also chained per lat/lon grid cell (hashed into index_size buckets),
+ *   maintained on add / remove, see locations_spatial.h
+ */
+typedef struct
+{
+    locations_model_slot_t *slots;
+    uint16_t *index;
+    uint16_t *cells;
+    size_t capacity;
+    size_t index_size;
     size_t count;
+    uint16_t head;
+    uint16_t tail;
+    uint16_t free_head;
+    uint16_t active;
 } locations_model_t;
 
+bool locations_model_init(locations_model_t *model, size_t capacity);
+void locations_model_deinit(locations_model_t *model);
+void locations_model_clear(locations_model_t *model);
+/* dst must be initialized with the same capacity as src */
+bool locations_model_copy(locations_model_t *dst, const locations_model_t *src);
+
+/* fails on duplicate name, full model or coordinates out of range;
+   loc->is_active makes the entry active only if no other entry is */
 bool locations_model_add(locations_model_t *model, const location_t *loc);
 bool locations_model_remove(locations_model_t *model, const char *name);
+const location_t *locations_model_find(const locations_model_t *model, const char *name);
+/* keeps position, coordinates and active flag; fails if new_name is empty or taken */
+bool locations_model_rename(locations_model_t *model, const char *name, const char *new_name);
+/* moves the entry to new coordinates (grid cell included); fails if unknown or out of range */
+bool locations_model_set_coords(locations_model_t *model, const char *name, int32_t latitude_e6, int32_t longitude_e6);
+bool locations_model_set_active(locations_model_t *model, const char *name);
+/* afterwards no entry is active */
+void locations_model_clear_active(locations_model_t *model);
 const location_t *locations_model_get_active(const locations_model_t *model);
+
+/*
+ * Content tag over name, coordinates and active flag (FNV-1a). Changes whenever one
+ * of them does, independent of slot, model copy or reboot; used as HTTP ETag.
+ */
+uint32_t locations_model_etag(const location_t *loc);
+
+/* handle of loc (which must point into model); slot LOCATIONS_MODEL_NO_SLOT if it does not */
+locations_handle_t locations_model_handle(const locations_model_t *model, const location_t *loc);
+/* location the handle refers to, NULL if it was removed since */
+const location_t *locations_model_resolve(const locations_model_t *model, locations_handle_t handle);
+
+/* iteration in insertion order: for (loc = first(m); loc != NULL; loc = next(m, loc)) */
+const location_t *locations_model_first(const locations_model_t *model);
+const location_t *locations_model_next(const locations_model_t *model, const location_t *loc);
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "locations_model.h"
+
+/*
+ * Reference counted, immutable copy of a locations model.
+ * A writer builds a snapshot from its private model and publishes it; readers
+ * retain the published snapshot, read it without locking and release it.
+ * The snapshot is freed when the last reference is released.
+ */
+typedef struct
+{
+    atomic_uint refs;
+    locations_model_t model;
+} locations_snapshot_t;
+
+/* copy of src with one reference held by the caller; NULL on allocation failure */
+locations_snapshot_t *locations_snapshot_create(const locations_model_t *src);
+void locations_snapshot_retain(locations_snapshot_t *snap);
+/* drops one reference; the last one frees the snapshot. NULL is ignored */
+void locations_snapshot_release(locations_snapshot_t *snap);
+
+const locations_model_t *locations_snapshot_model(const locations_snapshot_t *snap);
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "locations_model.h"
+
+/* uniform lat/lon grid, cell edge in microdegrees (1 deg) */
+#define LOCATIONS_SPATIAL_CELL_E6 1000000L
+#define LOCATIONS_SPATIAL_ROWS 180U
+#define LOCATIONS_SPATIAL_COLS 360U
+
+#define LOCATIONS_SPATIAL_MAX_K 16U
+
+#define LOCATIONS_SPATIAL_EARTH_RADIUS_M 6371008.8f
+
+typedef struct
+{
+    const location_t *loc;
+    float distance_m;
+} locations_spatial_hit_t;
+
+/* grid cell of a coordinate (latitude clamped, longitude wrapped) */
+uint32_t locations_spatial_cell_key(int32_t lat_e6, int32_t lon_e6);
+/* bucket of a cell key within model->cells */
+size_t locations_spatial_bucket(const locations_model_t *model, uint32_t cell_key);
+
+/* great-circle distance (haversine, single precision; metre-level accuracy) */
+float locations_spatial_distance_m(int32_t lat1_e6, int32_t lon1_e6, int32_t lat2_e6, int32_t lon2_e6);
+
+/*
+ * k nearest locations, ascending by distance.
+ * Grid cells are visited in rings around the query point until no unvisited
+ * cell can hold a closer entry; falls back to a full scan once the rings
+ * would cover more cells than the model has entries.
+ * Returns the number of hits written (<= k, <= LOCATIONS_SPATIAL_MAX_K),
+ * 0 for coordinates out of range.
+ */
+size_t locations_spatial_nearest(const locations_model_t *model,
+                                 int32_t lat_e6, int32_t lon_e6,
+                                 locations_spatial_hit_t *out_hits, size_t k);
@@ -0,0 +1,112 @@
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "locations_batch.h"
+
+static bool set_coords(locations_model_t *model, const locations_batch_op_t *op)
+{
+    bool ok = false;
+    const location_t *current = locations_model_find(model, op->loc.name);
+
+    if (current != NULL)
+    {
+        const int32_t lat = (op->loc.latitude_e6 == LOCATIONS_BATCH_KEEP_COORD) ? current->latitude_e6 : op->loc.latitude_e6;
+        const int32_t lon = (op->loc.longitude_e6 == LOCATIONS_BATCH_KEEP_COORD) ? current->longitude_e6 : op->loc.longitude_e6;
+
+        ok = locations_model_set_coords(model, op->loc.name, lat, lon);
+    }
+
+    return ok;
+}
+
+static bool apply_one(locations_model_t *model, const locations_batch_op_t *op)
+{
+    bool ok = false;
+    const location_t *current = NULL;
+
+    switch (op->type)
+    {
+    case LOCATIONS_BATCH_ADD:
+        ok = locations_model_add(model, &op->loc);
+        break;
+    case LOCATIONS_BATCH_REMOVE:
+        ok = locations_model_remove(model, op->loc.name);
+        break;
+    case LOCATIONS_BATCH_RENAME:
+        ok = locations_model_rename(model, op->loc.name, op->new_name);
+        break;
+    case LOCATIONS_BATCH_SET_ACTIVE:
+        ok = locations_model_set_active(model, op->loc.name);
+        break;
+    case LOCATIONS_BATCH_SET_COORDS:
+        ok = set_coords(model, op);
+        break;
+    case LOCATIONS_BATCH_DEACTIVATE:
+        current = locations_model_find(model, op->loc.name);
+        ok = (current != NULL);
+        if (ok && (current == locations_model_get_active(model)))
+        {
+            locations_model_clear_active(model);
+        }
+        break;
+    case LOCATIONS_BATCH_CHECK_ETAG:
+        current = locations_model_find(model, op->loc.name);
+        ok = (current != NULL) && (locations_model_etag(current) == op->etag);
+        break;
+    default:
+        ok = false;
+        break;
+    }
+
+    return ok;
+}
+
+bool locations_batch_apply(locations_model_t *model,
+                           const locations_batch_op_t *ops, size_t count,
+                           size_t *out_failed_index)
+{
+    bool return_value = false;
+    size_t failed = count;
+
+    if ((model == NULL) || (model->slots == NULL) || ((ops == NULL) && (count > 0U)))
+    {
+        return_value = false;
+    }
+    else
+    {
+        locations_model_t scratch = {0};
+
+        if ((locations_model_init(&scratch, model->capacity) == true) &&
+            (locations_model_copy(&scratch, model) == true))
+        {
+            return_value = true;
+
+            for (size_t i = 0U; i < count; i++)
+            {
+                if (apply_one(&scratch, &ops[i]) == false)
+                {
+                    failed = i;
+                    return_value = false;
+                    break;
+                }
+            }
+
+            if (return_value == true)
+            {
+                /* swap pools: the model takes the scratch state, the old pool is released below */
+                const locations_model_t old = *model;
+                *model = scratch;
+                scratch = old;
+            }
+        }
+
+        locations_model_deinit(&scratch);
+    }
+
+    if ((return_value == false) && (out_failed_index != NULL))
+    {
+        *out_failed_index = failed;
+    }
+
+    return return_value;
+}
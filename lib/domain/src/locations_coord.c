@@ -0,0 +1,179 @@
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "locations_coord.h"
+
+bool locations_coord_lat_valid(int32_t lat_e6)
+{
+    return (lat_e6 >= -LOCATIONS_COORD_LAT_MAX_E6) && (lat_e6 <= LOCATIONS_COORD_LAT_MAX_E6);
+}
+
+bool locations_coord_lon_valid(int32_t lon_e6)
+{
+    return (lon_e6 >= -LOCATIONS_COORD_LON_MAX_E6) && (lon_e6 <= LOCATIONS_COORD_LON_MAX_E6);
+}
+
+bool locations_coord_parse(const char *text, size_t len, int32_t *out_e6)
+{
+    bool ok = false;
+
+    if ((text != NULL) && (out_e6 != NULL) && (len > 0U))
+    {
+        size_t i = 0U;
+        bool negative = false;
+
+        if ((text[0] == '-') || (text[0] == '+'))
+        {
+            negative = (text[0] == '-');
+            i++;
+        }
+
+        int64_t e6 = 0;
+        size_t int_digits = 0U;
+        size_t frac_digits = 0U;
+        bool round_up = false;
+        bool seen_dot = false;
+
+        ok = true;
+
+        for (; (i < len) && (ok == true); i++)
+        {
+            const char c = text[i];
+
+            if ((c == '.') && (seen_dot == false))
+            {
+                seen_dot = true;
+            }
+            else if ((c >= '0') && (c <= '9'))
+            {
+                const int64_t digit = (int64_t)(c - '0');
+
+                if (seen_dot == false)
+                {
+                    /* +/-180 needs at most 3 integer digits (leading zeros aside) */
+                    e6 = (e6 * 10) + (digit * LOCATIONS_COORD_SCALE);
+                    int_digits++;
+                    ok = (e6 <= (int64_t)LOCATIONS_COORD_LON_MAX_E6 * 10);
+                }
+                else
+                {
+                    if (frac_digits < 6U)
+                    {
+                        int64_t place = LOCATIONS_COORD_SCALE / 10;
+                        for (size_t p = 0U; p < frac_digits; p++)
+                        {
+                            place /= 10;
+                        }
+                        e6 += digit * place;
+                    }
+                    else if (frac_digits == 6U)
+                    {
+                        round_up = (digit >= 5);
+                    }
+                    else
+                    {
+                        /* digits beyond the 7th do not change half-away rounding */
+                    }
+                    frac_digits++;
+                }
+            }
+            else
+            {
+                ok = false;
+            }
+        }
+
+        /* need at least one digit; "." or "-" alone is not a number */
+        if ((int_digits + frac_digits) == 0U)
+        {
+            ok = false;
+        }
+
+        if (ok == true)
+        {
+            if (round_up == true)
+            {
+                e6++;
+            }
+            if (negative == true)
+            {
+                e6 = -e6;
+            }
+
+            ok = (e6 >= -(int64_t)LOCATIONS_COORD_LON_MAX_E6) && (e6 <= (int64_t)LOCATIONS_COORD_LON_MAX_E6);
+            if (ok == true)
+            {
+                *out_e6 = (int32_t)e6;
+            }
+        }
+    }
+
+    return ok;
+}
+
+bool locations_coord_from_double(double deg, int32_t *out_e6)
+{
+    bool ok = false;
+
+    if ((out_e6 != NULL) && (isfinite(deg) != 0) && (fabs(deg) <= 180.0))
+    {
+        const double scaled = deg * (double)LOCATIONS_COORD_SCALE;
+
+        /* round half away from zero */
+        *out_e6 = (int32_t)((scaled < 0.0) ? (scaled - 0.5) : (scaled + 0.5));
+        ok = true;
+    }
+
+    return ok;
+}
+
+size_t locations_coord_format(int32_t e6, char *out, size_t out_len)
+{
+    size_t len = 0U;
+
+    if ((out != NULL) && (out_len >= LOCATIONS_COORD_STR_MAX))
+    {
+        char tmp[LOCATIONS_COORD_STR_MAX];
+        uint32_t mag = (e6 < 0) ? (uint32_t)(-(int64_t)e6) : (uint32_t)e6;
+        uint32_t int_part = mag / (uint32_t)LOCATIONS_COORD_SCALE;
+        uint32_t frac = mag % (uint32_t)LOCATIONS_COORD_SCALE;
+        size_t frac_len = 6U;
+
+        /* drop trailing zeros of the fraction */
+        while ((frac_len > 0U) && ((frac % 10U) == 0U))
+        {
+            frac /= 10U;
+            frac_len--;
+        }
+
+        /* build backwards: fraction, dot, integer part, sign */
+        size_t pos = sizeof(tmp);
+        for (size_t i = 0U; i < frac_len; i++)
+        {
+            tmp[--pos] = (char)('0' + (frac % 10U));
+            frac /= 10U;
+        }
+        if (frac_len > 0U)
+        {
+            tmp[--pos] = '.';
+        }
+        do
+        {
+            tmp[--pos] = (char)('0' + (int_part % 10U));
+            int_part /= 10U;
+        } while (int_part > 0U);
+        if ((e6 < 0) && (mag != 0U))
+        {
+            tmp[--pos] = '-';
+        }
+
+        len = sizeof(tmp) - pos;
+        (void)memcpy(out, &tmp[pos], len);
+        out[len] = '\0';
+    }
+
+    return len;
+}
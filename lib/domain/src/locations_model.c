@@ -1,38 +1,350 @@
 #include <string.h>
+#include <stdlib.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include "locations_model.h"
+#include "locations_coord.h"
+#include "locations_spatial.h"
 
-bool locations_model_add(locations_model_t *model, const location_t *loc)
+/*
+    name index helpers
+*/
+
+#define FNV_OFFSET 2166136261U
+#define FNV_PRIME 16777619U
+
+static uint32_t fnv_bytes(uint32_t hash, const unsigned char *p, size_t len)
+{
+    uint32_t h = hash;
+
+    for (size_t i = 0U; i < len; i++)
+    {
+        h ^= (uint32_t)p[i];
+        h *= FNV_PRIME;
+    }
+
+    return h;
+}
+
+static uint32_t name_hash(const char *name)
+{
+    /* FNV-1a, 32 bit */
+    return fnv_bytes(FNV_OFFSET, (const unsigned char *)name, strlen(name));
+}
+
+static size_t index_home(const locations_model_t *model, const char *name)
+{
+    return (size_t)name_hash(name) & (model->index_size - 1U);
+}
+
+/* returns the index position holding `name`, or the empty position where it would go */
+static size_t index_probe(const locations_model_t *model, const char *name, bool *found)
+{
+    const size_t mask = model->index_size - 1U;
+    size_t pos = index_home(model, name);
+
+    *found = false;
+
+    /* load factor <= 0.5 guarantees an empty position */
+    while (model->index[pos] != LOCATIONS_MODEL_NO_SLOT)
+    {
+        if (strcmp(model->slots[model->index[pos]].loc.name, name) == 0)
+        {
+            *found = true;
+            break;
+        }
+
+        pos = (pos + 1U) & mask;
+    }
+
+    return pos;
+}
+
+/* backward-shift deletion: keeps probe chains intact without tombstones */
+static void index_erase(locations_model_t *model, size_t pos)
+{
+    const size_t mask = model->index_size - 1U;
+    size_t hole = pos;
+    size_t next = pos;
+
+    model->index[hole] = LOCATIONS_MODEL_NO_SLOT;
+
+    for (;;)
+    {
+        next = (next + 1U) & mask;
+
+        if (model->index[next] == LOCATIONS_MODEL_NO_SLOT)
+        {
+            break;
+        }
+
+        const size_t home = index_home(model, model->slots[model->index[next]].loc.name);
+
+        /* entry may stay if its home lies cyclically in (hole, next] */
+        const bool stays = (hole < next) ? ((hole < home) && (home <= next))
+                                         : ((hole < home) || (home <= next));
+
+        if (stays == false)
+        {
+            model->index[hole] = model->index[next];
+            model->index[next] = LOCATIONS_MODEL_NO_SLOT;
+            hole = next;
+        }
+    }
+}
+
+/*
+    grid helpers
+*/
+
+static void cell_link(locations_model_t *model, uint16_t slot)
+{
+    locations_model_slot_t *s = &model->slots[slot];
+    const size_t bucket = locations_spatial_bucket(model, s->cell);
+
+    s->cell_prev = LOCATIONS_MODEL_NO_SLOT;
+    s->cell_next = model->cells[bucket];
+    if (s->cell_next != LOCATIONS_MODEL_NO_SLOT)
+    {
+        model->slots[s->cell_next].cell_prev = slot;
+    }
+    model->cells[bucket] = slot;
+}
+
+static void cell_unlink(locations_model_t *model, uint16_t slot)
+{
+    locations_model_slot_t *s = &model->slots[slot];
+
+    if (s->cell_prev != LOCATIONS_MODEL_NO_SLOT)
+    {
+        model->slots[s->cell_prev].cell_next = s->cell_next;
+    }
+    else
+    {
+        model->cells[locations_spatial_bucket(model, s->cell)] = s->cell_next;
+    }
+
+    if (s->cell_next != LOCATIONS_MODEL_NO_SLOT)
+    {
+        model->slots[s->cell_next].cell_prev = s->cell_prev;
+    }
+
+    s->cell_prev = LOCATIONS_MODEL_NO_SLOT;
+    s->cell_next = LOCATIONS_MODEL_NO_SLOT;
+}
+
+/*
+    active slot: the only place that writes is_active
+*/
+
+static void active_set(locations_model_t *model, uint16_t slot)
+{
+    if (model->active != LOCATIONS_MODEL_NO_SLOT)
+    {
+        model->slots[model->active].loc.is_active = false;
+    }
+
+    model->active = slot;
+
+    if (slot != LOCATIONS_MODEL_NO_SLOT)
+    {
+        model->slots[slot].loc.is_active = true;
+    }
+}
+
+static const locations_model_slot_t *slot_of(const location_t *loc)
+{
+    /* loc is the first member of its slot */
+    return (const locations_model_slot_t *)(const void *)loc;
+}
+
+/*
+    lifecycle
+*/
+
+bool locations_model_init(locations_model_t *model, size_t capacity)
 {
     bool return_value = false;
 
-    if ((model == NULL) || (loc == NULL))
+    if ((model == NULL) || (capacity == 0U) || (capacity > (size_t)LOCATIONS_MODEL_MAX_NUMBER))
     {
         return_value = false;
     }
-    else if (model->count >= LOCATIONS_MODEL_MAX_NUMBER)
+    else
+    {
+        size_t index_size = 4U;
+        while (index_size < (capacity * 2U))
+        {
+            index_size *= 2U;
+        }
+
+        /* slots, name index and grid buckets in one pool block */
+        const size_t slots_bytes = capacity * sizeof(locations_model_slot_t);
+        const size_t index_bytes = index_size * sizeof(uint16_t);
+        /* zeroed: slot generations start at 0 (free) */
+        uint8_t *pool = (uint8_t *)calloc(1U, slots_bytes + (2U * index_bytes));
+
+        (void)memset(model, 0, sizeof(*model));
+
+        if (pool != NULL)
+        {
+            model->slots = (locations_model_slot_t *)(void *)pool;
+            model->index = (uint16_t *)(void *)&pool[slots_bytes];
+            model->cells = (uint16_t *)(void *)&pool[slots_bytes + index_bytes];
+            model->capacity = capacity;
+            model->index_size = index_size;
+
+            locations_model_clear(model);
+            return_value = true;
+        }
+    }
+
+    return return_value;
+}
+
+void locations_model_deinit(locations_model_t *model)
+{
+    if (model != NULL)
+    {
+        free(model->slots);
+        (void)memset(model, 0, sizeof(*model));
+    }
+}
+
+void locations_model_clear(locations_model_t *model)
+{
+    if ((model != NULL) && (model->slots != NULL))
+    {
+        for (size_t i = 0U; i < model->capacity; i++)
+        {
+            /* slots in use become free (even generation), so old handles go stale */
+            const uint16_t gen = model->slots[i].gen;
+            (void)memset(&model->slots[i], 0, sizeof(model->slots[i]));
+            model->slots[i].gen = (uint16_t)(gen + (gen & 1U));
+        }
+
+        for (size_t i = 0U; i < model->index_size; i++)
+        {
+            model->index[i] = LOCATIONS_MODEL_NO_SLOT;
+            model->cells[i] = LOCATIONS_MODEL_NO_SLOT;
+        }
+
+        /* free list is chained through .next */
+        for (size_t i = 0U; i < model->capacity; i++)
+        {
+            model->slots[i].cell_prev = LOCATIONS_MODEL_NO_SLOT;
+            model->slots[i].cell_next = LOCATIONS_MODEL_NO_SLOT;
+            model->slots[i].prev = LOCATIONS_MODEL_NO_SLOT;
+            model->slots[i].next = ((i + 1U) < model->capacity) ? (uint16_t)(i + 1U) : LOCATIONS_MODEL_NO_SLOT;
+        }
+
+        model->count = 0U;
+        model->head = LOCATIONS_MODEL_NO_SLOT;
+        model->tail = LOCATIONS_MODEL_NO_SLOT;
+        model->free_head = 0U;
+        model->active = LOCATIONS_MODEL_NO_SLOT;
+    }
+}
+
+bool locations_model_copy(locations_model_t *dst, const locations_model_t *src)
+{
+    bool return_value = false;
+
+    if ((dst == NULL) || (src == NULL) || (dst->slots == NULL) || (src->slots == NULL) ||
+        (dst->capacity != src->capacity))
     {
         return_value = false;
     }
     else
     {
+        /* links are slot numbers, so the pool block copies as is */
+        const size_t pool_bytes = (src->capacity * sizeof(locations_model_slot_t)) +
+                                  (2U * src->index_size * sizeof(uint16_t));
+
+        (void)memcpy(dst->slots, src->slots, pool_bytes);
+        dst->count = src->count;
+        dst->head = src->head;
+        dst->tail = src->tail;
+        dst->free_head = src->free_head;
+        dst->active = src->active;
+
         return_value = true;
+    }
+
+    return return_value;
+}
+
+/*
+    mutation
+*/
+
+bool locations_model_add(locations_model_t *model, const location_t *loc)
+{
+    bool return_value = false;
+
+    if ((model == NULL) || (model->slots == NULL) || (loc == NULL))
+    {
+        return_value = false;
+    }
+    else if (model->count >= model->capacity)
+    {
+        return_value = false;
+    }
+    else if ((locations_coord_lat_valid(loc->latitude_e6) == false) ||
+             (locations_coord_lon_valid(loc->longitude_e6) == false))
+    {
+        return_value = false;
+    }
+    else
+    {
+        bool found = false;
+        const size_t pos = index_probe(model, loc->name, &found);
 
-        for (size_t i = 0U; i < model->count; i++)
+        if (found == true)
         {
-            if (strcmp(model->items[i].name, loc->name) == 0)
+            return_value = false;
+        }
+        else
+        {
+            const uint16_t slot = model->free_head;
+            locations_model_slot_t *s = &model->slots[slot];
+
+            model->free_head = s->next;
+
+            s->loc = *loc;
+            s->loc.name[sizeof(s->loc.name) - 1U] = '\0';
+            s->loc.is_active = false;
+            s->gen++;
+
+            /* append in insertion order */
+            s->prev = model->tail;
+            s->next = LOCATIONS_MODEL_NO_SLOT;
+            if (model->tail != LOCATIONS_MODEL_NO_SLOT)
             {
-                return_value = false;
-                break;
+                model->slots[model->tail].next = slot;
+            }
+            else
+            {
+                model->head = slot;
+            }
+            model->tail = slot;
+
+            model->index[pos] = slot;
+
+            s->cell = locations_spatial_cell_key(s->loc.latitude_e6, s->loc.longitude_e6);
+            cell_link(model, slot);
+
+            /* first active entry wins, a later one is stored inactive */
+            if ((loc->is_active == true) && (model->active == LOCATIONS_MODEL_NO_SLOT))
+            {
+                active_set(model, slot);
             }
-        }
 
-        if (return_value == true)
-        {
-            model->items[model->count] = *loc;
             model->count++;
+
+            return_value = true;
         }
     }
 
@@ -43,26 +355,14 @@ bool locations_model_remove(locations_model_t *model, const char *name)
 {
     bool return_value = false;
 
-    size_t index = 0U;
-    bool found = false;
-    bool removed_was_active = false;
-
-    if ((model == NULL) || (name == NULL) || (name[0] == '\0'))
+    if ((model == NULL) || (model->slots == NULL) || (name == NULL) || (name[0] == '\0'))
     {
         return_value = false;
     }
     else
     {
-        /* find index by name */
-        for (size_t i = 0U; i < model->count; i++)
-        {
-            if (strcmp(model->items[i].name, name) == 0)
-            {
-                index = i;
-                found = true;
-                break;
-            }
-        }
+        bool found = false;
+        const size_t pos = index_probe(model, name, &found);
 
         if (found == false)
         {
@@ -70,28 +370,141 @@ bool locations_model_remove(locations_model_t *model, const char *name)
         }
         else
         {
-            removed_was_active = model->items[index].is_active;
+            const uint16_t slot = model->index[pos];
+            locations_model_slot_t *s = &model->slots[slot];
 
-            /* shift left */
-            for (size_t i = index; (i + 1U) < model->count; i++)
+            /* removing the active entry leaves none active */
+            if (model->active == slot)
             {
-                model->items[i] = model->items[i + 1U];
+                active_set(model, LOCATIONS_MODEL_NO_SLOT);
             }
 
-            /* decrease count */
-            model->count--;
+            /* index first: backward shift still needs the names of the other entries */
+            index_erase(model, pos);
+            cell_unlink(model, slot);
 
-            (void)memset(&model->items[model->count], 0, sizeof(model->items[model->count]));
+            /* unlink from insertion order */
+            if (s->prev != LOCATIONS_MODEL_NO_SLOT)
+            {
+                model->slots[s->prev].next = s->next;
+            }
+            else
+            {
+                model->head = s->next;
+            }
 
-            /* if the removed was active, enforce "no active" afterwards */
-            if (removed_was_active == true)
+            if (s->next != LOCATIONS_MODEL_NO_SLOT)
+            {
+                model->slots[s->next].prev = s->prev;
+            }
+            else
             {
-                for (size_t i = 0U; i < model->count; i++)
-                {
-                    model->items[i].is_active = false;
-                }
+                model->tail = s->prev;
             }
 
+            /* return slot to the free list */
+            (void)memset(&s->loc, 0, sizeof(s->loc));
+            s->gen++;
+            s->prev = LOCATIONS_MODEL_NO_SLOT;
+            s->next = model->free_head;
+            model->free_head = slot;
+
+            model->count--;
+
+            return_value = true;
+        }
+    }
+
+    return return_value;
+}
+
+bool locations_model_rename(locations_model_t *model, const char *name, const char *new_name)
+{
+    bool return_value = false;
+
+    if ((model == NULL) || (model->slots == NULL) || (name == NULL) || (new_name == NULL) || (new_name[0] == '\0'))
+    {
+        return_value = false;
+    }
+    else
+    {
+        char bounded[sizeof(model->slots[0].loc.name)];
+        bool found = false;
+        bool taken = false;
+
+        /* same truncation as locations_model_add */
+        (void)strncpy(bounded, new_name, sizeof(bounded) - 1U);
+        bounded[sizeof(bounded) - 1U] = '\0';
+
+        const size_t pos = index_probe(model, name, &found);
+        (void)index_probe(model, bounded, &taken);
+
+        if ((found == true) && (taken == false))
+        {
+            const uint16_t slot = model->index[pos];
+
+            /* re-key: erase under the old name, insert under the new one */
+            index_erase(model, pos);
+            (void)memcpy(model->slots[slot].loc.name, bounded, sizeof(bounded));
+            model->index[index_probe(model, bounded, &taken)] = slot;
+
+            return_value = true;
+        }
+    }
+
+    return return_value;
+}
+
+bool locations_model_set_coords(locations_model_t *model, const char *name, int32_t latitude_e6, int32_t longitude_e6)
+{
+    bool return_value = false;
+
+    if ((model == NULL) || (model->slots == NULL) || (name == NULL) ||
+        (locations_coord_lat_valid(latitude_e6) == false) ||
+        (locations_coord_lon_valid(longitude_e6) == false))
+    {
+        return_value = false;
+    }
+    else
+    {
+        bool found = false;
+        const size_t pos = index_probe(model, name, &found);
+
+        if (found == true)
+        {
+            const uint16_t slot = model->index[pos];
+            locations_model_slot_t *s = &model->slots[slot];
+
+            /* the grid cell may change with the coordinates */
+            cell_unlink(model, slot);
+            s->loc.latitude_e6 = latitude_e6;
+            s->loc.longitude_e6 = longitude_e6;
+            s->cell = locations_spatial_cell_key(latitude_e6, longitude_e6);
+            cell_link(model, slot);
+
+            return_value = true;
+        }
+    }
+
+    return return_value;
+}
+
+bool locations_model_set_active(locations_model_t *model, const char *name)
+{
+    bool return_value = false;
+
+    if ((model == NULL) || (model->slots == NULL) || (name == NULL))
+    {
+        return_value = false;
+    }
+    else
+    {
+        bool found = false;
+        const size_t pos = index_probe(model, name, &found);
+
+        if (found == true)
+        {
+            active_set(model, model->index[pos]);
             return_value = true;
         }
     }
@@ -99,21 +512,137 @@ bool locations_model_remove(locations_model_t *model, const char *name)
     return return_value;
 }
 
+void locations_model_clear_active(locations_model_t *model)
+{
+    if ((model != NULL) && (model->slots != NULL))
+    {
+        active_set(model, LOCATIONS_MODEL_NO_SLOT);
+    }
+}
+
+/*
+    queries
+*/
+
+const location_t *locations_model_find(const locations_model_t *model, const char *name)
+{
+    const location_t *loc = NULL;
+
+    if ((model != NULL) && (model->slots != NULL) && (name != NULL))
+    {
+        bool found = false;
+        const size_t pos = index_probe(model, name, &found);
+
+        if (found == true)
+        {
+            loc = &model->slots[model->index[pos]].loc;
+        }
+    }
+
+    return loc;
+}
+
 const location_t *locations_model_get_active(const locations_model_t *model)
 {
     const location_t *active = NULL;
 
-    if (model != NULL)
+    if ((model != NULL) && (model->slots != NULL) && (model->active != LOCATIONS_MODEL_NO_SLOT))
+    {
+        active = &model->slots[model->active].loc;
+    }
+
+    return active;
+}
+
+locations_handle_t locations_model_handle(const locations_model_t *model, const location_t *loc)
+{
+    locations_handle_t handle = {LOCATIONS_MODEL_NO_SLOT, 0U};
+
+    if ((model != NULL) && (model->slots != NULL) && (loc != NULL))
     {
-        for (size_t i = 0U; i < model->count; i++)
+        /* compare addresses as integers: loc may belong to another model */
+        const uintptr_t base = (uintptr_t)(const void *)model->slots;
+        const uintptr_t addr = (uintptr_t)(const void *)loc;
+
+        if ((addr >= base) && (((addr - base) % sizeof(locations_model_slot_t)) == 0U))
         {
-            if (model->items[i].is_active == true)
+            const size_t slot = (addr - base) / sizeof(locations_model_slot_t);
+
+            if ((slot < model->capacity) && ((model->slots[slot].gen & 1U) != 0U))
             {
-                active = &model->items[i];
-                break;
+                handle.slot = (uint16_t)slot;
+                handle.gen = model->slots[slot].gen;
             }
         }
     }
 
-    return active;
-}
\ No newline at end of file
+    return handle;
+}
+
+const location_t *locations_model_resolve(const locations_model_t *model, locations_handle_t handle)
+{
+    const location_t *loc = NULL;
+
+    if ((model != NULL) && (model->slots != NULL) && ((size_t)handle.slot < model->capacity) &&
+        ((handle.gen & 1U) != 0U) && (model->slots[handle.slot].gen == handle.gen))
+    {
+        loc = &model->slots[handle.slot].loc;
+    }
+
+    return loc;
+}
+
+const location_t *locations_model_first(const locations_model_t *model)
+{
+    const location_t *loc = NULL;
+
+    if ((model != NULL) && (model->slots != NULL) && (model->head != LOCATIONS_MODEL_NO_SLOT))
+    {
+        loc = &model->slots[model->head].loc;
+    }
+
+    return loc;
+}
+
+const location_t *locations_model_next(const locations_model_t *model, const location_t *loc)
+{
+    const location_t *next = NULL;
+
+    if ((model != NULL) && (model->slots != NULL) && (loc != NULL))
+    {
+        const uint16_t slot = slot_of(loc)->next;
+
+        if (slot != LOCATIONS_MODEL_NO_SLOT)
+        {
+            next = &model->slots[slot].loc;
+        }
+    }
+
+    return next;
+}
+
+uint32_t locations_model_etag(const location_t *loc)
+{
+    uint32_t hash = 0U;
+
+    if (loc != NULL)
+    {
+        /* fixed byte order, so the tag does not depend on the host */
+        const uint32_t lat = (uint32_t)loc->latitude_e6;
+        const uint32_t lon = (uint32_t)loc->longitude_e6;
+        const unsigned char tail[9] = {
+            (unsigned char)(lat & 0xFFU), (unsigned char)((lat >> 8) & 0xFFU),
+            (unsigned char)((lat >> 16) & 0xFFU), (unsigned char)(lat >> 24),
+            (unsigned char)(lon & 0xFFU), (unsigned char)((lon >> 8) & 0xFFU),
+            (unsigned char)((lon >> 16) & 0xFFU), (unsigned char)(lon >> 24),
+            (loc->is_active == true) ? 1U : 0U,
+        };
+        const char *nul = (const char *)memchr(loc->name, '\0', sizeof(loc->name));
+        const size_t name_len = (nul != NULL) ? (size_t)(nul - loc->name) : sizeof(loc->name);
+
+        hash = fnv_bytes(FNV_OFFSET, (const unsigned char *)loc->name, name_len);
+        hash = fnv_bytes(hash, tail, sizeof(tail));
+    }
+
+    return hash;
+}
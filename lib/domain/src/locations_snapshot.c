@@ -0,0 +1,58 @@
+#include <stdlib.h>
+
+#include "locations_snapshot.h"
+
+locations_snapshot_t *locations_snapshot_create(const locations_model_t *src)
+{
+    locations_snapshot_t *snap = NULL;
+
+    if ((src != NULL) && (src->slots != NULL))
+    {
+        snap = (locations_snapshot_t *)calloc(1U, sizeof(*snap));
+
+        if (snap != NULL)
+        {
+            if ((locations_model_init(&snap->model, src->capacity) == true) &&
+                (locations_model_copy(&snap->model, src) == true))
+            {
+                atomic_init(&snap->refs, 1U);
+            }
+            else
+            {
+                /* model is zeroed by calloc, deinit is safe even if init failed */
+                locations_model_deinit(&snap->model);
+                free(snap);
+                snap = NULL;
+            }
+        }
+    }
+
+    return snap;
+}
+
+void locations_snapshot_retain(locations_snapshot_t *snap)
+{
+    if (snap != NULL)
+    {
+        /* the caller already holds a reference, so no ordering is needed */
+        (void)atomic_fetch_add_explicit(&snap->refs, 1U, memory_order_relaxed);
+    }
+}
+
+void locations_snapshot_release(locations_snapshot_t *snap)
+{
+    if (snap != NULL)
+    {
+        /* acq_rel: all reads through other references happen before the free */
+        if (atomic_fetch_sub_explicit(&snap->refs, 1U, memory_order_acq_rel) == 1U)
+        {
+            locations_model_deinit(&snap->model);
+            free(snap);
+        }
+    }
+}
+
+const locations_model_t *locations_snapshot_model(const locations_snapshot_t *snap)
+{
+    return (snap != NULL) ? &snap->model : NULL;
+}
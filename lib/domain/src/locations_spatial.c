@@ -0,0 +1,304 @@
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "locations_spatial.h"
+#include "locations_coord.h"
+
+#define E6_TO_RAD (3.14159265358979323846f / (180.0f * 1000000.0f))
+
+#define DEG_E6_90 (90L * LOCATIONS_COORD_SCALE)
+#define DEG_E6_180 (180L * LOCATIONS_COORD_SCALE)
+#define DEG_E6_360 (360L * LOCATIONS_COORD_SCALE)
+
+/* cells visited before falling back to a full scan: model count + first ring */
+#define MIN_CELL_BUDGET 9U
+
+/* ring bound is shrunk by this factor so float rounding never stops the search early */
+#define BOUND_SLACK 0.9999f
+
+typedef struct
+{
+    const locations_model_t *model;
+    locations_spatial_hit_t *hits;
+    size_t k;
+    size_t n;
+    size_t seen;
+    int32_t lat_e6;
+    int32_t lon_e6;
+} nearest_ctx_t;
+
+/*
+    grid helpers
+*/
+
+static int32_t floor_div(int64_t a, int64_t b)
+{
+    int64_t q = a / b;
+
+    if (((a % b) != 0) && ((a < 0) != (b < 0)))
+    {
+        q--;
+    }
+
+    return (int32_t)q;
+}
+
+static int32_t cell_row(int32_t lat_e6)
+{
+    int32_t row = floor_div((int64_t)lat_e6 + DEG_E6_90, LOCATIONS_SPATIAL_CELL_E6);
+
+    if (row < 0)
+    {
+        row = 0;
+    }
+    else if (row >= (int32_t)LOCATIONS_SPATIAL_ROWS)
+    {
+        row = (int32_t)LOCATIONS_SPATIAL_ROWS - 1;
+    }
+
+    return row;
+}
+
+static int32_t wrap_col(int32_t col)
+{
+    const int32_t cols = (int32_t)LOCATIONS_SPATIAL_COLS;
+
+    return ((col % cols) + cols) % cols;
+}
+
+static int32_t cell_col(int32_t lon_e6)
+{
+    return wrap_col(floor_div((int64_t)lon_e6 + DEG_E6_180, LOCATIONS_SPATIAL_CELL_E6));
+}
+
+uint32_t locations_spatial_cell_key(int32_t lat_e6, int32_t lon_e6)
+{
+    return ((uint32_t)cell_row(lat_e6) * LOCATIONS_SPATIAL_COLS) + (uint32_t)cell_col(lon_e6);
+}
+
+size_t locations_spatial_bucket(const locations_model_t *model, uint32_t cell_key)
+{
+    /* Fibonacci hashing; neighbouring cells land in different buckets */
+    return (size_t)(cell_key * 2654435761U) & (model->index_size - 1U);
+}
+
+static float haversine_m(float h)
+{
+    if (h > 1.0f)
+    {
+        h = 1.0f;
+    }
+
+    return 2.0f * LOCATIONS_SPATIAL_EARTH_RADIUS_M * asinf(sqrtf(h));
+}
+
+float locations_spatial_distance_m(int32_t lat1_e6, int32_t lon1_e6, int32_t lat2_e6, int32_t lon2_e6)
+{
+    /* differences in integer microdegrees, longitude folded into [-180, 180] */
+    int64_t dlon_e6 = (int64_t)lon2_e6 - (int64_t)lon1_e6;
+    dlon_e6 %= DEG_E6_360;
+    if (dlon_e6 > DEG_E6_180)
+    {
+        dlon_e6 -= DEG_E6_360;
+    }
+    else if (dlon_e6 < -DEG_E6_180)
+    {
+        dlon_e6 += DEG_E6_360;
+    }
+
+    const float dlat = (float)((int64_t)lat2_e6 - (int64_t)lat1_e6) * E6_TO_RAD;
+    const float dlon = (float)dlon_e6 * E6_TO_RAD;
+    const float s_lat = sinf(dlat / 2.0f);
+    const float s_lon = sinf(dlon / 2.0f);
+
+    return haversine_m((s_lat * s_lat) +
+                       (cosf((float)lat1_e6 * E6_TO_RAD) * cosf((float)lat2_e6 * E6_TO_RAD) * s_lon * s_lon));
+}
+
+/*
+    result list (sorted ascending, at most k entries)
+*/
+
+static void hits_insert(nearest_ctx_t *ctx, const location_t *loc)
+{
+    const float d = locations_spatial_distance_m(ctx->lat_e6, ctx->lon_e6, loc->latitude_e6, loc->longitude_e6);
+
+    ctx->seen++;
+
+    if ((ctx->n < ctx->k) || (d < ctx->hits[ctx->k - 1U].distance_m))
+    {
+        size_t i = (ctx->n < ctx->k) ? ctx->n++ : (ctx->k - 1U);
+
+        while ((i > 0U) && (ctx->hits[i - 1U].distance_m > d))
+        {
+            ctx->hits[i] = ctx->hits[i - 1U];
+            i--;
+        }
+
+        ctx->hits[i].loc = loc;
+        ctx->hits[i].distance_m = d;
+    }
+}
+
+static void visit_cell(nearest_ctx_t *ctx, int32_t row, int32_t col)
+{
+    if ((row >= 0) && (row < (int32_t)LOCATIONS_SPATIAL_ROWS))
+    {
+        const locations_model_t *model = ctx->model;
+        const uint32_t key = ((uint32_t)row * LOCATIONS_SPATIAL_COLS) + (uint32_t)wrap_col(col);
+
+        /* a bucket may chain several cells; only take entries of this one */
+        for (uint16_t s = model->cells[locations_spatial_bucket(model, key)];
+             s != LOCATIONS_MODEL_NO_SLOT;
+             s = model->slots[s].cell_next)
+        {
+            if (model->slots[s].cell == key)
+            {
+                hits_insert(ctx, &model->slots[s].loc);
+            }
+        }
+    }
+}
+
+/* lower bound for the distance of any entry outside rings 0..r */
+static float outside_bound_m(const nearest_ctx_t *ctx, int32_t row0, int32_t col0, int32_t r)
+{
+    const int64_t lat_lo = ((int64_t)(row0 - r) * LOCATIONS_SPATIAL_CELL_E6) - DEG_E6_90;
+    const int64_t lat_hi = ((int64_t)(row0 + r + 1) * LOCATIONS_SPATIAL_CELL_E6) - DEG_E6_90;
+    const int64_t lon_lo = ((int64_t)(col0 - r) * LOCATIONS_SPATIAL_CELL_E6) - DEG_E6_180;
+    const int64_t lon_hi = ((int64_t)(col0 + r + 1) * LOCATIONS_SPATIAL_CELL_E6) - DEG_E6_180;
+
+    /* north / south of the band: hav(d) >= hav(dlat) */
+    int64_t d_lat = INT64_MAX;
+    if (lat_lo > -DEG_E6_90)
+    {
+        d_lat = (int64_t)ctx->lat_e6 - lat_lo;
+    }
+    if ((lat_hi < DEG_E6_90) && ((lat_hi - ctx->lat_e6) < d_lat))
+    {
+        d_lat = lat_hi - ctx->lat_e6;
+    }
+
+    const float bound_lat = (d_lat == INT64_MAX) ? HUGE_VALF
+                                                 : ((float)d_lat * E6_TO_RAD * LOCATIONS_SPATIAL_EARTH_RADIUS_M);
+
+    /* east / west inside the band: hav(d) >= cos(lat) * cos(lat') * hav(dlon) */
+    int64_t d_lon = (int64_t)ctx->lon_e6 - lon_lo;
+    if ((lon_hi - ctx->lon_e6) < d_lon)
+    {
+        d_lon = lon_hi - ctx->lon_e6;
+    }
+
+    int64_t max_abs_lat = (lat_lo < 0) ? -lat_lo : lat_lo;
+    if (((lat_hi < 0) ? -lat_hi : lat_hi) > max_abs_lat)
+    {
+        max_abs_lat = (lat_hi < 0) ? -lat_hi : lat_hi;
+    }
+
+    float bound_lon = 0.0f;
+    if (max_abs_lat < DEG_E6_90)
+    {
+        const float s_lon = sinf(((float)d_lon * E6_TO_RAD) / 2.0f);
+        bound_lon = haversine_m(cosf((float)ctx->lat_e6 * E6_TO_RAD) * cosf((float)max_abs_lat * E6_TO_RAD) * s_lon * s_lon);
+    }
+
+    return ((bound_lat < bound_lon) ? bound_lat : bound_lon) * BOUND_SLACK;
+}
+
+static void full_scan(nearest_ctx_t *ctx)
+{
+    ctx->n = 0U;
+    ctx->seen = 0U;
+
+    for (const location_t *loc = locations_model_first(ctx->model); loc != NULL; loc = locations_model_next(ctx->model, loc))
+    {
+        hits_insert(ctx, loc);
+    }
+}
+
+size_t locations_spatial_nearest(const locations_model_t *model,
+                                 int32_t lat_e6, int32_t lon_e6,
+                                 locations_spatial_hit_t *out_hits, size_t k)
+{
+    nearest_ctx_t ctx = {
+        .model = model,
+        .hits = out_hits,
+        .k = k,
+        .n = 0U,
+        .seen = 0U,
+        .lat_e6 = lat_e6,
+        .lon_e6 = lon_e6,
+    };
+
+    if ((model == NULL) || (model->slots == NULL) || (out_hits == NULL) || (k == 0U) ||
+        (locations_coord_lat_valid(lat_e6) == false) || (locations_coord_lon_valid(lon_e6) == false))
+    {
+        return 0U;
+    }
+
+    /* +180 and -180 are the same meridian; keep the query inside its cell for the ring bounds */
+    if (ctx.lon_e6 == (int32_t)DEG_E6_180)
+    {
+        ctx.lon_e6 = -(int32_t)DEG_E6_180;
+    }
+
+    if (ctx.k > LOCATIONS_SPATIAL_MAX_K)
+    {
+        ctx.k = LOCATIONS_SPATIAL_MAX_K;
+    }
+    if (ctx.k > model->count)
+    {
+        ctx.k = model->count;
+    }
+
+    const int32_t row0 = cell_row(lat_e6);
+    const int32_t col0 = cell_col(lon_e6);
+    const size_t budget = model->count + MIN_CELL_BUDGET;
+    size_t visited = 0U;
+    bool done = (ctx.k == 0U);
+
+    for (int32_t r = 0; done == false; r++)
+    {
+        const size_t ring_cells = (r == 0) ? 1U : (8U * (size_t)r);
+
+        /* rings got more expensive than looking at every entry */
+        if (((visited + ring_cells) > budget) || (((2 * r) + 1) >= (int32_t)LOCATIONS_SPATIAL_COLS))
+        {
+            full_scan(&ctx);
+            break;
+        }
+
+        if (r == 0)
+        {
+            visit_cell(&ctx, row0, col0);
+        }
+        else
+        {
+            for (int32_t c = col0 - r; c <= (col0 + r); c++)
+            {
+                visit_cell(&ctx, row0 - r, c);
+                visit_cell(&ctx, row0 + r, c);
+            }
+            for (int32_t row = row0 - r + 1; row <= (row0 + r - 1); row++)
+            {
+                visit_cell(&ctx, row, col0 - r);
+                visit_cell(&ctx, row, col0 + r);
+            }
+        }
+
+        visited += ring_cells;
+
+        if (ctx.seen >= model->count)
+        {
+            done = true;
+        }
+        else if ((ctx.n == ctx.k) && (ctx.hits[ctx.k - 1U].distance_m <= outside_bound_m(&ctx, row0, col0, r)))
+        {
+            done = true;
+        }
+    }
+
+    return ctx.n;
+}
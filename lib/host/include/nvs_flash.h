@@ -0,0 +1,11 @@
+#pragma once
+
+#include "esp_err.h"
+
+/* Host (native) subset of ESP-IDF nvs_flash.h, see nvs_host.h */
+
+/* mounts a RAM-only partition of NVS_HOST_DEFAULT_PAGES unless nvs_host_mount() ran before */
+esp_err_t nvs_flash_init(void);
+esp_err_t nvs_flash_deinit(void);
+/* erases every page of the mounted partition (counted in nvs_host_stats_t) */
+esp_err_t nvs_flash_erase(void);
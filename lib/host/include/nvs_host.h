@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+/*
+ * NVS emulator for the native env: implements nvs.h / nvs_flash.h on a
+ * partition image held in RAM and, optionally, mirrored to a file so values
+ * survive a remount (a simulated reboot).
+ *
+ * The image follows the IDF layout closely enough for wear accounting:
+ * 4 KiB pages with a state word and a 2-bit-per-entry state bitmap, 126
+ * entries of 32 bytes per page, items written append-only into the active
+ * page (a string or blob takes one header entry plus one entry per 32 data
+ * bytes), replaced items marked erased, one page kept free and reclaimed by
+ * garbage collection (live items copied out, page erased). Unchanged values
+ * are not rewritten, as in IDF. Flash rules hold: programming only clears
+ * bits, only a page erase sets them. Not modelled: CRCs, blobs spanning
+ * pages (values are limited to one page, 4000 bytes), power loss.
+ *
+ * Single threaded; one partition at a time.
+ */
+
+#define NVS_HOST_PAGE_SIZE 4096U
+#define NVS_HOST_ENTRY_SIZE 32U
+#define NVS_HOST_ENTRIES_PER_PAGE 126U
+/* nvs partition in partitions.csv: 0x6000 */
+#define NVS_HOST_DEFAULT_PAGES 6U
+
+typedef struct
+{
+    uint32_t entries_written; /* 32-byte entries programmed, garbage collection included */
+    uint32_t entries_erased;  /* entries marked erased (value replaced or removed) */
+    uint32_t entries_moved;   /* live entries copied by garbage collection */
+    uint32_t page_erases;
+    uint32_t writes_skipped; /* sets with the stored value */
+    uint32_t commits;
+} nvs_host_stats_t;
+
+/* path NULL: RAM only; an existing file must hold exactly pages pages */
+esp_err_t nvs_host_mount(const char *path, size_t pages);
+void nvs_host_unmount(void);
+
+/* counters since mount or the last reset */
+void nvs_host_stats(nvs_host_stats_t *out);
+void nvs_host_reset_stats(void);
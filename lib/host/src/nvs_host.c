@@ -0,0 +1,1150 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nvs.h"
+#include "nvs_flash.h"
+#include "nvs_host.h"
+
+/* page: state word, sequence number, entry state bitmap, entries */
+#define PAGE_SEQ_OFFSET 4U
+#define PAGE_BITMAP_OFFSET 32U
+#define PAGE_ENTRIES_OFFSET 64U
+
+#define PAGE_UNINIT 0xFFFFFFFFU
+#define PAGE_ACTIVE 0xFFFFFFFEU
+#define PAGE_FULL 0xFFFFFFFCU
+
+/* 2 bits per entry */
+#define ENTRY_EMPTY 3U
+#define ENTRY_WRITTEN 2U
+#define ENTRY_ERASED 0U
+
+/* entry: ns, type, span, chunk, crc (unused), key, data */
+#define ENTRY_NS 0U
+#define ENTRY_TYPE 1U
+#define ENTRY_SPAN 2U
+#define ENTRY_KEY 8U
+#define ENTRY_DATA 24U
+#define ENTRY_DATA_LEN 8U
+
+/* namespace names are U8 items in namespace 0, valued with their index */
+#define NS_NAMES 0U
+#define NS_MAX 254U
+
+#define MAX_HANDLES 16U
+#define MAX_VALUE_LEN ((NVS_HOST_ENTRIES_PER_PAGE - 1U) * NVS_HOST_ENTRY_SIZE)
+
+typedef struct
+{
+    size_t page;
+    size_t entry;
+} item_pos_t;
+
+typedef struct
+{
+    bool used;
+    bool read_only;
+    uint8_t ns;
+} host_handle_t;
+
+static struct
+{
+    bool mounted;
+    uint8_t *image;
+    size_t pages;
+    FILE *file;
+    size_t active;     /* page receiving writes */
+    size_t next_entry; /* first empty entry in it */
+    uint32_t next_seq;
+    host_handle_t handles[MAX_HANDLES];
+    nvs_host_stats_t stats;
+} s_nvs;
+
+/*
+    flash
+*/
+
+static size_t entry_offset(size_t page, size_t entry)
+{
+    return (page * NVS_HOST_PAGE_SIZE) + PAGE_ENTRIES_OFFSET + (entry * NVS_HOST_ENTRY_SIZE);
+}
+
+static const uint8_t *entry_at(size_t page, size_t entry)
+{
+    return &s_nvs.image[entry_offset(page, entry)];
+}
+
+static void mirror(size_t off, size_t len)
+{
+    if (s_nvs.file != NULL)
+    {
+        (void)fseek(s_nvs.file, (long)off, SEEK_SET);
+        (void)fwrite(&s_nvs.image[off], 1U, len, s_nvs.file);
+        (void)fflush(s_nvs.file);
+    }
+}
+
+/* programming clears bits only */
+static void program(size_t off, const uint8_t *data, size_t len)
+{
+    for (size_t i = 0U; i < len; i++)
+    {
+        s_nvs.image[off + i] &= data[i];
+    }
+    mirror(off, len);
+}
+
+static void erase_page(size_t page)
+{
+    (void)memset(&s_nvs.image[page * NVS_HOST_PAGE_SIZE], 0xFF, NVS_HOST_PAGE_SIZE);
+    mirror(page * NVS_HOST_PAGE_SIZE, NVS_HOST_PAGE_SIZE);
+    s_nvs.stats.page_erases++;
+}
+
+static uint32_t read_u32(size_t off)
+{
+    const uint8_t *p = &s_nvs.image[off];
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8U) | ((uint32_t)p[2] << 16U) | ((uint32_t)p[3] << 24U);
+}
+
+static void program_u32(size_t off, uint32_t value)
+{
+    const uint8_t b[4] = {(uint8_t)value, (uint8_t)(value >> 8U), (uint8_t)(value >> 16U), (uint8_t)(value >> 24U)};
+    program(off, b, sizeof(b));
+}
+
+static uint32_t page_state(size_t page)
+{
+    return read_u32(page * NVS_HOST_PAGE_SIZE);
+}
+
+static void activate_page(size_t page)
+{
+    program_u32(page * NVS_HOST_PAGE_SIZE, PAGE_ACTIVE);
+    program_u32((page * NVS_HOST_PAGE_SIZE) + PAGE_SEQ_OFFSET, s_nvs.next_seq);
+    s_nvs.next_seq++;
+    s_nvs.active = page;
+    s_nvs.next_entry = 0U;
+}
+
+static uint8_t entry_state(size_t page, size_t entry)
+{
+    const uint8_t bits = s_nvs.image[(page * NVS_HOST_PAGE_SIZE) + PAGE_BITMAP_OFFSET + (entry / 4U)];
+    return (uint8_t)((bits >> ((entry % 4U) * 2U)) & 3U);
+}
+
+static void set_entry_states(size_t page, size_t first, size_t count, uint8_t state)
+{
+    for (size_t e = first; e < (first + count); e++)
+    {
+        const uint8_t clear = (uint8_t)(((uint8_t)~state & 3U) << ((e % 4U) * 2U));
+        const uint8_t bits = (uint8_t)~clear;
+        program((page * NVS_HOST_PAGE_SIZE) + PAGE_BITMAP_OFFSET + (e / 4U), &bits, 1U);
+    }
+}
+
+/* entries covered by the item at (page, entry); damaged spans count as one */
+static size_t item_span(size_t page, size_t entry)
+{
+    const size_t span = entry_at(page, entry)[ENTRY_SPAN];
+    return ((span == 0U) || ((entry + span) > NVS_HOST_ENTRIES_PER_PAGE)) ? 1U : span;
+}
+
+/* from one item (or free / erased entry) to the next */
+static size_t item_step(size_t page, size_t entry)
+{
+    return (entry_state(page, entry) == ENTRY_WRITTEN) ? item_span(page, entry) : 1U;
+}
+
+static bool is_live(size_t page, size_t entry, uint8_t ns)
+{
+    return (entry_state(page, entry) == ENTRY_WRITTEN) && (entry_at(page, entry)[ENTRY_NS] == ns);
+}
+
+/*
+    items
+*/
+
+static bool is_var_type(uint8_t type)
+{
+    return (type == (uint8_t)NVS_TYPE_STR) || (type == (uint8_t)NVS_TYPE_BLOB);
+}
+
+static size_t var_len(const uint8_t *entry)
+{
+    return (size_t)entry[ENTRY_DATA] | ((size_t)entry[ENTRY_DATA + 1U] << 8U);
+}
+
+static bool key_matches(const uint8_t *entry, const char *key)
+{
+    return strncmp((const char *)&entry[ENTRY_KEY], key, NVS_KEY_NAME_MAX_SIZE) == 0;
+}
+
+/*
+ * Exact (ns, key, type) match, skipping *skip if given; type NVS_TYPE_ANY
+ * takes the first key match. ESP_ERR_NVS_TYPE_MISMATCH if the key only
+ * exists with another type.
+ */
+static esp_err_t find_item(uint8_t ns, const char *key, uint8_t type, const item_pos_t *skip, item_pos_t *out)
+{
+    esp_err_t err = ESP_ERR_NVS_NOT_FOUND;
+    bool found = false;
+
+    for (size_t p = 0U; (found == false) && (p < s_nvs.pages); p++)
+    {
+        size_t e = 0U;
+
+        while ((found == false) && (page_state(p) != PAGE_UNINIT) && (e < NVS_HOST_ENTRIES_PER_PAGE))
+        {
+            const uint8_t state = entry_state(p, e);
+            const uint8_t *entry = entry_at(p, e);
+            const bool skipped = (skip != NULL) && (skip->page == p) && (skip->entry == e);
+
+            if ((state == ENTRY_WRITTEN) && (skipped == false) && (entry[ENTRY_NS] == ns) &&
+                (key_matches(entry, key) == true))
+            {
+                if ((type == (uint8_t)NVS_TYPE_ANY) || (entry[ENTRY_TYPE] == type))
+                {
+                    out->page = p;
+                    out->entry = e;
+                    err = ESP_OK;
+                    found = true;
+                }
+                else
+                {
+                    err = ESP_ERR_NVS_TYPE_MISMATCH;
+                }
+            }
+            e += item_step(p, e);
+        }
+    }
+
+    return err;
+}
+
+static void erase_item(const item_pos_t *pos)
+{
+    const size_t span = item_span(pos->page, pos->entry);
+
+    set_entry_states(pos->page, pos->entry, span, ENTRY_ERASED);
+    s_nvs.stats.entries_erased += (uint32_t)span;
+}
+
+static size_t count_entries(size_t page, uint8_t state)
+{
+    size_t n = 0U;
+
+    for (size_t e = 0U; e < NVS_HOST_ENTRIES_PER_PAGE; e++)
+    {
+        n += (entry_state(page, e) == state) ? 1U : 0U;
+    }
+
+    return n;
+}
+
+/* an erased page other than the one kept for garbage collection, or s_nvs.pages */
+static size_t spare_page(void)
+{
+    size_t first = s_nvs.pages;
+    size_t free_pages = 0U;
+
+    for (size_t p = 0U; p < s_nvs.pages; p++)
+    {
+        if (page_state(p) == PAGE_UNINIT)
+        {
+            first = (free_pages == 0U) ? p : first;
+            free_pages++;
+        }
+    }
+
+    return (free_pages >= 2U) ? first : s_nvs.pages;
+}
+
+/* copies the live items of the page with the most erased entries to the free page, then erases it */
+static esp_err_t collect_garbage(void)
+{
+    size_t victim = s_nvs.pages;
+    size_t best = 0U;
+    size_t reserve = s_nvs.pages;
+    esp_err_t err = ESP_OK;
+
+    for (size_t p = 0U; p < s_nvs.pages; p++)
+    {
+        const uint32_t state = page_state(p);
+
+        if (state == PAGE_UNINIT)
+        {
+            reserve = p;
+        }
+        else if ((state == PAGE_FULL) || (p == s_nvs.active))
+        {
+            const size_t erased = count_entries(p, ENTRY_ERASED);
+            if (erased > best)
+            {
+                best = erased;
+                victim = p;
+            }
+        }
+        else
+        {
+            /* not in use */
+        }
+    }
+
+    if ((victim == s_nvs.pages) || (reserve == s_nvs.pages))
+    {
+        err = ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+    }
+    else
+    {
+        if (victim != s_nvs.active)
+        {
+            program_u32(s_nvs.active * NVS_HOST_PAGE_SIZE, PAGE_FULL);
+        }
+        activate_page(reserve);
+
+        size_t e = 0U;
+        while (e < NVS_HOST_ENTRIES_PER_PAGE)
+        {
+            const size_t span = item_step(victim, e);
+
+            if (entry_state(victim, e) == ENTRY_WRITTEN)
+            {
+                program(entry_offset(reserve, s_nvs.next_entry), entry_at(victim, e), span * NVS_HOST_ENTRY_SIZE);
+                set_entry_states(reserve, s_nvs.next_entry, span, ENTRY_WRITTEN);
+                s_nvs.next_entry += span;
+                s_nvs.stats.entries_written += (uint32_t)span;
+                s_nvs.stats.entries_moved += (uint32_t)span;
+            }
+            e += span;
+        }
+
+        erase_page(victim);
+    }
+
+    return err;
+}
+
+static esp_err_t alloc_entries(size_t span, item_pos_t *out)
+{
+    esp_err_t err = ESP_OK;
+    bool done = false;
+
+    while ((done == false) && (err == ESP_OK))
+    {
+        if ((s_nvs.next_entry + span) <= NVS_HOST_ENTRIES_PER_PAGE)
+        {
+            out->page = s_nvs.active;
+            out->entry = s_nvs.next_entry;
+            done = true;
+        }
+        else
+        {
+            const size_t spare = spare_page();
+
+            if (spare < s_nvs.pages)
+            {
+                program_u32(s_nvs.active * NVS_HOST_PAGE_SIZE, PAGE_FULL);
+                activate_page(spare);
+            }
+            else
+            {
+                /* each run reclaims at least one erased entry, so this ends */
+                err = collect_garbage();
+            }
+        }
+    }
+
+    return err;
+}
+
+/* writes the new item first, then erases the one it replaces (wherever garbage collection moved it) */
+static esp_err_t write_item(uint8_t ns, uint8_t type, const char *key, const uint8_t data[ENTRY_DATA_LEN],
+                            const void *value, size_t len)
+{
+    const size_t span = 1U + ((len + NVS_HOST_ENTRY_SIZE - 1U) / NVS_HOST_ENTRY_SIZE);
+    item_pos_t old;
+    item_pos_t pos;
+    esp_err_t err = ESP_OK;
+    bool unchanged = false;
+
+    if (find_item(ns, key, type, NULL, &old) == ESP_OK)
+    {
+        const uint8_t *entry = entry_at(old.page, old.entry);
+        unchanged = (memcmp(&entry[ENTRY_DATA], data, is_var_type(type) ? 2U : ENTRY_DATA_LEN) == 0) &&
+                    ((len == 0U) || (memcmp(&entry[NVS_HOST_ENTRY_SIZE], value, len) == 0));
+    }
+
+    if (unchanged == true)
+    {
+        s_nvs.stats.writes_skipped++;
+    }
+    else
+    {
+        err = alloc_entries(span, &pos);
+    }
+
+    if ((unchanged == false) && (err == ESP_OK))
+    {
+        uint8_t header[NVS_HOST_ENTRY_SIZE];
+
+        (void)memset(header, 0xFF, sizeof(header));
+        header[ENTRY_NS] = ns;
+        header[ENTRY_TYPE] = type;
+        header[ENTRY_SPAN] = (uint8_t)span;
+        (void)memset(&header[ENTRY_KEY], 0, NVS_KEY_NAME_MAX_SIZE);
+        (void)memcpy(&header[ENTRY_KEY], key, strlen(key));
+        (void)memcpy(&header[ENTRY_DATA], data, ENTRY_DATA_LEN);
+
+        program(entry_offset(pos.page, pos.entry), header, sizeof(header));
+        if (len > 0U)
+        {
+            program(entry_offset(pos.page, pos.entry + 1U), (const uint8_t *)value, len);
+        }
+        set_entry_states(pos.page, pos.entry, span, ENTRY_WRITTEN);
+        s_nvs.next_entry += span;
+        s_nvs.stats.entries_written += (uint32_t)span;
+
+        if (find_item(ns, key, type, &pos, &old) == ESP_OK)
+        {
+            erase_item(&old);
+        }
+    }
+
+    return err;
+}
+
+/*
+    namespaces and handles
+*/
+
+static bool valid_key(const char *key)
+{
+    return (key != NULL) && (key[0] != '\0') && (memchr(key, '\0', NVS_KEY_NAME_MAX_SIZE) != NULL);
+}
+
+static esp_err_t namespace_index(const char *name, bool create, uint8_t *out)
+{
+    item_pos_t pos;
+    esp_err_t err = find_item(NS_NAMES, name, (uint8_t)NVS_TYPE_U8, NULL, &pos);
+
+    if (err == ESP_OK)
+    {
+        *out = entry_at(pos.page, pos.entry)[ENTRY_DATA];
+    }
+    else if ((err == ESP_ERR_NVS_NOT_FOUND) && (create == true))
+    {
+        uint8_t next = 1U;
+
+        for (size_t p = 0U; p < s_nvs.pages; p++)
+        {
+            for (size_t e = 0U; e < NVS_HOST_ENTRIES_PER_PAGE; e += item_step(p, e))
+            {
+                const uint8_t *entry = entry_at(p, e);
+                if ((is_live(p, e, NS_NAMES) == true) && (entry[ENTRY_DATA] >= next))
+                {
+                    next = (uint8_t)(entry[ENTRY_DATA] + 1U);
+                }
+            }
+        }
+
+        if (next > NS_MAX)
+        {
+            err = ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+        }
+        else
+        {
+            uint8_t data[ENTRY_DATA_LEN];
+            (void)memset(data, 0xFF, sizeof(data));
+            data[0] = next;
+
+            err = write_item(NS_NAMES, (uint8_t)NVS_TYPE_U8, name, data, NULL, 0U);
+            *out = next;
+        }
+    }
+    else
+    {
+        /* not found, read only */
+    }
+
+    return err;
+}
+
+static esp_err_t use_handle(nvs_handle_t handle, bool write, uint8_t *out_ns)
+{
+    esp_err_t err = ESP_OK;
+
+    if (s_nvs.mounted == false)
+    {
+        err = ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+    else if ((handle == 0U) || (handle > MAX_HANDLES) || (s_nvs.handles[handle - 1U].used == false))
+    {
+        err = ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    else if ((write == true) && (s_nvs.handles[handle - 1U].read_only == true))
+    {
+        err = ESP_ERR_NVS_READ_ONLY;
+    }
+    else
+    {
+        *out_ns = s_nvs.handles[handle - 1U].ns;
+    }
+
+    return err;
+}
+
+static esp_err_t check_key(const char *key)
+{
+    esp_err_t err = ESP_OK;
+
+    if ((key == NULL) || (key[0] == '\0'))
+    {
+        err = ESP_ERR_NVS_INVALID_NAME;
+    }
+    else if (valid_key(key) == false)
+    {
+        err = ESP_ERR_NVS_KEY_TOO_LONG;
+    }
+    else
+    {
+        /* ok */
+    }
+
+    return err;
+}
+
+/*
+    typed access
+*/
+
+static esp_err_t set_prim(nvs_handle_t handle, const char *key, nvs_type_t type, uint64_t bits)
+{
+    uint8_t ns = 0U;
+    esp_err_t err = use_handle(handle, true, &ns);
+
+    if (err == ESP_OK)
+    {
+        err = check_key(key);
+    }
+    if (err == ESP_OK)
+    {
+        const size_t size = (size_t)type & 0x0FU;
+        uint8_t data[ENTRY_DATA_LEN];
+
+        (void)memset(data, 0xFF, sizeof(data));
+        for (size_t i = 0U; i < size; i++)
+        {
+            data[i] = (uint8_t)(bits >> (8U * i));
+        }
+        err = write_item(ns, (uint8_t)type, key, data, NULL, 0U);
+    }
+
+    return err;
+}
+
+static esp_err_t get_prim(nvs_handle_t handle, const char *key, nvs_type_t type, uint64_t *out)
+{
+    uint8_t ns = 0U;
+    item_pos_t pos;
+    esp_err_t err = use_handle(handle, false, &ns);
+
+    if (err == ESP_OK)
+    {
+        err = (out == NULL) ? ESP_ERR_INVALID_ARG : check_key(key);
+    }
+    if (err == ESP_OK)
+    {
+        err = find_item(ns, key, (uint8_t)type, NULL, &pos);
+    }
+    if (err == ESP_OK)
+    {
+        const uint8_t *data = &entry_at(pos.page, pos.entry)[ENTRY_DATA];
+        uint64_t bits = 0U;
+
+        for (size_t i = ((size_t)type & 0x0FU); i > 0U; i--)
+        {
+            bits = (bits << 8U) | data[i - 1U];
+        }
+        *out = bits;
+    }
+
+    return err;
+}
+
+static esp_err_t set_var(nvs_handle_t handle, const char *key, nvs_type_t type, const void *value, size_t len)
+{
+    uint8_t ns = 0U;
+    esp_err_t err = use_handle(handle, true, &ns);
+
+    if (err == ESP_OK)
+    {
+        err = (value == NULL) ? ESP_ERR_INVALID_ARG : check_key(key);
+    }
+    if ((err == ESP_OK) && (len > MAX_VALUE_LEN))
+    {
+        err = ESP_ERR_NVS_VALUE_TOO_LONG;
+    }
+    if (err == ESP_OK)
+    {
+        uint8_t data[ENTRY_DATA_LEN];
+
+        (void)memset(data, 0xFF, sizeof(data));
+        data[0] = (uint8_t)len;
+        data[1] = (uint8_t)(len >> 8U);
+        err = write_item(ns, (uint8_t)type, key, data, value, len);
+    }
+
+    return err;
+}
+
+static esp_err_t get_var(nvs_handle_t handle, const char *key, nvs_type_t type, void *out, size_t *len)
+{
+    uint8_t ns = 0U;
+    item_pos_t pos;
+    esp_err_t err = use_handle(handle, false, &ns);
+
+    if (err == ESP_OK)
+    {
+        err = (len == NULL) ? ESP_ERR_INVALID_ARG : check_key(key);
+    }
+    if (err == ESP_OK)
+    {
+        err = find_item(ns, key, (uint8_t)type, NULL, &pos);
+    }
+    if (err == ESP_OK)
+    {
+        const size_t size = var_len(entry_at(pos.page, pos.entry));
+
+        if (out == NULL)
+        {
+            *len = size;
+        }
+        else if (*len < size)
+        {
+            err = ESP_ERR_NVS_INVALID_LENGTH;
+        }
+        else
+        {
+            (void)memcpy(out, entry_at(pos.page, pos.entry + 1U), size);
+            *len = size;
+        }
+    }
+
+    return err;
+}
+
+/*
+    mount
+*/
+
+static void attach_active_page(void)
+{
+    size_t active = s_nvs.pages;
+    uint32_t seq = 0U;
+
+    s_nvs.next_seq = 0U;
+    for (size_t p = 0U; p < s_nvs.pages; p++)
+    {
+        const uint32_t state = page_state(p);
+        const uint32_t page_seq = read_u32((p * NVS_HOST_PAGE_SIZE) + PAGE_SEQ_OFFSET);
+
+        if (state != PAGE_UNINIT)
+        {
+            s_nvs.next_seq = (page_seq >= s_nvs.next_seq) ? (page_seq + 1U) : s_nvs.next_seq;
+        }
+        if ((state == PAGE_ACTIVE) && ((active == s_nvs.pages) || (page_seq > seq)))
+        {
+            active = p;
+            seq = page_seq;
+        }
+    }
+
+    if (active == s_nvs.pages)
+    {
+        /* fresh or all pages full: garbage collection takes over on the first write */
+        for (size_t p = 0U; (active == s_nvs.pages) && (p < s_nvs.pages); p++)
+        {
+            active = (page_state(p) == PAGE_UNINIT) ? p : active;
+        }
+        if (active < s_nvs.pages)
+        {
+            activate_page(active);
+        }
+        else
+        {
+            s_nvs.active = 0U;
+            s_nvs.next_entry = NVS_HOST_ENTRIES_PER_PAGE;
+        }
+    }
+    else
+    {
+        s_nvs.active = active;
+        s_nvs.next_entry = 0U;
+        for (size_t e = 0U; e < NVS_HOST_ENTRIES_PER_PAGE; e++)
+        {
+            s_nvs.next_entry = (entry_state(active, e) != ENTRY_EMPTY) ? (e + 1U) : s_nvs.next_entry;
+        }
+    }
+}
+
+esp_err_t nvs_host_mount(const char *path, size_t pages)
+{
+    const size_t size = pages * NVS_HOST_PAGE_SIZE;
+    bool claimed = false;
+    esp_err_t err = ESP_OK;
+
+    if (s_nvs.mounted == true)
+    {
+        err = ESP_ERR_INVALID_STATE;
+    }
+    else if (pages < 2U)
+    {
+        err = ESP_ERR_INVALID_SIZE;
+    }
+    else
+    {
+        (void)memset(&s_nvs, 0, sizeof(s_nvs));
+        claimed = true;
+        s_nvs.image = (uint8_t *)malloc(size);
+        s_nvs.pages = pages;
+        err = (s_nvs.image == NULL) ? ESP_ERR_NO_MEM : ESP_OK;
+    }
+
+    if ((err == ESP_OK) && (path != NULL))
+    {
+        s_nvs.file = fopen(path, "r+b");
+        if (s_nvs.file != NULL)
+        {
+            const size_t got = fread(s_nvs.image, 1U, size, s_nvs.file);
+            const int more = fgetc(s_nvs.file);
+            err = ((got == size) && (more == EOF)) ? ESP_OK : ESP_ERR_INVALID_SIZE;
+        }
+        else
+        {
+            s_nvs.file = fopen(path, "w+b");
+            err = (s_nvs.file != NULL) ? ESP_OK : ESP_FAIL;
+            if (err == ESP_OK)
+            {
+                (void)memset(s_nvs.image, 0xFF, size);
+                mirror(0U, size);
+            }
+        }
+    }
+    else if (err == ESP_OK)
+    {
+        (void)memset(s_nvs.image, 0xFF, size);
+    }
+    else
+    {
+        /* nothing allocated */
+    }
+
+    if (err == ESP_OK)
+    {
+        s_nvs.mounted = true;
+        attach_active_page();
+        s_nvs.stats = (nvs_host_stats_t){0};
+    }
+    else if (claimed == true)
+    {
+        if (s_nvs.file != NULL)
+        {
+            (void)fclose(s_nvs.file);
+        }
+        free(s_nvs.image);
+        (void)memset(&s_nvs, 0, sizeof(s_nvs));
+    }
+    else
+    {
+        /* s_nvs untouched */
+    }
+
+    return err;
+}
+
+void nvs_host_unmount(void)
+{
+    if (s_nvs.mounted == true)
+    {
+        if (s_nvs.file != NULL)
+        {
+            (void)fclose(s_nvs.file);
+        }
+        free(s_nvs.image);
+        (void)memset(&s_nvs, 0, sizeof(s_nvs));
+    }
+}
+
+void nvs_host_stats(nvs_host_stats_t *out)
+{
+    if (out != NULL)
+    {
+        *out = s_nvs.stats;
+    }
+}
+
+void nvs_host_reset_stats(void)
+{
+    s_nvs.stats = (nvs_host_stats_t){0};
+}
+
+/*
+    nvs_flash.h
+*/
+
+esp_err_t nvs_flash_init(void)
+{
+    return (s_nvs.mounted == true) ? ESP_OK : nvs_host_mount(NULL, NVS_HOST_DEFAULT_PAGES);
+}
+
+esp_err_t nvs_flash_deinit(void)
+{
+    const esp_err_t err = (s_nvs.mounted == true) ? ESP_OK : ESP_ERR_NVS_NOT_INITIALIZED;
+
+    nvs_host_unmount();
+    return err;
+}
+
+esp_err_t nvs_flash_erase(void)
+{
+    if (s_nvs.mounted == true)
+    {
+        for (size_t p = 0U; p < s_nvs.pages; p++)
+        {
+            erase_page(p);
+        }
+        (void)memset(s_nvs.handles, 0, sizeof(s_nvs.handles));
+        attach_active_page();
+    }
+
+    return ESP_OK;
+}
+
+/*
+    nvs.h
+*/
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle)
+{
+    uint8_t ns = 0U;
+    size_t slot = MAX_HANDLES;
+    esp_err_t err = ESP_OK;
+
+    if (s_nvs.mounted == false)
+    {
+        err = ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+    else if (out_handle == NULL)
+    {
+        err = ESP_ERR_INVALID_ARG;
+    }
+    else
+    {
+        err = check_key(name);
+    }
+
+    for (size_t i = 0U; (err == ESP_OK) && (slot == MAX_HANDLES) && (i < MAX_HANDLES); i++)
+    {
+        slot = (s_nvs.handles[i].used == false) ? i : slot;
+    }
+    if ((err == ESP_OK) && (slot == MAX_HANDLES))
+    {
+        err = ESP_ERR_NO_MEM;
+    }
+
+    if (err == ESP_OK)
+    {
+        err = namespace_index(name, open_mode == NVS_READWRITE, &ns);
+    }
+    if (err == ESP_OK)
+    {
+        s_nvs.handles[slot].used = true;
+        s_nvs.handles[slot].read_only = (open_mode == NVS_READONLY);
+        s_nvs.handles[slot].ns = ns;
+        *out_handle = (nvs_handle_t)(slot + 1U);
+    }
+
+    return err;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+    if ((handle > 0U) && (handle <= MAX_HANDLES))
+    {
+        s_nvs.handles[handle - 1U].used = false;
+    }
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    uint8_t ns = 0U;
+    const esp_err_t err = use_handle(handle, false, &ns);
+
+    if (err == ESP_OK)
+    {
+        s_nvs.stats.commits++;
+    }
+
+    return err;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key)
+{
+    uint8_t ns = 0U;
+    item_pos_t pos;
+    esp_err_t err = use_handle(handle, true, &ns);
+
+    if (err == ESP_OK)
+    {
+        err = check_key(key);
+    }
+    if (err == ESP_OK)
+    {
+        err = find_item(ns, key, (uint8_t)NVS_TYPE_ANY, NULL, &pos);
+    }
+    if (err == ESP_OK)
+    {
+        erase_item(&pos);
+    }
+
+    return err;
+}
+
+esp_err_t nvs_erase_all(nvs_handle_t handle)
+{
+    uint8_t ns = 0U;
+    const esp_err_t err = use_handle(handle, true, &ns);
+
+    for (size_t p = 0U; (err == ESP_OK) && (p < s_nvs.pages); p++)
+    {
+        size_t e = 0U;
+        while (e < NVS_HOST_ENTRIES_PER_PAGE)
+        {
+            const size_t span = item_step(p, e);
+
+            if (is_live(p, e, ns) == true)
+            {
+                const item_pos_t pos = {p, e};
+                erase_item(&pos);
+            }
+            e += span;
+        }
+    }
+
+    return err;
+}
+
+esp_err_t nvs_set_i8(nvs_handle_t handle, const char *key, int8_t value)
+{
+    return set_prim(handle, key, NVS_TYPE_I8, (uint64_t)(uint8_t)value);
+}
+
+esp_err_t nvs_set_u8(nvs_handle_t handle, const char *key, uint8_t value)
+{
+    return set_prim(handle, key, NVS_TYPE_U8, (uint64_t)value);
+}
+
+esp_err_t nvs_set_i16(nvs_handle_t handle, const char *key, int16_t value)
+{
+    return set_prim(handle, key, NVS_TYPE_I16, (uint64_t)(uint16_t)value);
+}
+
+esp_err_t nvs_set_u16(nvs_handle_t handle, const char *key, uint16_t value)
+{
+    return set_prim(handle, key, NVS_TYPE_U16, (uint64_t)value);
+}
+
+esp_err_t nvs_set_i32(nvs_handle_t handle, const char *key, int32_t value)
+{
+    return set_prim(handle, key, NVS_TYPE_I32, (uint64_t)(uint32_t)value);
+}
+
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char *key, uint32_t value)
+{
+    return set_prim(handle, key, NVS_TYPE_U32, (uint64_t)value);
+}
+
+esp_err_t nvs_set_i64(nvs_handle_t handle, const char *key, int64_t value)
+{
+    return set_prim(handle, key, NVS_TYPE_I64, (uint64_t)value);
+}
+
+esp_err_t nvs_set_u64(nvs_handle_t handle, const char *key, uint64_t value)
+{
+    return set_prim(handle, key, NVS_TYPE_U64, value);
+}
+
+esp_err_t nvs_set_str(nvs_handle_t handle, const char *key, const char *value)
+{
+    return set_var(handle, key, NVS_TYPE_STR, value, (value != NULL) ? (strlen(value) + 1U) : 0U);
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    return set_var(handle, key, NVS_TYPE_BLOB, value, length);
+}
+
+esp_err_t nvs_get_i8(nvs_handle_t handle, const char *key, int8_t *out_value)
+{
+    uint64_t bits = 0U;
+    const esp_err_t err = get_prim(handle, key, NVS_TYPE_I8, (out_value != NULL) ? &bits : NULL);
+
+    if (err == ESP_OK)
+    {
+        *out_value = (int8_t)(uint8_t)bits;
+    }
+    return err;
+}
+
+esp_err_t nvs_get_u8(nvs_handle_t handle, const char *key, uint8_t *out_value)
+{
+    uint64_t bits = 0U;
+    const esp_err_t err = get_prim(handle, key, NVS_TYPE_U8, (out_value != NULL) ? &bits : NULL);
+
+    if (err == ESP_OK)
+    {
+        *out_value = (uint8_t)bits;
+    }
+    return err;
+}
+
+esp_err_t nvs_get_i16(nvs_handle_t handle, const char *key, int16_t *out_value)
+{
+    uint64_t bits = 0U;
+    const esp_err_t err = get_prim(handle, key, NVS_TYPE_I16, (out_value != NULL) ? &bits : NULL);
+
+    if (err == ESP_OK)
+    {
+        *out_value = (int16_t)(uint16_t)bits;
+    }
+    return err;
+}
+
+esp_err_t nvs_get_u16(nvs_handle_t handle, const char *key, uint16_t *out_value)
+{
+    uint64_t bits = 0U;
+    const esp_err_t err = get_prim(handle, key, NVS_TYPE_U16, (out_value != NULL) ? &bits : NULL);
+
+    if (err == ESP_OK)
+    {
+        *out_value = (uint16_t)bits;
+    }
+    return err;
+}
+
+esp_err_t nvs_get_i32(nvs_handle_t handle, const char *key, int32_t *out_value)
+{
+    uint64_t bits = 0U;
+    const esp_err_t err = get_prim(handle, key, NVS_TYPE_I32, (out_value != NULL) ? &bits : NULL);
+
+    if (err == ESP_OK)
+    {
+        *out_value = (int32_t)(uint32_t)bits;
+    }
+    return err;
+}
+
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char *key, uint32_t *out_value)
+{
+    uint64_t bits = 0U;
+    const esp_err_t err = get_prim(handle, key, NVS_TYPE_U32, (out_value != NULL) ? &bits : NULL);
+
+    if (err == ESP_OK)
+    {
+        *out_value = (uint32_t)bits;
+    }
+    return err;
+}
+
+esp_err_t nvs_get_i64(nvs_handle_t handle, const char *key, int64_t *out_value)
+{
+    uint64_t bits = 0U;
+    const esp_err_t err = get_prim(handle, key, NVS_TYPE_I64, (out_value != NULL) ? &bits : NULL);
+
+    if (err == ESP_OK)
+    {
+        *out_value = (int64_t)bits;
+    }
+    return err;
+}
+
+esp_err_t nvs_get_u64(nvs_handle_t handle, const char *key, uint64_t *out_value)
+{
+    return get_prim(handle, key, NVS_TYPE_U64, out_value);
+}
+
+esp_err_t nvs_get_str(nvs_handle_t handle, const char *key, char *out_value, size_t *length)
+{
+    return get_var(handle, key, NVS_TYPE_STR, out_value, length);
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    return get_var(handle, key, NVS_TYPE_BLOB, out_value, length);
+}
+
+esp_err_t nvs_get_stats(const char *part_name, nvs_stats_t *nvs_stats)
+{
+    esp_err_t err = ESP_OK;
+
+    (void)part_name;
+    if (s_nvs.mounted == false)
+    {
+        err = ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+    else if (nvs_stats == NULL)
+    {
+        err = ESP_ERR_INVALID_ARG;
+    }
+    else
+    {
+        size_t used = 0U;
+        size_t names = 0U;
+
+        for (size_t p = 0U; p < s_nvs.pages; p++)
+        {
+            used += count_entries(p, ENTRY_WRITTEN);
+            for (size_t e = 0U; e < NVS_HOST_ENTRIES_PER_PAGE; e += item_step(p, e))
+            {
+                names += (is_live(p, e, NS_NAMES) == true) ? 1U : 0U;
+            }
+        }
+
+        nvs_stats->total_entries = s_nvs.pages * NVS_HOST_ENTRIES_PER_PAGE;
+        nvs_stats->used_entries = used;
+        nvs_stats->free_entries = nvs_stats->total_entries - used;
+        nvs_stats->available_entries = (nvs_stats->free_entries > NVS_HOST_ENTRIES_PER_PAGE)
+                                           ? (nvs_stats->free_entries - NVS_HOST_ENTRIES_PER_PAGE)
+                                           : 0U;
+        nvs_stats->namespace_count = names;
+    }
+
+    return err;
+}
+
+esp_err_t nvs_get_used_entry_count(nvs_handle_t handle, size_t *used_entries)
+{
+    uint8_t ns = 0U;
+    esp_err_t err = use_handle(handle, false, &ns);
+
+    if ((err == ESP_OK) && (used_entries == NULL))
+    {
+        err = ESP_ERR_INVALID_ARG;
+    }
+    if (err == ESP_OK)
+    {
+        *used_entries = 0U;
+        for (size_t p = 0U; p < s_nvs.pages; p++)
+        {
+            for (size_t e = 0U; e < NVS_HOST_ENTRIES_PER_PAGE; e += item_step(p, e))
+            {
+                *used_entries += (is_live(p, e, ns) == true) ? item_span(p, e) : 0U;
+            }
+        }
+    }
+
+    return err;
+}
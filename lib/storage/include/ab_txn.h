@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "write_journal.h"
+
+/*
+ * A/B transactions for a group of keys in a key/value store (NVS).
+ *
+ * Each key of the group is stored twice, as "a:<key>" and "b:<key>". A
+ * generation word under the group's own key selects the slot readers use:
+ * odd generations live in slot a, even ones in slot b, 0 means the group was
+ * never written and readers fall back to the plain keys (values stored before
+ * the group existed). A write takes the generation after the one readers see,
+ * puts every key into that generation's slot and puts the generation word
+ * last, so a store that keeps write order (write_journal.h, NVS itself) shows
+ * one whole generation after a power cut, never a mix. Boot needs no
+ * recovery: the generation word is the only state.
+ *
+ * Every write is a generation of its own, also one that lands before the
+ * previous one reached flash: its slot may be the one the flashed word points
+ * to, but the previous word is applied first, and a flush the store runs in
+ * the middle of the write (journal full) commits only complete generations.
+ */
+
+/* slot prefix "a:" leaves 13 characters of the 15 NVS allows */
+#define AB_TXN_KEY_MAX 14U
+#define AB_TXN_GEN_LEN 8U
+
+typedef struct
+{
+    /*
+     * nvs_get_str / nvs_get_blob contract by kind (out NULL: length only).
+     * committed true: ignore writes not yet on flash.
+     */
+    int (*get)(void *ctx, const char *key, write_journal_kind_t kind, bool committed, void *out, size_t *len);
+    /* ERASE of a missing key succeeds */
+    int (*put)(void *ctx, const char *key, write_journal_kind_t kind, const void *data, size_t len);
+    void *ctx;
+    int not_found; /* get result for a missing key */
+    int corrupt;   /* returned for an unreadable generation word */
+} ab_txn_store_t;
+
+/* kind ERASE: the key is absent in the new generation */
+typedef struct
+{
+    const char *key;
+    write_journal_kind_t kind;
+    const void *data;
+    size_t len;
+} ab_txn_item_t;
+
+/* generation readers see (committed false) or the one on flash; 0: never written */
+int ab_txn_generation(const ab_txn_store_t *s, const char *group, bool committed, uint32_t *out_gen);
+
+/*
+ * key as of generation gen (from ab_txn_generation, read under the same lock
+ * for a consistent set); same contract as the store's get
+ */
+int ab_txn_read(const ab_txn_store_t *s, uint32_t gen, const char *key, write_journal_kind_t kind, void *out,
+                size_t *len);
+
+/*
+ * items must cover the whole group: keys left out keep whatever the target
+ * slot held two generations ago. After the first write the plain keys are
+ * erased. Returns the first store error; the current generation stays
+ * readable whatever part of the write made it.
+ */
+int ab_txn_write(const ab_txn_store_t *s, const char *group, const ab_txn_item_t *items, size_t count);
+
+/* storage helpers, exposed for tests */
+bool ab_txn_slot_key(const char *key, uint32_t gen, char out[WRITE_JOURNAL_KEY_MAX]);
+void ab_txn_gen_encode(uint32_t gen, uint8_t out[AB_TXN_GEN_LEN]);
+bool ab_txn_gen_decode(const uint8_t *in, size_t len, uint32_t *out_gen);
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Slab pool of fixed-size scratch buffers: a few size classes, each a
+ * caller-provided array of equal blocks tracked by a bitmap. borrow() hands
+ * out the smallest free block that fits, return() gives it back. Every block
+ * remembers who borrowed it (owner + label) so outstanding blocks can be
+ * listed. No locking: callers serialize access.
+ */
+
+#define BUF_POOL_MAX_CLASSES 4U
+#define BUF_POOL_MAX_BLOCKS 16U
+
+typedef struct
+{
+    uint8_t *mem;
+    size_t block_size;
+    size_t count;
+    uint16_t used_mask;
+    uint16_t in_use;
+    uint16_t peak;
+    uint32_t borrows;
+    uint32_t misses; /* borrows that found no free block of this size (or larger) */
+    const void *owner[BUF_POOL_MAX_BLOCKS];
+    const char *label[BUF_POOL_MAX_BLOCKS];
+} buf_pool_class_t;
+
+typedef struct
+{
+    buf_pool_class_t cls[BUF_POOL_MAX_CLASSES];
+    size_t class_count;
+} buf_pool_t;
+
+typedef void (*buf_pool_visit_fn)(const char *label, size_t block_size, void *ctx);
+
+void buf_pool_init(buf_pool_t *pool);
+/* classes must be added in ascending block_size; mem holds block_size * count bytes */
+bool buf_pool_add_class(buf_pool_t *pool, void *mem, size_t block_size, size_t count);
+/* smallest free block >= size; NULL if none (counted as a miss of the best fitting class) */
+void *buf_pool_borrow(buf_pool_t *pool, size_t size, const void *owner, const char *label);
+/* false if buf is not a pool block or not borrowed (double return) */
+bool buf_pool_return(buf_pool_t *pool, void *buf);
+/* block size of a borrowed block, 0 otherwise */
+size_t buf_pool_block_size(const buf_pool_t *pool, const void *buf);
+/* borrowed blocks of owner (NULL: all); visit may be NULL; returns the count */
+size_t buf_pool_outstanding(const buf_pool_t *pool, const void *owner, buf_pool_visit_fn visit, void *ctx);
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Typed settings described by a compile-time table (config_def_t[]): each key
+ * has a public name, its NVS key, a type, bounds and a default. Values are
+ * stored as text (see config_registry_parse_text / format_text) and exchanged
+ * as one flat JSON object keyed by name.
+ *
+ * Bounds: min / max are the value range for U32 and the length range for STR
+ * (max <= CONFIG_VALUE_STR_MAX); BOOL ignores them.
+ */
+
+#define CONFIG_VALUE_STR_MAX 64U
+/* public names; longer names never match */
+#define CONFIG_NAME_MAX 24U
+
+/* never output; "<name>_len":<length> instead */
+#define CONFIG_FLAG_SECRET 1U
+
+typedef enum
+{
+    CONFIG_TYPE_STR = 0,
+    CONFIG_TYPE_U32,
+    CONFIG_TYPE_BOOL
+} config_type_t;
+
+typedef struct
+{
+    const char *name;
+    const char *nvs_key;
+    config_type_t type;
+    uint32_t min;
+    uint32_t max;
+    uint32_t def_num; /* U32 / BOOL default */
+    const char *def_str; /* STR default */
+    uint32_t flags;
+} config_def_t;
+
+typedef struct
+{
+    const config_def_t *defs;
+    size_t count;
+} config_registry_t;
+
+typedef struct
+{
+    uint32_t num; /* U32, BOOL (0 / 1) */
+    char str[CONFIG_VALUE_STR_MAX + 1U];
+} config_value_t;
+
+typedef struct
+{
+    size_t key; /* index into the table */
+    config_value_t value;
+} config_entry_t;
+
+typedef enum
+{
+    CONFIG_PARSE_OK = 0,
+    CONFIG_PARSE_SYNTAX,
+    CONFIG_PARSE_UNKNOWN_KEY,
+    CONFIG_PARSE_INVALID_VALUE,
+    CONFIG_PARSE_DUPLICATE,
+    CONFIG_PARSE_TOO_MANY
+} config_parse_result_t;
+
+/* index of name, reg->count if there is none */
+size_t config_registry_find(const config_registry_t *reg, const char *name);
+void config_registry_default(const config_registry_t *reg, size_t key, config_value_t *out);
+bool config_registry_validate(const config_registry_t *reg, size_t key, const config_value_t *value);
+
+/* stored text: STR as is, U32 in decimal, BOOL "0" / "1"; parse also validates */
+bool config_registry_parse_text(const config_registry_t *reg, size_t key, const char *text, config_value_t *out);
+/* text length without the NUL, 0 if out_len is too small */
+size_t config_registry_format_text(const config_registry_t *reg, size_t key, const config_value_t *value, char *out,
+                                   size_t out_len);
+
+/*
+ * One flat object {"<name>":<value>,...}; every value validated. On success
+ * out holds *out_count entries in document order. Otherwise *out_count is the
+ * index of the offending member (for UNKNOWN_KEY, INVALID_VALUE, DUPLICATE).
+ */
+config_parse_result_t config_registry_from_json(const config_registry_t *reg, const char *json, config_entry_t *out,
+                                                size_t max, size_t *out_count);
+/* entries in the given order; out == NULL measures. Length without the NUL, 0 if it does not fit */
+size_t config_registry_to_json(const config_registry_t *reg, const config_entry_t *entries, size_t count, char *out,
+                               size_t out_len);
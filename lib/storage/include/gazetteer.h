@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Read-only city gazetteer image (built by tools/gazetteer_build.py, all integers little endian):
+ *
+ * header:  "GZT1", u32 count, u32 entries offset, u32 names offset, u32 names length
+ * buckets: u32[257] at offset 20; bucket[b] = first entry whose key starts with a byte >= b,
+ *          bucket[256] = count
+ * entries: count x 16 bytes: i32 latitude_e6, i32 longitude_e6, u32 name offset, u8 name length, u8[3] 0
+ * names:   UTF-8, not NUL terminated, 1..31 bytes each
+ *
+ * Entries are sorted by key = name with ASCII letters lowered, so a prefix search is one
+ * bucket lookup plus a binary search inside the bucket. Lookups read the image in place
+ * (memory-mapped flash on the device) and never allocate.
+ */
+
+#define GAZETTEER_MAGIC "GZT1"
+#define GAZETTEER_HEADER_LEN 20U
+#define GAZETTEER_BUCKETS 257U
+#define GAZETTEER_ENTRY_LEN 16U
+#define GAZETTEER_NAME_MAX 31U
+
+typedef struct
+{
+    const uint8_t *base;
+    size_t len;
+    uint32_t count;
+    uint32_t entries_off;
+    uint32_t names_off;
+    uint32_t names_len;
+} gazetteer_t;
+
+/* name points into the image and is not NUL terminated */
+typedef struct
+{
+    const char *name;
+    size_t name_len;
+    int32_t latitude_e6;
+    int32_t longitude_e6;
+} gazetteer_entry_t;
+
+/* checks header, bucket table and section bounds; out is usable only on success */
+bool gazetteer_open(gazetteer_t *out, const void *image, size_t len);
+
+/* false if index is out of range or the entry is malformed */
+bool gazetteer_get(const gazetteer_t *gz, uint32_t index, gazetteer_entry_t *out);
+
+/*
+ * Entries whose name starts with prefix (ASCII case-insensitive), in key order.
+ * Returns the number written to out (<= max); an empty prefix matches nothing.
+ */
+size_t gazetteer_search(const gazetteer_t *gz, const char *prefix, gazetteer_entry_t *out, size_t max);
+
+/* first entry whose whole name equals name (ASCII case-insensitive) */
+bool gazetteer_find(const gazetteer_t *gz, const char *name, gazetteer_entry_t *out);
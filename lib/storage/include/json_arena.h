@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Bump-pointer arena for short-lived JSON trees (cJSON via cJSON_InitHooks).
+ * Allocation is an aligned pointer bump; free only rolls back the most recent
+ * allocation (cJSON's print buffers), everything else is dropped on reset.
+ * The caller owns the buffer; the arena never touches the heap.
+ */
+
+#define JSON_ARENA_ALIGN 8U
+
+typedef struct
+{
+    uint8_t *buf;
+    size_t size;
+    size_t used;
+    size_t last;       /* offset of the most recent allocation */
+    size_t high_water; /* largest `used` since init */
+    uint32_t overflows; /* allocations that did not fit (caller fell back) */
+} json_arena_t;
+
+void json_arena_init(json_arena_t *arena, void *buf, size_t size);
+/* JSON_ARENA_ALIGN aligned; NULL if it does not fit (counted in overflows) */
+void *json_arena_alloc(json_arena_t *arena, size_t size);
+/* true if ptr points into the arena buffer */
+bool json_arena_owns(const json_arena_t *arena, const void *ptr);
+/* rolls back ptr if it is the most recent allocation, otherwise a no-op */
+void json_arena_free(json_arena_t *arena, void *ptr);
+/* drops all allocations; statistics are kept */
+void json_arena_reset(json_arena_t *arena);
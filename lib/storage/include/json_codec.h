@@ -0,0 +1,177 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Allocation-free JSON building blocks for the fixed-schema codecs
+ * (locations_storage, settings_storage). Output matches cJSON_PrintUnformatted
+ * for the value kinds used here: same string escaping, no whitespace.
+ *
+ * Schemas are X-macro field lists (see storage_keys.h):
+ *     X(field, key, kind, flags)
+ * field is the struct member, key a string literal, kind selects the
+ * read_<kind>/write_<kind> pair of the codec, flags is a JSON_FIELD_* mask.
+ */
+
+#define JSON_FIELD_OPTIONAL 0U
+#define JSON_FIELD_REQUIRED 1U
+/* written as "<key>_len":<strlen> unless secrets are requested */
+#define JSON_FIELD_SECRET 2U
+
+/* nesting accepted inside skipped (unknown) members */
+#define JSON_CODEC_MAX_DEPTH 16U
+/* longer member names never match a schema key */
+#define JSON_CODEC_KEY_MAX 32U
+
+/*
+    writer
+*/
+
+/*
+ * out == NULL measures only: pos counts every byte and ok stays true.
+ * Otherwise out is kept NUL terminated and the first write that does not fit
+ * (with its NUL) clears ok; later writes are ignored.
+ */
+typedef struct
+{
+    char *out;
+    size_t out_len;
+    size_t pos;
+    bool ok;
+} json_writer_t;
+
+void json_writer_init(json_writer_t *w, char *out, size_t out_len);
+void json_write_raw(json_writer_t *w, const char *text, size_t len);
+void json_write_lit(json_writer_t *w, const char *text);
+/* quoted and escaped; stops at NUL or after max_len bytes */
+void json_write_str(json_writer_t *w, const char *text, size_t max_len);
+void json_write_bool(json_writer_t *w, bool value);
+void json_write_uint(json_writer_t *w, unsigned long value);
+/* "key": with a leading ',' unless *first; key is written as is (schema literals need no escaping) */
+void json_write_key(json_writer_t *w, bool *first, const char *key);
+/* string member of at most max_len bytes; hidden -> "<key>_len":<length> instead */
+void json_write_str_field(json_writer_t *w, bool *first, const char *key, const char *text, size_t max_len,
+                          bool hidden, const char *hidden_key);
+/* bytes written without the NUL, 0 if anything did not fit */
+size_t json_writer_len(const json_writer_t *w);
+
+/*
+    reader
+*/
+
+/* over a NUL terminated document; ok is cleared by the first syntax error
+   (or by a codec rejecting a value, which fails the whole document) */
+typedef struct
+{
+    const char *p;
+    bool ok;
+} json_reader_t;
+
+void json_reader_init(json_reader_t *r, const char *json);
+
+/* consumes '{' / '[' */
+bool json_read_object_begin(json_reader_t *r);
+bool json_read_array_begin(json_reader_t *r);
+
+/*
+ * Object members: first must start true. Returns true with the member name
+ * in key (":" consumed; "" if longer than key_len - 1), false at '}' or on error.
+ */
+bool json_read_member(json_reader_t *r, bool *first, char *key, size_t key_len);
+/* array elements, same contract: true if a value follows, false at ']' or on error */
+bool json_read_element(json_reader_t *r, bool *first);
+
+/* decodes escapes (\uXXXX as UTF-8); copies at most out_len - 1 bytes, the rest is dropped */
+bool json_read_str(json_reader_t *r, char *out, size_t out_len);
+bool json_read_bool(json_reader_t *r, bool *out);
+/* validates a JSON number and returns its text (not NUL terminated) */
+bool json_read_number(json_reader_t *r, const char **out_text, size_t *out_len);
+bool json_skip_value(json_reader_t *r);
+/* only whitespace may follow the document */
+bool json_read_end(json_reader_t *r);
+
+/*
+    schema codecs
+*/
+
+/* kind macros: JSON_READ_<kind>(reader, lvalue), JSON_WRITE_<kind>(writer, first, key, value, hidden) */
+#define JSON_READ_str(r, f) json_read_str((r), (f), sizeof(f))
+#define JSON_WRITE_str(w, first, k, v, hidden) \
+    json_write_str_field((w), (first), k, (v), sizeof(v), (hidden), k "_len")
+#define JSON_READ_bool(r, f) json_read_bool((r), &(f))
+#define JSON_WRITE_bool(w, first, k, v, hidden) \
+    do                                          \
+    {                                           \
+        json_write_key((w), (first), k);        \
+        json_write_bool((w), (v));              \
+    } while (0)
+
+/* expansion helpers for JSON_CODEC_DEFINE; they refer to its local names */
+#define JSON_CODEC_REQUIRE_(field, k, kind, flags)                       \
+    required |= (((flags) & JSON_FIELD_REQUIRED) != 0U) ? bit : 0U;     \
+    bit <<= 1U;
+#define JSON_CODEC_READ_(field, k, kind, flags)                          \
+    if ((matched == false) && (strcmp(key, k) == 0))                     \
+    {                                                                    \
+        matched = true;                                                  \
+        if ((seen & bit) == 0U)                                          \
+        {                                                                \
+            seen |= bit;                                                 \
+            (void)JSON_READ_##kind(r, out->field);                       \
+        }                                                                \
+        else                                                             \
+        {                                                                \
+            (void)json_skip_value(r); /* first occurrence wins, as cJSON */ \
+        }                                                                \
+    }                                                                    \
+    bit <<= 1U;
+#define JSON_CODEC_WRITE_(field, k, kind, flags) \
+    JSON_WRITE_##kind(w, &first, k, in->field, (((flags) & JSON_FIELD_SECRET) != 0U) && (secrets == false));
+
+/*
+ * Defines
+ *     static bool <name>_read(json_reader_t *r, type *out)
+ *         one object; unknown members skipped, all REQUIRED ones present;
+ *         out is zeroed first (absent optional fields stay 0 / false / "")
+ *     static void <name>_write(json_writer_t *w, const type *in, bool secrets)
+ *         one object, members in schema order
+ */
+#define JSON_CODEC_DEFINE(name, type, FIELDS)                                  \
+    static bool name##_read(json_reader_t *r, type *out)                      \
+    {                                                                          \
+        char key[JSON_CODEC_KEY_MAX];                                          \
+        bool first = true;                                                     \
+        uint32_t seen = 0U;                                                    \
+        uint32_t required = 0U;                                                \
+        uint32_t bit = 1U;                                                     \
+                                                                               \
+        (void)memset(out, 0, sizeof(*out));                                    \
+        FIELDS(JSON_CODEC_REQUIRE_)                                            \
+                                                                               \
+        (void)json_read_object_begin(r);                                       \
+        while (json_read_member(r, &first, key, sizeof(key)) == true)          \
+        {                                                                      \
+            bool matched = false;                                              \
+            bit = 1U;                                                          \
+            FIELDS(JSON_CODEC_READ_)                                           \
+            if (matched == false)                                              \
+            {                                                                  \
+                (void)json_skip_value(r);                                      \
+            }                                                                  \
+        }                                                                      \
+                                                                               \
+        return (r->ok == true) && ((seen & required) == required);             \
+    }                                                                          \
+                                                                               \
+    static void name##_write(json_writer_t *w, const type *in, bool secrets)   \
+    {                                                                          \
+        bool first = true;                                                     \
+                                                                               \
+        (void)secrets;                                                         \
+        json_write_raw(w, "{", 1U);                                            \
+        FIELDS(JSON_CODEC_WRITE_)                                              \
+        json_write_raw(w, "}", 1U);                                            \
+    }
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Latency histogram with fixed log buckets (x4 each, 8 us .. 32 ms, then
+ * everything slower), small enough to keep one per operation kind for the
+ * process lifetime. No locking: callers serialize access.
+ */
+
+#define LATENCY_HIST_BUCKETS 8U
+#define LATENCY_HIST_FIRST_BOUND_US 8U
+
+typedef struct
+{
+    uint32_t count[LATENCY_HIST_BUCKETS];
+    uint32_t samples;
+    uint32_t max_us;
+    uint64_t total_us;
+} latency_hist_t;
+
+void latency_hist_add(latency_hist_t *h, uint32_t us);
+/* exclusive upper bound of bucket in us; UINT32_MAX for the last one */
+uint32_t latency_hist_bound(size_t bucket);
+uint32_t latency_hist_mean(const latency_hist_t *h);
+/* upper bound of the bucket holding the pct-th percentile (capped at max_us); 0 without samples */
+uint32_t latency_hist_percentile(const latency_hist_t *h, uint32_t pct);
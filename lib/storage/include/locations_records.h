@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "locations_model.h"
+
+/*
+ * Binary per-record layout for the locations list (all integers little endian):
+ *
+ * record: i32 latitude_e6, i32 longitude_e6, name bytes (no NUL, 1..31)
+ * index:  u8 version, u8 reserved, u16 count, u16 active id, u16 ids[count]
+ *
+ * The index lists the record ids in list order; the active flag lives only in
+ * the index, so switching the active location rewrites nothing else.
+ */
+
+#define LOCATIONS_RECORD_HEADER_LEN 8U
+#define LOCATIONS_RECORD_MAX_LEN (LOCATIONS_RECORD_HEADER_LEN + 31U)
+
+#define LOCATIONS_INDEX_VERSION 1U
+#define LOCATIONS_INDEX_HEADER_LEN 6U
+#define LOCATIONS_INDEX_NO_ID 0xFFFFU
+
+/* returns the encoded length, 0 on error (empty name, buffer too small) */
+size_t locations_record_encode(const location_t *loc, uint8_t *out, size_t out_len);
+/* is_active is left false */
+bool locations_record_decode(const uint8_t *buf, size_t len, location_t *out_loc);
+
+size_t locations_index_measure(size_t count);
+/* returns the encoded length, 0 on error */
+size_t locations_index_encode(const uint16_t *ids, size_t count, uint16_t active_id, uint8_t *out, size_t out_len);
+/* fails on unknown version, length mismatch, more than max_ids ids or an active id not in the list */
+bool locations_index_decode(const uint8_t *buf, size_t len,
+                            uint16_t *out_ids, size_t max_ids, size_t *out_count,
+                            uint16_t *out_active_id);
@@ -3,8 +3,23 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+#include "locations_coord.h"
 #include "locations_model.h"
 
+/* out_model must be initialized (locations_model_init); it is left empty on failure */
 bool locations_storage_from_json(const char *json, locations_model_t *out_model);
 bool locations_storage_to_json(const locations_model_t *model, char *out_json, size_t out_len);
-size_t locations_storage_measure_json(const locations_model_t *model);
\ No newline at end of file
+size_t locations_storage_measure_json(const locations_model_t *model);
+/*
+ * Single location as one JSON object, written without cJSON or heap use
+ * (same keys, escaping and number format as locations_storage_to_json).
+ * Returns the length without the terminating NUL, 0 if out_len is too small.
+ */
+size_t locations_storage_item_to_json(const location_t *loc, char *out, size_t out_len);
+/* name as a quoted JSON string, same contract as above */
+size_t locations_storage_name_to_json(const char *name, char *out, size_t out_len);
+
+/* worst case: every name byte escaped as \u00XX */
+#define LOCATIONS_STORAGE_NAME_JSON_MAX ((31U * 6U) + 2U + 1U)
+/* {"name":<name>,"latitude":<coord>,"longitude":<coord>,"is_active":false}, 52 bytes of fixed text */
+#define LOCATIONS_STORAGE_ITEM_JSON_MAX (LOCATIONS_STORAGE_NAME_JSON_MAX + (2U * LOCATIONS_COORD_STR_MAX) + 52U)
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Small LZSS codec (heatshrink-style bitstream) for NVS values.
+ *
+ * Stream, MSB first: '1' + 8-bit literal, or '0' + 8-bit distance - 1 +
+ * 4-bit length - 2, i.e. back references reach 256 bytes and copy 2..17.
+ * The compressor searches the input itself (no window buffer, no tables);
+ * the decompressor copies from what it already wrote to out. Neither
+ * allocates. Worst case growth is 1 bit per byte.
+ *
+ * Container for storage: "LZ", version, flags, original length (u16 LE),
+ * stream. Values without the header are stored uncompressed; a container
+ * with LZSS_FLAG_STORED carries its value as is, for keys that keep the
+ * container after a write that did not compress.
+ */
+
+#define LZSS_WINDOW_BITS 8U
+#define LZSS_LENGTH_BITS 4U
+#define LZSS_MIN_MATCH 2U
+
+#define LZSS_HEADER_LEN 6U
+#define LZSS_VERSION 1U
+/* original value was a NUL terminated string (the NUL is included in the length) */
+#define LZSS_FLAG_STR 1U
+/* the stream is the value itself (lzss_store) */
+#define LZSS_FLAG_STORED 2U
+#define LZSS_MAX_INPUT 0xFFFFU
+
+/* stream bytes for len input bytes in the worst case */
+size_t lzss_bound(size_t len);
+/* stream length, 0 if it does not fit into cap */
+size_t lzss_compress(const void *in, size_t len, uint8_t *out, size_t cap);
+/* false unless the stream decodes to exactly out_len bytes */
+bool lzss_decompress(const uint8_t *in, size_t in_len, void *out, size_t out_len);
+
+/* header + stream; 0 if that is not smaller than len (store the value as is) or does not fit */
+size_t lzss_pack(const void *in, size_t len, uint8_t flags, uint8_t *out, size_t cap);
+/* header (flags | LZSS_FLAG_STORED) + the value as is; 0 if that does not fit */
+size_t lzss_store(const void *in, size_t len, uint8_t flags, uint8_t *out, size_t cap);
+/* false if in does not start with a valid header */
+bool lzss_unpack_info(const uint8_t *in, size_t in_len, size_t *out_len, uint8_t *out_flags);
+/* out_len must be the length from lzss_unpack_info */
+bool lzss_unpack(const uint8_t *in, size_t in_len, void *out, size_t out_len);
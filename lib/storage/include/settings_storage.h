@@ -2,14 +2,18 @@
 
 #include "stdbool.h"
 #include "stddef.h"
+#include "stdint.h"
 
 #define SETTINGS_WIFI_SSID_MAX_LEN (32)
 #define SETTINGS_WIFI_PASS_MAX_LEN (64)
+/* priority: a plain integer 0..this; anything else fails the whole document */
+#define SETTINGS_WIFI_PRIORITY_MAX (255U)
 
 typedef struct
 {
     char ssid[SETTINGS_WIFI_SSID_MAX_LEN + 1];
     char pass[SETTINGS_WIFI_PASS_MAX_LEN + 1];
+    uint8_t priority; /* position in the profile list, 0 first (also when absent) */
 } settings_wifi_t;
 
 bool settings_storage_wifi_from_json(const char *json, settings_wifi_t *out);
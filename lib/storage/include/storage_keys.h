@@ -7,4 +7,24 @@
 #define STORAGE_KEY_NAME "name"
 #define STORAGE_KEY_LATITUDE "latitude"
 #define STORAGE_KEY_LONGITUDE "longitude"
-#define STORAGE_KEY_IS_ACTIVE "is_active"
\ No newline at end of file
+#define STORAGE_KEY_IS_ACTIVE "is_active"
+
+/* wifi settings object keys */
+#define STORAGE_KEY_WIFI_SSID "ssid"
+#define STORAGE_KEY_WIFI_PASS "pass"
+#define STORAGE_KEY_WIFI_PRIORITY "priority"
+
+/*
+ * Object schemas, one line per member: X(field, key, kind, flags).
+ * Member order is the output order; see json_codec.h for kinds and flags.
+ */
+#define STORAGE_LOCATION_FIELDS(X)                                  \
+    X(name, STORAGE_KEY_NAME, str, JSON_FIELD_REQUIRED)             \
+    X(latitude_e6, STORAGE_KEY_LATITUDE, coord, JSON_FIELD_REQUIRED) \
+    X(longitude_e6, STORAGE_KEY_LONGITUDE, coord, JSON_FIELD_REQUIRED) \
+    X(is_active, STORAGE_KEY_IS_ACTIVE, bool, JSON_FIELD_OPTIONAL)
+
+#define STORAGE_WIFI_FIELDS(X)                                      \
+    X(ssid, STORAGE_KEY_WIFI_SSID, str, JSON_FIELD_REQUIRED)        \
+    X(pass, STORAGE_KEY_WIFI_PASS, str, JSON_FIELD_SECRET)          \
+    X(priority, STORAGE_KEY_WIFI_PRIORITY, priority, JSON_FIELD_OPTIONAL)
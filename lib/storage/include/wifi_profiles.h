@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "settings_storage.h"
+
+/*
+ * Saved WiFi networks in priority order (index 0 is tried first). A profile
+ * may carry a hint from its last successful connect: BSSID, channel and auth
+ * mode. An attempt with the hint joins that access point on that channel
+ * without scanning the others first.
+ *
+ * Binary layout (one NVS blob):
+ *
+ * header:  u8 version, u8 count
+ * profile: u8 ssid_len (1..32), u8 pass_len (0..64), u8 flags, u8 channel,
+ *          u8 authmode, u8 bssid[6], ssid bytes, pass bytes (no NULs)
+ */
+
+#define WIFI_PROFILES_MAX 4U
+#define WIFI_PROFILES_VERSION 1U
+#define WIFI_PROFILES_HEADER_LEN 2U
+#define WIFI_PROFILE_HEADER_LEN 11U
+#define WIFI_PROFILES_MAX_LEN                                                                                \
+    (WIFI_PROFILES_HEADER_LEN +                                                                              \
+     (WIFI_PROFILES_MAX * (WIFI_PROFILE_HEADER_LEN + SETTINGS_WIFI_SSID_MAX_LEN + SETTINGS_WIFI_PASS_MAX_LEN)))
+
+#define WIFI_PROFILE_BSSID_LEN 6U
+/* profile flags */
+#define WIFI_PROFILE_FLAG_HINT 1U
+
+typedef struct
+{
+    bool valid;
+    uint8_t bssid[WIFI_PROFILE_BSSID_LEN];
+    uint8_t channel;
+    uint8_t authmode; /* wifi_auth_mode_t of the access point */
+} wifi_profile_hint_t;
+
+typedef struct
+{
+    char ssid[SETTINGS_WIFI_SSID_MAX_LEN + 1U];
+    char pass[SETTINGS_WIFI_PASS_MAX_LEN + 1U];
+    wifi_profile_hint_t hint;
+} wifi_profile_t;
+
+typedef struct
+{
+    wifi_profile_t items[WIFI_PROFILES_MAX];
+    size_t count;
+} wifi_profiles_t;
+
+/* index of ssid, list->count if it is not saved */
+size_t wifi_profiles_find(const wifi_profiles_t *list, const char *ssid);
+
+/*
+ * Saves ssid / pass and moves the profile to pos (past the end: last). An
+ * existing profile keeps its hint. False (list unchanged) for an empty or too
+ * long ssid, a too long pass or a full list.
+ */
+bool wifi_profiles_put(wifi_profiles_t *list, const char *ssid, const char *pass, size_t pos);
+bool wifi_profiles_remove(wifi_profiles_t *list, const char *ssid);
+
+/* true if the stored hint changed, i.e. the list is worth writing */
+bool wifi_profiles_set_hint(wifi_profiles_t *list, const char *ssid, const wifi_profile_hint_t *hint);
+
+/* returns the encoded length, 0 on error */
+size_t wifi_profiles_encode(const wifi_profiles_t *list, uint8_t *out, size_t out_len);
+/* fails on unknown version, length mismatch, bad lengths or a duplicate ssid */
+bool wifi_profiles_decode(const uint8_t *buf, size_t len, wifi_profiles_t *out);
+
+typedef struct
+{
+    size_t profile; /* index into the list */
+    bool fast;      /* use the hint: fixed channel and BSSID, no full scan */
+} wifi_profiles_attempt_t;
+
+/*
+ * Connect order of one round: a fast attempt for every profile with a hint,
+ * in priority order, then a full scan for every profile in priority order.
+ * step counts from 0; false once the round is over.
+ */
+bool wifi_profiles_attempt(const wifi_profiles_t *list, size_t step, wifi_profiles_attempt_t *out);
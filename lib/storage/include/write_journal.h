@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Write-behind journal for a key/value store (NVS): puts are kept in RAM and
+ * flush() applies the pending entries to the backend followed by a single
+ * commit.
+ *
+ * Ordering: entries are applied in the order they were put, so a flush cut
+ * short (power loss, backend error) leaves the store as it was after some
+ * earlier put, never a later write without the earlier ones. To keep that, a
+ * put only replaces the pending entry of its key when that entry is the newest
+ * one (A, A collapses); with anything queued in between it becomes an entry of
+ * its own (A, B, A stays three) and the older value is applied first. Values
+ * live in a caller-provided byte area. No locking: callers serialize access.
+ */
+
+/* NVS key limit: 15 characters + NUL */
+#define WRITE_JOURNAL_KEY_MAX 16U
+#define WRITE_JOURNAL_MAX_ENTRIES 16U
+
+typedef enum
+{
+    WRITE_JOURNAL_STR = 0, /* data holds the string with its NUL */
+    WRITE_JOURNAL_BLOB,
+    WRITE_JOURNAL_ERASE /* no data */
+} write_journal_kind_t;
+
+typedef struct
+{
+    char key[WRITE_JOURNAL_KEY_MAX];
+    write_journal_kind_t kind;
+    size_t off;
+    size_t len;
+} write_journal_entry_t;
+
+/* commits avoided = puts - commits */
+typedef struct
+{
+    uint32_t puts;
+    uint32_t coalesced; /* puts that replaced the newest entry, of the same key */
+    uint32_t flushes;   /* flush() calls with pending entries */
+    uint32_t commits;
+    uint32_t failures; /* flushes stopped by a backend error */
+} write_journal_stats_t;
+
+typedef struct
+{
+    uint8_t *mem;
+    size_t mem_size;
+    size_t mem_used;
+    write_journal_entry_t entries[WRITE_JOURNAL_MAX_ENTRIES]; /* oldest first */
+    size_t count;
+    write_journal_stats_t stats;
+} write_journal_t;
+
+/* backend calls return 0 on success; anything else stops the flush and is returned by it */
+typedef struct
+{
+    int (*apply)(void *ctx, const char *key, write_journal_kind_t kind, const void *data, size_t len);
+    int (*commit)(void *ctx);
+    void *ctx;
+} write_journal_backend_t;
+
+void write_journal_init(write_journal_t *j, void *mem, size_t mem_size);
+/*
+ * false if the key is too long or the journal has no room (entry slots or
+ * bytes); pending entries are then left as they were. Flush and retry; a
+ * value larger than mem_size never fits.
+ */
+bool write_journal_put(write_journal_t *j, const char *key, write_journal_kind_t kind, const void *data, size_t len);
+/* newest pending entry of key; data points into the journal until the next put / flush */
+bool write_journal_get(const write_journal_t *j, const char *key, write_journal_kind_t *out_kind, const void **out_data,
+                       size_t *out_len);
+size_t write_journal_pending(const write_journal_t *j);
+/*
+ * Applies entries oldest first, then commits once. Applied entries are dropped
+ * even if a later one fails (the backend already has them); the failed one and
+ * everything after it stay pending. A failed commit keeps all entries pending.
+ * Nothing pending: returns 0 without a commit.
+ */
+int write_journal_flush(write_journal_t *j, const write_journal_backend_t *backend);
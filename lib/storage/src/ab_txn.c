@@ -0,0 +1,142 @@
+#include <string.h>
+
+#include "ab_txn.h"
+
+bool ab_txn_slot_key(const char *key, uint32_t gen, char out[WRITE_JOURNAL_KEY_MAX])
+{
+    bool ok = false;
+
+    if ((key != NULL) && (key[0] != '\0') && (memchr(key, '\0', AB_TXN_KEY_MAX) != NULL))
+    {
+        out[0] = ((gen & 1U) != 0U) ? 'a' : 'b';
+        out[1] = ':';
+        (void)strcpy(&out[2], key);
+        ok = true;
+    }
+
+    return ok;
+}
+
+/* generation, then its complement: a word that is not both is not one */
+void ab_txn_gen_encode(uint32_t gen, uint8_t out[AB_TXN_GEN_LEN])
+{
+    const uint32_t inv = ~gen;
+
+    for (size_t i = 0U; i < 4U; i++)
+    {
+        out[i] = (uint8_t)(gen >> (8U * i));
+        out[4U + i] = (uint8_t)(inv >> (8U * i));
+    }
+}
+
+bool ab_txn_gen_decode(const uint8_t *in, size_t len, uint32_t *out_gen)
+{
+    uint32_t gen = 0U;
+    uint32_t inv = 0U;
+    bool ok = (in != NULL) && (len == AB_TXN_GEN_LEN);
+
+    for (size_t i = 4U; (ok == true) && (i > 0U); i--)
+    {
+        gen = (gen << 8U) | in[i - 1U];
+        inv = (inv << 8U) | in[3U + i];
+    }
+
+    ok = ok && (gen == ~inv) && (gen != 0U);
+    if ((ok == true) && (out_gen != NULL))
+    {
+        *out_gen = gen;
+    }
+
+    return ok;
+}
+
+int ab_txn_generation(const ab_txn_store_t *s, const char *group, bool committed, uint32_t *out_gen)
+{
+    uint8_t word[AB_TXN_GEN_LEN];
+    size_t len = sizeof(word);
+    uint32_t gen = 0U;
+    int err = s->get(s->ctx, group, WRITE_JOURNAL_BLOB, committed, word, &len);
+
+    if (err == s->not_found)
+    {
+        err = 0;
+    }
+    else if ((err == 0) && (ab_txn_gen_decode(word, len, &gen) == false))
+    {
+        err = s->corrupt;
+    }
+    else
+    {
+        /* decoded, or a store error */
+    }
+
+    if ((err == 0) && (out_gen != NULL))
+    {
+        *out_gen = gen;
+    }
+
+    return err;
+}
+
+int ab_txn_read(const ab_txn_store_t *s, uint32_t gen, const char *key, write_journal_kind_t kind, void *out,
+                size_t *len)
+{
+    char slot_key[WRITE_JOURNAL_KEY_MAX];
+    int err = 0;
+
+    if (gen == 0U)
+    {
+        err = s->get(s->ctx, key, kind, false, out, len);
+    }
+    else if (ab_txn_slot_key(key, gen, slot_key) == true)
+    {
+        err = s->get(s->ctx, slot_key, kind, false, out, len);
+    }
+    else
+    {
+        err = s->not_found;
+    }
+
+    return err;
+}
+
+int ab_txn_write(const ab_txn_store_t *s, const char *group, const ab_txn_item_t *items, size_t count)
+{
+    uint32_t current = 0U;
+    int err = ab_txn_generation(s, group, false, &current);
+
+    if (err == s->corrupt)
+    {
+        /* nothing readable to protect; start over */
+        current = 0U;
+        err = 0;
+    }
+
+    /* the slot the current word does not point to; skipping 0 keeps the parity alternating */
+    const uint32_t next = ((current + 1U) == 0U) ? 2U : (current + 1U);
+
+    for (size_t i = 0U; (err == 0) && (i < count); i++)
+    {
+        char slot_key[WRITE_JOURNAL_KEY_MAX];
+
+        err = (ab_txn_slot_key(items[i].key, next, slot_key) == true)
+                  ? s->put(s->ctx, slot_key, items[i].kind, items[i].data, items[i].len)
+                  : s->not_found;
+    }
+
+    if (err == 0)
+    {
+        uint8_t word[AB_TXN_GEN_LEN];
+
+        ab_txn_gen_encode(next, word);
+        err = s->put(s->ctx, group, WRITE_JOURNAL_BLOB, word, sizeof(word));
+    }
+
+    /* values from before the group existed; read only while the word is missing */
+    for (size_t i = 0U; (err == 0) && (current == 0U) && (i < count); i++)
+    {
+        err = s->put(s->ctx, items[i].key, WRITE_JOURNAL_ERASE, NULL, 0U);
+    }
+
+    return err;
+}
@@ -0,0 +1,152 @@
+#include <string.h>
+
+#include "buf_pool.h"
+
+void buf_pool_init(buf_pool_t *pool)
+{
+    (void)memset(pool, 0, sizeof(*pool));
+}
+
+bool buf_pool_add_class(buf_pool_t *pool, void *mem, size_t block_size, size_t count)
+{
+    bool ok = false;
+
+    if ((pool != NULL) && (mem != NULL) && (block_size > 0U) && (count > 0U) && (count <= BUF_POOL_MAX_BLOCKS) &&
+        (pool->class_count < BUF_POOL_MAX_CLASSES) &&
+        ((pool->class_count == 0U) || (pool->cls[pool->class_count - 1U].block_size < block_size)))
+    {
+        buf_pool_class_t *c = &pool->cls[pool->class_count];
+
+        (void)memset(c, 0, sizeof(*c));
+        c->mem = (uint8_t *)mem;
+        c->block_size = block_size;
+        c->count = count;
+        pool->class_count++;
+        ok = true;
+    }
+
+    return ok;
+}
+
+void *buf_pool_borrow(buf_pool_t *pool, size_t size, const void *owner, const char *label)
+{
+    void *buf = NULL;
+    buf_pool_class_t *best = NULL;
+
+    for (size_t i = 0U; (pool != NULL) && (buf == NULL) && (i < pool->class_count); i++)
+    {
+        buf_pool_class_t *c = &pool->cls[i];
+
+        if (c->block_size >= size)
+        {
+            best = (best == NULL) ? c : best;
+
+            for (size_t b = 0U; (buf == NULL) && (b < c->count); b++)
+            {
+                const uint16_t bit = (uint16_t)(1U << b);
+
+                if ((c->used_mask & bit) == 0U)
+                {
+                    c->used_mask |= bit;
+                    c->owner[b] = owner;
+                    c->label[b] = label;
+                    c->in_use++;
+                    c->borrows++;
+                    c->peak = (c->in_use > c->peak) ? c->in_use : c->peak;
+                    buf = &c->mem[b * c->block_size];
+                }
+            }
+        }
+    }
+
+    if ((buf == NULL) && (best != NULL))
+    {
+        best->misses++;
+    }
+
+    return buf;
+}
+
+/* class and block index of buf; false if buf is not the start of a block */
+static bool locate(const buf_pool_t *pool, const void *buf, size_t *out_cls, size_t *out_block)
+{
+    bool found = false;
+    const uint8_t *p = (const uint8_t *)buf;
+
+    for (size_t i = 0U; (pool != NULL) && (found == false) && (i < pool->class_count); i++)
+    {
+        const buf_pool_class_t *c = &pool->cls[i];
+
+        if ((p >= c->mem) && (p < &c->mem[c->count * c->block_size]) &&
+            (((size_t)(p - c->mem) % c->block_size) == 0U))
+        {
+            *out_cls = i;
+            *out_block = (size_t)(p - c->mem) / c->block_size;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+bool buf_pool_return(buf_pool_t *pool, void *buf)
+{
+    bool ok = false;
+    size_t ci = 0U;
+    size_t b = 0U;
+
+    if ((buf != NULL) && locate(pool, buf, &ci, &b))
+    {
+        buf_pool_class_t *c = &pool->cls[ci];
+        const uint16_t bit = (uint16_t)(1U << b);
+
+        if ((c->used_mask & bit) != 0U)
+        {
+            c->used_mask &= (uint16_t)~bit;
+            c->owner[b] = NULL;
+            c->label[b] = NULL;
+            c->in_use--;
+            ok = true;
+        }
+    }
+
+    return ok;
+}
+
+size_t buf_pool_block_size(const buf_pool_t *pool, const void *buf)
+{
+    size_t size = 0U;
+    size_t ci = 0U;
+    size_t b = 0U;
+
+    if ((buf != NULL) && locate(pool, buf, &ci, &b) && ((pool->cls[ci].used_mask & (1U << b)) != 0U))
+    {
+        size = pool->cls[ci].block_size;
+    }
+
+    return size;
+}
+
+size_t buf_pool_outstanding(const buf_pool_t *pool, const void *owner, buf_pool_visit_fn visit, void *ctx)
+{
+    size_t n = 0U;
+
+    for (size_t i = 0U; (pool != NULL) && (i < pool->class_count); i++)
+    {
+        const buf_pool_class_t *c = &pool->cls[i];
+
+        for (size_t b = 0U; b < c->count; b++)
+        {
+            if (((c->used_mask & (1U << b)) != 0U) && ((owner == NULL) || (c->owner[b] == owner)))
+            {
+                n++;
+                if (visit != NULL)
+                {
+                    visit(c->label[b], c->block_size, ctx);
+                }
+            }
+        }
+    }
+
+    return n;
+}
@@ -0,0 +1,326 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "config_registry.h"
+#include "json_codec.h"
+
+static const config_def_t *def_of(const config_registry_t *reg, size_t key)
+{
+    return ((reg != NULL) && (key < reg->count)) ? &reg->defs[key] : NULL;
+}
+
+size_t config_registry_find(const config_registry_t *reg, const char *name)
+{
+    size_t idx = (reg != NULL) ? reg->count : 0U;
+
+    for (size_t i = 0U; (reg != NULL) && (name != NULL) && (idx == reg->count) && (i < reg->count); i++)
+    {
+        if (strcmp(reg->defs[i].name, name) == 0)
+        {
+            idx = i;
+        }
+    }
+
+    return idx;
+}
+
+void config_registry_default(const config_registry_t *reg, size_t key, config_value_t *out)
+{
+    const config_def_t *d = def_of(reg, key);
+
+    (void)memset(out, 0, sizeof(*out));
+    if (d != NULL)
+    {
+        out->num = d->def_num;
+        if (d->def_str != NULL)
+        {
+            (void)strncpy(out->str, d->def_str, CONFIG_VALUE_STR_MAX);
+        }
+    }
+}
+
+bool config_registry_validate(const config_registry_t *reg, size_t key, const config_value_t *value)
+{
+    const config_def_t *d = def_of(reg, key);
+    bool ok = false;
+
+    if ((d != NULL) && (value != NULL))
+    {
+        switch (d->type)
+        {
+        case CONFIG_TYPE_STR:
+        {
+            const char *end = (const char *)memchr(value->str, '\0', sizeof(value->str));
+            const size_t len = (end != NULL) ? (size_t)(end - value->str) : sizeof(value->str);
+            ok = (end != NULL) && (len >= d->min) && (len <= d->max);
+            break;
+        }
+        case CONFIG_TYPE_U32:
+            ok = (value->num >= d->min) && (value->num <= d->max);
+            break;
+        case CONFIG_TYPE_BOOL:
+            ok = (value->num <= 1U);
+            break;
+        default:
+            ok = false;
+            break;
+        }
+    }
+
+    return ok;
+}
+
+/* decimal digits only, no sign, no leading zeros beyond "0", fits uint32_t */
+static bool parse_u32(const char *text, size_t len, uint32_t *out)
+{
+    uint32_t v = 0U;
+    bool ok = (len > 0U) && (len <= 10U) && ((len == 1U) || (text[0] != '0'));
+
+    for (size_t i = 0U; (ok == true) && (i < len); i++)
+    {
+        const uint32_t digit = (uint32_t)(text[i] - '0');
+
+        if ((text[i] < '0') || (text[i] > '9') || (v > ((UINT32_MAX - digit) / 10U)))
+        {
+            ok = false;
+        }
+        else
+        {
+            v = (v * 10U) + digit;
+        }
+    }
+
+    if (ok == true)
+    {
+        *out = v;
+    }
+
+    return ok;
+}
+
+bool config_registry_parse_text(const config_registry_t *reg, size_t key, const char *text, config_value_t *out)
+{
+    const config_def_t *d = def_of(reg, key);
+    config_value_t v;
+    bool ok = false;
+
+    if ((d != NULL) && (text != NULL) && (out != NULL))
+    {
+        (void)memset(&v, 0, sizeof(v));
+
+        if (d->type == CONFIG_TYPE_STR)
+        {
+            const size_t len = strlen(text);
+            ok = (len <= CONFIG_VALUE_STR_MAX);
+            if (ok == true)
+            {
+                (void)memcpy(v.str, text, len);
+            }
+        }
+        else
+        {
+            ok = parse_u32(text, strlen(text), &v.num);
+        }
+
+        ok = ok && config_registry_validate(reg, key, &v);
+        if (ok == true)
+        {
+            *out = v;
+        }
+    }
+
+    return ok;
+}
+
+size_t config_registry_format_text(const config_registry_t *reg, size_t key, const config_value_t *value, char *out,
+                                   size_t out_len)
+{
+    const config_def_t *d = def_of(reg, key);
+    size_t len = 0U;
+
+    if ((d != NULL) && (value != NULL) && (out != NULL) && (out_len > 0U))
+    {
+        int n;
+
+        if (d->type == CONFIG_TYPE_STR)
+        {
+            n = snprintf(out, out_len, "%s", value->str);
+        }
+        else
+        {
+            n = snprintf(out, out_len, "%lu", (unsigned long)value->num);
+        }
+
+        len = ((n > 0) && ((size_t)n < out_len)) ? (size_t)n : 0U;
+    }
+
+    return len;
+}
+
+/* peeks at the next value: does its JSON type fit the setting (without failing the reader)? */
+static bool type_fits(const json_reader_t *r, config_type_t type)
+{
+    const char *p = r->p;
+
+    while ((*p == ' ') || (*p == '\t') || (*p == '\n') || (*p == '\r'))
+    {
+        p++;
+    }
+
+    return ((type == CONFIG_TYPE_STR) && (*p == '"')) ||
+           ((type == CONFIG_TYPE_U32) && ((*p == '-') || ((*p >= '0') && (*p <= '9')))) ||
+           ((type == CONFIG_TYPE_BOOL) && ((*p == 't') || (*p == 'f')));
+}
+
+static bool read_value(json_reader_t *r, const config_def_t *d, config_value_t *out)
+{
+    bool ok = false;
+
+    (void)memset(out, 0, sizeof(*out));
+
+    switch (d->type)
+    {
+    case CONFIG_TYPE_STR:
+    {
+        /* one spare byte tells an over-long value from one of exactly max length */
+        char buf[CONFIG_VALUE_STR_MAX + 2U];
+        ok = json_read_str(r, buf, sizeof(buf)) && (strlen(buf) <= CONFIG_VALUE_STR_MAX);
+        if (ok == true)
+        {
+            (void)memcpy(out->str, buf, strlen(buf) + 1U);
+        }
+        break;
+    }
+    case CONFIG_TYPE_U32:
+    {
+        const char *text = NULL;
+        size_t len = 0U;
+        ok = json_read_number(r, &text, &len) && parse_u32(text, len, &out->num);
+        break;
+    }
+    case CONFIG_TYPE_BOOL:
+    {
+        bool b = false;
+        ok = json_read_bool(r, &b);
+        out->num = (b == true) ? 1U : 0U;
+        break;
+    }
+    default:
+        ok = false;
+        break;
+    }
+
+    return ok;
+}
+
+config_parse_result_t config_registry_from_json(const config_registry_t *reg, const char *json, config_entry_t *out,
+                                                size_t max, size_t *out_count)
+{
+    config_parse_result_t res = CONFIG_PARSE_SYNTAX;
+    size_t n = 0U;
+
+    if ((reg != NULL) && (json != NULL) && (out != NULL))
+    {
+        json_reader_t r;
+        char name[CONFIG_NAME_MAX];
+        bool first = true;
+
+        res = CONFIG_PARSE_OK;
+        json_reader_init(&r, json);
+        (void)json_read_object_begin(&r);
+
+        while ((res == CONFIG_PARSE_OK) && (json_read_member(&r, &first, name, sizeof(name)) == true))
+        {
+            const size_t key = config_registry_find(reg, name);
+            config_value_t v;
+
+            if (key == reg->count)
+            {
+                res = CONFIG_PARSE_UNKNOWN_KEY;
+            }
+            else if (n == max)
+            {
+                res = CONFIG_PARSE_TOO_MANY;
+            }
+            else if ((r.ok == true) && (type_fits(&r, reg->defs[key].type) == false))
+            {
+                res = CONFIG_PARSE_INVALID_VALUE;
+            }
+            else if (read_value(&r, &reg->defs[key], &v) == false)
+            {
+                /* out of range / negative / fraction leave the reader ok; anything else broke the document */
+                res = (r.ok == true) ? CONFIG_PARSE_INVALID_VALUE : CONFIG_PARSE_SYNTAX;
+            }
+            else if (config_registry_validate(reg, key, &v) == false)
+            {
+                res = CONFIG_PARSE_INVALID_VALUE;
+            }
+            else
+            {
+                for (size_t i = 0U; (res == CONFIG_PARSE_OK) && (i < n); i++)
+                {
+                    res = (out[i].key == key) ? CONFIG_PARSE_DUPLICATE : CONFIG_PARSE_OK;
+                }
+                if (res == CONFIG_PARSE_OK)
+                {
+                    out[n].key = key;
+                    out[n].value = v;
+                    n++;
+                }
+            }
+        }
+
+        if ((res == CONFIG_PARSE_OK) && ((r.ok == false) || (json_read_end(&r) == false)))
+        {
+            res = CONFIG_PARSE_SYNTAX;
+        }
+    }
+
+    if (out_count != NULL)
+    {
+        *out_count = n;
+    }
+
+    return res;
+}
+
+size_t config_registry_to_json(const config_registry_t *reg, const config_entry_t *entries, size_t count, char *out,
+                               size_t out_len)
+{
+    json_writer_t w;
+    bool first = true;
+    char hidden_key[CONFIG_NAME_MAX + 4U];
+
+    json_writer_init(&w, out, out_len);
+    json_write_raw(&w, "{", 1U);
+
+    for (size_t i = 0U; (reg != NULL) && (entries != NULL) && (i < count); i++)
+    {
+        const config_def_t *d = def_of(reg, entries[i].key);
+        const config_value_t *v = &entries[i].value;
+
+        if (d == NULL)
+        {
+            w.ok = false;
+        }
+        else if (d->type == CONFIG_TYPE_STR)
+        {
+            (void)snprintf(hidden_key, sizeof(hidden_key), "%s_len", d->name);
+            json_write_str_field(&w, &first, d->name, v->str, sizeof(v->str),
+                                 ((d->flags & CONFIG_FLAG_SECRET) != 0U), hidden_key);
+        }
+        else if (d->type == CONFIG_TYPE_BOOL)
+        {
+            json_write_key(&w, &first, d->name);
+            json_write_bool(&w, v->num != 0U);
+        }
+        else
+        {
+            json_write_key(&w, &first, d->name);
+            json_write_uint(&w, (unsigned long)v->num);
+        }
+    }
+
+    json_write_raw(&w, "}", 1U);
+    return json_writer_len(&w);
+}
@@ -0,0 +1,190 @@
+#include <string.h>
+
+#include "gazetteer.h"
+#include "locations_coord.h"
+
+/*
+    little endian helpers
+*/
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int32_t get_i32(const uint8_t *p)
+{
+    return (int32_t)get_u32(p);
+}
+
+static uint32_t bucket_at(const gazetteer_t *gz, size_t b)
+{
+    return get_u32(&gz->base[GAZETTEER_HEADER_LEN + (4U * b)]);
+}
+
+/* ASCII lower case; other bytes (UTF-8 included) compare as they are */
+static uint8_t key_byte(uint8_t c)
+{
+    return ((c >= (uint8_t)'A') && (c <= (uint8_t)'Z')) ? (uint8_t)(c + 32U) : c;
+}
+
+/*
+ * compares the first min(name_len, prefix_len) key bytes, then the lengths
+ * when the prefix is longer; < 0: name sorts before prefix, 0: name starts with prefix
+ */
+static int compare_prefix(const gazetteer_entry_t *e, const char *prefix, size_t prefix_len)
+{
+    int result = 0;
+    size_t i = 0U;
+
+    while ((result == 0) && (i < prefix_len))
+    {
+        if (i >= e->name_len)
+        {
+            result = -1;
+        }
+        else
+        {
+            result = (int)key_byte((uint8_t)e->name[i]) - (int)key_byte((uint8_t)prefix[i]);
+        }
+        i++;
+    }
+
+    return result;
+}
+
+/* first entry in the prefix's bucket that does not sort before the prefix */
+static uint32_t lower_bound(const gazetteer_t *gz, const char *prefix, size_t prefix_len)
+{
+    const uint8_t first = key_byte((uint8_t)prefix[0]);
+    uint32_t lo = bucket_at(gz, first);
+    uint32_t hi = bucket_at(gz, (size_t)first + 1U);
+    gazetteer_entry_t e;
+
+    while (lo < hi)
+    {
+        const uint32_t mid = lo + ((hi - lo) / 2U);
+
+        /* a malformed entry ends the range on the left */
+        if (gazetteer_get(gz, mid, &e) && (compare_prefix(&e, prefix, prefix_len) < 0))
+        {
+            lo = mid + 1U;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+/*
+    public
+*/
+
+bool gazetteer_open(gazetteer_t *out, const void *image, size_t len)
+{
+    bool ok = false;
+    const uint8_t *base = (const uint8_t *)image;
+    const size_t table_end = GAZETTEER_HEADER_LEN + (4U * GAZETTEER_BUCKETS);
+
+    if ((out != NULL) && (base != NULL) && (len >= table_end) &&
+        (memcmp(base, GAZETTEER_MAGIC, 4U) == 0))
+    {
+        gazetteer_t gz;
+        gz.base = base;
+        gz.len = len;
+        gz.count = get_u32(&base[4]);
+        gz.entries_off = get_u32(&base[8]);
+        gz.names_off = get_u32(&base[12]);
+        gz.names_len = get_u32(&base[16]);
+
+        /* 64 bit sums: offsets come from flash and must not wrap */
+        const uint64_t entries_end = (uint64_t)gz.entries_off + ((uint64_t)gz.count * GAZETTEER_ENTRY_LEN);
+        const uint64_t names_end = (uint64_t)gz.names_off + (uint64_t)gz.names_len;
+
+        ok = (gz.entries_off >= table_end) && (entries_end <= (uint64_t)len) &&
+             (gz.names_off >= table_end) && (names_end <= (uint64_t)len);
+
+        /* buckets must be monotonic and end at count: every search range is then in bounds */
+        uint32_t prev = 0U;
+        for (size_t b = 0U; ok && (b < GAZETTEER_BUCKETS); b++)
+        {
+            const uint32_t v = bucket_at(&gz, b);
+            ok = (v >= prev) && (v <= gz.count);
+            prev = v;
+        }
+        ok = ok && (prev == gz.count);
+
+        if (ok)
+        {
+            *out = gz;
+        }
+    }
+
+    return ok;
+}
+
+bool gazetteer_get(const gazetteer_t *gz, uint32_t index, gazetteer_entry_t *out)
+{
+    bool ok = false;
+
+    if ((gz != NULL) && (out != NULL) && (index < gz->count))
+    {
+        const uint8_t *p = &gz->base[gz->entries_off + (index * GAZETTEER_ENTRY_LEN)];
+        const uint32_t name_off = get_u32(&p[8]);
+        const size_t name_len = (size_t)p[12];
+
+        if ((name_len > 0U) && (name_len <= GAZETTEER_NAME_MAX) &&
+            (name_off <= gz->names_len) && (name_len <= (size_t)(gz->names_len - name_off)))
+        {
+            out->name = (const char *)&gz->base[gz->names_off + name_off];
+            out->name_len = name_len;
+            out->latitude_e6 = get_i32(&p[0]);
+            out->longitude_e6 = get_i32(&p[4]);
+
+            ok = locations_coord_lat_valid(out->latitude_e6) && locations_coord_lon_valid(out->longitude_e6);
+        }
+    }
+
+    return ok;
+}
+
+size_t gazetteer_search(const gazetteer_t *gz, const char *prefix, gazetteer_entry_t *out, size_t max)
+{
+    size_t n = 0U;
+    const size_t prefix_len = (prefix != NULL) ? strlen(prefix) : 0U;
+
+    if ((gz != NULL) && (out != NULL) && (max > 0U) && (prefix_len > 0U))
+    {
+        gazetteer_entry_t e;
+
+        for (uint32_t i = lower_bound(gz, prefix, prefix_len); (i < gz->count) && (n < max); i++)
+        {
+            if ((gazetteer_get(gz, i, &e) == false) || (compare_prefix(&e, prefix, prefix_len) != 0))
+            {
+                break;
+            }
+            out[n] = e;
+            n++;
+        }
+    }
+
+    return n;
+}
+
+bool gazetteer_find(const gazetteer_t *gz, const char *name, gazetteer_entry_t *out)
+{
+    bool found = false;
+    gazetteer_entry_t e;
+
+    /* keys sort shorter-first, so an exact match is the first prefix match */
+    if ((out != NULL) && (gazetteer_search(gz, name, &e, 1U) == 1U) && (e.name_len == strlen(name)))
+    {
+        *out = e;
+        found = true;
+    }
+
+    return found;
+}
@@ -0,0 +1,68 @@
+#include "json_arena.h"
+
+void json_arena_init(json_arena_t *arena, void *buf, size_t size)
+{
+    /* the buffer start is aligned here so every offset below only needs rounding */
+    const uintptr_t addr = (uintptr_t)buf;
+    const size_t skip = (size_t)((JSON_ARENA_ALIGN - (addr % JSON_ARENA_ALIGN)) % JSON_ARENA_ALIGN);
+
+    arena->buf = (uint8_t *)buf;
+    arena->size = 0U;
+    arena->used = 0U;
+    arena->last = 0U;
+    arena->high_water = 0U;
+    arena->overflows = 0U;
+
+    if ((buf != NULL) && (size > skip))
+    {
+        arena->buf = &((uint8_t *)buf)[skip];
+        arena->size = size - skip;
+    }
+}
+
+void *json_arena_alloc(json_arena_t *arena, size_t size)
+{
+    void *ptr = NULL;
+    const size_t start = (arena->used + (JSON_ARENA_ALIGN - 1U)) & ~(size_t)(JSON_ARENA_ALIGN - 1U);
+
+    if ((start <= arena->size) && (size <= (arena->size - start)))
+    {
+        ptr = &arena->buf[start];
+        arena->last = start;
+        arena->used = start + size;
+
+        if (arena->used > arena->high_water)
+        {
+            arena->high_water = arena->used;
+        }
+    }
+    else
+    {
+        arena->overflows++;
+    }
+
+    return ptr;
+}
+
+bool json_arena_owns(const json_arena_t *arena, const void *ptr)
+{
+    const uintptr_t p = (uintptr_t)ptr;
+    const uintptr_t base = (uintptr_t)arena->buf;
+
+    return (ptr != NULL) && (arena->size > 0U) && (p >= base) && (p < (base + arena->size));
+}
+
+void json_arena_free(json_arena_t *arena, void *ptr)
+{
+    if (json_arena_owns(arena, ptr) && ((size_t)((uint8_t *)ptr - arena->buf) == arena->last) &&
+        (arena->last < arena->used))
+    {
+        arena->used = arena->last;
+    }
+}
+
+void json_arena_reset(json_arena_t *arena)
+{
+    arena->used = 0U;
+    arena->last = 0U;
+}
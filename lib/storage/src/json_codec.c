@@ -0,0 +1,601 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "json_codec.h"
+
+/*
+    writer
+*/
+
+void json_writer_init(json_writer_t *w, char *out, size_t out_len)
+{
+    w->out = out;
+    w->out_len = out_len;
+    w->pos = 0U;
+    w->ok = (out == NULL) || (out_len > 0U);
+
+    if ((out != NULL) && (out_len > 0U))
+    {
+        out[0] = '\0';
+    }
+}
+
+void json_write_raw(json_writer_t *w, const char *text, size_t len)
+{
+    if (w->ok == true)
+    {
+        if (w->out == NULL)
+        {
+            w->pos += len;
+        }
+        else if ((w->pos + len) < w->out_len)
+        {
+            (void)memcpy(&w->out[w->pos], text, len);
+            w->pos += len;
+            w->out[w->pos] = '\0';
+        }
+        else
+        {
+            w->ok = false;
+        }
+    }
+}
+
+void json_write_lit(json_writer_t *w, const char *text)
+{
+    json_write_raw(w, text, strlen(text));
+}
+
+/* escaping as cJSON does it: short forms, \u00XX for other control bytes, rest as is */
+void json_write_str(json_writer_t *w, const char *text, size_t max_len)
+{
+    json_write_raw(w, "\"", 1U);
+
+    for (size_t i = 0U; (i < max_len) && (text[i] != '\0'); i++)
+    {
+        const unsigned char c = (unsigned char)text[i];
+        char esc[8];
+
+        switch (c)
+        {
+        case '"':
+            json_write_raw(w, "\\\"", 2U);
+            break;
+        case '\\':
+            json_write_raw(w, "\\\\", 2U);
+            break;
+        case '\b':
+            json_write_raw(w, "\\b", 2U);
+            break;
+        case '\f':
+            json_write_raw(w, "\\f", 2U);
+            break;
+        case '\n':
+            json_write_raw(w, "\\n", 2U);
+            break;
+        case '\r':
+            json_write_raw(w, "\\r", 2U);
+            break;
+        case '\t':
+            json_write_raw(w, "\\t", 2U);
+            break;
+        default:
+            if (c < 0x20U)
+            {
+                (void)snprintf(esc, sizeof(esc), "\\u%04x", (unsigned int)c);
+                json_write_raw(w, esc, 6U);
+            }
+            else
+            {
+                json_write_raw(w, &text[i], 1U);
+            }
+            break;
+        }
+    }
+
+    json_write_raw(w, "\"", 1U);
+}
+
+void json_write_bool(json_writer_t *w, bool value)
+{
+    json_write_lit(w, (value == true) ? "true" : "false");
+}
+
+void json_write_uint(json_writer_t *w, unsigned long value)
+{
+    char buf[24];
+    const int len = snprintf(buf, sizeof(buf), "%lu", value);
+
+    json_write_raw(w, buf, (size_t)len);
+}
+
+void json_write_key(json_writer_t *w, bool *first, const char *key)
+{
+    if (*first == false)
+    {
+        json_write_raw(w, ",", 1U);
+    }
+    *first = false;
+
+    json_write_raw(w, "\"", 1U);
+    json_write_lit(w, key);
+    json_write_raw(w, "\":", 2U);
+}
+
+void json_write_str_field(json_writer_t *w, bool *first, const char *key, const char *text, size_t max_len,
+                          bool hidden, const char *hidden_key)
+{
+    if (hidden == true)
+    {
+        const char *nul = (const char *)memchr(text, '\0', max_len);
+
+        json_write_key(w, first, hidden_key);
+        json_write_uint(w, (unsigned long)((nul != NULL) ? (size_t)(nul - text) : max_len));
+    }
+    else
+    {
+        json_write_key(w, first, key);
+        json_write_str(w, text, max_len);
+    }
+}
+
+size_t json_writer_len(const json_writer_t *w)
+{
+    return (w->ok == true) ? w->pos : 0U;
+}
+
+/*
+    reader
+*/
+
+static bool fail(json_reader_t *r)
+{
+    r->ok = false;
+    return false;
+}
+
+static void skip_ws(json_reader_t *r)
+{
+    while ((*r->p == ' ') || (*r->p == '\t') || (*r->p == '\n') || (*r->p == '\r'))
+    {
+        r->p++;
+    }
+}
+
+/* consumes c after optional whitespace */
+static bool expect(json_reader_t *r, char c)
+{
+    bool ok = false;
+
+    if (r->ok == true)
+    {
+        skip_ws(r);
+        if (*r->p == c)
+        {
+            r->p++;
+            ok = true;
+        }
+        else
+        {
+            (void)fail(r);
+        }
+    }
+
+    return ok;
+}
+
+static int hex_digit(char c)
+{
+    int v = -1;
+
+    if ((c >= '0') && (c <= '9'))
+    {
+        v = c - '0';
+    }
+    else if ((c >= 'a') && (c <= 'f'))
+    {
+        v = (c - 'a') + 10;
+    }
+    else if ((c >= 'A') && (c <= 'F'))
+    {
+        v = (c - 'A') + 10;
+    }
+    else
+    {
+        v = -1;
+    }
+
+    return v;
+}
+
+/* four hex digits after "\u"; -1 if malformed */
+static long read_hex4(const char *p)
+{
+    long v = 0;
+
+    for (size_t i = 0U; (i < 4U) && (v >= 0); i++)
+    {
+        const int d = hex_digit(p[i]);
+        v = (d < 0) ? -1 : ((v << 4) | (long)d);
+    }
+
+    return v;
+}
+
+static size_t utf8_encode(uint32_t cp, char out[4])
+{
+    size_t len = 0U;
+
+    if (cp < 0x80U)
+    {
+        out[0] = (char)cp;
+        len = 1U;
+    }
+    else if (cp < 0x800U)
+    {
+        out[0] = (char)(0xC0U | (cp >> 6));
+        out[1] = (char)(0x80U | (cp & 0x3FU));
+        len = 2U;
+    }
+    else if (cp < 0x10000U)
+    {
+        out[0] = (char)(0xE0U | (cp >> 12));
+        out[1] = (char)(0x80U | ((cp >> 6) & 0x3FU));
+        out[2] = (char)(0x80U | (cp & 0x3FU));
+        len = 3U;
+    }
+    else
+    {
+        out[0] = (char)(0xF0U | (cp >> 18));
+        out[1] = (char)(0x80U | ((cp >> 12) & 0x3FU));
+        out[2] = (char)(0x80U | ((cp >> 6) & 0x3FU));
+        out[3] = (char)(0x80U | (cp & 0x3FU));
+        len = 4U;
+    }
+
+    return len;
+}
+
+/* \uXXXX (plus a following low surrogate if needed) at p; returns chars consumed, 0 if invalid or U+0000 */
+static size_t read_unicode_escape(const char *p, uint32_t *out_cp)
+{
+    size_t used = 0U;
+    const long hi = read_hex4(&p[2]);
+
+    if ((hi > 0) && ((hi < 0xD800L) || (hi > 0xDFFFL)))
+    {
+        *out_cp = (uint32_t)hi;
+        used = 6U;
+    }
+    else if ((hi >= 0xD800L) && (hi <= 0xDBFFL) && (p[6] == '\\') && (p[7] == 'u'))
+    {
+        const long lo = read_hex4(&p[8]);
+        if ((lo >= 0xDC00L) && (lo <= 0xDFFFL))
+        {
+            *out_cp = 0x10000U + (((uint32_t)hi - 0xD800U) << 10) + ((uint32_t)lo - 0xDC00U);
+            used = 12U;
+        }
+    }
+    else
+    {
+        used = 0U;
+    }
+
+    return used;
+}
+
+/* out may be NULL with out_len 0 to skip; *truncated set if bytes were dropped */
+static bool read_string(json_reader_t *r, char *out, size_t out_len, bool *truncated)
+{
+    size_t n = 0U;
+    bool done = false;
+
+    *truncated = false;
+    (void)expect(r, '"');
+
+    while ((r->ok == true) && (done == false))
+    {
+        const unsigned char c = (unsigned char)*r->p;
+        char bytes[4];
+        size_t len = 1U;
+
+        bytes[0] = (char)c;
+
+        if (c == (unsigned char)'"')
+        {
+            r->p++;
+            done = true;
+            len = 0U;
+        }
+        else if (c < 0x20U)
+        {
+            /* includes the terminating NUL of an unclosed string */
+            (void)fail(r);
+            len = 0U;
+        }
+        else if (c == (unsigned char)'\\')
+        {
+            const char e = r->p[1];
+            const char *simple = strchr("\"\\/bfnrt", e);
+
+            if ((e != '\0') && (simple != NULL))
+            {
+                bytes[0] = "\"\\/\b\f\n\r\t"[simple - "\"\\/bfnrt"];
+                r->p += 2;
+            }
+            else if (e == 'u')
+            {
+                uint32_t cp = 0U;
+                const size_t used = read_unicode_escape(r->p, &cp);
+
+                if (used > 0U)
+                {
+                    len = utf8_encode(cp, bytes);
+                    r->p += used;
+                }
+                else
+                {
+                    (void)fail(r);
+                    len = 0U;
+                }
+            }
+            else
+            {
+                (void)fail(r);
+                len = 0U;
+            }
+        }
+        else
+        {
+            r->p++;
+        }
+
+        for (size_t i = 0U; i < len; i++)
+        {
+            if ((n + 1U) < out_len)
+            {
+                out[n] = bytes[i];
+                n++;
+            }
+            else
+            {
+                *truncated = true;
+            }
+        }
+    }
+
+    if (out_len > 0U)
+    {
+        out[n] = '\0';
+    }
+
+    return r->ok;
+}
+
+void json_reader_init(json_reader_t *r, const char *json)
+{
+    r->p = json;
+    r->ok = (json != NULL);
+}
+
+bool json_read_object_begin(json_reader_t *r)
+{
+    return expect(r, '{');
+}
+
+bool json_read_array_begin(json_reader_t *r)
+{
+    return expect(r, '[');
+}
+
+/* shared by members and elements: true if another entry follows */
+static bool next_entry(json_reader_t *r, bool *first, char close)
+{
+    bool more = false;
+
+    if (r->ok == true)
+    {
+        skip_ws(r);
+        if (*r->p == close)
+        {
+            r->p++;
+        }
+        else if (*first == true)
+        {
+            more = true;
+        }
+        else if (*r->p == ',')
+        {
+            r->p++;
+            more = true;
+        }
+        else
+        {
+            (void)fail(r);
+        }
+
+        *first = false;
+    }
+
+    return more;
+}
+
+bool json_read_member(json_reader_t *r, bool *first, char *key, size_t key_len)
+{
+    bool more = next_entry(r, first, '}');
+    bool truncated = false;
+
+    if (more == true)
+    {
+        more = read_string(r, key, key_len, &truncated) && expect(r, ':');
+        if (truncated == true)
+        {
+            key[0] = '\0';
+        }
+    }
+
+    return more;
+}
+
+bool json_read_element(json_reader_t *r, bool *first)
+{
+    return next_entry(r, first, ']');
+}
+
+bool json_read_str(json_reader_t *r, char *out, size_t out_len)
+{
+    bool truncated = false;
+
+    return read_string(r, out, out_len, &truncated);
+}
+
+bool json_read_bool(json_reader_t *r, bool *out)
+{
+    bool ok = false;
+
+    if (r->ok == true)
+    {
+        skip_ws(r);
+        if (strncmp(r->p, "true", 4U) == 0)
+        {
+            *out = true;
+            r->p += 4;
+            ok = true;
+        }
+        else if (strncmp(r->p, "false", 5U) == 0)
+        {
+            *out = false;
+            r->p += 5;
+            ok = true;
+        }
+        else
+        {
+            (void)fail(r);
+        }
+    }
+
+    return ok;
+}
+
+static const char *skip_digits(const char *p)
+{
+    while ((*p >= '0') && (*p <= '9'))
+    {
+        p++;
+    }
+    return p;
+}
+
+/* -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)? */
+bool json_read_number(json_reader_t *r, const char **out_text, size_t *out_len)
+{
+    bool ok = false;
+
+    if (r->ok == true)
+    {
+        skip_ws(r);
+
+        const char *start = r->p;
+        const char *p = (*start == '-') ? &start[1] : start;
+        const char *q = skip_digits(p);
+
+        ok = (q > p) && ((*p != '0') || (q == &p[1]));
+
+        if ((ok == true) && (*q == '.'))
+        {
+            p = &q[1];
+            q = skip_digits(p);
+            ok = (q > p);
+        }
+        if ((ok == true) && ((*q == 'e') || (*q == 'E')))
+        {
+            p = ((q[1] == '+') || (q[1] == '-')) ? &q[2] : &q[1];
+            q = skip_digits(p);
+            ok = (q > p);
+        }
+
+        if (ok == true)
+        {
+            *out_text = start;
+            *out_len = (size_t)(q - start);
+            r->p = q;
+        }
+        else
+        {
+            (void)fail(r);
+        }
+    }
+
+    return ok;
+}
+
+static bool skip_value(json_reader_t *r, size_t depth)
+{
+    bool first = true;
+    char key[1];
+    const char *text = NULL;
+    size_t len = 0U;
+    bool flag = false;
+
+    if (r->ok == true)
+    {
+        skip_ws(r);
+
+        if (((*r->p == '{') || (*r->p == '[')) && (depth >= JSON_CODEC_MAX_DEPTH))
+        {
+            (void)fail(r);
+        }
+        else if (*r->p == '{')
+        {
+            r->p++;
+            while (json_read_member(r, &first, key, sizeof(key)) && skip_value(r, depth + 1U))
+            {
+            }
+        }
+        else if (*r->p == '[')
+        {
+            r->p++;
+            while (json_read_element(r, &first) && skip_value(r, depth + 1U))
+            {
+            }
+        }
+        else if (*r->p == '"')
+        {
+            (void)read_string(r, NULL, 0U, &flag);
+        }
+        else if ((*r->p == 't') || (*r->p == 'f'))
+        {
+            (void)json_read_bool(r, &flag);
+        }
+        else if (strncmp(r->p, "null", 4U) == 0)
+        {
+            r->p += 4;
+        }
+        else
+        {
+            (void)json_read_number(r, &text, &len);
+        }
+    }
+
+    return r->ok;
+}
+
+bool json_skip_value(json_reader_t *r)
+{
+    return skip_value(r, 0U);
+}
+
+bool json_read_end(json_reader_t *r)
+{
+    if (r->ok == true)
+    {
+        skip_ws(r);
+        if (*r->p != '\0')
+        {
+            (void)fail(r);
+        }
+    }
+
+    return r->ok;
+}
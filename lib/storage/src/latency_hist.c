@@ -0,0 +1,43 @@
+#include "latency_hist.h"
+
+uint32_t latency_hist_bound(size_t bucket)
+{
+    return ((bucket + 1U) < LATENCY_HIST_BUCKETS) ? (LATENCY_HIST_FIRST_BOUND_US << (2U * bucket)) : UINT32_MAX;
+}
+
+void latency_hist_add(latency_hist_t *h, uint32_t us)
+{
+    size_t bucket = 0U;
+
+    /* the last bucket takes everything, UINT32_MAX included */
+    while (((bucket + 1U) < LATENCY_HIST_BUCKETS) && (us >= latency_hist_bound(bucket)))
+    {
+        bucket++;
+    }
+
+    h->count[bucket]++;
+    h->samples++;
+    h->total_us += us;
+    h->max_us = (us > h->max_us) ? us : h->max_us;
+}
+
+uint32_t latency_hist_mean(const latency_hist_t *h)
+{
+    return (h->samples > 0U) ? (uint32_t)(h->total_us / h->samples) : 0U;
+}
+
+uint32_t latency_hist_percentile(const latency_hist_t *h, uint32_t pct)
+{
+    /* samples at or below the percentile, rounded up */
+    const uint64_t want = (((uint64_t)h->samples * pct) + 99U) / 100U;
+    uint64_t seen = 0U;
+    uint32_t bound = 0U;
+
+    for (size_t i = 0U; (h->samples > 0U) && (seen < want) && (i < LATENCY_HIST_BUCKETS); i++)
+    {
+        seen += h->count[i];
+        bound = latency_hist_bound(i);
+    }
+
+    return (bound > h->max_us) ? h->max_us : bound;
+}
@@ -0,0 +1,155 @@
+#include <string.h>
+
+#include "locations_records.h"
+
+/*
+    little endian helpers
+*/
+
+static void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)(v & 0xFFU);
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)((uint16_t)p[0] | ((uint16_t)p[1] << 8));
+}
+
+static void put_i32(uint8_t *p, int32_t v)
+{
+    const uint32_t u = (uint32_t)v;
+
+    p[0] = (uint8_t)(u & 0xFFU);
+    p[1] = (uint8_t)((u >> 8) & 0xFFU);
+    p[2] = (uint8_t)((u >> 16) & 0xFFU);
+    p[3] = (uint8_t)(u >> 24);
+}
+
+static int32_t get_i32(const uint8_t *p)
+{
+    const uint32_t u = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+
+    return (int32_t)u;
+}
+
+/*
+    record
+*/
+
+size_t locations_record_encode(const location_t *loc, uint8_t *out, size_t out_len)
+{
+    size_t len = 0U;
+
+    if ((loc != NULL) && (out != NULL))
+    {
+        const char *nul = (const char *)memchr(loc->name, '\0', sizeof(loc->name));
+        const size_t name_len = (nul != NULL) ? (size_t)(nul - loc->name) : (sizeof(loc->name) - 1U);
+
+        if ((name_len > 0U) && (out_len >= (LOCATIONS_RECORD_HEADER_LEN + name_len)))
+        {
+            put_i32(&out[0], loc->latitude_e6);
+            put_i32(&out[4], loc->longitude_e6);
+            (void)memcpy(&out[LOCATIONS_RECORD_HEADER_LEN], loc->name, name_len);
+
+            len = LOCATIONS_RECORD_HEADER_LEN + name_len;
+        }
+    }
+
+    return len;
+}
+
+bool locations_record_decode(const uint8_t *buf, size_t len, location_t *out_loc)
+{
+    bool ok = false;
+
+    if ((buf != NULL) && (out_loc != NULL) &&
+        (len > LOCATIONS_RECORD_HEADER_LEN) && (len <= LOCATIONS_RECORD_MAX_LEN))
+    {
+        const size_t name_len = len - LOCATIONS_RECORD_HEADER_LEN;
+
+        /* embedded NUL would silently shorten the name */
+        if (memchr(&buf[LOCATIONS_RECORD_HEADER_LEN], '\0', name_len) == NULL)
+        {
+            (void)memset(out_loc, 0, sizeof(*out_loc));
+
+            out_loc->latitude_e6 = get_i32(&buf[0]);
+            out_loc->longitude_e6 = get_i32(&buf[4]);
+            (void)memcpy(out_loc->name, &buf[LOCATIONS_RECORD_HEADER_LEN], name_len);
+
+            ok = true;
+        }
+    }
+
+    return ok;
+}
+
+/*
+    index
+*/
+
+size_t locations_index_measure(size_t count)
+{
+    return LOCATIONS_INDEX_HEADER_LEN + (2U * count);
+}
+
+size_t locations_index_encode(const uint16_t *ids, size_t count, uint16_t active_id, uint8_t *out, size_t out_len)
+{
+    size_t len = 0U;
+
+    if ((out != NULL) && ((ids != NULL) || (count == 0U)) && (count <= 0xFFFFU) &&
+        (out_len >= locations_index_measure(count)))
+    {
+        out[0] = (uint8_t)LOCATIONS_INDEX_VERSION;
+        out[1] = 0U;
+        put_u16(&out[2], (uint16_t)count);
+        put_u16(&out[4], active_id);
+
+        for (size_t i = 0U; i < count; i++)
+        {
+            put_u16(&out[LOCATIONS_INDEX_HEADER_LEN + (2U * i)], ids[i]);
+        }
+
+        len = locations_index_measure(count);
+    }
+
+    return len;
+}
+
+bool locations_index_decode(const uint8_t *buf, size_t len,
+                            uint16_t *out_ids, size_t max_ids, size_t *out_count,
+                            uint16_t *out_active_id)
+{
+    bool ok = false;
+
+    if ((buf != NULL) && (out_count != NULL) && (out_active_id != NULL) &&
+        (len >= LOCATIONS_INDEX_HEADER_LEN) && (buf[0] == (uint8_t)LOCATIONS_INDEX_VERSION))
+    {
+        const size_t count = (size_t)get_u16(&buf[2]);
+        const uint16_t active_id = get_u16(&buf[4]);
+
+        if ((len == locations_index_measure(count)) && (count <= max_ids) && ((out_ids != NULL) || (count == 0U)))
+        {
+            bool active_listed = (active_id == (uint16_t)LOCATIONS_INDEX_NO_ID);
+
+            for (size_t i = 0U; i < count; i++)
+            {
+                out_ids[i] = get_u16(&buf[LOCATIONS_INDEX_HEADER_LEN + (2U * i)]);
+                if (out_ids[i] == active_id)
+                {
+                    active_listed = true;
+                }
+            }
+
+            if (active_listed == true)
+            {
+                *out_count = count;
+                *out_active_id = active_id;
+                ok = true;
+            }
+        }
+    }
+
+    return ok;
+}
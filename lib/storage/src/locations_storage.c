@@ -1,182 +1,143 @@
+#include <stdlib.h>
 #include <string.h>
-#include <stdio.h>
-
-#include <cJSON.h>
 
+#include "json_codec.h"
 #include "storage_keys.h"
+#include "locations_coord.h"
 #include "locations_storage.h"
 
-static void clear_model(locations_model_t *model)
-{
-    if (model != NULL)
-    {
-        (void)memset(model, 0, sizeof(*model));
-    }
-}
+/*
+    coord kind: exact decimal text <-> microdegrees
+*/
 
-static bool read_location_object(const cJSON *obj, location_t *out_loc)
+/* exponent forms fall back to the nearest microdegree of the double, as with cJSON */
+static bool read_coord(json_reader_t *r, int32_t *out_e6)
 {
-    bool ok = false;
+    const char *text = NULL;
+    size_t len = 0U;
+    bool ok = json_read_number(r, &text, &len);
 
-    if ((obj != NULL) && (out_loc != NULL))
+    if ((ok == true) && (locations_coord_parse(text, len, out_e6) == false))
     {
-        const cJSON *j_name = cJSON_GetObjectItemCaseSensitive(obj, STORAGE_KEY_NAME);
-        const cJSON *j_lat = cJSON_GetObjectItemCaseSensitive(obj, STORAGE_KEY_LATITUDE);
-        const cJSON *j_lon = cJSON_GetObjectItemCaseSensitive(obj, STORAGE_KEY_LONGITUDE);
-        const cJSON *j_act = cJSON_GetObjectItemCaseSensitive(obj, STORAGE_KEY_IS_ACTIVE);
-
-        if (cJSON_IsString(j_name) && (j_name->valuestring != NULL) &&
-            cJSON_IsNumber(j_lat) &&
-            cJSON_IsNumber(j_lon) &&
-            (cJSON_IsBool(j_act) || (j_act == NULL)))
-        {
-            (void)memset(out_loc, 0, sizeof(*out_loc));
-
-            /* Name is bounded */
-            (void)snprintf(out_loc->name, sizeof(out_loc->name), "%s", j_name->valuestring);
-
-            out_loc->latitude = j_lat->valuedouble;
-            out_loc->longitude = j_lon->valuedouble;
+        char buf[32];
 
-            /* is_active optional -> default false */
-            out_loc->is_active = (j_act != NULL) ? cJSON_IsTrue(j_act) : false;
-
-            ok = true;
+        ok = (len < sizeof(buf));
+        if (ok == true)
+        {
+            (void)memcpy(buf, text, len);
+            buf[len] = '\0';
+            ok = locations_coord_from_double(strtod(buf, NULL), out_e6);
         }
     }
 
+    if (ok == false)
+    {
+        r->ok = false;
+    }
+
     return ok;
 }
 
+static void write_coord(json_writer_t *w, int32_t e6)
+{
+    char buf[LOCATIONS_COORD_STR_MAX];
+    const size_t len = locations_coord_format(e6, buf, sizeof(buf));
+
+    json_write_raw(w, buf, len);
+}
+
+#define JSON_READ_coord(r, f) read_coord((r), &(f))
+#define JSON_WRITE_coord(w, first, k, v, hidden) \
+    do                                           \
+    {                                            \
+        json_write_key((w), (first), k);         \
+        write_coord((w), (v));                   \
+    } while (0)
+
+JSON_CODEC_DEFINE(location, location_t, STORAGE_LOCATION_FIELDS)
+
+/*
+    list
+*/
+
 bool locations_storage_from_json(const char *json, locations_model_t *out_model)
 {
     bool return_value = false;
 
-    if ((json == NULL) || (out_model == NULL))
+    if ((json != NULL) && (out_model != NULL) && (out_model->slots != NULL))
     {
-        return_value = false;
-    }
-    else
-    {
-        cJSON *root = cJSON_Parse(json);
-        if (root == NULL)
-        {
-            return_value = false;
-        }
-        else
+        json_reader_t r;
+        char key[JSON_CODEC_KEY_MAX];
+        bool first = true;
+        bool found = false;
+        bool added = true;
+
+        locations_model_clear(out_model);
+        json_reader_init(&r, json);
+        (void)json_read_object_begin(&r);
+
+        while ((added == true) && (json_read_member(&r, &first, key, sizeof(key)) == true))
         {
-            const cJSON *arr = cJSON_GetObjectItemCaseSensitive(root, STORAGE_KEY_LOCATIONS_ARRAY);
-            if (!cJSON_IsArray(arr))
-            {
-                return_value = false;
-            }
-            else
+            if ((found == false) && (strcmp(key, STORAGE_KEY_LOCATIONS_ARRAY) == 0))
             {
-                locations_model_t tmp;
-                bool active_seen = false;
+                bool first_item = true;
 
-                clear_model(&tmp);
-                return_value = true;
-
-                const cJSON *item = NULL;
-                cJSON_ArrayForEach(item, arr)
+                found = json_read_array_begin(&r);
+                while ((added == true) && (json_read_element(&r, &first_item) == true))
                 {
-                    if (tmp.count >= LOCATIONS_MODEL_MAX_NUMBER)
-                    {
-                        return_value = false;
-                        break;
-                    }
-
                     location_t loc;
-                    if (!read_location_object(item, &loc))
-                    {
-                        return_value = false;
-                        break;
-                    }
-
-                    /* Enforce “only one active”: keep first, clear others */
-                    if (loc.is_active)
-                    {
-                        if (active_seen)
-                        {
-                            loc.is_active = false;
-                        }
-                        else
-                        {
-                            active_seen = true;
-                        }
-                    }
-
-                    /* We intentionally do NOT call locations_model_add here because:
-                       - we want to preserve stored order
-                       - we want storage to be independent from domain rules if needed
-                       If you want strict domain rules, switch to locations_model_add(&tmp,&loc). */
-                    tmp.items[tmp.count] = loc;
-                    tmp.count++;
-                }
 
-                if (return_value)
-                {
-                    *out_model = tmp;
+                    /* Appending keeps the stored order; fails on duplicate names
+                       or when the stored list exceeds the model capacity.
+                       “Only one active” is enforced by the model: first one wins. */
+                    added = location_read(&r, &loc) && locations_model_add(out_model, &loc);
                 }
             }
+            else
+            {
+                (void)json_skip_value(&r);
+            }
+        }
+
+        return_value = (added == true) && (found == true) && json_read_end(&r);
 
-            cJSON_Delete(root);
+        if (return_value == false)
+        {
+            locations_model_clear(out_model);
         }
     }
 
     return return_value;
 }
 
-size_t locations_storage_measure_json(const locations_model_t *model)
+static void write_list(json_writer_t *w, const locations_model_t *model)
 {
-    size_t needed = 0U;
+    bool first = true;
 
-    if (model != NULL)
+    json_write_lit(w, "{\"" STORAGE_KEY_LOCATIONS_ARRAY "\":[");
+    for (const location_t *loc = locations_model_first(model); loc != NULL; loc = locations_model_next(model, loc))
     {
-        /* Build JSON and measure length; simplest and reliable */
-        cJSON *root = cJSON_CreateObject();
-        cJSON *arr = cJSON_CreateArray();
-
-        if ((root != NULL) && (arr != NULL))
+        if (first == false)
         {
-            (void)cJSON_AddItemToObject(root, STORAGE_KEY_LOCATIONS_ARRAY, arr);
-
-            for (size_t i = 0U; i < model->count; i++)
-            {
-                const location_t *loc = &model->items[i];
-
-                cJSON *obj = cJSON_CreateObject();
-                if (obj == NULL)
-                {
-                    needed = 0U;
-                    break;
-                }
-
-                (void)cJSON_AddStringToObject(obj, STORAGE_KEY_NAME, loc->name);
-                (void)cJSON_AddNumberToObject(obj, STORAGE_KEY_LATITUDE, loc->latitude);
-                (void)cJSON_AddNumberToObject(obj, STORAGE_KEY_LONGITUDE, loc->longitude);
-                (void)cJSON_AddBoolToObject(obj, STORAGE_KEY_IS_ACTIVE, loc->is_active);
+            json_write_raw(w, ",", 1U);
+        }
+        first = false;
+        location_write(w, loc, false);
+    }
+    json_write_lit(w, "]}");
+}
 
-                cJSON_AddItemToArray(arr, obj);
-            }
+size_t locations_storage_measure_json(const locations_model_t *model)
+{
+    size_t needed = 0U;
 
-            char *printed = cJSON_PrintUnformatted(root);
-            if (printed != NULL)
-            {
-                needed = strlen(printed) + 1U;
-                cJSON_free(printed);
-            }
-            else
-            {
-                needed = 0U;
-            }
-        }
+    if (model != NULL)
+    {
+        json_writer_t w;
 
-        if (root != NULL)
-        {
-            cJSON_Delete(root);
-        }
+        json_writer_init(&w, NULL, 0U);
+        write_list(&w, model);
+        needed = json_writer_len(&w) + 1U;
     }
 
     return needed;
@@ -186,74 +147,50 @@ bool locations_storage_to_json(const locations_model_t *model, char *out_json, s
 {
     bool return_value = false;
 
-    if ((model == NULL) || (out_json == NULL) || (out_len == 0U))
+    if ((model != NULL) && (out_json != NULL) && (out_len > 0U))
     {
-        return_value = false;
+        json_writer_t w;
+
+        json_writer_init(&w, out_json, out_len);
+        write_list(&w, model);
+        return_value = (json_writer_len(&w) > 0U);
     }
-    else
-    {
-        cJSON *root = cJSON_CreateObject();
-        cJSON *arr = cJSON_CreateArray();
 
-        if ((root == NULL) || (arr == NULL))
-        {
-            return_value = false;
-        }
-        else
-        {
-            (void)cJSON_AddItemToObject(root, STORAGE_KEY_LOCATIONS_ARRAY, arr);
+    return return_value;
+}
 
-            return_value = true;
+/*
+    single items
+*/
 
-            for (size_t i = 0U; i < model->count; i++)
-            {
-                const location_t *loc = &model->items[i];
+size_t locations_storage_name_to_json(const char *name, char *out, size_t out_len)
+{
+    size_t len = 0U;
 
-                cJSON *obj = cJSON_CreateObject();
-                if (obj == NULL)
-                {
-                    return_value = false;
-                    break;
-                }
+    if ((name != NULL) && (out != NULL))
+    {
+        json_writer_t w;
 
-                (void)cJSON_AddStringToObject(obj, STORAGE_KEY_NAME, loc->name);
-                (void)cJSON_AddNumberToObject(obj, STORAGE_KEY_LATITUDE, loc->latitude);
-                (void)cJSON_AddNumberToObject(obj, STORAGE_KEY_LONGITUDE, loc->longitude);
-                (void)cJSON_AddBoolToObject(obj, STORAGE_KEY_IS_ACTIVE, loc->is_active);
+        json_writer_init(&w, out, out_len);
+        json_write_str(&w, name, strlen(name));
+        len = json_writer_len(&w);
+    }
 
-                cJSON_AddItemToArray(arr, obj);
-            }
+    return len;
+}
 
-            if (return_value)
-            {
-                char *printed = cJSON_PrintUnformatted(root);
-                if (printed == NULL)
-                {
-                    return_value = false;
-                }
-                else
-                {
-                    const size_t needed = strlen(printed) + 1U;
-                    if (needed > out_len)
-                    {
-                        return_value = false;
-                    }
-                    else
-                    {
-                        (void)memcpy(out_json, printed, needed);
-                        return_value = true;
-                    }
-
-                    cJSON_free(printed);
-                }
-            }
-        }
+size_t locations_storage_item_to_json(const location_t *loc, char *out, size_t out_len)
+{
+    size_t len = 0U;
 
-        if (root != NULL)
-        {
-            cJSON_Delete(root);
-        }
+    if ((loc != NULL) && (out != NULL))
+    {
+        json_writer_t w;
+
+        json_writer_init(&w, out, out_len);
+        location_write(&w, loc, false);
+        len = json_writer_len(&w);
     }
 
-    return return_value;
-}
\ No newline at end of file
+    return len;
+}
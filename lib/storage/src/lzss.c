@@ -0,0 +1,274 @@
+#include <string.h>
+
+#include "lzss.h"
+
+#define WINDOW_SIZE (1U << LZSS_WINDOW_BITS)
+#define MAX_MATCH (LZSS_MIN_MATCH + (1U << LZSS_LENGTH_BITS) - 1U)
+
+typedef struct
+{
+    uint8_t *out;
+    size_t cap;
+    size_t pos; /* bytes started */
+    uint8_t bit; /* next bit in out[pos - 1], 0: start a new byte */
+    bool ok;
+} bit_writer_t;
+
+static void put_bits(bit_writer_t *w, uint32_t value, uint8_t count)
+{
+    for (uint8_t i = count; (w->ok == true) && (i > 0U); i--)
+    {
+        if (w->bit == 0U)
+        {
+            if (w->pos == w->cap)
+            {
+                w->ok = false;
+            }
+            else
+            {
+                w->out[w->pos] = 0U;
+                w->pos++;
+                w->bit = 0x80U;
+            }
+        }
+
+        if (w->ok == true)
+        {
+            if (((value >> (i - 1U)) & 1U) != 0U)
+            {
+                w->out[w->pos - 1U] |= w->bit;
+            }
+            w->bit >>= 1U;
+        }
+    }
+}
+
+typedef struct
+{
+    const uint8_t *in;
+    size_t len;
+    size_t pos;
+    uint8_t bit;
+} bit_reader_t;
+
+/* false once the input is exhausted */
+static bool get_bits(bit_reader_t *r, uint8_t count, uint32_t *out)
+{
+    uint32_t v = 0U;
+    bool ok = true;
+
+    for (uint8_t i = 0U; (ok == true) && (i < count); i++)
+    {
+        if (r->bit == 0U)
+        {
+            r->bit = 0x80U;
+            r->pos++;
+        }
+
+        if (r->pos > r->len)
+        {
+            ok = false;
+        }
+        else
+        {
+            v = (v << 1U) | (((r->in[r->pos - 1U] & r->bit) != 0U) ? 1U : 0U);
+            r->bit >>= 1U;
+        }
+    }
+
+    *out = v;
+    return ok;
+}
+
+size_t lzss_bound(size_t len)
+{
+    return len + ((len + 7U) / 8U);
+}
+
+size_t lzss_compress(const void *in, size_t len, uint8_t *out, size_t cap)
+{
+    const uint8_t *src = (const uint8_t *)in;
+    bit_writer_t w = {out, cap, 0U, 0U, (out != NULL) || (cap == 0U)};
+    size_t i = 0U;
+
+    while ((w.ok == true) && (src != NULL) && (i < len))
+    {
+        const size_t start = (i > WINDOW_SIZE) ? (i - WINDOW_SIZE) : 0U;
+        const size_t limit = ((len - i) < MAX_MATCH) ? (len - i) : MAX_MATCH;
+        size_t best_len = 0U;
+        size_t best_dist = 0U;
+
+        /* nearest first, so equal lengths keep the shortest distance; matches may overlap i */
+        for (size_t j = i; (j > start) && (best_len < limit); j--)
+        {
+            const size_t cand = j - 1U;
+            size_t k = 0U;
+
+            while ((k < limit) && (src[cand + k] == src[i + k]))
+            {
+                k++;
+            }
+            if (k > best_len)
+            {
+                best_len = k;
+                best_dist = i - cand;
+            }
+        }
+
+        if (best_len >= LZSS_MIN_MATCH)
+        {
+            put_bits(&w, 0U, 1U);
+            put_bits(&w, (uint32_t)(best_dist - 1U), (uint8_t)LZSS_WINDOW_BITS);
+            put_bits(&w, (uint32_t)(best_len - LZSS_MIN_MATCH), (uint8_t)LZSS_LENGTH_BITS);
+            i += best_len;
+        }
+        else
+        {
+            put_bits(&w, 1U, 1U);
+            put_bits(&w, src[i], 8U);
+            i++;
+        }
+    }
+
+    return ((w.ok == true) && (src != NULL)) ? w.pos : 0U;
+}
+
+bool lzss_decompress(const uint8_t *in, size_t in_len, void *out, size_t out_len)
+{
+    uint8_t *dst = (uint8_t *)out;
+    bit_reader_t r = {in, in_len, 0U, 0U};
+    size_t n = 0U;
+    bool ok = (in != NULL) && ((dst != NULL) || (out_len == 0U));
+
+    while ((ok == true) && (n < out_len))
+    {
+        uint32_t tag = 0U;
+        uint32_t v = 0U;
+
+        ok = get_bits(&r, 1U, &tag);
+        if ((ok == true) && (tag == 1U))
+        {
+            ok = get_bits(&r, 8U, &v);
+            if (ok == true)
+            {
+                dst[n] = (uint8_t)v;
+                n++;
+            }
+        }
+        else if (ok == true)
+        {
+            uint32_t count = 0U;
+
+            ok = get_bits(&r, (uint8_t)LZSS_WINDOW_BITS, &v) && get_bits(&r, (uint8_t)LZSS_LENGTH_BITS, &count);
+
+            const size_t dist = (size_t)v + 1U;
+            const size_t copy = (size_t)count + LZSS_MIN_MATCH;
+
+            ok = ok && (dist <= n) && (copy <= (out_len - n));
+            for (size_t k = 0U; (ok == true) && (k < copy); k++)
+            {
+                dst[n] = dst[n - dist];
+                n++;
+            }
+        }
+        else
+        {
+            /* truncated stream */
+        }
+    }
+
+    /* no bytes after the one holding the last code */
+    return ok && (r.pos == in_len);
+}
+
+static void write_header(uint8_t *out, uint8_t flags, size_t len)
+{
+    out[0] = (uint8_t)'L';
+    out[1] = (uint8_t)'Z';
+    out[2] = (uint8_t)LZSS_VERSION;
+    out[3] = flags;
+    out[4] = (uint8_t)(len & 0xFFU);
+    out[5] = (uint8_t)(len >> 8U);
+}
+
+size_t lzss_pack(const void *in, size_t len, uint8_t flags, uint8_t *out, size_t cap)
+{
+    size_t total = 0U;
+
+    if ((in != NULL) && (out != NULL) && (len <= LZSS_MAX_INPUT) && (cap > LZSS_HEADER_LEN))
+    {
+        const size_t room = cap - LZSS_HEADER_LEN;
+        /* the packed value must end up smaller than len */
+        const size_t gain = (len > (LZSS_HEADER_LEN + 1U)) ? (len - LZSS_HEADER_LEN - 1U) : 0U;
+        const size_t limit = (room < gain) ? room : gain;
+        const size_t stream = (limit > 0U) ? lzss_compress(in, len, &out[LZSS_HEADER_LEN], limit) : 0U;
+
+        if (stream > 0U)
+        {
+            write_header(out, flags, len);
+            total = LZSS_HEADER_LEN + stream;
+        }
+    }
+
+    return total;
+}
+
+size_t lzss_store(const void *in, size_t len, uint8_t flags, uint8_t *out, size_t cap)
+{
+    size_t total = 0U;
+
+    if ((in != NULL) && (out != NULL) && (len > 0U) && (len <= LZSS_MAX_INPUT) && (cap >= (LZSS_HEADER_LEN + len)))
+    {
+        write_header(out, flags | LZSS_FLAG_STORED, len);
+        (void)memcpy(&out[LZSS_HEADER_LEN], in, len);
+        total = LZSS_HEADER_LEN + len;
+    }
+
+    return total;
+}
+
+bool lzss_unpack_info(const uint8_t *in, size_t in_len, size_t *out_len, uint8_t *out_flags)
+{
+    bool ok = (in != NULL) && (in_len > LZSS_HEADER_LEN) && (in[0] == (uint8_t)'L') && (in[1] == (uint8_t)'Z') &&
+              (in[2] == (uint8_t)LZSS_VERSION);
+
+    if (ok == true)
+    {
+        if (out_len != NULL)
+        {
+            *out_len = (size_t)in[4] | ((size_t)in[5] << 8U);
+        }
+        if (out_flags != NULL)
+        {
+            *out_flags = in[3];
+        }
+    }
+
+    return ok;
+}
+
+bool lzss_unpack(const uint8_t *in, size_t in_len, void *out, size_t out_len)
+{
+    size_t len = 0U;
+    uint8_t flags = 0U;
+    bool ok = lzss_unpack_info(in, in_len, &len, &flags) && (len == out_len);
+
+    if ((ok == true) && ((flags & LZSS_FLAG_STORED) != 0U))
+    {
+        ok = ((in_len - LZSS_HEADER_LEN) == out_len);
+        if (ok == true)
+        {
+            (void)memcpy(out, &in[LZSS_HEADER_LEN], out_len);
+        }
+    }
+    else if (ok == true)
+    {
+        ok = lzss_decompress(&in[LZSS_HEADER_LEN], in_len - LZSS_HEADER_LEN, out, out_len);
+    }
+    else
+    {
+        /* no container, or another length */
+    }
+
+    return ok;
+}
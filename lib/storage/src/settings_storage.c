@@ -1,60 +1,64 @@
 #include <string.h>
-#include <stdio.h>
-
-#include <cJSON.h>
 
+#include "json_codec.h"
+#include "storage_keys.h"
 #include "settings_storage.h"
 
-static const char *KEY_SSID = "ssid";
-static const char *KEY_PASS = "pass";
-static const char *KEY_PASS_LEN = "pass_len";
-
-static void clear_wifi(settings_wifi_t *s)
+/* digits only: no sign, fraction or exponent */
+static bool read_priority(json_reader_t *r, uint8_t *out)
 {
-    if (s != NULL)
+    const char *text = NULL;
+    size_t len = 0U;
+    uint32_t value = 0U;
+    bool ok = json_read_number(r, &text, &len);
+
+    for (size_t i = 0U; (ok == true) && (i < len); i++)
     {
-        (void)memset(s, 0, sizeof(*s));
+        ok = (text[i] >= '0') && (text[i] <= '9');
+        value = (ok == true) ? ((value * 10U) + (uint32_t)(text[i] - '0')) : value;
+        ok = ok && (value <= SETTINGS_WIFI_PRIORITY_MAX);
     }
-}
 
-bool settings_storage_wifi_from_json(const char *json, settings_wifi_t *out)
-{
-    bool ok = false;
-
-    if ((json == NULL) || (out == NULL))
+    if (ok == true)
     {
-        return false;
+        *out = (uint8_t)value;
     }
-
-    cJSON *root = cJSON_Parse(json);
-    if (root == NULL)
+    else
     {
-        return false;
+        r->ok = false;
     }
 
-    const cJSON *j_ssid = cJSON_GetObjectItemCaseSensitive(root, KEY_SSID);
-    const cJSON *j_pass = cJSON_GetObjectItemCaseSensitive(root, KEY_PASS);
+    return ok;
+}
 
-    if (cJSON_IsString(j_ssid) && (j_ssid->valuestring != NULL) && (j_ssid->valuestring[0] != '\0'))
+#define JSON_READ_priority(r, f) read_priority((r), &(f))
+#define JSON_WRITE_priority(w, first, k, v, hidden) \
+    do                                              \
+    {                                               \
+        json_write_key((w), (first), k);            \
+        json_write_uint((w), (unsigned long)(v));   \
+    } while (0)
+
+JSON_CODEC_DEFINE(wifi, settings_wifi_t, STORAGE_WIFI_FIELDS)
+
+bool settings_storage_wifi_from_json(const char *json, settings_wifi_t *out)
+{
+    bool ok = false;
+
+    if ((json != NULL) && (out != NULL))
     {
-        clear_wifi(out);
+        json_reader_t r;
+        settings_wifi_t tmp;
 
-        /* Bounded copy */
-        (void)snprintf(out->ssid, sizeof(out->ssid), "%s", j_ssid->valuestring);
+        json_reader_init(&r, json);
+        ok = wifi_read(&r, &tmp) && json_read_end(&r) && (tmp.ssid[0] != '\0');
 
-        if (cJSON_IsString(j_pass) && (j_pass->valuestring != NULL))
+        if (ok == true)
         {
-            (void)snprintf(out->pass, sizeof(out->pass), "%s", j_pass->valuestring);
+            *out = tmp;
         }
-        else
-        {
-            out->pass[0] = '\0';
-        }
-
-        ok = true;
     }
 
-    cJSON_Delete(root);
     return ok;
 }
 
@@ -62,35 +66,15 @@ size_t settings_storage_wifi_measure_json(const settings_wifi_t *s, bool include
 {
     size_t needed = 0U;
 
-    if (s == NULL)
-    {
-        return 0U;
-    }
-
-    cJSON *root = cJSON_CreateObject();
-    if (root == NULL)
-    {
-        return 0U;
-    }
-
-    (void)cJSON_AddStringToObject(root, KEY_SSID, s->ssid);
-    if (include_pass)
-    {
-        (void)cJSON_AddStringToObject(root, KEY_PASS, s->pass);
-    }
-    else
+    if (s != NULL)
     {
-        (void)cJSON_AddNumberToObject(root, KEY_PASS_LEN, (int)strlen(s->pass));
-    }
+        json_writer_t w;
 
-    char *printed = cJSON_PrintUnformatted(root);
-    if (printed != NULL)
-    {
-        needed = strlen(printed) + 1U;
-        cJSON_free(printed);
+        json_writer_init(&w, NULL, 0U);
+        wifi_write(&w, s, include_pass);
+        needed = json_writer_len(&w) + 1U;
     }
 
-    cJSON_Delete(root);
     return needed;
 }
 
@@ -98,40 +82,14 @@ bool settings_storage_wifi_to_json(const settings_wifi_t *s, bool include_pass,
 {
     bool ok = false;
 
-    if ((s == NULL) || (out_json == NULL) || (out_len == 0U))
-    {
-        return false;
-    }
-
-    cJSON *root = cJSON_CreateObject();
-    if (root == NULL)
+    if ((s != NULL) && (out_json != NULL) && (out_len > 0U))
     {
-        return false;
-    }
-
-    (void)cJSON_AddStringToObject(root, KEY_SSID, s->ssid);
-    if (include_pass)
-    {
-        (void)cJSON_AddStringToObject(root, KEY_PASS, s->pass);
-    }
-    else
-    {
-        (void)cJSON_AddNumberToObject(root, KEY_PASS_LEN, (int)strlen(s->pass));
-    }
-
-    char *printed = cJSON_PrintUnformatted(root);
-    if (printed != NULL)
-    {
-        const size_t needed = strlen(printed) + 1U;
-        if (needed <= out_len)
-        {
-            (void)memcpy(out_json, printed, needed);
-            ok = true;
-        }
+        json_writer_t w;
 
-        cJSON_free(printed);
+        json_writer_init(&w, out_json, out_len);
+        wifi_write(&w, s, include_pass);
+        ok = (json_writer_len(&w) > 0U);
     }
 
-    cJSON_Delete(root);
     return ok;
-}
\ No newline at end of file
+}
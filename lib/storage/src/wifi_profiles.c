@@ -0,0 +1,271 @@
+#include <string.h>
+
+#include "wifi_profiles.h"
+
+/* length of a NUL terminated string inside max bytes, max + 1 if there is no NUL */
+static size_t bounded_len(const char *s, size_t max)
+{
+    const char *nul = (const char *)memchr(s, '\0', max + 1U);
+
+    return (nul != NULL) ? (size_t)(nul - s) : (max + 1U);
+}
+
+size_t wifi_profiles_find(const wifi_profiles_t *list, const char *ssid)
+{
+    size_t i = 0U;
+
+    while ((i < list->count) && (strcmp(list->items[i].ssid, ssid) != 0))
+    {
+        i++;
+    }
+
+    return i;
+}
+
+/* rotates items[from] to items[to], shifting the ones in between */
+static void move_item(wifi_profiles_t *list, size_t from, size_t to)
+{
+    const wifi_profile_t tmp = list->items[from];
+
+    if (from < to)
+    {
+        (void)memmove(&list->items[from], &list->items[from + 1U], (to - from) * sizeof(list->items[0]));
+    }
+    else if (from > to)
+    {
+        (void)memmove(&list->items[to + 1U], &list->items[to], (from - to) * sizeof(list->items[0]));
+    }
+    else
+    {
+        /* in place */
+    }
+
+    list->items[to] = tmp;
+}
+
+bool wifi_profiles_put(wifi_profiles_t *list, const char *ssid, const char *pass, size_t pos)
+{
+    bool ok = false;
+
+    if ((list != NULL) && (ssid != NULL) && (pass != NULL))
+    {
+        const size_t ssid_len = bounded_len(ssid, SETTINGS_WIFI_SSID_MAX_LEN);
+        const size_t pass_len = bounded_len(pass, SETTINGS_WIFI_PASS_MAX_LEN);
+        size_t idx = SIZE_MAX;
+
+        if ((ssid_len > 0U) && (ssid_len <= SETTINGS_WIFI_SSID_MAX_LEN) && (pass_len <= SETTINGS_WIFI_PASS_MAX_LEN))
+        {
+            idx = wifi_profiles_find(list, ssid);
+            if (idx == list->count)
+            {
+                if (list->count < WIFI_PROFILES_MAX)
+                {
+                    (void)memset(&list->items[idx], 0, sizeof(list->items[idx]));
+                    (void)memcpy(list->items[idx].ssid, ssid, ssid_len);
+                    list->count++;
+                }
+                else
+                {
+                    idx = SIZE_MAX;
+                }
+            }
+        }
+
+        if (idx != SIZE_MAX)
+        {
+            wifi_profile_t *p = &list->items[idx];
+
+            (void)memset(p->pass, 0, sizeof(p->pass));
+            (void)memcpy(p->pass, pass, pass_len);
+            move_item(list, idx, (pos < list->count) ? pos : (list->count - 1U));
+            ok = true;
+        }
+    }
+
+    return ok;
+}
+
+bool wifi_profiles_remove(wifi_profiles_t *list, const char *ssid)
+{
+    bool ok = false;
+
+    if ((list != NULL) && (ssid != NULL))
+    {
+        const size_t idx = wifi_profiles_find(list, ssid);
+
+        if (idx < list->count)
+        {
+            move_item(list, idx, list->count - 1U);
+            list->count--;
+            (void)memset(&list->items[list->count], 0, sizeof(list->items[0])); /* no password left behind */
+            ok = true;
+        }
+    }
+
+    return ok;
+}
+
+bool wifi_profiles_set_hint(wifi_profiles_t *list, const char *ssid, const wifi_profile_hint_t *hint)
+{
+    bool changed = false;
+
+    if ((list != NULL) && (ssid != NULL) && (hint != NULL))
+    {
+        const size_t idx = wifi_profiles_find(list, ssid);
+
+        if (idx < list->count)
+        {
+            wifi_profile_hint_t *h = &list->items[idx].hint;
+
+            changed = (h->valid != hint->valid) || (h->channel != hint->channel) ||
+                      (h->authmode != hint->authmode) || (memcmp(h->bssid, hint->bssid, sizeof(h->bssid)) != 0);
+            *h = *hint;
+        }
+    }
+
+    return changed;
+}
+
+/*
+    encoding
+*/
+
+size_t wifi_profiles_encode(const wifi_profiles_t *list, uint8_t *out, size_t out_len)
+{
+    size_t len = 0U;
+    bool ok = (list != NULL) && (out != NULL) && (list->count <= WIFI_PROFILES_MAX) &&
+              (out_len >= WIFI_PROFILES_HEADER_LEN);
+
+    if (ok == true)
+    {
+        out[0] = (uint8_t)WIFI_PROFILES_VERSION;
+        out[1] = (uint8_t)list->count;
+        len = WIFI_PROFILES_HEADER_LEN;
+    }
+
+    for (size_t i = 0U; (ok == true) && (i < list->count); i++)
+    {
+        const wifi_profile_t *p = &list->items[i];
+        const size_t ssid_len = bounded_len(p->ssid, SETTINGS_WIFI_SSID_MAX_LEN);
+        const size_t pass_len = bounded_len(p->pass, SETTINGS_WIFI_PASS_MAX_LEN);
+
+        ok = (ssid_len > 0U) && (ssid_len <= SETTINGS_WIFI_SSID_MAX_LEN) &&
+             (pass_len <= SETTINGS_WIFI_PASS_MAX_LEN) &&
+             ((out_len - len) >= (WIFI_PROFILE_HEADER_LEN + ssid_len + pass_len));
+
+        if (ok == true)
+        {
+            uint8_t *q = &out[len];
+
+            q[0] = (uint8_t)ssid_len;
+            q[1] = (uint8_t)pass_len;
+            q[2] = (p->hint.valid == true) ? (uint8_t)WIFI_PROFILE_FLAG_HINT : 0U;
+            q[3] = p->hint.channel;
+            q[4] = p->hint.authmode;
+            (void)memcpy(&q[5], p->hint.bssid, WIFI_PROFILE_BSSID_LEN);
+            (void)memcpy(&q[WIFI_PROFILE_HEADER_LEN], p->ssid, ssid_len);
+            (void)memcpy(&q[WIFI_PROFILE_HEADER_LEN + ssid_len], p->pass, pass_len);
+
+            len += WIFI_PROFILE_HEADER_LEN + ssid_len + pass_len;
+        }
+    }
+
+    return (ok == true) ? len : 0U;
+}
+
+bool wifi_profiles_decode(const uint8_t *buf, size_t len, wifi_profiles_t *out)
+{
+    wifi_profiles_t tmp;
+    size_t count = 0U;
+    size_t off = WIFI_PROFILES_HEADER_LEN;
+    bool ok = (buf != NULL) && (out != NULL) && (len >= WIFI_PROFILES_HEADER_LEN) &&
+              (buf[0] == WIFI_PROFILES_VERSION) && (buf[1] <= WIFI_PROFILES_MAX);
+
+    (void)memset(&tmp, 0, sizeof(tmp));
+    if (ok == true)
+    {
+        count = buf[1];
+    }
+
+    for (size_t i = 0U; (ok == true) && (i < count); i++)
+    {
+        const uint8_t *q = &buf[off];
+        size_t ssid_len = 0U;
+        size_t pass_len = 0U;
+
+        ok = ((len - off) >= WIFI_PROFILE_HEADER_LEN);
+        if (ok == true)
+        {
+            ssid_len = q[0];
+            pass_len = q[1];
+            ok = (ssid_len > 0U) && (ssid_len <= SETTINGS_WIFI_SSID_MAX_LEN) &&
+                 (pass_len <= SETTINGS_WIFI_PASS_MAX_LEN) &&
+                 ((len - off) >= (WIFI_PROFILE_HEADER_LEN + ssid_len + pass_len));
+        }
+
+        /* embedded NULs would silently shorten the strings */
+        ok = ok && (memchr(&q[WIFI_PROFILE_HEADER_LEN], '\0', ssid_len + pass_len) == NULL);
+
+        if (ok == true)
+        {
+            wifi_profile_t *p = &tmp.items[i];
+
+            (void)memcpy(p->ssid, &q[WIFI_PROFILE_HEADER_LEN], ssid_len);
+            (void)memcpy(p->pass, &q[WIFI_PROFILE_HEADER_LEN + ssid_len], pass_len);
+            p->hint.valid = ((q[2] & WIFI_PROFILE_FLAG_HINT) != 0U);
+            p->hint.channel = q[3];
+            p->hint.authmode = q[4];
+            (void)memcpy(p->hint.bssid, &q[5], WIFI_PROFILE_BSSID_LEN);
+
+            ok = (wifi_profiles_find(&tmp, p->ssid) == i); /* tmp.count is i here */
+            tmp.count = i + 1U;
+            off += WIFI_PROFILE_HEADER_LEN + ssid_len + pass_len;
+        }
+    }
+
+    ok = ok && (off == len);
+    if (ok == true)
+    {
+        *out = tmp;
+    }
+    (void)memset(&tmp, 0, sizeof(tmp));
+
+    return ok;
+}
+
+/*
+    connect plan
+*/
+
+bool wifi_profiles_attempt(const wifi_profiles_t *list, size_t step, wifi_profiles_attempt_t *out)
+{
+    size_t left = step;
+    bool found = false;
+
+    /* fast attempts first: each one fails within one channel's dwell time */
+    for (size_t i = 0U; (found == false) && (i < list->count); i++)
+    {
+        if (list->items[i].hint.valid == true)
+        {
+            if (left == 0U)
+            {
+                out->profile = i;
+                out->fast = true;
+                found = true;
+            }
+            else
+            {
+                left--;
+            }
+        }
+    }
+
+    if ((found == false) && (left < list->count))
+    {
+        out->profile = left;
+        out->fast = false;
+        found = true;
+    }
+
+    return found;
+}
@@ -0,0 +1,182 @@
+#include <string.h>
+
+#include "write_journal.h"
+
+void write_journal_init(write_journal_t *j, void *mem, size_t mem_size)
+{
+    (void)memset(j, 0, sizeof(*j));
+    j->mem = (uint8_t *)mem;
+    j->mem_size = (mem != NULL) ? mem_size : 0U;
+}
+
+/* newest entry of key, count if none */
+static size_t find(const write_journal_t *j, const char *key)
+{
+    size_t idx = j->count;
+
+    for (size_t i = j->count; (idx == j->count) && (i > 0U); i--)
+    {
+        if (strcmp(j->entries[i - 1U].key, key) == 0)
+        {
+            idx = i - 1U;
+        }
+    }
+
+    return idx;
+}
+
+/* drops entry idx and closes the gap in mem */
+static void remove_entry(write_journal_t *j, size_t idx)
+{
+    const write_journal_entry_t *e = &j->entries[idx];
+    const size_t off = e->off;
+    const size_t len = e->len;
+
+    if (len > 0U)
+    {
+        (void)memmove(&j->mem[off], &j->mem[off + len], j->mem_used - off - len);
+        j->mem_used -= len;
+    }
+
+    for (size_t i = idx; (i + 1U) < j->count; i++)
+    {
+        j->entries[i] = j->entries[i + 1U];
+    }
+    j->count--;
+
+    for (size_t i = 0U; i < j->count; i++)
+    {
+        if (j->entries[i].off > off)
+        {
+            j->entries[i].off -= len;
+        }
+    }
+}
+
+bool write_journal_put(write_journal_t *j, const char *key, write_journal_kind_t kind, const void *data, size_t len)
+{
+    bool ok = false;
+
+    if ((j != NULL) && (key != NULL) && (strlen(key) < WRITE_JOURNAL_KEY_MAX) &&
+        ((kind == WRITE_JOURNAL_ERASE) || (data != NULL) || (len == 0U)))
+    {
+        const size_t n = (kind == WRITE_JOURNAL_ERASE) ? 0U : len;
+        /* only the newest entry may collapse: replacing an older one would reorder it */
+        const size_t last = (j->count > 0U) ? (j->count - 1U) : 0U;
+        const bool replace = (j->count > 0U) && (strcmp(j->entries[last].key, key) == 0);
+        const size_t freed = replace ? j->entries[last].len : 0U;
+        const size_t slots = replace ? last : j->count;
+
+        if ((slots < WRITE_JOURNAL_MAX_ENTRIES) && (n <= ((j->mem_size - j->mem_used) + freed)))
+        {
+            if (replace == true)
+            {
+                remove_entry(j, last);
+                j->stats.coalesced++;
+            }
+
+            write_journal_entry_t *e = &j->entries[j->count];
+            (void)strcpy(e->key, key);
+            e->kind = kind;
+            e->off = j->mem_used;
+            e->len = n;
+            if (n > 0U)
+            {
+                (void)memcpy(&j->mem[j->mem_used], data, n);
+                j->mem_used += n;
+            }
+            j->count++;
+            j->stats.puts++;
+            ok = true;
+        }
+    }
+
+    return ok;
+}
+
+bool write_journal_get(const write_journal_t *j, const char *key, write_journal_kind_t *out_kind, const void **out_data,
+                       size_t *out_len)
+{
+    bool found = false;
+
+    if ((j != NULL) && (key != NULL))
+    {
+        const size_t idx = find(j, key);
+
+        if (idx < j->count)
+        {
+            const write_journal_entry_t *e = &j->entries[idx];
+
+            if (out_kind != NULL)
+            {
+                *out_kind = e->kind;
+            }
+            if (out_data != NULL)
+            {
+                *out_data = &j->mem[e->off];
+            }
+            if (out_len != NULL)
+            {
+                *out_len = e->len;
+            }
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+size_t write_journal_pending(const write_journal_t *j)
+{
+    return (j != NULL) ? j->count : 0U;
+}
+
+int write_journal_flush(write_journal_t *j, const write_journal_backend_t *backend)
+{
+    int err = 0;
+
+    if ((j != NULL) && (backend != NULL) && (j->count > 0U))
+    {
+        size_t applied = 0U;
+
+        j->stats.flushes++;
+
+        while ((err == 0) && (applied < j->count))
+        {
+            const write_journal_entry_t *e = &j->entries[applied];
+
+            err = backend->apply(backend->ctx, e->key, e->kind, &j->mem[e->off], e->len);
+            if (err == 0)
+            {
+                applied++;
+            }
+        }
+
+        /* applied entries are already in the backend: commit them even if a later one failed */
+        int commit_err = 0;
+        if (applied > 0U)
+        {
+            commit_err = backend->commit(backend->ctx);
+            j->stats.commits++;
+        }
+
+        if (commit_err != 0)
+        {
+            /* unknown what reached the store: keep everything, a retry re-applies in the same order */
+            applied = 0U;
+            err = (err == 0) ? commit_err : err;
+        }
+
+        if (err != 0)
+        {
+            j->stats.failures++;
+        }
+
+        for (size_t i = 0U; i < applied; i++)
+        {
+            remove_entry(j, 0U);
+        }
+    }
+
+    return err;
+}
@@ -0,0 +1,106 @@
+#include "app/app_buf_pool.h"
+
+#include <stdbool.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_log.h"
+
+static const char *TAG = "buf_pool";
+
+// small: request bodies, stream chunks; medium: batch bodies, stored JSON;
+// large: upstream weather responses, batch op arrays
+#define APP_BUF_SMALL_COUNT 4
+#define APP_BUF_MEDIUM_COUNT 2
+#define APP_BUF_LARGE_COUNT 1
+
+// word aligned so blocks can hold structs (batch ops)
+static uint32_t s_small[APP_BUF_SMALL_COUNT][APP_BUF_SMALL / sizeof(uint32_t)];
+static uint32_t s_medium[APP_BUF_MEDIUM_COUNT][APP_BUF_MEDIUM / sizeof(uint32_t)];
+static uint32_t s_large[APP_BUF_LARGE_COUNT][APP_BUF_LARGE / sizeof(uint32_t)];
+
+static buf_pool_t s_pool;
+static bool s_ready = false;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+void app_buf_pool_init(void)
+{
+    if (s_ready)
+        return;
+
+    buf_pool_init(&s_pool);
+    (void)buf_pool_add_class(&s_pool, s_small, APP_BUF_SMALL, APP_BUF_SMALL_COUNT);
+    (void)buf_pool_add_class(&s_pool, s_medium, APP_BUF_MEDIUM, APP_BUF_MEDIUM_COUNT);
+    (void)buf_pool_add_class(&s_pool, s_large, APP_BUF_LARGE, APP_BUF_LARGE_COUNT);
+    s_ready = true;
+
+    ESP_LOGI(TAG, "%u bytes in %u classes",
+             (unsigned)(sizeof(s_small) + sizeof(s_medium) + sizeof(s_large)), (unsigned)s_pool.class_count);
+}
+
+void *app_buf_borrow_labeled(size_t size, const char *label)
+{
+    if (!s_ready)
+        return NULL;
+
+    portENTER_CRITICAL(&s_lock);
+    void *buf = buf_pool_borrow(&s_pool, size, xTaskGetCurrentTaskHandle(), label);
+    portEXIT_CRITICAL(&s_lock);
+
+    if (!buf)
+        ESP_LOGW(TAG, "%s: no free buffer for %u bytes", label, (unsigned)size);
+
+    return buf;
+}
+
+void app_buf_return(void *buf)
+{
+    if (!buf)
+        return;
+
+    portENTER_CRITICAL(&s_lock);
+    const bool ok = buf_pool_return(&s_pool, buf);
+    portEXIT_CRITICAL(&s_lock);
+
+    if (!ok)
+        ESP_LOGE(TAG, "return of %p: not a borrowed pool buffer", buf);
+}
+
+static void log_leak(const char *label, size_t block_size, void *ctx)
+{
+    ESP_LOGE(TAG, "%s: %u-byte buffer from %s not returned",
+             (const char *)ctx, (unsigned)block_size, label ? label : "?");
+}
+
+size_t app_buf_pool_check_leaks(const char *where)
+{
+    // the visitor only logs, but logging inside a critical section is not allowed
+    buf_pool_t copy;
+    portENTER_CRITICAL(&s_lock);
+    copy = s_pool;
+    portEXIT_CRITICAL(&s_lock);
+
+    return buf_pool_outstanding(&copy, xTaskGetCurrentTaskHandle(), log_leak, (void *)where);
+}
+
+size_t app_buf_pool_stats(app_buf_class_stats_t *out, size_t max)
+{
+    portENTER_CRITICAL(&s_lock);
+    const size_t n = s_pool.class_count;
+    for (size_t i = 0; out && i < n && i < max; i++)
+    {
+        const buf_pool_class_t *c = &s_pool.cls[i];
+        out[i] = (app_buf_class_stats_t){
+            .block_size = c->block_size,
+            .count = (uint16_t)c->count,
+            .in_use = c->in_use,
+            .peak = c->peak,
+            .borrows = c->borrows,
+            .misses = c->misses,
+        };
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    return n;
+}
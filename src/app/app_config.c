@@ -0,0 +1,340 @@
+#include "app/app_config.h"
+#include "app/app_settings_persistence.h"
+#include "app/nvs_helpers.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "nvs.h"
+#include "esp_log.h"
+
+static const char *TAG = "app_config";
+
+#define APP_CONFIG_DEF_(id, name, nvs_key, type, min, max, def_num, def_str, flags) \
+    [id] = {name, nvs_key, type, min, max, def_num, def_str, flags},
+
+static const config_def_t s_defs[APP_CONFIG_COUNT] = {APP_CONFIG_KEYS(APP_CONFIG_DEF_)};
+
+static const config_registry_t s_registry = {s_defs, APP_CONFIG_COUNT};
+
+// group members outside the registry: carried over by every write until dropped
+static const char *const s_legacy_keys[] = {APP_CONFIG_NVS_WIFI_SSID, APP_CONFIG_NVS_WIFI_PASS};
+#define LEGACY_COUNT (sizeof(s_legacy_keys) / sizeof(s_legacy_keys[0]))
+#define GROUP_COUNT (APP_CONFIG_COUNT + LEGACY_COUNT)
+
+// NULL for registry keys outside the group (WiFi profile)
+static const char *group_key(size_t k)
+{
+    return (k < APP_CONFIG_COUNT) ? s_defs[k].nvs_key : s_legacy_keys[k - APP_CONFIG_COUNT];
+}
+
+static bool is_profile_key(size_t key)
+{
+    return key < APP_CONFIG_COUNT && s_defs[key].nvs_key == NULL;
+}
+
+const config_registry_t *app_config_registry(void)
+{
+    return &s_registry;
+}
+
+// stored value or default; other NVS errors are returned
+static esp_err_t read_one(uint32_t gen, size_t key, config_value_t *out)
+{
+    char text[CONFIG_VALUE_STR_MAX + 1];
+    size_t len = sizeof(text);
+
+    esp_err_t err = nvs_cfg_txn_get_str(gen, s_defs[key].nvs_key, text, &len);
+    if (err == ESP_OK && config_registry_parse_text(&s_registry, key, text, out))
+        return ESP_OK;
+
+    if (err == ESP_OK || err == ESP_ERR_NVS_INVALID_LENGTH)
+        ESP_LOGW(TAG, "stored %s invalid, using default", s_defs[key].name);
+    else if (err != ESP_ERR_NVS_NOT_FOUND)
+        return err;
+
+    config_registry_default(&s_registry, key, out);
+    return ESP_OK;
+}
+
+esp_err_t app_config_get_many(config_entry_t *entries, size_t count)
+{
+    if (!entries && count > 0)
+        return ESP_ERR_INVALID_ARG;
+
+    uint32_t gen = 0;
+    settings_wifi_t wifi;
+    bool wifi_read = false;
+
+    // every key from the same generation
+    nvs_cfg_lock();
+    esp_err_t err = nvs_cfg_txn_generation(APP_CONFIG_NVS_GROUP, &gen);
+    for (size_t i = 0; err == ESP_OK && i < count; i++)
+    {
+        const size_t key = entries[i].key;
+        if (key >= APP_CONFIG_COUNT)
+        {
+            err = ESP_ERR_INVALID_ARG;
+        }
+        else if (is_profile_key(key))
+        {
+            // no profile saved: both read as their default ""
+            if (!wifi_read)
+            {
+                err = app_settings_load_wifi(&wifi);
+                if (err == ESP_ERR_NOT_FOUND)
+                    err = ESP_OK;
+                wifi_read = true;
+            }
+            memset(&entries[i].value, 0, sizeof(entries[i].value));
+            snprintf(entries[i].value.str, sizeof(entries[i].value.str), "%s",
+                     (key == APP_CONFIG_WIFI_SSID) ? wifi.ssid : wifi.pass);
+        }
+        else
+        {
+            err = read_one(gen, key, &entries[i].value);
+        }
+    }
+    nvs_cfg_unlock();
+
+    memset(&wifi, 0, sizeof(wifi));
+    return err;
+}
+
+static void apply_log_level(uint32_t level)
+{
+    esp_log_level_set("*", (esp_log_level_t)level);
+}
+
+// The group is written whole: stored text of the keys not named, set's values
+// formatted, erase's keys (and with drop_legacy the legacy keys) left out.
+// Entries are validated by the caller.
+static esp_err_t write_group(const config_entry_t *set, size_t set_count, const app_config_key_t *erase,
+                             size_t erase_count, bool drop_legacy)
+{
+    char text[GROUP_COUNT][CONFIG_VALUE_STR_MAX + 1];
+    bool present[GROUP_COUNT];
+    uint32_t gen = 0;
+
+    nvs_cfg_lock();
+    esp_err_t err = nvs_cfg_txn_generation(APP_CONFIG_NVS_GROUP, &gen);
+
+    for (size_t k = 0; err == ESP_OK && k < GROUP_COUNT; k++)
+    {
+        size_t len = sizeof(text[k]);
+        const esp_err_t e = group_key(k) ? nvs_cfg_txn_get_str(gen, group_key(k), text[k], &len)
+                                         : ESP_ERR_NVS_NOT_FOUND;
+
+        // an unreadable (too long) value reads as the default, so it is dropped like a missing one
+        present[k] = (e == ESP_OK);
+        if (e != ESP_OK && e != ESP_ERR_NVS_NOT_FOUND && e != ESP_ERR_NVS_INVALID_LENGTH)
+            err = e;
+    }
+
+    for (size_t i = 0; i < set_count; i++)
+    {
+        if (is_profile_key(set[i].key))
+            continue;
+        // an empty string is a valid value (e.g. open network password); format returns 0 for it
+        (void)config_registry_format_text(&s_registry, set[i].key, &set[i].value, text[set[i].key],
+                                          sizeof(text[0]));
+        present[set[i].key] = true;
+    }
+    for (size_t i = 0; i < erase_count; i++)
+        present[erase[i]] = false;
+    for (size_t k = APP_CONFIG_COUNT; drop_legacy && k < GROUP_COUNT; k++)
+        present[k] = false;
+
+    ab_txn_item_t items[GROUP_COUNT];
+    size_t n = 0;
+    for (size_t k = 0; k < GROUP_COUNT; k++)
+    {
+        if (!group_key(k))
+            continue;
+        items[n++] = (ab_txn_item_t){
+            .key = group_key(k),
+            .kind = present[k] ? WRITE_JOURNAL_STR : WRITE_JOURNAL_ERASE,
+            .data = present[k] ? text[k] : NULL,
+            .len = present[k] ? strlen(text[k]) + 1 : 0,
+        };
+    }
+
+    if (err == ESP_OK)
+        err = nvs_cfg_txn_write(APP_CONFIG_NVS_GROUP, items, n);
+    nvs_cfg_unlock();
+
+    memset(text, 0, sizeof(text)); // legacy password
+    return err;
+}
+
+// wifi.ssid / wifi.pass of set onto the highest priority profile: a new SSID
+// keeps the password it was saved with (or the current one if it is new)
+static esp_err_t write_profile(const config_entry_t *set, size_t set_count)
+{
+    const config_value_t *ssid = NULL;
+    const config_value_t *pass = NULL;
+    for (size_t i = 0; i < set_count; i++)
+    {
+        if (set[i].key == APP_CONFIG_WIFI_SSID)
+            ssid = &set[i].value;
+        else if (set[i].key == APP_CONFIG_WIFI_PASS)
+            pass = &set[i].value;
+    }
+    if (!ssid && !pass)
+        return ESP_OK;
+
+    settings_wifi_t wifi;
+    esp_err_t err = app_settings_load_wifi(&wifi);
+    if (err == ESP_ERR_NOT_FOUND)
+        err = ESP_OK;
+
+    if (err == ESP_OK && ssid && strcmp(ssid->str, wifi.ssid) != 0)
+    {
+        wifi_profiles_t list = {.count = 0};
+        size_t at = WIFI_PROFILES_MAX;
+        if (app_settings_load_wifi_profiles(&list) == ESP_OK)
+            at = wifi_profiles_find(&list, ssid->str);
+        if (at < list.count)
+            snprintf(wifi.pass, sizeof(wifi.pass), "%s", list.items[at].pass);
+        snprintf(wifi.ssid, sizeof(wifi.ssid), "%s", ssid->str);
+        memset(&list, 0, sizeof(list));
+    }
+    if (err == ESP_OK && pass)
+        snprintf(wifi.pass, sizeof(wifi.pass), "%s", pass->str);
+
+    if (err == ESP_OK)
+        err = (wifi.ssid[0] != '\0') ? app_settings_save_wifi(&wifi) : ESP_ERR_INVALID_ARG;
+
+    memset(&wifi, 0, sizeof(wifi));
+    return err;
+}
+
+esp_err_t app_config_set_many(const config_entry_t *entries, size_t count)
+{
+    if (!entries && count > 0)
+        return ESP_ERR_INVALID_ARG;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!config_registry_validate(&s_registry, entries[i].key, &entries[i].value))
+            return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t err = write_profile(entries, count);
+    if (err == ESP_OK)
+        err = write_group(entries, count, NULL, 0, false);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "set failed: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (entries[i].key == APP_CONFIG_LOG_LEVEL)
+            apply_log_level(entries[i].value.num);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t app_config_erase_many(const app_config_key_t *keys, size_t count)
+{
+    if (!keys && count > 0)
+        return ESP_ERR_INVALID_ARG;
+
+    bool log_touched = false;
+    bool ssid_erased = false;
+    bool pass_erased = false;
+    for (size_t i = 0; i < count; i++)
+    {
+        if ((size_t)keys[i] >= APP_CONFIG_COUNT)
+            return ESP_ERR_INVALID_ARG;
+        log_touched |= (keys[i] == APP_CONFIG_LOG_LEVEL);
+        ssid_erased |= (keys[i] == APP_CONFIG_WIFI_SSID);
+        pass_erased |= (keys[i] == APP_CONFIG_WIFI_PASS);
+    }
+
+    settings_wifi_t wifi;
+    esp_err_t err = (ssid_erased || pass_erased) ? app_settings_load_wifi(&wifi) : ESP_ERR_NOT_FOUND;
+    if (err == ESP_OK && ssid_erased)
+    {
+        err = app_settings_remove_wifi(wifi.ssid);
+    }
+    else if (err == ESP_OK)
+    {
+        wifi.pass[0] = '\0';
+        err = app_settings_save_wifi(&wifi);
+    }
+    memset(&wifi, 0, sizeof(wifi));
+
+    // nothing saved is already erased
+    if (err == ESP_ERR_NOT_FOUND)
+        err = ESP_OK;
+    if (err == ESP_OK)
+        err = write_group(NULL, 0, keys, count, false);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "erase failed: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    if (log_touched)
+    {
+        config_value_t def;
+        config_registry_default(&s_registry, APP_CONFIG_LOG_LEVEL, &def);
+        apply_log_level(def.num);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t app_config_get_legacy_wifi(settings_wifi_t *out)
+{
+    if (!out)
+        return ESP_ERR_INVALID_ARG;
+
+    memset(out, 0, sizeof(*out));
+    size_t ssid_len = sizeof(out->ssid);
+    size_t pass_len = sizeof(out->pass);
+    uint32_t gen = 0;
+
+    // both keys from one generation
+    nvs_cfg_lock();
+    esp_err_t err = nvs_cfg_txn_generation(APP_CONFIG_NVS_GROUP, &gen);
+    if (err == ESP_OK)
+        err = nvs_cfg_txn_get_str(gen, APP_CONFIG_NVS_WIFI_SSID, out->ssid, &ssid_len);
+    if (err == ESP_OK)
+    {
+        err = nvs_cfg_txn_get_str(gen, APP_CONFIG_NVS_WIFI_PASS, out->pass, &pass_len);
+        if (err == ESP_ERR_NVS_NOT_FOUND) // open network
+            err = ESP_OK;
+    }
+    nvs_cfg_unlock();
+
+    if (err == ESP_OK && out->ssid[0] == '\0')
+        err = ESP_ERR_NVS_NOT_FOUND;
+    if (err != ESP_OK)
+        memset(out, 0, sizeof(*out));
+    return (err == ESP_ERR_NVS_NOT_FOUND) ? ESP_ERR_NOT_FOUND : err;
+}
+
+esp_err_t app_config_drop_legacy_wifi(void)
+{
+    const esp_err_t err = write_group(NULL, 0, NULL, 0, true);
+    if (err != ESP_OK)
+        ESP_LOGE(TAG, "dropping legacy WiFi keys failed: %s", esp_err_to_name(err));
+    return err;
+}
+
+void app_config_init(void)
+{
+    config_entry_t e = {.key = APP_CONFIG_LOG_LEVEL};
+
+    if (app_config_get_many(&e, 1) == ESP_OK)
+    {
+        apply_log_level(e.value.num);
+        ESP_LOGI(TAG, "log level %u", (unsigned)e.value.num);
+    }
+}
@@ -0,0 +1,54 @@
+#include "app/app_gazetteer.h"
+
+#include <stdbool.h>
+
+#include "esp_log.h"
+#include "esp_partition.h"
+
+static const char *TAG = "app_gazetteer";
+
+#define GAZETTEER_PARTITION_LABEL "gazetteer"
+
+static gazetteer_t s_gz;
+static bool s_ready = false;
+
+esp_err_t app_gazetteer_init(void)
+{
+    if (s_ready)
+        return ESP_OK;
+
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                                           GAZETTEER_PARTITION_LABEL);
+    if (!part)
+    {
+        ESP_LOGW(TAG, "no '%s' partition, place search disabled", GAZETTEER_PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // mapping stays for the lifetime of the firmware, so the handle is never unmapped
+    const void *image = NULL;
+    esp_partition_mmap_handle_t handle;
+    esp_err_t err = esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &image, &handle);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "mmap failed: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    // erased flash (no image flashed) fails the magic check
+    if (!gazetteer_open(&s_gz, image, part->size))
+    {
+        esp_partition_munmap(handle);
+        ESP_LOGW(TAG, "partition holds no valid gazetteer image");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    s_ready = true;
+    ESP_LOGI(TAG, "mapped %u places", (unsigned)s_gz.count);
+    return ESP_OK;
+}
+
+const gazetteer_t *app_gazetteer_get(void)
+{
+    return s_ready ? &s_gz : NULL;
+}
@@ -0,0 +1,95 @@
+#include "app/app_json_arena.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_log.h"
+#include <cJSON.h>
+
+#include "core_config.h"
+#include "json_arena.h"
+
+static const char *TAG = "json_arena";
+
+static uint8_t s_buf[CORE_JSON_ARENA_SIZE];
+static json_arena_t s_arena;
+
+// only the owner task bumps the arena; the owner is set and cleared by itself,
+// so other tasks reading a stale value can never mistake it for their own handle
+static TaskHandle_t s_owner = NULL;
+static unsigned s_depth = 0;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void *arena_malloc(size_t size)
+{
+    void *ptr = NULL;
+
+    if (s_owner == xTaskGetCurrentTaskHandle())
+        ptr = json_arena_alloc(&s_arena, size);
+
+    return ptr ? ptr : malloc(size);
+}
+
+static void arena_free(void *ptr)
+{
+    if (json_arena_owns(&s_arena, ptr))
+        json_arena_free(&s_arena, ptr);
+    else
+        free(ptr);
+}
+
+void app_json_arena_init(void)
+{
+    json_arena_init(&s_arena, s_buf, sizeof(s_buf));
+
+    cJSON_Hooks hooks = {.malloc_fn = arena_malloc, .free_fn = arena_free};
+    cJSON_InitHooks(&hooks);
+
+    ESP_LOGI(TAG, "cJSON arena %u bytes", (unsigned)sizeof(s_buf));
+}
+
+void app_json_arena_enter(void)
+{
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+
+    portENTER_CRITICAL(&s_lock);
+    if (s_owner == NULL)
+        s_owner = self;
+    if (s_owner == self)
+        s_depth++;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void app_json_arena_leave(void)
+{
+    if (s_owner != xTaskGetCurrentTaskHandle())
+        return;
+
+    if (--s_depth > 0)
+        return;
+
+    const size_t used = s_arena.used;
+    const size_t peak = s_arena.high_water;
+    json_arena_reset(&s_arena);
+
+    portENTER_CRITICAL(&s_lock);
+    s_owner = NULL;
+    portEXIT_CRITICAL(&s_lock);
+
+    // `used` is what was left at the end; peak only moves when a scope set a new record
+    ESP_LOGD(TAG, "scope done: %u bytes left, peak %u / %u, overflows %u",
+             (unsigned)used, (unsigned)peak, (unsigned)s_arena.size, (unsigned)s_arena.overflows);
+}
+
+void app_json_arena_stats(app_json_arena_stats_t *out)
+{
+    if (!out)
+        return;
+
+    out->size = s_arena.size;
+    out->high_water = s_arena.high_water;
+    out->overflows = s_arena.overflows;
+}
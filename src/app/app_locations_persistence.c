@@ -1,49 +1,358 @@
 #include "app/app_locations_persistence.h"
+#include "app/app_buf_pool.h"
 #include "app/nvs_helpers.h"
+#include "locations_records.h"
 #include "locations_storage.h"
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define NVS_KEY_LOCATIONS "locations"
-#define NVS_JSON_MAX_LEN 2048
+#include "nvs.h"
+#include "esp_log.h"
 
-esp_err_t app_locations_load(locations_model_t *out)
+static const char *TAG = "app_locations";
+
+typedef struct
+{
+    uint16_t *ids;
+    location_t *locs;
+    size_t count;
+    uint16_t active_id;
+} stored_list_t;
+
+static void record_key(uint16_t id, char key[16])
+{
+    snprintf(key, 16, NVS_KEY_LOC_RECORD_FMT, (unsigned)id);
+}
+
+static void stored_list_free(stored_list_t *list)
+{
+    free(list->ids);
+    free(list->locs);
+    memset(list, 0, sizeof(*list));
+}
+
+// reads index and records; ESP_ERR_NOT_FOUND if there is no index
+static esp_err_t stored_list_read(size_t max_count, stored_list_t *out)
 {
-    if (!out)
-        return ESP_ERR_INVALID_ARG;
     memset(out, 0, sizeof(*out));
+    out->active_id = LOCATIONS_INDEX_NO_ID;
+
+    size_t len = 0;
+    esp_err_t err = nvs_cfg_get_blob(NVS_KEY_LOC_INDEX, NULL, &len);
+    if (err == ESP_ERR_NVS_NOT_FOUND)
+        return ESP_ERR_NOT_FOUND;
+    if (err != ESP_OK)
+        return err;
+
+    uint8_t *buf = malloc(len);
+    out->ids = calloc(max_count + 1, sizeof(uint16_t));
+    out->locs = calloc(max_count + 1, sizeof(location_t));
+    if (!buf || !out->ids || !out->locs)
+    {
+        free(buf);
+        stored_list_free(out);
+        return ESP_ERR_NO_MEM;
+    }
+
+    err = nvs_cfg_get_blob(NVS_KEY_LOC_INDEX, buf, &len);
+    if (err == ESP_OK && !locations_index_decode(buf, len, out->ids, max_count, &out->count, &out->active_id))
+        err = ESP_FAIL;
+    free(buf);
+
+    for (size_t i = 0; err == ESP_OK && i < out->count; i++)
+    {
+        char key[16];
+        uint8_t rec[LOCATIONS_RECORD_MAX_LEN];
+        size_t rec_len = sizeof(rec);
+
+        record_key(out->ids[i], key);
+        err = nvs_cfg_get_blob(key, rec, &rec_len);
+        if (err == ESP_OK && !locations_record_decode(rec, rec_len, &out->locs[i]))
+            err = ESP_FAIL;
+    }
+
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "stored list unreadable: %s", esp_err_to_name(err));
+        stored_list_free(out);
+    }
 
-    char *buf = calloc(1, NVS_JSON_MAX_LEN);
+    return err;
+}
+
+static esp_err_t load_legacy_json(locations_model_t *out)
+{
+    // buffer sized to the stored value, so it grows with the model capacity
+    size_t len = 0;
+    esp_err_t err = nvs_json_len(NVS_KEY_LOCATIONS, &len);
+    if (err != ESP_OK)
+        return err;
+
+    // one-time migration: pool block if it fits, heap otherwise
+    char *buf = app_buf_borrow(len);
+    const bool pooled = (buf != NULL);
+    if (!pooled)
+        buf = calloc(1, len);
     if (!buf)
         return ESP_ERR_NO_MEM;
 
-    esp_err_t err = nvs_load_json(NVS_KEY_LOCATIONS, buf, NVS_JSON_MAX_LEN);
+    err = nvs_load_json(NVS_KEY_LOCATIONS, buf, len);
     if (err == ESP_OK)
         err = locations_storage_from_json(buf, out) ? ESP_OK : ESP_FAIL;
 
-    free(buf);
+    if (pooled)
+        app_buf_return(buf);
+    else
+        free(buf);
     return err;
 }
 
-esp_err_t app_locations_save(const locations_model_t *in)
+// ids come from alloc_id below this bound; ids of an older firmware did too
+static size_t id_bits_for(size_t capacity)
+{
+    return 3 * capacity + 1;
+}
+
+static bool id_marked(const uint8_t *bits_map, size_t bits, uint16_t id)
+{
+    return id < bits && (bits_map[id / 8] & (1U << (id % 8))) != 0;
+}
+
+static void mark_id(uint8_t *used, size_t bits, uint16_t id)
+{
+    if (id < bits)
+        used[id / 8] |= (uint8_t)(1U << (id % 8));
+}
+
+// lowest id the stored index does not name; the journal keeps write order, so
+// every index before this save's one on flash stays pointing at what it wrote.
+// With at most two model's worth of ids in use one is always free.
+static uint16_t alloc_id(uint8_t *used, size_t bits)
+{
+    for (size_t id = 0; id < bits; id++)
+    {
+        if (!id_marked(used, bits, (uint16_t)id))
+        {
+            mark_id(used, bits, (uint16_t)id);
+            return (uint16_t)id;
+        }
+    }
+    return LOCATIONS_INDEX_NO_ID;
+}
+
+bool app_locations_stored_init(app_locations_stored_t *stored, size_t capacity)
 {
-    if (!in)
+    memset(stored, 0, sizeof(*stored));
+    stored->id_bits = id_bits_for(capacity);
+    stored->active_id = LOCATIONS_INDEX_NO_ID;
+    stored->ids = calloc(capacity, sizeof(uint16_t));
+    if (!stored->ids || !locations_model_init(&stored->model, capacity))
+    {
+        app_locations_stored_deinit(stored);
+        return false;
+    }
+    return true;
+}
+
+void app_locations_stored_deinit(app_locations_stored_t *stored)
+{
+    if (stored->model.slots)
+        locations_model_deinit(&stored->model);
+    free(stored->ids);
+    memset(stored, 0, sizeof(*stored));
+}
+
+esp_err_t app_locations_load(locations_model_t *out, app_locations_stored_t *stored)
+{
+    if (!out || !out->slots || !stored || stored->model.capacity != out->capacity)
         return ESP_ERR_INVALID_ARG;
+    locations_model_clear(out);
+    locations_model_clear(&stored->model);
+    stored->active_id = LOCATIONS_INDEX_NO_ID;
+    stored->valid = false;
 
-    char *buf = calloc(1, NVS_JSON_MAX_LEN);
-    if (!buf)
-        return ESP_ERR_NO_MEM;
+    // index and records from one state
+    stored_list_t list;
+    nvs_cfg_lock();
+    esp_err_t err = stored_list_read(out->capacity, &list);
+    nvs_cfg_unlock();
 
-    esp_err_t err = ESP_FAIL;
-    if (locations_storage_to_json(in, buf, NVS_JSON_MAX_LEN))
-        err = nvs_save_json(NVS_KEY_LOCATIONS, buf);
+    if (err == ESP_ERR_NOT_FOUND)
+    {
+        // nothing in the record layout yet: the first save writes every record
+        err = load_legacy_json(out);
+        stored->valid = (err == ESP_OK || err == ESP_ERR_NOT_FOUND);
+        return err;
+    }
+    if (err != ESP_OK)
+        return err;
 
-    free(buf);
+    for (size_t i = 0; err == ESP_OK && i < list.count; i++)
+    {
+        list.locs[i].is_active = (list.ids[i] == list.active_id);
+        const location_t *added = locations_model_add(out, &list.locs[i]) ? locations_model_find(out, list.locs[i].name)
+                                                                          : NULL;
+        if (added)
+            stored->ids[locations_model_handle(out, added).slot] = list.ids[i];
+        else
+            err = ESP_FAIL;
+    }
+
+    if (err == ESP_OK && locations_model_copy(&stored->model, out))
+    {
+        stored->active_id = list.active_id;
+        stored->valid = true;
+    }
+    else
+    {
+        err = ESP_FAIL;
+        locations_model_clear(out);
+        locations_model_clear(&stored->model);
+    }
+
+    stored_list_free(&list);
     return err;
 }
 
-esp_err_t app_locations_clear(void)
+static bool same_location(const location_t *a, const location_t *b)
+{
+    return strcmp(a->name, b->name) == 0 &&
+           a->latitude_e6 == b->latitude_e6 &&
+           a->longitude_e6 == b->longitude_e6;
+}
+
+// Write order: new records -> index -> stale records erased.
+// Unchanged records and an unchanged index are not rewritten; nothing is read
+// from flash, the comparison is against stored.
+esp_err_t app_locations_save(const locations_model_t *in, app_locations_stored_t *stored)
 {
-    return nvs_erase_key_cfg(NVS_KEY_LOCATIONS);
-}
\ No newline at end of file
+    if (!in || !stored || stored->model.capacity != in->capacity)
+        return ESP_ERR_INVALID_ARG;
+    if (!stored->valid)
+        return ESP_ERR_INVALID_STATE;
+
+    const size_t bits = stored->id_bits;
+    const size_t map_len = (bits + 7) / 8;
+    uint8_t *prev = calloc(map_len, 1);  // ids of the stored index
+    uint8_t *used = calloc(map_len, 1);  // prev plus the ids of this save
+    uint8_t *keep = calloc(map_len, 1);  // ids of the new index
+    uint16_t *ids = calloc(in->count + 1, sizeof(uint16_t));
+    uint16_t *slot_ids = calloc(in->capacity, sizeof(uint16_t));
+    const size_t index_len = locations_index_measure(in->count);
+    uint8_t *index = malloc(index_len);
+    esp_err_t err = (prev && used && keep && ids && slot_ids && index) ? ESP_OK : ESP_ERR_NO_MEM;
+
+    // the writes are queued in the NVS journal in this order, which is also the flush order
+    nvs_cfg_lock();
+
+    if (err == ESP_OK)
+    {
+        for (const location_t *old = locations_model_first(&stored->model); old;
+             old = locations_model_next(&stored->model, old))
+            mark_id(prev, bits, stored->ids[locations_model_handle(&stored->model, old).slot]);
+        memcpy(used, prev, map_len);
+    }
+
+    size_t n = 0;
+    size_t written = 0;
+    bool touched = false; // a put was made: the journal cannot take it back
+    uint16_t active_id = LOCATIONS_INDEX_NO_ID;
+    bool index_changed = false;
+    const location_t *old = locations_model_first(&stored->model);
+
+    for (const location_t *loc = locations_model_first(in); err == ESP_OK && loc; loc = locations_model_next(in, loc))
+    {
+        const location_t *prior = locations_model_find(&stored->model, loc->name);
+        uint16_t id = LOCATIONS_INDEX_NO_ID;
+
+        if (prior && same_location(prior, loc))
+        {
+            id = stored->ids[locations_model_handle(&stored->model, prior).slot];
+        }
+        else
+        {
+            uint8_t rec[LOCATIONS_RECORD_MAX_LEN];
+            const size_t rec_len = locations_record_encode(loc, rec, sizeof(rec));
+            char key[16];
+
+            id = alloc_id(used, bits);
+            record_key(id, key);
+            touched = touched || rec_len > 0;
+            err = (rec_len > 0) ? nvs_cfg_set_blob(key, rec, rec_len) : ESP_ERR_INVALID_ARG;
+            written++;
+        }
+
+        // index order and ids against the stored index, walked alongside
+        if (!old || stored->ids[locations_model_handle(&stored->model, old).slot] != id)
+            index_changed = true;
+        old = old ? locations_model_next(&stored->model, old) : NULL;
+
+        ids[n++] = id;
+        slot_ids[locations_model_handle(in, loc).slot] = id;
+        mark_id(keep, bits, id);
+        if (loc->is_active)
+            active_id = id;
+    }
+
+    index_changed = index_changed || old != NULL || active_id != stored->active_id;
+
+    if (err == ESP_OK && index_changed)
+    {
+        const size_t len = locations_index_encode(ids, n, active_id, index, index_len);
+        touched = touched || len > 0;
+        err = (len > 0) ? nvs_cfg_set_blob(NVS_KEY_LOC_INDEX, index, len) : ESP_FAIL;
+    }
+
+    // records only the stored index named, and the legacy JSON string; missing
+    // keys are fine
+    for (size_t id = 0; err == ESP_OK && id < bits; id++)
+    {
+        if (id_marked(prev, bits, (uint16_t)id) && !id_marked(keep, bits, (uint16_t)id))
+        {
+            char key[16];
+            record_key((uint16_t)id, key);
+            touched = true;
+            err = nvs_cfg_erase_key(key);
+        }
+    }
+    if (err == ESP_OK)
+    {
+        touched = true;
+        err = nvs_cfg_erase_key(NVS_KEY_LOCATIONS);
+    }
+
+    if (err == ESP_OK && locations_model_copy(&stored->model, in))
+    {
+        uint16_t *swap = stored->ids;
+        stored->ids = slot_ids;
+        slot_ids = swap;
+        stored->active_id = active_id;
+    }
+    else
+    {
+        // flash is somewhere between the old and the new state
+        stored->valid = false;
+        if (err != ESP_OK && touched)
+            err = ESP_ERR_NOT_FINISHED;
+    }
+
+    nvs_cfg_unlock();
+
+    if (err == ESP_OK)
+        ESP_LOGI(TAG, "saved %u locations: %u record(s) written, index %s",
+                 (unsigned)n, (unsigned)written, index_changed ? "written" : "unchanged");
+    else
+        ESP_LOGE(TAG, "save failed: %s", esp_err_to_name(err));
+
+    free(prev);
+    free(used);
+    free(keep);
+    free(ids);
+    free(slot_ids);
+    free(index);
+    return err;
+}
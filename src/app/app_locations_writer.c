@@ -0,0 +1,225 @@
+#include "app/app_locations_writer.h"
+#include "app/app_locations_persistence.h"
+
+#include <stdbool.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+#include "esp_log.h"
+
+#include "core_config.h"
+#include "locations_model.h"
+
+static const char *TAG = "locations_writer";
+
+#define WRITER_QUEUE_LEN 8
+// commands sharing one persisted write at most
+#define WRITER_MAX_GROUP 8
+
+typedef struct
+{
+    const locations_batch_op_t *ops;
+    size_t count;
+    esp_err_t *result;
+    size_t *failed_index;
+    SemaphoreHandle_t done;
+} writer_cmd_t;
+
+static QueueHandle_t s_queue = NULL;
+static TaskHandle_t s_task = NULL;
+
+// only touched by the writer task
+static locations_model_t s_model;
+static app_locations_stored_t s_stored; // what NVS holds; saves diff against it
+static bool s_loaded = false;
+
+// last persisted state for readers; the published pointer holds one reference
+static locations_snapshot_t *s_snapshot = NULL;
+static portMUX_TYPE s_snapshot_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// copies s_model and swaps it in; readers still holding the old one keep it alive
+static void publish_snapshot(void)
+{
+    locations_snapshot_t *snap = locations_snapshot_create(&s_model);
+    if (!snap)
+    {
+        ESP_LOGE(TAG, "snapshot alloc failed, readers keep the previous list");
+        return;
+    }
+
+    portENTER_CRITICAL(&s_snapshot_lock);
+    locations_snapshot_t *old = s_snapshot;
+    s_snapshot = snap;
+    portEXIT_CRITICAL(&s_snapshot_lock);
+
+    locations_snapshot_release(old);
+}
+
+static esp_err_t ensure_loaded(void)
+{
+    if (s_loaded)
+        return ESP_OK;
+
+    esp_err_t err = app_locations_load(&s_model, &s_stored);
+    if (err == ESP_ERR_NOT_FOUND)
+        err = ESP_OK; // nothing stored yet -> empty list
+
+    s_loaded = (err == ESP_OK);
+    if (s_loaded)
+        publish_snapshot();
+
+    return err;
+}
+
+static void apply_cmd(const writer_cmd_t *cmd, bool *dirty)
+{
+    *cmd->result = ensure_loaded();
+    if (*cmd->result != ESP_OK)
+        return;
+
+    if (locations_batch_apply(&s_model, cmd->ops, cmd->count, cmd->failed_index))
+        *dirty = true;
+    else
+        *cmd->result = (*cmd->failed_index < cmd->count) ? ESP_ERR_INVALID_ARG : ESP_ERR_NO_MEM;
+}
+
+static void writer_task(void *arg)
+{
+    (void)arg;
+    writer_cmd_t group[WRITER_MAX_GROUP];
+
+    for (;;)
+    {
+        size_t n = 0;
+        bool dirty = false;
+        TickType_t wait = portMAX_DELAY;
+
+        // first command blocks; later ones join the group while they keep arriving within the window
+        while (n < WRITER_MAX_GROUP && xQueueReceive(s_queue, &group[n], wait) == pdTRUE)
+        {
+            apply_cmd(&group[n], &dirty);
+            n++;
+            wait = pdMS_TO_TICKS(CORE_LOCATIONS_WRITE_COALESCE_MS);
+        }
+
+        if (dirty)
+        {
+            esp_err_t err = app_locations_save(&s_model, &s_stored);
+            if (err != ESP_OK)
+            {
+                ESP_LOGE(TAG, "save failed: %s", esp_err_to_name(err));
+                // Queued writes of a save that stopped part way are flushed later
+                // (they cannot be taken back), so the change may still land. Reload
+                // through the journal now: readers and the next group then start
+                // from what NVS will hold. A failed reload is retried by the next
+                // command.
+                s_loaded = false;
+                (void)ensure_loaded();
+                for (size_t i = 0; i < n; i++)
+                {
+                    if (*group[i].result == ESP_OK)
+                        *group[i].result = err;
+                }
+            }
+            else
+            {
+                ESP_LOGI(TAG, "persisted %u command(s), count=%u", (unsigned)n, (unsigned)s_model.count);
+                publish_snapshot();
+            }
+        }
+
+        for (size_t i = 0; i < n; i++)
+            xSemaphoreGive(group[i].done);
+    }
+}
+
+esp_err_t app_locations_writer_start(void)
+{
+    if (s_task)
+        return ESP_OK;
+
+    if (!locations_model_init(&s_model, CORE_LOCATIONS_CAPACITY))
+        return ESP_ERR_NO_MEM;
+    if (!app_locations_stored_init(&s_stored, CORE_LOCATIONS_CAPACITY))
+    {
+        locations_model_deinit(&s_model);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // first snapshot before the HTTP server starts; on failure the next command retries
+    esp_err_t err = ensure_loaded();
+    if (err != ESP_OK)
+        ESP_LOGW(TAG, "initial load failed: %s", esp_err_to_name(err));
+
+    s_queue = xQueueCreate(WRITER_QUEUE_LEN, sizeof(writer_cmd_t));
+    if (!s_queue)
+    {
+        app_locations_stored_deinit(&s_stored);
+        locations_model_deinit(&s_model);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // save works on heap buffers (id maps, index); the batch scratch copy is heap too
+    if (xTaskCreate(writer_task, "loc_writer", 4096, NULL, 5, &s_task) != pdPASS)
+    {
+        ESP_LOGE(TAG, "xTaskCreate failed");
+        vQueueDelete(s_queue);
+        s_queue = NULL;
+        s_task = NULL;
+        app_locations_stored_deinit(&s_stored);
+        locations_model_deinit(&s_model);
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "started (coalesce window %d ms)", CORE_LOCATIONS_WRITE_COALESCE_MS);
+    return ESP_OK;
+}
+
+locations_snapshot_t *app_locations_snapshot_acquire(void)
+{
+    // load + retain must not interleave with the writer dropping the last reference
+    portENTER_CRITICAL(&s_snapshot_lock);
+    locations_snapshot_t *snap = s_snapshot;
+    locations_snapshot_retain(snap);
+    portEXIT_CRITICAL(&s_snapshot_lock);
+
+    return snap;
+}
+
+esp_err_t app_locations_writer_submit(const locations_batch_op_t *ops, size_t count, size_t *out_failed_index)
+{
+    if (!s_queue)
+        return ESP_ERR_INVALID_STATE;
+    if (!ops || count == 0)
+        return ESP_ERR_INVALID_ARG;
+
+    esp_err_t result = ESP_FAIL;
+    size_t failed = count;
+
+    // reply slot lives on the caller's stack; the caller blocks until the writer gives it
+    StaticSemaphore_t done_buf;
+    writer_cmd_t cmd = {
+        .ops = ops,
+        .count = count,
+        .result = &result,
+        .failed_index = &failed,
+        .done = xSemaphoreCreateBinaryStatic(&done_buf),
+    };
+
+    if (xQueueSend(s_queue, &cmd, portMAX_DELAY) != pdTRUE)
+    {
+        vSemaphoreDelete(cmd.done);
+        return ESP_FAIL;
+    }
+
+    xSemaphoreTake(cmd.done, portMAX_DELAY);
+    vSemaphoreDelete(cmd.done);
+
+    if (out_failed_index)
+        *out_failed_index = failed;
+
+    return result;
+}
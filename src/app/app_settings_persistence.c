@@ -1,62 +1,242 @@
+#include <stdbool.h>
+#include <stdio.h>
 #include <string.h>
 
+#include "freertos/FreeRTOS.h"
+
 #include "nvs.h"
-#include "nvs_flash.h"
+#include "esp_log.h"
 
 #include "app/app_settings_persistence.h"
+#include "app/app_config.h"
+#include "app/nvs_helpers.h"
 
-#define NVS_NS_CFG "cfg"
-#define NVS_KEY_SSID "sta_ssid"
-#define NVS_KEY_PASS "sta_pass"
+static const char *TAG = "app_settings";
 
-esp_err_t app_settings_load_wifi(settings_wifi_t *out)
+// RAM copy of the last NVS result (ESP_OK or ESP_ERR_NOT_FOUND); other errors are not cached.
+// s_gen is bumped by every write, so a read racing a save cannot store the old value.
+static wifi_profiles_t s_wifi;
+static esp_err_t s_wifi_result = ESP_ERR_INVALID_STATE;
+static bool s_wifi_valid = false;
+static uint32_t s_gen = 0;
+static app_settings_cache_stats_t s_stats;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// read-modify-write scratch, guarded by nvs_cfg_lock() (too large for the event task stack)
+static wifi_profiles_t s_edit;
+static uint8_t s_blob[WIFI_PROFILES_MAX_LEN];
+
+static void cache_store(uint32_t gen, const wifi_profiles_t *list, esp_err_t result)
+{
+    portENTER_CRITICAL(&s_lock);
+    if (gen == s_gen)
+    {
+        s_wifi = *list;
+        s_wifi_result = result;
+        s_wifi_valid = true;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+// after a write: store what is on flash now, or drop the cache if the write failed
+static void cache_written(const wifi_profiles_t *list)
+{
+    portENTER_CRITICAL(&s_lock);
+    s_gen++;
+    s_stats.invalidations++;
+    s_wifi_valid = (list != NULL);
+    if (list != NULL)
+    {
+        s_wifi = *list;
+        s_wifi_result = (list->count > 0) ? ESP_OK : ESP_ERR_NOT_FOUND;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+// caller holds nvs_cfg_lock(); *legacy: the list came from the pre-profile keys
+static esp_err_t nvs_read_profiles(wifi_profiles_t *out, bool *legacy)
+{
+    memset(out, 0, sizeof(*out));
+    *legacy = false;
+
+    size_t len = sizeof(s_blob);
+    esp_err_t err = nvs_cfg_get_blob(NVS_KEY_WIFI_PROFILES, s_blob, &len);
+
+    if (err == ESP_OK && !wifi_profiles_decode(s_blob, len, out))
+    {
+        ESP_LOGE(TAG, "stored WiFi profiles corrupt (%u bytes)", (unsigned)len);
+        err = ESP_FAIL;
+    }
+    else if (err == ESP_ERR_NVS_NOT_FOUND)
+    {
+        settings_wifi_t pair;
+        err = app_config_get_legacy_wifi(&pair);
+        if (err == ESP_OK)
+            *legacy = wifi_profiles_put(out, pair.ssid, pair.pass, 0);
+        memset(&pair, 0, sizeof(pair));
+    }
+    memset(s_blob, 0, sizeof(s_blob));
+
+    if ((err == ESP_OK || err == ESP_ERR_NOT_FOUND) && out->count == 0)
+        return ESP_ERR_NOT_FOUND;
+    return err;
+}
+
+// nvs_cfg_lock() + s_edit = stored list; a corrupt one is started over
+static esp_err_t edit_begin(bool *legacy)
+{
+    nvs_cfg_lock();
+    esp_err_t err = nvs_read_profiles(&s_edit, legacy);
+    if (err == ESP_FAIL || err == ESP_ERR_NOT_FOUND)
+    {
+        memset(&s_edit, 0, sizeof(s_edit));
+        err = ESP_OK;
+    }
+    return err;
+}
+
+// writes s_edit (changed), drops the legacy keys once the list holds them, unlocks
+static esp_err_t edit_end(esp_err_t err, bool changed, bool legacy)
+{
+    const bool write = (err == ESP_OK) && changed;
+
+    if (write)
+    {
+        if (s_edit.count == 0)
+        {
+            err = nvs_cfg_erase_key(NVS_KEY_WIFI_PROFILES);
+        }
+        else
+        {
+            const size_t len = wifi_profiles_encode(&s_edit, s_blob, sizeof(s_blob));
+            err = (len > 0) ? nvs_cfg_set_blob(NVS_KEY_WIFI_PROFILES, s_blob, len) : ESP_FAIL;
+            memset(s_blob, 0, sizeof(s_blob));
+        }
+    }
+    // the blob is read first, so the pair is dead weight from here on
+    if (write && err == ESP_OK && legacy)
+        err = app_config_drop_legacy_wifi();
+
+    // cache holds the written value; after a failed write the stored state is unknown -> reload
+    if (write)
+        cache_written((err == ESP_OK) ? &s_edit : NULL);
+
+    memset(&s_edit, 0, sizeof(s_edit));
+    nvs_cfg_unlock();
+    return err;
+}
+
+esp_err_t app_settings_load_wifi_profiles(wifi_profiles_t *out)
 {
     if (out == NULL)
     {
         return ESP_ERR_INVALID_ARG;
     }
 
-    (void)memset(out, 0, sizeof(*out));
+    esp_err_t err = ESP_OK;
+    bool hit = false;
+    uint32_t gen = 0;
+
+    portENTER_CRITICAL(&s_lock);
+    if (s_wifi_valid)
+    {
+        *out = s_wifi;
+        err = s_wifi_result;
+        hit = true;
+        s_stats.hits++;
+    }
+    else
+    {
+        gen = s_gen;
+        s_stats.misses++;
+    }
+    portEXIT_CRITICAL(&s_lock);
 
-    nvs_handle_t nvs;
-    esp_err_t err = nvs_open(NVS_NS_CFG, NVS_READONLY, &nvs);
-    if (err != ESP_OK)
+    if (hit)
     {
         return err;
     }
 
-    size_t ssid_len = sizeof(out->ssid);
-    size_t pass_len = sizeof(out->pass);
+    bool legacy = false;
+    nvs_cfg_lock();
+    err = nvs_read_profiles(out, &legacy);
+    nvs_cfg_unlock();
 
-    esp_err_t e1 = nvs_get_str(nvs, NVS_KEY_SSID, out->ssid, &ssid_len);
-    esp_err_t e2 = nvs_get_str(nvs, NVS_KEY_PASS, out->pass, &pass_len);
+    if (err == ESP_OK || err == ESP_ERR_NOT_FOUND)
+    {
+        cache_store(gen, out, err);
+    }
 
-    nvs_close(nvs);
+    return err;
+}
 
-    if (e1 == ESP_ERR_NVS_NOT_FOUND)
+esp_err_t app_settings_load_wifi(settings_wifi_t *out)
+{
+    if (out == NULL)
     {
-        out->ssid[0] = '\0';
-        out->pass[0] = '\0';
-        return ESP_ERR_NOT_FOUND;
+        return ESP_ERR_INVALID_ARG;
     }
-    if (e1 != ESP_OK)
+
+    wifi_profiles_t list;
+    esp_err_t err = app_settings_load_wifi_profiles(&list);
+
+    memset(out, 0, sizeof(*out));
+    if (err == ESP_OK)
     {
-        out->ssid[0] = '\0';
-        out->pass[0] = '\0';
-        return e1;
+        (void)snprintf(out->ssid, sizeof(out->ssid), "%s", list.items[0].ssid);
+        (void)snprintf(out->pass, sizeof(out->pass), "%s", list.items[0].pass);
     }
+    memset(&list, 0, sizeof(list));
+
+    return err;
+}
+
+esp_err_t app_settings_init(void)
+{
+    bool legacy = false;
+    esp_err_t err = edit_begin(&legacy);
+
+    // single pair from before profiles -> one-entry list
+    if (err == ESP_OK && legacy)
+        ESP_LOGI(TAG, "moving stored WiFi credentials to the profile list");
+    err = edit_end(err, legacy, legacy);
+
+    wifi_profiles_t tmp;
+    if (err == ESP_OK)
+        err = app_settings_load_wifi_profiles(&tmp);
+    memset(&tmp, 0, sizeof(tmp));
 
-    if (e2 == ESP_ERR_NVS_NOT_FOUND)
+    return (err == ESP_ERR_NOT_FOUND) ? ESP_OK : err;
+}
+
+void app_settings_cache_stats(app_settings_cache_stats_t *out)
+{
+    if (out == NULL)
     {
-        out->pass[0] = '\0';
+        return;
     }
-    else if (e2 != ESP_OK)
+
+    portENTER_CRITICAL(&s_lock);
+    *out = s_stats;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+esp_err_t app_settings_put_wifi(const settings_wifi_t *in, size_t pos)
+{
+    if (in == NULL || in->ssid[0] == '\0')
     {
-        out->pass[0] = '\0';
-        return e2;
+        return ESP_ERR_INVALID_ARG;
     }
 
-    return ESP_OK;
+    bool legacy = false;
+    esp_err_t err = edit_begin(&legacy);
+    const bool full = (s_edit.count == WIFI_PROFILES_MAX && wifi_profiles_find(&s_edit, in->ssid) == s_edit.count);
+    if (err == ESP_OK && full)
+        err = ESP_ERR_NO_MEM;
+    if (err == ESP_OK && !wifi_profiles_put(&s_edit, in->ssid, in->pass, pos))
+        err = ESP_ERR_INVALID_ARG;
+
+    return edit_end(err, true, legacy);
 }
 
 esp_err_t app_settings_save_wifi(const settings_wifi_t *in)
@@ -66,41 +246,56 @@ esp_err_t app_settings_save_wifi(const settings_wifi_t *in)
         return ESP_ERR_INVALID_ARG;
     }
 
-    nvs_handle_t nvs;
-    esp_err_t err = nvs_open(NVS_NS_CFG, NVS_READWRITE, &nvs);
-    if (err != ESP_OK)
-    {
-        return err;
-    }
+    bool legacy = false;
+    esp_err_t err = edit_begin(&legacy);
 
-    err = nvs_set_str(nvs, NVS_KEY_SSID, in->ssid);
-    if (err == ESP_OK)
+    // full and new: the lowest priority profile makes room
+    if (err == ESP_OK && s_edit.count == WIFI_PROFILES_MAX && wifi_profiles_find(&s_edit, in->ssid) == s_edit.count)
     {
-        err = nvs_set_str(nvs, NVS_KEY_PASS, in->pass);
+        ESP_LOGW(TAG, "profile list full, dropping '%s'", s_edit.items[s_edit.count - 1].ssid);
+        (void)wifi_profiles_remove(&s_edit, s_edit.items[s_edit.count - 1].ssid);
     }
+    if (err == ESP_OK && !wifi_profiles_put(&s_edit, in->ssid, in->pass, 0))
+        err = ESP_ERR_INVALID_ARG;
 
-    if (err == ESP_OK)
+    return edit_end(err, true, legacy);
+}
+
+esp_err_t app_settings_remove_wifi(const char *ssid)
+{
+    if (ssid == NULL)
     {
-        err = nvs_commit(nvs);
+        return ESP_ERR_INVALID_ARG;
     }
 
-    nvs_close(nvs);
-    return err;
+    bool legacy = false;
+    esp_err_t err = edit_begin(&legacy);
+    const bool removed = (err == ESP_OK) && wifi_profiles_remove(&s_edit, ssid);
+
+    err = edit_end(err, removed, legacy);
+    return (err == ESP_OK && !removed) ? ESP_ERR_NOT_FOUND : err;
 }
 
 esp_err_t app_settings_clear_wifi(void)
 {
-    nvs_handle_t nvs;
-    esp_err_t err = nvs_open(NVS_NS_CFG, NVS_READWRITE, &nvs);
-    if (err != ESP_OK)
+    bool legacy = false;
+    esp_err_t err = edit_begin(&legacy);
+
+    s_edit.count = 0;
+    return edit_end(err, true, legacy);
+}
+
+esp_err_t app_settings_wifi_connected(const char *ssid, const wifi_profile_hint_t *hint)
+{
+    if (ssid == NULL || hint == NULL)
     {
-        return err;
+        return ESP_ERR_INVALID_ARG;
     }
 
-    (void)nvs_erase_key(nvs, NVS_KEY_SSID);
-    (void)nvs_erase_key(nvs, NVS_KEY_PASS);
+    bool legacy = false;
+    esp_err_t err = edit_begin(&legacy);
+    // a connect with credentials that are not saved (wifi_sta_connect) has nothing to update
+    const bool changed = (err == ESP_OK) && wifi_profiles_set_hint(&s_edit, ssid, hint);
 
-    err = nvs_commit(nvs);
-    nvs_close(nvs);
-    return err;
-}
\ No newline at end of file
+    return edit_end(err, changed, legacy);
+}
@@ -1,25 +1,657 @@
 #include "app/nvs_helpers.h"
 
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
 #include "nvs.h"
 #include "nvs_flash.h"
 #include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+
+#include "core_config.h"
+#include "lzss.h"
 
 static const char *TAG = "nvs_helpers";
 
-esp_err_t nvs_load_json(const char *key, char *out_buf, size_t out_len)
+// pending values; a save larger than this is written through
+#define NVS_JOURNAL_BYTES 2048
+// flash entry size of the NVS page layout
+#define NVS_ENTRY_BYTES 32U
+// a failed flush is retried after 0.5 s, doubling up to 30 s
+#define NVS_FLUSH_RETRY_FIRST_MS 500U
+#define NVS_FLUSH_RETRY_MAX_MS 30000U
+#define NVS_FLUSH_TASK_STACK 4096
+
+// Opened lazily; a failed open (e.g. read-only before the namespace exists) is retried next time.
+static nvs_handle_t s_handle[2];
+static bool s_handle_open[2] = {false, false};
+
+static StaticSemaphore_t s_lock_buf;
+static SemaphoreHandle_t s_lock = NULL;
+static portMUX_TYPE s_lock_init = portMUX_INITIALIZER_UNLOCKED;
+
+// all below guarded by s_lock
+static int s_depth = 0;
+static bool s_dirty = false; // written since the last flush was scheduled
+static uint8_t s_journal_mem[NVS_JOURNAL_BYTES];
+static write_journal_t s_journal;
+static bool s_journal_ready = false;
+static esp_timer_handle_t s_flush_timer = NULL;
+static uint32_t s_flush_failures = 0;
+static uint32_t s_direct_commits = 0;
+static latency_hist_t s_lat_read;
+static latency_hist_t s_lat_write;
+static latency_hist_t s_lat_flush;
+
+// Timed flushes run here, not on the esp_timer task: a commit erases and
+// programs flash for tens of ms and would hold up every other timer callback.
+static TaskHandle_t s_flush_task = NULL;
+
+static void lat_add(latency_hist_t *h, int64_t t0)
 {
-    if (!key || !out_buf || out_len == 0)
+    const int64_t us = esp_timer_get_time() - t0;
+    latency_hist_add(h, (us > (int64_t)UINT32_MAX) ? UINT32_MAX : (uint32_t)us);
+}
+
+static SemaphoreHandle_t cfg_lock(void)
+{
+    // static create does not allocate, so it may run inside the critical section
+    portENTER_CRITICAL(&s_lock_init);
+    if (s_lock == NULL)
+        s_lock = xSemaphoreCreateRecursiveMutexStatic(&s_lock_buf);
+    portEXIT_CRITICAL(&s_lock_init);
+    return s_lock;
+}
+
+// caller holds the lock; the handle stays open for the process lifetime
+static esp_err_t cfg_handle(nvs_open_mode_t mode, nvs_handle_t *out)
+{
+    const int slot = (mode == NVS_READWRITE) ? 1 : 0;
+    esp_err_t err = ESP_OK;
+
+    if (!s_handle_open[slot])
+    {
+        err = nvs_open(NVS_NS_CFG, mode, &s_handle[slot]);
+        s_handle_open[slot] = (err == ESP_OK);
+    }
+
+    if (err == ESP_OK)
+        *out = s_handle[slot];
+    return err;
+}
+
+// Strings longer than CORE_NVS_COMPRESS_MIN are stored as an LZSS container
+// (lzss.h) under "~<key>" when that is smaller; plain strings stay under <key>,
+// so values written before compression existed still read back. Readers prefer
+// the container, so a key that has one keeps it: later values go there too,
+// stored as is when they do not compress. Every write of a value is then one
+// nvs_set and a power cut leaves the old or the new value. A plain key next to
+// the container is stale and erased after the set; an erase removes the plain
+// key first, so a cut in between still reads the value from before the erase.
+#define NVS_PACKED_PREFIX "~"
+
+static bool packed_key(const char *key, char out[NVS_KEY_NAME_MAX_SIZE])
+{
+    const int n = snprintf(out, NVS_KEY_NAME_MAX_SIZE, NVS_PACKED_PREFIX "%s", key);
+    return n > 0 && n < NVS_KEY_NAME_MAX_SIZE;
+}
+
+static esp_err_t erase_if_present(nvs_handle_t nvs, const char *key)
+{
+    esp_err_t err = nvs_erase_key(nvs, key);
+    return (err == ESP_ERR_NVS_NOT_FOUND) ? ESP_OK : err;
+}
+
+static esp_err_t set_str_value(nvs_handle_t nvs, const char *key, const char *value, size_t len)
+{
+    char pk[NVS_KEY_NAME_MAX_SIZE];
+    const bool can_pack = packed_key(key, pk);
+    size_t old_len = 0;
+    const bool has_container = can_pack && nvs_get_blob(nvs, pk, NULL, &old_len) == ESP_OK;
+    const bool compress = can_pack && CORE_NVS_COMPRESS_MIN > 0 && len > CORE_NVS_COMPRESS_MIN;
+    const size_t cap = LZSS_HEADER_LEN + len;
+    uint8_t *packed = NULL;
+    size_t packed_len = 0;
+
+    if (has_container || compress)
+    {
+        packed = malloc(cap);
+        if (packed && compress)
+            packed_len = lzss_pack(value, len, LZSS_FLAG_STR, packed, cap);
+        if (packed && has_container && packed_len == 0)
+            packed_len = lzss_store(value, len, LZSS_FLAG_STR, packed, cap);
+    }
+
+    esp_err_t err;
+    if (has_container && packed_len == 0)
+    {
+        err = ESP_ERR_NO_MEM;
+    }
+    else if (packed_len > 0)
+    {
+        err = nvs_set_blob(nvs, pk, packed, packed_len);
+        if (err == ESP_OK)
+            err = erase_if_present(nvs, key);
+        ESP_LOGD(TAG, "key='%s' stored in container: %u -> %u bytes", key, (unsigned)len, (unsigned)packed_len);
+    }
+    else
+    {
+        err = nvs_set_str(nvs, key, value);
+    }
+
+    free(packed);
+    return err;
+}
+
+static esp_err_t get_str_value(nvs_handle_t nvs, const char *key, char *out, size_t *len)
+{
+    char pk[NVS_KEY_NAME_MAX_SIZE];
+    size_t blob_len = 0;
+
+    esp_err_t err = packed_key(key, pk) ? nvs_get_blob(nvs, pk, NULL, &blob_len) : ESP_ERR_NVS_NOT_FOUND;
+    if (err == ESP_ERR_NVS_NOT_FOUND)
+        return nvs_get_str(nvs, key, out, len);
+    if (err != ESP_OK)
+        return err;
+
+    uint8_t *blob = malloc(blob_len);
+    if (!blob)
+        return ESP_ERR_NO_MEM;
+
+    size_t plain_len = 0;
+    err = nvs_get_blob(nvs, pk, blob, &blob_len);
+    if (err == ESP_OK && !lzss_unpack_info(blob, blob_len, &plain_len, NULL))
+        err = ESP_FAIL;
+
+    // same length contract as nvs_get_str (NUL included)
+    if (err == ESP_OK && out)
+    {
+        if (*len < plain_len)
+            err = ESP_ERR_NVS_INVALID_LENGTH;
+        else if (!lzss_unpack(blob, blob_len, out, plain_len) || plain_len == 0 || out[plain_len - 1] != '\0')
+            err = ESP_FAIL;
+    }
+    if (err == ESP_OK)
+        *len = plain_len;
+    if (err == ESP_FAIL)
+        ESP_LOGE(TAG, "packed value key='%s' corrupt", key);
+
+    free(blob);
+    return err;
+}
+
+static int journal_apply(void *ctx, const char *key, write_journal_kind_t kind, const void *data, size_t len)
+{
+    const nvs_handle_t nvs = *(const nvs_handle_t *)ctx;
+    esp_err_t err;
+
+    switch (kind)
+    {
+    case WRITE_JOURNAL_STR:
+        err = set_str_value(nvs, key, (const char *)data, len);
+        break;
+    case WRITE_JOURNAL_BLOB:
+        err = nvs_set_blob(nvs, key, data, len);
+        break;
+    default:
+    {
+        char pk[NVS_KEY_NAME_MAX_SIZE];
+        err = erase_if_present(nvs, key);
+        if (err == ESP_OK && packed_key(key, pk))
+            err = erase_if_present(nvs, pk);
+        break;
+    }
+    }
+
+    return err;
+}
+
+static int journal_commit(void *ctx)
+{
+    return nvs_commit(*(const nvs_handle_t *)ctx);
+}
+
+// caller holds the lock; backs off so a flash that keeps failing is not hammered
+static void schedule_retry_locked(void)
+{
+    const uint32_t shift = (s_flush_failures < 6) ? s_flush_failures : 6;
+    uint32_t ms = NVS_FLUSH_RETRY_FIRST_MS << shift;
+    if (ms > NVS_FLUSH_RETRY_MAX_MS)
+        ms = NVS_FLUSH_RETRY_MAX_MS;
+    s_flush_failures++;
+
+    (void)esp_timer_stop(s_flush_timer);
+    (void)esp_timer_start_once(s_flush_timer, (uint64_t)ms * 1000ULL);
+    ESP_LOGW(TAG, "journal flush retry in %u ms", (unsigned)ms);
+}
+
+// caller holds the lock
+static esp_err_t flush_locked(void)
+{
+    if (!s_journal_ready || write_journal_pending(&s_journal) == 0)
+    {
+        s_dirty = false;
+        s_flush_failures = 0;
+        return ESP_OK;
+    }
+
+    const int64_t t0 = esp_timer_get_time();
+    nvs_handle_t nvs;
+    esp_err_t err = cfg_handle(NVS_READWRITE, &nvs);
+    if (err == ESP_OK)
+    {
+        const write_journal_backend_t backend = {journal_apply, journal_commit, &nvs};
+        err = write_journal_flush(&s_journal, &backend);
+    }
+    lat_add(&s_lat_flush, t0);
+
+    const bool pending = (write_journal_pending(&s_journal) > 0);
+    if (err != ESP_OK)
+        ESP_LOGE(TAG, "journal flush failed (%u pending): %s",
+                 (unsigned)write_journal_pending(&s_journal), esp_err_to_name(err));
+
+    if (!pending)
+    {
+        s_dirty = false;
+        s_flush_failures = 0;
+    }
+    else if (s_flush_timer != NULL)
+    {
+        // the retry timer owns the pending entries; a new write restarts the quiet period
+        s_dirty = false;
+        schedule_retry_locked();
+    }
+    else
+    {
+        s_dirty = true; // write-through: the next unlock retries
+    }
+    return err;
+}
+
+// outermost unlock after a write: restart the quiet period, or write through if there is no timer
+static void schedule_flush_locked(void)
+{
+    if (s_flush_timer == NULL || CORE_NVS_WRITE_BEHIND_MS == 0)
+    {
+        (void)flush_locked();
+        return;
+    }
+
+    (void)esp_timer_stop(s_flush_timer);
+    (void)esp_timer_start_once(s_flush_timer, (uint64_t)CORE_NVS_WRITE_BEHIND_MS * 1000ULL);
+}
+
+void nvs_cfg_lock(void)
+{
+    xSemaphoreTakeRecursive(cfg_lock(), portMAX_DELAY);
+    s_depth++;
+}
+
+void nvs_cfg_unlock(void)
+{
+    if (--s_depth == 0 && s_dirty)
+        schedule_flush_locked();
+    xSemaphoreGiveRecursive(cfg_lock());
+}
+
+static esp_err_t cfg_get(const char *key, write_journal_kind_t want, void *out, size_t *len)
+{
+    if (!key || !len)
         return ESP_ERR_INVALID_ARG;
 
+    write_journal_kind_t kind;
+    const void *data = NULL;
+    size_t n = 0;
+    esp_err_t err;
+
+    nvs_cfg_lock();
+    const int64_t t0 = esp_timer_get_time();
+
+    if (s_journal_ready && write_journal_get(&s_journal, key, &kind, &data, &n))
+    {
+        // same contract as nvs_get_str / nvs_get_blob
+        if (kind == WRITE_JOURNAL_ERASE)
+            err = ESP_ERR_NVS_NOT_FOUND;
+        else if (kind != want)
+            err = ESP_ERR_NVS_TYPE_MISMATCH;
+        else if (out && *len < n)
+            err = ESP_ERR_NVS_INVALID_LENGTH;
+        else
+        {
+            if (out)
+                memcpy(out, data, n);
+            *len = n;
+            err = ESP_OK;
+        }
+    }
+    else
+    {
+        nvs_handle_t nvs;
+        err = cfg_handle(NVS_READONLY, &nvs);
+        if (err == ESP_OK)
+            err = (want == WRITE_JOURNAL_STR) ? get_str_value(nvs, key, (char *)out, len)
+                                              : nvs_get_blob(nvs, key, out, len);
+    }
+
+    lat_add(&s_lat_read, t0);
+    nvs_cfg_unlock();
+    return err;
+}
+
+static esp_err_t cfg_put(const char *key, write_journal_kind_t kind, const void *data, size_t len)
+{
+    if (!key || (kind != WRITE_JOURNAL_ERASE && !data))
+        return ESP_ERR_INVALID_ARG;
+
+    esp_err_t err = ESP_OK;
+
+    nvs_cfg_lock();
+    const int64_t t0 = esp_timer_get_time();
+
+    if (!s_journal_ready)
+    {
+        write_journal_init(&s_journal, s_journal_mem, sizeof(s_journal_mem));
+        s_journal_ready = true;
+    }
+
+    bool queued = write_journal_put(&s_journal, key, kind, data, len);
+    if (!queued)
+    {
+        // full: make room (keeps the order), then retry
+        err = flush_locked();
+        if (err == ESP_OK)
+            queued = write_journal_put(&s_journal, key, kind, data, len);
+    }
+
+    if (err == ESP_OK && !queued)
+    {
+        // larger than the whole journal, which is empty now: write through
+        nvs_handle_t nvs;
+        err = cfg_handle(NVS_READWRITE, &nvs);
+        if (err == ESP_OK)
+            err = journal_apply(&nvs, key, kind, data, len);
+        if (err == ESP_OK)
+            err = nvs_commit(nvs);
+        if (err == ESP_OK)
+            s_direct_commits++;
+    }
+
+    if (queued)
+        s_dirty = true;
+    lat_add(&s_lat_write, t0);
+
+    nvs_cfg_unlock();
+
+    if (err != ESP_OK)
+        ESP_LOGE(TAG, "write key='%s' failed: %s", key, esp_err_to_name(err));
+    return err;
+}
+
+esp_err_t nvs_cfg_get_str(const char *key, char *out, size_t *len)
+{
+    return cfg_get(key, WRITE_JOURNAL_STR, out, len);
+}
+
+esp_err_t nvs_cfg_get_blob(const char *key, void *out, size_t *len)
+{
+    return cfg_get(key, WRITE_JOURNAL_BLOB, out, len);
+}
+
+esp_err_t nvs_cfg_set_str(const char *key, const char *value)
+{
+    return cfg_put(key, WRITE_JOURNAL_STR, value, value ? strlen(value) + 1 : 0);
+}
+
+esp_err_t nvs_cfg_set_blob(const char *key, const void *data, size_t len)
+{
+    return cfg_put(key, WRITE_JOURNAL_BLOB, data, len);
+}
+
+esp_err_t nvs_cfg_erase_key(const char *key)
+{
+    return cfg_put(key, WRITE_JOURNAL_ERASE, NULL, 0);
+}
+
+static int txn_get(void *ctx, const char *key, write_journal_kind_t kind, bool committed, void *out, size_t *len)
+{
+    (void)ctx;
+    if (!committed)
+        return cfg_get(key, kind, out, len);
+
+    // caller holds the lock, so no flush is half done
     nvs_handle_t nvs;
-    esp_err_t err = nvs_open(NVS_NS_CFG, NVS_READONLY, &nvs);
+    esp_err_t err = cfg_handle(NVS_READONLY, &nvs);
+    if (err == ESP_OK)
+        err = (kind == WRITE_JOURNAL_STR) ? get_str_value(nvs, key, (char *)out, len) : nvs_get_blob(nvs, key, out, len);
+    return err;
+}
+
+static int txn_put(void *ctx, const char *key, write_journal_kind_t kind, const void *data, size_t len)
+{
+    (void)ctx;
+    return cfg_put(key, kind, data, len);
+}
+
+static const ab_txn_store_t s_txn_store = {
+    .get = txn_get,
+    .put = txn_put,
+    .ctx = NULL,
+    .not_found = ESP_ERR_NVS_NOT_FOUND,
+    .corrupt = ESP_FAIL,
+};
+
+esp_err_t nvs_cfg_txn_generation(const char *group, uint32_t *out_gen)
+{
+    if (!group || !out_gen)
+        return ESP_ERR_INVALID_ARG;
+
+    nvs_cfg_lock();
+    const esp_err_t err = ab_txn_generation(&s_txn_store, group, false, out_gen);
+    nvs_cfg_unlock();
+    return err;
+}
+
+esp_err_t nvs_cfg_txn_get_str(uint32_t gen, const char *key, char *out, size_t *len)
+{
+    if (!key || !len)
+        return ESP_ERR_INVALID_ARG;
+
+    return ab_txn_read(&s_txn_store, gen, key, WRITE_JOURNAL_STR, out, len);
+}
+
+esp_err_t nvs_cfg_txn_write(const char *group, const ab_txn_item_t *items, size_t count)
+{
+    if (!group || (!items && count > 0))
+        return ESP_ERR_INVALID_ARG;
+
+    // slot keys, then the generation word, queued in that order; a flush that a
+    // full journal forces in between commits only whole generations (ab_txn.h)
+    nvs_cfg_lock();
+    const esp_err_t err = ab_txn_write(&s_txn_store, group, items, count);
+    nvs_cfg_unlock();
+
     if (err != ESP_OK)
+        ESP_LOGE(TAG, "transaction '%s' failed: %s", group, esp_err_to_name(err));
+    return err;
+}
+
+esp_err_t nvs_cfg_flush(void)
+{
+    nvs_cfg_lock();
+    if (s_flush_timer)
+        (void)esp_timer_stop(s_flush_timer);
+    const esp_err_t err = flush_locked();
+    nvs_cfg_unlock();
+    return err;
+}
+
+void nvs_cfg_stats(nvs_cfg_stats_t *out)
+{
+    if (!out)
+        return;
+
+    memset(out, 0, sizeof(*out));
+    nvs_cfg_lock();
+    if (s_journal_ready)
+    {
+        out->journal = s_journal.stats;
+        out->pending = write_journal_pending(&s_journal);
+    }
+    out->direct_commits = s_direct_commits;
+    out->read = s_lat_read;
+    out->write = s_lat_write;
+    out->flush = s_lat_flush;
+    nvs_cfg_unlock();
+}
+
+// value size of one key; integers carry their width in the low type bits
+static uint32_t key_bytes(nvs_handle_t nvs, const nvs_entry_info_t *info)
+{
+    size_t len = 0;
+
+    if (info->type == NVS_TYPE_STR)
+        return (nvs_get_str(nvs, info->key, NULL, &len) == ESP_OK) ? (uint32_t)len : 0;
+    if (info->type == NVS_TYPE_BLOB)
+        return (nvs_get_blob(nvs, info->key, NULL, &len) == ESP_OK) ? (uint32_t)len : 0;
+    return (uint32_t)info->type & 0x0FU;
+}
+
+esp_err_t nvs_usage_keys(nvs_key_usage_t *out, size_t max, size_t *out_count)
+{
+    if (!out_count || (!out && max > 0))
+        return ESP_ERR_INVALID_ARG;
+
+    nvs_iterator_t it = NULL;
+    nvs_handle_t nvs = 0;
+    char open_ns[NVS_KEY_NAME_MAX_SIZE] = "";
+    size_t n = 0;
+
+    // under the lock so a flush does not move entries mid-walk
+    nvs_cfg_lock();
+    esp_err_t err = nvs_entry_find(NVS_DEFAULT_PART_NAME, NULL, NVS_TYPE_ANY, &it);
+    while (err == ESP_OK)
+    {
+        nvs_entry_info_t info;
+        err = nvs_entry_info(it, &info);
+        if (err == ESP_OK && n < max)
+        {
+            // entries come grouped by page, not by namespace: reopen on change only
+            if (strcmp(open_ns, info.namespace_name) != 0)
+            {
+                if (open_ns[0] != '\0')
+                    nvs_close(nvs);
+                open_ns[0] = '\0';
+                if (nvs_open(info.namespace_name, NVS_READONLY, &nvs) == ESP_OK)
+                    snprintf(open_ns, sizeof(open_ns), "%s", info.namespace_name);
+            }
+
+            nvs_key_usage_t *u = &out[n];
+            snprintf(u->ns, sizeof(u->ns), "%s", info.namespace_name);
+            snprintf(u->key, sizeof(u->key), "%s", info.key);
+            u->type = info.type;
+            u->bytes = (open_ns[0] != '\0') ? key_bytes(nvs, &info) : 0;
+            u->entries = (info.type == NVS_TYPE_STR || info.type == NVS_TYPE_BLOB)
+                             ? (uint16_t)(1U + (u->bytes + NVS_ENTRY_BYTES - 1U) / NVS_ENTRY_BYTES)
+                             : 1U;
+        }
+        if (err == ESP_OK)
+        {
+            n++;
+            err = nvs_entry_next(&it);
+        }
+    }
+    nvs_release_iterator(it);
+    if (open_ns[0] != '\0')
+        nvs_close(nvs);
+    nvs_cfg_unlock();
+
+    // the iterator ends (or never starts) with NOT_FOUND
+    if (err == ESP_ERR_NVS_NOT_FOUND)
+        err = ESP_OK;
+    *out_count = n;
+    return err;
+}
+
+static void flush_timer_cb(void *arg)
+{
+    (void)arg;
+    (void)xTaskNotifyGive(s_flush_task);
+}
+
+static void flush_task(void *arg)
+{
+    (void)arg;
+    for (;;)
+    {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        // a failure re-arms the timer with backoff (flush_locked)
+        (void)nvs_cfg_flush();
+    }
+}
+
+static void flush_on_shutdown(void)
+{
+    (void)nvs_cfg_flush();
+}
+
+esp_err_t nvs_cfg_init(void)
+{
+    if (s_flush_timer)
+        return ESP_OK;
+
+    const esp_timer_create_args_t args = {
+        .callback = flush_timer_cb,
+        .arg = NULL,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "nvs_flush",
+    };
+
+    esp_timer_handle_t timer = NULL;
+    esp_err_t err = esp_timer_create(&args, &timer);
+    if (err != ESP_OK)
+        return err; // stays write-through
+
+    if (xTaskCreate(flush_task, "nvs_flush", NVS_FLUSH_TASK_STACK, NULL, 4, &s_flush_task) != pdPASS)
+    {
+        ESP_LOGW(TAG, "no flush task, staying write-through");
+        (void)esp_timer_delete(timer);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // esp_restart() runs this before rebooting
+    err = esp_register_shutdown_handler(flush_on_shutdown);
+    if (err != ESP_OK)
+    {
+        ESP_LOGW(TAG, "no shutdown hook (%s), staying write-through", esp_err_to_name(err));
+        vTaskDelete(s_flush_task);
+        s_flush_task = NULL;
+        (void)esp_timer_delete(timer);
         return err;
+    }
+
+    nvs_cfg_lock();
+    s_flush_timer = timer;
+    nvs_cfg_unlock();
+
+    ESP_LOGI(TAG, "write-behind: %d ms quiet period, %u byte journal", CORE_NVS_WRITE_BEHIND_MS,
+             (unsigned)NVS_JOURNAL_BYTES);
+    return ESP_OK;
+}
+
+esp_err_t nvs_load_json(const char *key, char *out_buf, size_t out_len)
+{
+    if (!key || !out_buf || out_len == 0)
+        return ESP_ERR_INVALID_ARG;
 
     size_t len = out_len;
-    err = nvs_get_str(nvs, key, out_buf, &len);
-    nvs_close(nvs);
+    esp_err_t err = nvs_cfg_get_str(key, out_buf, &len);
 
     if (err == ESP_ERR_NVS_NOT_FOUND)
         return ESP_ERR_NOT_FOUND;
@@ -27,26 +659,29 @@ esp_err_t nvs_load_json(const char *key, char *out_buf, size_t out_len)
     return err;
 }
 
-esp_err_t nvs_save_json(const char *key, const char *json)
+esp_err_t nvs_json_len(const char *key, size_t *out_len)
 {
-    if (!key || !json)
+    if (!key || !out_len)
         return ESP_ERR_INVALID_ARG;
 
-    nvs_handle_t nvs;
-    esp_err_t err = nvs_open(NVS_NS_CFG, NVS_READWRITE, &nvs);
-    if (err != ESP_OK)
-        return err;
+    size_t len = 0;
+    esp_err_t err = nvs_cfg_get_str(key, NULL, &len);
+
+    if (err == ESP_ERR_NVS_NOT_FOUND)
+        return ESP_ERR_NOT_FOUND;
 
-    err = nvs_set_str(nvs, key, json);
     if (err == ESP_OK)
-        err = nvs_commit(nvs);
+        *out_len = len;
 
-    nvs_close(nvs);
+    return err;
+}
 
-    if (err != ESP_OK)
-        ESP_LOGE(TAG, "nvs_save_json key='%s' failed: %s", key, esp_err_to_name(err));
+esp_err_t nvs_save_json(const char *key, const char *json)
+{
+    if (!key || !json)
+        return ESP_ERR_INVALID_ARG;
 
-    return err;
+    return nvs_cfg_set_str(key, json);
 }
 
 esp_err_t nvs_erase_key_cfg(const char *key)
@@ -54,13 +689,42 @@ esp_err_t nvs_erase_key_cfg(const char *key)
     if (!key)
         return ESP_ERR_INVALID_ARG;
 
+    return nvs_cfg_erase_key(key);
+}
+
+void nvs_cfg_bench(void)
+{
+#if CORE_NVS_BENCH
+    const int rounds = 200;
+    const char *key = "bench_probe";
+    char buf[8];
     nvs_handle_t nvs;
-    esp_err_t err = nvs_open(NVS_NS_CFG, NVS_READWRITE, &nvs);
-    if (err != ESP_OK)
-        return err;
 
-    (void)nvs_erase_key(nvs, key);
-    err = nvs_commit(nvs);
-    nvs_close(nvs);
-    return err;
-}
\ No newline at end of file
+    // value to read, on flash so the pooled reads do not come from the journal
+    if (nvs_save_json(key, "x") != ESP_OK || nvs_cfg_flush() != ESP_OK)
+        return;
+
+    int64_t t0 = esp_timer_get_time();
+    for (int i = 0; i < rounds; i++)
+    {
+        size_t len = sizeof(buf);
+        if (nvs_open(NVS_NS_CFG, NVS_READONLY, &nvs) == ESP_OK)
+        {
+            (void)nvs_get_str(nvs, key, buf, &len);
+            nvs_close(nvs);
+        }
+    }
+    const int64_t t_open = esp_timer_get_time() - t0;
+
+    t0 = esp_timer_get_time();
+    for (int i = 0; i < rounds; i++)
+        (void)nvs_load_json(key, buf, sizeof(buf));
+    const int64_t t_pooled = esp_timer_get_time() - t0;
+
+    (void)nvs_erase_key_cfg(key);
+    (void)nvs_cfg_flush();
+
+    ESP_LOGI(TAG, "bench get_str: open/close %lld us/op, pooled %lld us/op (%d rounds)",
+             (long long)(t_open / rounds), (long long)(t_pooled / rounds), rounds);
+#endif
+}
@@ -0,0 +1,178 @@
+#include "http/http_conn.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "core_config.h"
+
+static const char *TAG = "http_conn";
+
+#define SWEEP_PERIOD_US (1000LL * 1000LL)
+#define IDLE_US ((int64_t)CORE_HTTP_KEEPALIVE_IDLE_S * 1000LL * 1000LL)
+
+typedef struct
+{
+    bool used;
+    bool closing;
+    int fd;
+    uint32_t requests;
+    int64_t last_us;
+    char keep_alive[32]; // Keep-Alive value; httpd keeps the pointer until the response is out
+} conn_t;
+
+static conn_t s_conns[HTTP_CONN_MAX_SOCKETS];
+static http_conn_stats_t s_stats;
+static esp_timer_handle_t s_sweep_timer = NULL;
+
+// fd < 0: a free slot
+static conn_t *find(int fd)
+{
+    for (size_t i = 0; i < HTTP_CONN_MAX_SOCKETS; i++)
+    {
+        if (fd < 0 ? !s_conns[i].used : (s_conns[i].used && s_conns[i].fd == fd))
+            return &s_conns[i];
+    }
+    return NULL;
+}
+
+esp_err_t http_conn_on_open(httpd_handle_t hd, int sockfd)
+{
+    (void)hd;
+
+    s_stats.opened++;
+    s_stats.open++;
+    if (s_stats.open > s_stats.peak_open)
+        s_stats.peak_open = s_stats.open;
+
+    // ohne freien Platz nicht verfolgt: Antworten schließen dann die Verbindung
+    conn_t *c = find(-1);
+    if (c)
+        *c = (conn_t){.used = true, .fd = sockfd, .last_us = esp_timer_get_time()};
+    return ESP_OK;
+}
+
+void http_conn_on_close(httpd_handle_t hd, int sockfd)
+{
+    (void)hd;
+
+    conn_t *c = find(sockfd);
+    if (c)
+        c->used = false;
+    s_stats.closed++;
+    if (s_stats.open > 0)
+        s_stats.open--;
+
+    close(sockfd);
+}
+
+void http_conn_request_begin(httpd_req_t *req)
+{
+    conn_t *c = find(httpd_req_to_sockfd(req));
+
+    s_stats.requests++;
+    if (!c)
+        return;
+
+    if (c->requests > 0)
+        s_stats.reused++;
+    c->requests++;
+    c->last_us = esp_timer_get_time();
+
+    // httpd schließt erst, wenn der Handler zurück ist — die Antwort geht noch raus
+    if (CORE_HTTP_KEEPALIVE_IDLE_S > 0 && c->requests >= CORE_HTTP_KEEPALIVE_MAX_REQUESTS && !c->closing &&
+        httpd_sess_trigger_close(req->handle, c->fd) == ESP_OK)
+    {
+        c->closing = true;
+        s_stats.closed_cap++;
+    }
+}
+
+void http_conn_request_end(httpd_req_t *req)
+{
+    conn_t *c = find(httpd_req_to_sockfd(req));
+
+    // ein langer Handler (Wetter-Abruf) zählt nicht als Leerlauf
+    if (c)
+        c->last_us = esp_timer_get_time();
+}
+
+void http_conn_set_headers(httpd_req_t *req)
+{
+    conn_t *c = find(httpd_req_to_sockfd(req));
+
+    if (!c || c->closing || CORE_HTTP_KEEPALIVE_IDLE_S == 0)
+    {
+        httpd_resp_set_hdr(req, "Connection", "close");
+        return;
+    }
+
+    snprintf(c->keep_alive, sizeof(c->keep_alive), "timeout=%u, max=%u", (unsigned)CORE_HTTP_KEEPALIVE_IDLE_S,
+             (unsigned)(CORE_HTTP_KEEPALIVE_MAX_REQUESTS - c->requests));
+    httpd_resp_set_hdr(req, "Connection", "keep-alive");
+    httpd_resp_set_hdr(req, "Keep-Alive", c->keep_alive);
+}
+
+// läuft als httpd-Arbeit im Server-Task, nie während eines Handlers
+static void sweep_work(void *arg)
+{
+    httpd_handle_t hd = arg;
+    const int64_t now = esp_timer_get_time();
+
+    for (size_t i = 0; i < HTTP_CONN_MAX_SOCKETS; i++)
+    {
+        conn_t *c = &s_conns[i];
+        if (!c->used || c->closing || now - c->last_us < IDLE_US)
+            continue;
+
+        const esp_err_t err = httpd_sess_trigger_close(hd, c->fd);
+        if (err == ESP_OK)
+        {
+            c->closing = true;
+            s_stats.closed_idle++;
+        }
+        else if (err == ESP_ERR_NOT_FOUND)
+        {
+            // Sitzung ohne close_fn verschwunden (z. B. open_fn-Fehler in httpd)
+            c->used = false;
+        }
+        // sonst nächste Runde erneut versuchen
+    }
+}
+
+static void sweep_timer_cb(void *arg)
+{
+    if (httpd_queue_work(arg, sweep_work, arg) != ESP_OK)
+        ESP_LOGW(TAG, "sweep not queued");
+}
+
+esp_err_t http_conn_start(httpd_handle_t hd)
+{
+    if (CORE_HTTP_KEEPALIVE_IDLE_S == 0 || s_sweep_timer != NULL)
+        return ESP_OK;
+
+    const esp_timer_create_args_t args = {
+        .callback = sweep_timer_cb,
+        .arg = hd,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "http_idle",
+    };
+
+    esp_err_t err = esp_timer_create(&args, &s_sweep_timer);
+    if (err == ESP_OK)
+        err = esp_timer_start_periodic(s_sweep_timer, SWEEP_PERIOD_US);
+    if (err != ESP_OK)
+        ESP_LOGE(TAG, "idle sweep not started: %s", esp_err_to_name(err));
+    else
+        ESP_LOGI(TAG, "keep-alive: idle %us, max %u requests", (unsigned)CORE_HTTP_KEEPALIVE_IDLE_S,
+                 (unsigned)CORE_HTTP_KEEPALIVE_MAX_REQUESTS);
+    return err;
+}
+
+void http_conn_stats(http_conn_stats_t *out)
+{
+    *out = s_stats;
+}
@@ -2,6 +2,11 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "core_config.h"
+#include "app/app_buf_pool.h"
+#include "app/app_json_arena.h"
+#include "http/http_conn.h"
+
 bool http_read_body(httpd_req_t *req, char *buf, size_t buf_len, size_t *out_len)
 {
     if (!req || !buf || buf_len < 2)
@@ -33,6 +38,47 @@ bool http_read_body(httpd_req_t *req, char *buf, size_t buf_len, size_t *out_len
     return true;
 }
 
+static int hex_value(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+bool http_url_decode(char *s)
+{
+    if (!s)
+        return false;
+
+    char *out = s;
+    for (const char *in = s; *in != '\0'; in++)
+    {
+        if (*in == '+')
+        {
+            *out++ = ' ';
+        }
+        else if (*in == '%')
+        {
+            const int hi = hex_value(in[1]);
+            const int lo = (hi >= 0) ? hex_value(in[2]) : -1;
+            if (lo < 0 || (hi == 0 && lo == 0))
+                return false;
+            *out++ = (char)((hi << 4) | lo);
+            in += 2;
+        }
+        else
+        {
+            *out++ = *in;
+        }
+    }
+    *out = '\0';
+    return true;
+}
+
 static void set_status(httpd_req_t *req, int code)
 {
     if (code == 200)
@@ -45,18 +91,27 @@ static void set_status(httpd_req_t *req, int code)
         httpd_resp_set_status(req, "404 Not Found");
     else if (code == 409)
         httpd_resp_set_status(req, "409 Conflict");
+    else if (code == 412)
+        httpd_resp_set_status(req, "412 Precondition Failed");
     else if (code == 502)
         httpd_resp_set_status(req, "502 Bad Gateway");
+    else if (code == 503)
+        httpd_resp_set_status(req, "503 Service Unavailable");
     else
         httpd_resp_set_status(req, "500 Internal Server Error");
 }
 
-void http_send_json(httpd_req_t *req, int status_code, const char *json)
+static void set_json_headers(httpd_req_t *req, int status_code)
 {
     set_status(req, status_code);
     httpd_resp_set_type(req, "application/json");
     httpd_resp_set_hdr(req, "Cache-Control", "no-store");
-    httpd_resp_set_hdr(req, "Connection", "close");
+    http_conn_set_headers(req);
+}
+
+void http_send_json(httpd_req_t *req, int status_code, const char *json)
+{
+    set_json_headers(req, status_code);
     httpd_resp_send(req, json ? json : "{}", HTTPD_RESP_USE_STRLEN);
 }
 
@@ -70,3 +125,89 @@ void http_send_err(httpd_req_t *req, int status_code, const char *msg)
     snprintf(buf, sizeof(buf), "{\"ok\":false,\"error\":\"%s\"}", msg);
     http_send_json(req, status_code, buf);
 }
+
+// user_ctx der Registrierung zeigt auf den Original-Deskriptor
+static esp_err_t dispatch(httpd_req_t *req)
+{
+    const httpd_uri_t *uri = req->user_ctx;
+
+    req->user_ctx = uri->user_ctx;
+    http_conn_request_begin(req);
+    const esp_err_t err = uri->handler(req);
+    http_conn_request_end(req);
+    return err;
+}
+
+esp_err_t http_register_uri(httpd_handle_t server, const httpd_uri_t *uri)
+{
+    httpd_uri_t wrapped = *uri;
+    wrapped.handler = dispatch;
+    wrapped.user_ctx = (void *)uri;
+    return httpd_register_uri_handler(server, &wrapped);
+}
+
+esp_err_t http_scoped(httpd_req_t *req, esp_err_t (*handler)(httpd_req_t *))
+{
+    app_json_arena_enter();
+    const esp_err_t err = handler(req);
+    app_json_arena_leave();
+
+#if CORE_BUF_POOL_LEAK_CHECK
+    (void)app_buf_pool_check_leaks(req->uri);
+#endif
+    return err;
+}
+
+void http_stream_begin(http_stream_t *s, httpd_req_t *req, int status_code)
+{
+    s->req = req;
+    s->len = 0;
+    s->cap = APP_BUF_SMALL;
+    s->buf = app_buf_borrow(s->cap);
+    s->err = s->buf ? ESP_OK : ESP_ERR_NO_MEM;
+    if (s->buf)
+        set_json_headers(req, status_code);
+}
+
+static void stream_flush(http_stream_t *s)
+{
+    if (s->err == ESP_OK && s->len > 0)
+        s->err = httpd_resp_send_chunk(s->req, s->buf, (ssize_t)s->len);
+    s->len = 0;
+}
+
+void http_stream_write(http_stream_t *s, const char *data, size_t len)
+{
+    if (s->err != ESP_OK)
+        return;
+
+    if (s->len + len > s->cap)
+        stream_flush(s);
+
+    // larger than the whole buffer -> own chunk
+    if (len > s->cap)
+    {
+        if (s->err == ESP_OK)
+            s->err = httpd_resp_send_chunk(s->req, data, (ssize_t)len);
+        return;
+    }
+
+    memcpy(s->buf + s->len, data, len);
+    s->len += len;
+}
+
+void http_stream_write_str(http_stream_t *s, const char *str)
+{
+    http_stream_write(s, str, strlen(str));
+}
+
+esp_err_t http_stream_end(http_stream_t *s)
+{
+    stream_flush(s);
+    if (s->err == ESP_OK)
+        s->err = httpd_resp_send_chunk(s->req, NULL, 0);
+
+    app_buf_return(s->buf);
+    s->buf = NULL;
+    return s->err;
+}
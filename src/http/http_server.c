@@ -1,12 +1,15 @@
 #include "http/http_server.h"
+#include "http/http_conn.h"
 
 #include "esp_http_server.h"
 #include "esp_log.h"
 
 #include "http/routes_portal.h"
 #include "http/routes_api_wifi.h"
+#include "http/routes_api_config.h"
 #include "http/routes_api_locations.h"
 #include "http/routes_api_weather.h"
+#include "http/routes_api_system.h"
 #include "ui/ui_routes.h"
 
 static const char *TAG = "http_server";
@@ -25,15 +28,19 @@ esp_err_t http_server_start(void)
 
     // Deine getunten Settings übernehmen
     config.lru_purge_enable = true;
-    config.max_open_sockets = 7;
+    config.max_open_sockets = HTTP_CONN_MAX_SOCKETS;
     config.recv_wait_timeout = 5;
     config.send_wait_timeout = 5;
-    config.max_uri_handlers = 24;
+    config.max_uri_handlers = 32;
     config.stack_size = 12288;
 
     // Für später: /ui/* wildcard routes
     config.uri_match_fn = httpd_uri_match_wildcard;
 
+    // Keep-Alive für die API: Sitzungen zählen, Leerlauf und Anfragezahl begrenzen
+    config.open_fn = http_conn_on_open;
+    config.close_fn = http_conn_on_close;
+
     esp_err_t err = httpd_start(&s_server, &config);
     if (err != ESP_OK)
     {
@@ -42,11 +49,15 @@ esp_err_t http_server_start(void)
         return ESP_FAIL;
     }
 
+    (void)http_conn_start(s_server); // ohne Sweep schließen Verbindungen nur am Limit
+
     routes_portal_register(s_server);
     ui_routes_register(s_server);
     routes_api_wifi_register(s_server);
+    routes_api_config_register(s_server);
     routes_api_locations_register(s_server);
     routes_api_weather_register(s_server);
+    routes_api_system_register(s_server);
 
     ESP_LOGI(TAG, "HTTP server started. Open http://192.168.4.1/");
 
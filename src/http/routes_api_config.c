@@ -0,0 +1,130 @@
+#include "http/routes_api_config.h"
+#include "http/http_helpers.h"
+
+#include <string.h>
+
+#include "esp_http_server.h"
+#include "esp_log.h"
+
+#include "config_registry.h"
+#include "app/app_buf_pool.h"
+#include "app/app_config.h"
+
+static const char *TAG = "routes_api_config";
+
+// ein Eintrag pro Schlüssel, liegt auf dem Handler-Stack
+_Static_assert(sizeof(config_entry_t) * APP_CONFIG_COUNT <= 1024, "config entries too large for the stack");
+
+// alle Einstellungen als ein Objekt
+static void send_config(httpd_req_t *req, int status)
+{
+    config_entry_t entries[APP_CONFIG_COUNT];
+    for (size_t i = 0; i < APP_CONFIG_COUNT; i++)
+        entries[i].key = i;
+
+    if (app_config_get_many(entries, APP_CONFIG_COUNT) != ESP_OK)
+    {
+        http_send_err(req, 500, "load_failed");
+        return;
+    }
+
+    const config_registry_t *reg = app_config_registry();
+    const size_t len = config_registry_to_json(reg, entries, APP_CONFIG_COUNT, NULL, 0);
+
+    char *buf = app_buf_borrow(len + 1);
+    if (buf == NULL)
+    {
+        http_send_err(req, 503, "busy");
+        return;
+    }
+
+    if (config_registry_to_json(reg, entries, APP_CONFIG_COUNT, buf, len + 1) == len)
+        http_send_json(req, status, buf);
+    else
+        http_send_err(req, 500, "encode_failed");
+
+    app_buf_return(buf);
+    memset(entries, 0, sizeof(entries)); // Passwort nicht auf dem Stack liegen lassen
+}
+
+static esp_err_t api_config_get(httpd_req_t *req)
+{
+    send_config(req, 200);
+    return ESP_OK;
+}
+
+// PUT {"name":value,...}: alle oder keiner; Antwort wie GET
+static esp_err_t api_config_put(httpd_req_t *req)
+{
+    char *body = app_buf_borrow(APP_BUF_SMALL);
+    if (body == NULL)
+    {
+        http_send_err(req, 503, "busy");
+        return ESP_OK;
+    }
+
+    config_entry_t entries[APP_CONFIG_COUNT];
+    size_t count = 0;
+    config_parse_result_t res = CONFIG_PARSE_SYNTAX;
+
+    const bool body_ok = http_read_body(req, body, APP_BUF_SMALL, NULL);
+    if (body_ok)
+        res = config_registry_from_json(app_config_registry(), body, entries, APP_CONFIG_COUNT, &count);
+    app_buf_return(body);
+
+    if (!body_ok)
+    {
+        http_send_err(req, 400, "invalid_body");
+        return ESP_OK;
+    }
+
+    switch (res)
+    {
+    case CONFIG_PARSE_OK:
+        break;
+    case CONFIG_PARSE_UNKNOWN_KEY:
+        http_send_err(req, 400, "unknown_key");
+        return ESP_OK;
+    case CONFIG_PARSE_INVALID_VALUE:
+        http_send_err(req, 400, "invalid_value");
+        return ESP_OK;
+    case CONFIG_PARSE_DUPLICATE:
+        http_send_err(req, 400, "duplicate_key");
+        return ESP_OK;
+    default:
+        // TOO_MANY kann nur mit Duplikaten auftreten, die vorher erkannt werden
+        http_send_err(req, 400, "invalid_json");
+        return ESP_OK;
+    }
+
+    esp_err_t err = app_config_set_many(entries, count);
+    memset(entries, 0, sizeof(entries));
+    if (err == ESP_ERR_INVALID_ARG)
+    {
+        // wifi.pass ohne gespeichertes Profil
+        http_send_err(req, 400, "invalid_value");
+        return ESP_OK;
+    }
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "save failed: %s", esp_err_to_name(err));
+        http_send_err(req, 500, "save_failed");
+        return ESP_OK;
+    }
+
+    ESP_LOGI(TAG, "PUT config: %u key(s) saved", (unsigned)count);
+    send_config(req, 200);
+    return ESP_OK;
+}
+
+HTTP_SCOPED_HANDLER(api_config_get)
+HTTP_SCOPED_HANDLER(api_config_put)
+
+static const httpd_uri_t uri_get = {.uri = "/api/config", .method = HTTP_GET, .handler = api_config_get_scoped};
+static const httpd_uri_t uri_put = {.uri = "/api/config", .method = HTTP_PUT, .handler = api_config_put_scoped};
+
+void routes_api_config_register(httpd_handle_t server)
+{
+    http_register_uri(server, &uri_get);
+    http_register_uri(server, &uri_put);
+}
@@ -9,63 +9,231 @@
 #include "esp_http_server.h"
 #include "esp_log.h"
 
+#include "gazetteer.h"
+#include "locations_batch.h"
+#include "locations_coord.h"
 #include "locations_model.h"
+#include "locations_snapshot.h"
+#include "locations_spatial.h"
 #include "locations_storage.h"
-#include "app/app_locations_persistence.h"
+#include "app/app_gazetteer.h"
+#include "app/app_buf_pool.h"
+#include "app/app_locations_writer.h"
 
 static const char *TAG = "routes_api_locations";
 
-// GET /api/locations — alle Locations zurückgeben
+#define BATCH_BODY_MAX 4096
+#define BATCH_MAX_OPS 64
+// Body und Ops kommen aus dem Puffer-Pool
+_Static_assert(BATCH_BODY_MAX <= APP_BUF_MEDIUM, "batch body exceeds pool block");
+_Static_assert(BATCH_MAX_OPS * sizeof(locations_batch_op_t) <= APP_BUF_LARGE, "batch ops exceed pool block");
+#define LOCATIONS_URI_PREFIX "/api/locations/"
+#define ETAG_STR_MAX 12
+#define PATCH_MAX_OPS 4
+#define SEARCH_DEFAULT_LIMIT 10
+#define SEARCH_MAX_LIMIT 20
+
+// Koordinate als exakte Dezimalzahl (raw JSON number) anhängen
+static void add_coord(cJSON *obj, const char *key, int32_t e6)
+{
+    char buf[LOCATIONS_COORD_STR_MAX];
+    locations_coord_format(e6, buf, sizeof(buf));
+    cJSON_AddRawToObject(obj, key, buf);
+}
+
+// JSON-Zahlen -> Mikrograd; false wenn außerhalb des gültigen Bereichs
+static bool read_coords(const cJSON *j_lat, const cJSON *j_lon, location_t *loc)
+{
+    return cJSON_IsNumber(j_lat) && cJSON_IsNumber(j_lon) &&
+           locations_coord_from_double(j_lat->valuedouble, &loc->latitude_e6) &&
+           locations_coord_from_double(j_lon->valuedouble, &loc->longitude_e6) &&
+           locations_coord_lat_valid(loc->latitude_e6);
+}
+
+// Einzelne Änderung über den Writer-Task; wartet bis gespeichert
+static esp_err_t submit_one(locations_batch_op_type_t type, const location_t *loc)
+{
+    locations_batch_op_t op = {.type = type, .loc = *loc};
+    return app_locations_writer_submit(&op, 1, NULL);
+}
+
+// ESP_ERR_INVALID_ARG = Regel verletzt (Duplikat, voll, unbekannt), sonst Laden/Speichern fehlgeschlagen
+static void send_mutation_err(httpd_req_t *req, esp_err_t err, int rejected_code, const char *rejected_msg)
+{
+    if (err == ESP_ERR_INVALID_ARG)
+    {
+        http_send_err(req, rejected_code, rejected_msg);
+        return;
+    }
+
+    ESP_LOGE(TAG, "mutation failed: %s", esp_err_to_name(err));
+    // Speichern abgebrochen, Änderung kann trotzdem noch landen — Liste neu lesen
+    http_send_err(req, 500, (err == ESP_ERR_NOT_FINISHED) ? "save_outcome_unknown" : "save_failed");
+}
+
+// query value als Koordinate (Mikrograd, exakt aus dem Dezimaltext); false wenn fehlt oder ungültig
+static bool query_coord(const char *query, const char *key, int32_t *out_e6)
+{
+    char val[24] = {0};
+    if (httpd_query_key_value(query, key, val, sizeof(val)) != ESP_OK)
+        return false;
+
+    return locations_coord_parse(val, strlen(val), out_e6);
+}
+
+// query value als positive Ganzzahl; false wenn fehlt oder keine Zahl
+static bool query_uint(const char *query, const char *key, unsigned long *out)
+{
+    char val[12] = {0};
+    if (httpd_query_key_value(query, key, val, sizeof(val)) != ESP_OK)
+        return false;
+
+    char *end = NULL;
+    *out = strtoul(val, &end, 10);
+    return end != val && *end == '\0' && val[0] != '-';
+}
+
+// GET /api/locations?limit=20&after=Berlin — seitenweise, als Chunks gestreamt
+// Ohne limit kommt die ganze Liste; "next" nur wenn noch Einträge folgen (als after verwenden)
 static esp_err_t api_locations_get(httpd_req_t *req)
 {
-    locations_model_t model = {0};
-    esp_err_t err = app_locations_load(&model);
+    char query[160] = {0};
+    char after[96] = {0};
+    bool has_after = false;
+    unsigned long limit = LOCATIONS_MODEL_MAX_NUMBER;
 
-    if (err == ESP_ERR_NOT_FOUND)
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK)
     {
-        http_send_json(req, 200, "{\"locations\":[]}");
-        return ESP_OK;
+        char tmp[12] = {0};
+        if (httpd_query_key_value(query, "limit", tmp, sizeof(tmp)) != ESP_ERR_NOT_FOUND &&
+            (!query_uint(query, "limit", &limit) || limit < 1 || limit > LOCATIONS_MODEL_MAX_NUMBER))
+        {
+            http_send_err(req, 400, "invalid_limit");
+            return ESP_OK;
+        }
+
+        // after URL-kodiert (Namen mit Leerzeichen / Umlauten)
+        esp_err_t err = httpd_query_key_value(query, "after", after, sizeof(after));
+        if ((err != ESP_OK && err != ESP_ERR_NOT_FOUND) || (err == ESP_OK && !http_url_decode(after)))
+        {
+            http_send_err(req, 400, "invalid_cursor");
+            return ESP_OK;
+        }
+        has_after = (err == ESP_OK);
     }
-    if (err != ESP_OK)
+
+    // Snapshot des Writers lesen — kein NVS-Zugriff, keine Sperre
+    locations_snapshot_t *snap = app_locations_snapshot_acquire();
+    if (snap == NULL)
     {
         http_send_err(req, 500, "load_failed");
         return ESP_OK;
     }
+    const locations_model_t *model = locations_snapshot_model(snap);
 
-    char *buf = calloc(1, 2048);
-    if (buf == NULL)
+    // Cursor = Name des letzten Eintrags der vorigen Seite (Namensindex, O(1))
+    const location_t *loc = locations_model_first(model);
+    if (has_after)
     {
-        http_send_err(req, 500, "oom");
-        return ESP_OK;
+        const location_t *cursor = locations_model_find(model, after);
+        if (cursor == NULL)
+        {
+            locations_snapshot_release(snap);
+            http_send_err(req, 400, "invalid_cursor");
+            return ESP_OK;
+        }
+        loc = locations_model_next(model, cursor);
     }
 
-    if (!locations_storage_to_json(&model, buf, 2048))
+    // Speicher konstant: ein Eintrag + Chunk-Puffer, unabhängig von der Listenlänge
+    http_stream_t stream;
+    http_stream_begin(&stream, req, 200);
+    if (stream.err == ESP_ERR_NO_MEM)
     {
-        free(buf);
-        http_send_err(req, 500, "json_failed");
+        locations_snapshot_release(snap);
+        http_send_err(req, 503, "busy");
         return ESP_OK;
     }
+    http_stream_write_str(&stream, "{\"locations\":[");
+
+    const location_t *last = NULL;
+    size_t n = 0;
+    for (; loc != NULL && n < limit && stream.err == ESP_OK; loc = locations_model_next(model, loc))
+    {
+        char item[LOCATIONS_STORAGE_ITEM_JSON_MAX];
+        const size_t len = locations_storage_item_to_json(loc, item, sizeof(item));
+        if (len == 0)
+        {
+            stream.err = ESP_FAIL;
+            break;
+        }
+
+        if (n > 0)
+            http_stream_write(&stream, ",", 1);
+        http_stream_write(&stream, item, len);
+        last = loc;
+        n++;
+    }
 
-    ESP_LOGI(TAG, "GET locations: count=%u", (unsigned)model.count);
-    http_send_json(req, 200, buf);
-    free(buf);
+    http_stream_write_str(&stream, "]");
+    if (loc != NULL && last != NULL)
+    {
+        char next[LOCATIONS_STORAGE_NAME_JSON_MAX];
+        http_stream_write_str(&stream, ",\"next\":");
+        http_stream_write(&stream, next, locations_storage_name_to_json(last->name, next, sizeof(next)));
+    }
+    http_stream_write_str(&stream, "}");
+
+    const size_t total = model->count;
+    locations_snapshot_release(snap);
+
+    // Header sind schon raus — Fehler nur noch loggen, Verbindung schließen
+    if (http_stream_end(&stream) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "GET locations: stream aborted: %s", esp_err_to_name(stream.err));
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "GET locations: %u of %u", (unsigned)n, (unsigned)total);
     return ESP_OK;
 }
 
+// Koordinaten zu loc->name aus dem Gazetteer; übernimmt die Schreibweise des Eintrags
+static bool lookup_place(location_t *loc)
+{
+    const gazetteer_t *gz = app_gazetteer_get();
+    gazetteer_entry_t e;
+    if (gz == NULL || !gazetteer_find(gz, loc->name, &e))
+        return false;
+
+    snprintf(loc->name, sizeof(loc->name), "%.*s", (int)e.name_len, e.name);
+    loc->latitude_e6 = e.latitude_e6;
+    loc->longitude_e6 = e.longitude_e6;
+    return true;
+}
+
 // POST /api/locations — neue Location hinzufügen
 // Body: {"name":"Berlin","latitude":52.52,"longitude":13.405}
+//   oder {"name":"Berlin"} — Koordinaten aus dem Gazetteer
 static esp_err_t api_locations_post(httpd_req_t *req)
 {
-    char body[512];
-    size_t n = 0;
-    if (!http_read_body(req, body, sizeof(body), &n))
+    char *body = app_buf_borrow(APP_BUF_SMALL);
+    if (body == NULL)
     {
-        http_send_err(req, 400, "invalid_body");
+        http_send_err(req, 503, "busy");
         return ESP_OK;
     }
 
-    // JSON parsen
-    cJSON *root = cJSON_Parse(body);
+    // JSON parsen; cJSON kopiert alles, der Puffer geht sofort zurück
+    const bool body_ok = http_read_body(req, body, APP_BUF_SMALL, NULL);
+    cJSON *root = body_ok ? cJSON_Parse(body) : NULL;
+    app_buf_return(body);
+
+    if (!body_ok)
+    {
+        http_send_err(req, 400, "invalid_body");
+        return ESP_OK;
+    }
     if (root == NULL)
     {
         http_send_err(req, 400, "invalid_json");
@@ -76,7 +244,9 @@ static esp_err_t api_locations_post(httpd_req_t *req)
     const cJSON *j_lat = cJSON_GetObjectItemCaseSensitive(root, "latitude");
     const cJSON *j_lon = cJSON_GetObjectItemCaseSensitive(root, "longitude");
 
-    if (!cJSON_IsString(j_name) || !cJSON_IsNumber(j_lat) || !cJSON_IsNumber(j_lon))
+    // Koordinaten dürfen fehlen — dann kommen sie aus dem Gazetteer (exakter Name)
+    const bool by_name = (j_lat == NULL && j_lon == NULL);
+    if (!cJSON_IsString(j_name) || (!by_name && (!cJSON_IsNumber(j_lat) || !cJSON_IsNumber(j_lon))))
     {
         cJSON_Delete(root);
         http_send_err(req, 400, "missing_fields");
@@ -85,163 +255,677 @@ static esp_err_t api_locations_post(httpd_req_t *req)
 
     location_t loc = {0};
     snprintf(loc.name, sizeof(loc.name), "%s", j_name->valuestring);
-    loc.latitude = j_lat->valuedouble;
-    loc.longitude = j_lon->valuedouble;
     loc.is_active = false;
-    cJSON_Delete(root);
 
-    // Bestehende Locations laden
-    locations_model_t model = {0};
-    esp_err_t err = app_locations_load(&model);
-    if (err != ESP_OK && err != ESP_ERR_NOT_FOUND)
+    if (by_name)
     {
-        http_send_err(req, 500, "load_failed");
-        return ESP_OK;
+        cJSON_Delete(root);
+        if (!lookup_place(&loc))
+        {
+            http_send_err(req, 404, "unknown_place");
+            return ESP_OK;
+        }
     }
-
-    // Hinzufügen — locations_model_add prüft auf Duplikate und Max
-    if (!locations_model_add(&model, &loc))
+    else
     {
-        http_send_err(req, 409, "duplicate_or_full");
-        return ESP_OK;
+        const bool coords_ok = read_coords(j_lat, j_lon, &loc);
+        cJSON_Delete(root);
+
+        if (!coords_ok)
+        {
+            http_send_err(req, 400, "invalid_coordinates");
+            return ESP_OK;
+        }
     }
 
-    err = app_locations_save(&model);
+    // Hinzufügen über den Writer — locations_model_add prüft auf Duplikate und Max
+    esp_err_t err = submit_one(LOCATIONS_BATCH_ADD, &loc);
     if (err != ESP_OK)
     {
-        ESP_LOGE(TAG, "save failed: %s", esp_err_to_name(err));
-        http_send_err(req, 500, "save_failed");
+        send_mutation_err(req, err, 409, "duplicate_or_full");
         return ESP_OK;
     }
 
-    ESP_LOGI(TAG, "POST location added: '%s' (%.4f, %.4f)", loc.name, loc.latitude, loc.longitude);
+    char lat_str[LOCATIONS_COORD_STR_MAX];
+    char lon_str[LOCATIONS_COORD_STR_MAX];
+    locations_coord_format(loc.latitude_e6, lat_str, sizeof(lat_str));
+    locations_coord_format(loc.longitude_e6, lon_str, sizeof(lon_str));
+    ESP_LOGI(TAG, "POST location added: '%s' (%s, %s)", loc.name, lat_str, lon_str);
     http_send_json(req, 201, "{\"ok\":true}");
     return ESP_OK;
 }
 
+// ?name=<Name>, URL-dekodiert (München kommt als M%C3%BCnchen); 400 gesendet wenn false
+static bool query_name(httpd_req_t *req, location_t *loc)
+{
+    char query[128] = {0};
+    char enc[sizeof(loc->name) * 3] = {0}; // bis zu %XX je Byte
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK)
+    {
+        http_send_err(req, 400, "missing_query");
+        return false;
+    }
+    if (httpd_query_key_value(query, "name", enc, sizeof(enc)) != ESP_OK)
+    {
+        http_send_err(req, 400, "missing_name_param");
+        return false;
+    }
+    if (!http_url_decode(enc) || enc[0] == '\0' || strlen(enc) >= sizeof(loc->name))
+    {
+        http_send_err(req, 400, "invalid_name");
+        return false;
+    }
+
+    snprintf(loc->name, sizeof(loc->name), "%s", enc);
+    return true;
+}
+
 // DELETE /api/locations?name=Berlin
 static esp_err_t api_locations_delete(httpd_req_t *req)
 {
-    char name[32] = {0};
-    if (httpd_req_get_url_query_str(req, name, sizeof(name)) != ESP_OK)
+    location_t loc = {0};
+    if (!query_name(req, &loc))
+        return ESP_OK;
+
+    esp_err_t err = submit_one(LOCATIONS_BATCH_REMOVE, &loc);
+    if (err != ESP_OK)
+    {
+        send_mutation_err(req, err, 404, "not_found");
+        return ESP_OK;
+    }
+
+    ESP_LOGI(TAG, "DELETE location: '%s'", loc.name);
+    http_send_json(req, 200, "{\"ok\":true}");
+    return ESP_OK;
+}
+
+// PUT /api/locations/active?name=Berlin
+static esp_err_t api_locations_set_active(httpd_req_t *req)
+{
+    location_t loc = {0};
+    if (!query_name(req, &loc))
+        return ESP_OK;
+
+    // Gesuchte aktivieren, alle anderen deaktivieren (Lookup über Namensindex)
+    esp_err_t err = submit_one(LOCATIONS_BATCH_SET_ACTIVE, &loc);
+    if (err != ESP_OK)
+    {
+        send_mutation_err(req, err, 404, "not_found");
+        return ESP_OK;
+    }
+
+    ESP_LOGI(TAG, "PUT active location: '%s'", loc.name);
+    http_send_json(req, 200, "{\"ok\":true}");
+    return ESP_OK;
+}
+
+// GET /api/locations/nearest?lat=52.5&lon=13.4&k=3
+static esp_err_t api_locations_nearest(httpd_req_t *req)
+{
+    char query[96] = {0};
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK)
     {
         http_send_err(req, 400, "missing_query");
         return ESP_OK;
     }
 
-    char name_val[32] = {0};
-    if (httpd_query_key_value(name, "name", name_val, sizeof(name_val)) != ESP_OK)
+    int32_t lat = 0;
+    int32_t lon = 0;
+    if (!query_coord(query, "lat", &lat) || !query_coord(query, "lon", &lon) ||
+        !locations_coord_lat_valid(lat))
     {
-        http_send_err(req, 400, "missing_name_param");
+        http_send_err(req, 400, "invalid_coordinates");
         return ESP_OK;
     }
 
-    locations_model_t model = {0};
-    esp_err_t err = app_locations_load(&model);
-    if (err == ESP_ERR_NOT_FOUND)
+    // k optional, default 1
+    unsigned long k_val = 1;
+    char k_str[8] = {0};
+    if (httpd_query_key_value(query, "k", k_str, sizeof(k_str)) != ESP_ERR_NOT_FOUND &&
+        (!query_uint(query, "k", &k_val) || k_val < 1 || k_val > LOCATIONS_SPATIAL_MAX_K))
     {
-        http_send_err(req, 404, "not_found");
+        http_send_err(req, 400, "invalid_k");
         return ESP_OK;
     }
-    if (err != ESP_OK)
+
+    locations_snapshot_t *snap = app_locations_snapshot_acquire();
+    if (snap == NULL)
     {
         http_send_err(req, 500, "load_failed");
         return ESP_OK;
     }
 
-    if (!locations_model_remove(&model, name_val))
+    // hits zeigen in den Snapshot; erst nach dem Serialisieren freigeben
+    locations_spatial_hit_t hits[LOCATIONS_SPATIAL_MAX_K];
+    const size_t n = locations_spatial_nearest(locations_snapshot_model(snap), lat, lon, hits, (size_t)k_val);
+
+    cJSON *root = cJSON_CreateObject();
+    cJSON *arr = cJSON_AddArrayToObject(root, "locations");
+    bool ok = (root != NULL) && (arr != NULL);
+
+    for (size_t i = 0; ok && i < n; i++)
     {
-        http_send_err(req, 404, "not_found");
+        cJSON *obj = cJSON_CreateObject();
+        ok = (obj != NULL) && cJSON_AddItemToArray(arr, obj);
+        if (ok)
+        {
+            (void)cJSON_AddStringToObject(obj, "name", hits[i].loc->name);
+            add_coord(obj, "latitude", hits[i].loc->latitude_e6);
+            add_coord(obj, "longitude", hits[i].loc->longitude_e6);
+            (void)cJSON_AddBoolToObject(obj, "is_active", hits[i].loc->is_active);
+            (void)cJSON_AddNumberToObject(obj, "distance_m", (double)(uint32_t)(hits[i].distance_m + 0.5f));
+        }
+    }
+
+    char *printed = ok ? cJSON_PrintUnformatted(root) : NULL;
+    cJSON_Delete(root);
+    locations_snapshot_release(snap);
+
+    if (printed == NULL)
+    {
+        http_send_err(req, 500, "json_failed");
+        return ESP_OK;
+    }
+
+    ESP_LOGI(TAG, "GET nearest (%ld, %ld e-6) k=%u: hits=%u", (long)lat, (long)lon, (unsigned)k_val, (unsigned)n);
+    http_send_json(req, 200, printed);
+    cJSON_free(printed);
+    return ESP_OK;
+}
+
+// Eine Batch-Operation aus JSON lesen; false bei unbekanntem op oder fehlenden Feldern
+static bool read_batch_op(const cJSON *obj, locations_batch_op_t *op)
+{
+    const cJSON *j_op = cJSON_GetObjectItemCaseSensitive(obj, "op");
+    const cJSON *j_name = cJSON_GetObjectItemCaseSensitive(obj, "name");
+
+    if (!cJSON_IsString(j_op) || !cJSON_IsString(j_name) || j_name->valuestring[0] == '\0')
+        return false;
+
+    memset(op, 0, sizeof(*op));
+    snprintf(op->loc.name, sizeof(op->loc.name), "%s", j_name->valuestring);
+
+    if (strcmp(j_op->valuestring, "add") == 0)
+    {
+        op->type = LOCATIONS_BATCH_ADD;
+        return read_coords(cJSON_GetObjectItemCaseSensitive(obj, "latitude"),
+                           cJSON_GetObjectItemCaseSensitive(obj, "longitude"), &op->loc);
+    }
+    if (strcmp(j_op->valuestring, "remove") == 0)
+    {
+        op->type = LOCATIONS_BATCH_REMOVE;
+        return true;
+    }
+    if (strcmp(j_op->valuestring, "rename") == 0)
+    {
+        const cJSON *j_new = cJSON_GetObjectItemCaseSensitive(obj, "new_name");
+        if (!cJSON_IsString(j_new))
+            return false;
+
+        op->type = LOCATIONS_BATCH_RENAME;
+        snprintf(op->new_name, sizeof(op->new_name), "%s", j_new->valuestring);
+        return true;
+    }
+    if (strcmp(j_op->valuestring, "set_active") == 0)
+    {
+        op->type = LOCATIONS_BATCH_SET_ACTIVE;
+        return true;
+    }
+
+    return false;
+}
+
+static void send_batch_err(httpd_req_t *req, int code, const char *msg, size_t index)
+{
+    char buf[96];
+    snprintf(buf, sizeof(buf), "{\"ok\":false,\"error\":\"%s\",\"index\":%u}", msg, (unsigned)index);
+    http_send_json(req, code, buf);
+}
+
+// POST /api/locations/batch — mehrere Änderungen, alles oder nichts, ein NVS-Commit
+// Body: {"ops":[{"op":"add","name":"Berlin","latitude":52.52,"longitude":13.405},
+//               {"op":"rename","name":"Berlin","new_name":"Home"},
+//               {"op":"set_active","name":"Home"},{"op":"remove","name":"Munich"}]}
+static esp_err_t api_locations_batch(httpd_req_t *req)
+{
+    if (req->content_len <= 0 || req->content_len >= BATCH_BODY_MAX)
+    {
+        http_send_err(req, 400, "invalid_body");
+        return ESP_OK;
+    }
+
+    char *body = app_buf_borrow((size_t)req->content_len + 1);
+    if (body == NULL)
+    {
+        http_send_err(req, 503, "busy");
+        return ESP_OK;
+    }
+
+    bool body_ok = http_read_body(req, body, (size_t)req->content_len + 1, NULL);
+    cJSON *root = body_ok ? cJSON_Parse(body) : NULL;
+    app_buf_return(body);
+
+    if (!body_ok)
+    {
+        http_send_err(req, 400, "invalid_body");
+        return ESP_OK;
+    }
+    if (root == NULL)
+    {
+        http_send_err(req, 400, "invalid_json");
+        return ESP_OK;
+    }
+
+    const cJSON *j_ops = cJSON_GetObjectItemCaseSensitive(root, "ops");
+    const int count = cJSON_IsArray(j_ops) ? cJSON_GetArraySize(j_ops) : -1;
+    if (count <= 0 || count > BATCH_MAX_OPS)
+    {
+        cJSON_Delete(root);
+        http_send_err(req, 400, "invalid_ops");
         return ESP_OK;
     }
 
-    err = app_locations_save(&model);
+    // Erst alles parsen, dann anwenden
+    locations_batch_op_t *ops = app_buf_borrow((size_t)count * sizeof(*ops));
+    if (ops == NULL)
+    {
+        cJSON_Delete(root);
+        http_send_err(req, 503, "busy");
+        return ESP_OK;
+    }
+    memset(ops, 0, (size_t)count * sizeof(*ops));
+
+    for (int i = 0; i < count; i++)
+    {
+        if (!read_batch_op(cJSON_GetArrayItem(j_ops, i), &ops[i]))
+        {
+            app_buf_return(ops);
+            cJSON_Delete(root);
+            send_batch_err(req, 400, "invalid_op", (size_t)i);
+            return ESP_OK;
+        }
+    }
+    cJSON_Delete(root);
+
+    size_t failed = 0;
+    esp_err_t err = app_locations_writer_submit(ops, (size_t)count, &failed);
+    app_buf_return(ops);
+
+    if (err == ESP_ERR_INVALID_ARG)
+    {
+        send_batch_err(req, 409, "op_rejected", failed);
+        return ESP_OK;
+    }
     if (err != ESP_OK)
     {
-        ESP_LOGE(TAG, "save failed: %s", esp_err_to_name(err));
-        http_send_err(req, 500, "save_failed");
+        send_mutation_err(req, err, 409, "op_rejected");
         return ESP_OK;
     }
 
-    ESP_LOGI(TAG, "DELETE location: '%s'", name_val);
-    http_send_json(req, 200, "{\"ok\":true}");
+    ESP_LOGI(TAG, "POST batch: %d ops applied", count);
+
+    char resp[48];
+    snprintf(resp, sizeof(resp), "{\"ok\":true,\"applied\":%d}", count);
+    http_send_json(req, 200, resp);
     return ESP_OK;
 }
 
-// PUT /api/locations/active?name=Berlin
-static esp_err_t api_locations_set_active(httpd_req_t *req)
+// GET /api/locations/search?q=ber&limit=10 — Ortsvorschläge aus dem Gazetteer (Präfix, ohne Heap)
+static esp_err_t api_locations_search(httpd_req_t *req)
 {
-    char query[32] = {0};
-    if (httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK)
+    // q URL-kodiert: bis zu 3 Bytes pro Namensbyte
+    char query[160] = {0};
+    char q[3 * GAZETTEER_NAME_MAX + 1] = {0};
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK ||
+        httpd_query_key_value(query, "q", q, sizeof(q)) != ESP_OK || q[0] == '\0')
     {
-        http_send_err(req, 400, "missing_query");
+        http_send_err(req, 400, "missing_q");
+        return ESP_OK;
+    }
+    if (!http_url_decode(q) || strlen(q) > GAZETTEER_NAME_MAX)
+    {
+        http_send_err(req, 400, "invalid_q");
         return ESP_OK;
     }
 
-    char name_val[32] = {0};
-    if (httpd_query_key_value(query, "name", name_val, sizeof(name_val)) != ESP_OK)
+    unsigned long limit = SEARCH_DEFAULT_LIMIT;
+    char tmp[12] = {0};
+    if (httpd_query_key_value(query, "limit", tmp, sizeof(tmp)) != ESP_ERR_NOT_FOUND &&
+        (!query_uint(query, "limit", &limit) || limit < 1 || limit > SEARCH_MAX_LIMIT))
     {
-        http_send_err(req, 400, "missing_name_param");
+        http_send_err(req, 400, "invalid_limit");
         return ESP_OK;
     }
 
-    locations_model_t model = {0};
-    esp_err_t err = app_locations_load(&model);
-    if (err == ESP_ERR_NOT_FOUND)
+    const gazetteer_t *gz = app_gazetteer_get();
+    if (gz == NULL)
     {
-        http_send_err(req, 404, "not_found");
+        http_send_err(req, 503, "gazetteer_unavailable");
+        return ESP_OK;
+    }
+
+    // Treffer zeigen ins gemappte Flash
+    gazetteer_entry_t hits[SEARCH_MAX_LIMIT];
+    const size_t n = gazetteer_search(gz, q, hits, (size_t)limit);
+
+    http_stream_t stream;
+    http_stream_begin(&stream, req, 200);
+    if (stream.err == ESP_ERR_NO_MEM)
+    {
+        http_send_err(req, 503, "busy");
         return ESP_OK;
     }
+    http_stream_write_str(&stream, "{\"results\":[");
+
+    for (size_t i = 0; i < n; i++)
+    {
+        char name[GAZETTEER_NAME_MAX + 1];
+        char name_json[LOCATIONS_STORAGE_NAME_JSON_MAX];
+        char lat[LOCATIONS_COORD_STR_MAX];
+        char lon[LOCATIONS_COORD_STR_MAX];
+
+        snprintf(name, sizeof(name), "%.*s", (int)hits[i].name_len, hits[i].name);
+        locations_coord_format(hits[i].latitude_e6, lat, sizeof(lat));
+        locations_coord_format(hits[i].longitude_e6, lon, sizeof(lon));
+
+        http_stream_write_str(&stream, (i > 0) ? ",{\"name\":" : "{\"name\":");
+        http_stream_write(&stream, name_json, locations_storage_name_to_json(name, name_json, sizeof(name_json)));
+        http_stream_write_str(&stream, ",\"latitude\":");
+        http_stream_write_str(&stream, lat);
+        http_stream_write_str(&stream, ",\"longitude\":");
+        http_stream_write_str(&stream, lon);
+        http_stream_write_str(&stream, "}");
+    }
+    http_stream_write_str(&stream, "]}");
+
+    if (http_stream_end(&stream) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "GET search: stream aborted: %s", esp_err_to_name(stream.err));
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "GET search '%s': hits=%u", q, (unsigned)n);
+    return ESP_OK;
+}
+
+// Name aus /api/locations/{name}[?...], URL-dekodiert; false wenn leer, zu lang oder mit '/'
+static bool name_from_uri(httpd_req_t *req, char *out, size_t out_len)
+{
+    const char *p = req->uri + strlen(LOCATIONS_URI_PREFIX);
+    const size_t len = strcspn(p, "?");
+    char enc[96];
+
+    if (len == 0 || len >= sizeof(enc))
+        return false;
+
+    memcpy(enc, p, len);
+    enc[len] = '\0';
+    if (!http_url_decode(enc) || strchr(enc, '/') != NULL || strlen(enc) >= out_len)
+        return false;
+
+    snprintf(out, out_len, "%s", enc);
+    return true;
+}
+
+// Einzelne Location mit ETag senden; etag_buf muss bis zum Senden leben
+static void send_location(httpd_req_t *req, const location_t *loc, char etag_buf[ETAG_STR_MAX])
+{
+    char item[LOCATIONS_STORAGE_ITEM_JSON_MAX];
+    if (locations_storage_item_to_json(loc, item, sizeof(item)) == 0)
+    {
+        http_send_err(req, 500, "json_failed");
+        return;
+    }
+
+    snprintf(etag_buf, ETAG_STR_MAX, "\"%08lx\"", (unsigned long)locations_model_etag(loc));
+    httpd_resp_set_hdr(req, "ETag", etag_buf);
+    http_send_json(req, 200, item);
+}
+
+// If-Match: fehlt oder "*" -> keine Prüfung; sonst "xxxxxxxx" (auch W/"..."); false wenn ungültig
+static bool read_if_match(httpd_req_t *req, bool *out_check, uint32_t *out_etag)
+{
+    char val[24] = {0};
+    esp_err_t err = httpd_req_get_hdr_value_str(req, "If-Match", val, sizeof(val));
+
+    *out_check = false;
+    if (err == ESP_ERR_NOT_FOUND)
+        return true;
     if (err != ESP_OK)
+        return false;
+    if (strcmp(val, "*") == 0)
+        return true;
+
+    const char *p = (strncmp(val, "W/", 2) == 0) ? val + 2 : val;
+    char *end = NULL;
+    if (p[0] != '"')
+        return false;
+
+    const unsigned long tag = strtoul(p + 1, &end, 16);
+    if (end != p + 9 || end[0] != '"' || end[1] != '\0')
+        return false;
+
+    *out_check = true;
+    *out_etag = (uint32_t)tag;
+    return true;
+}
+
+// GET /api/locations/{name} — eine Location, mit ETag für PATCH/If-Match
+static esp_err_t api_locations_get_one(httpd_req_t *req)
+{
+    char name[32] = {0};
+    if (!name_from_uri(req, name, sizeof(name)))
     {
-        http_send_err(req, 500, "load_failed");
+        http_send_err(req, 400, "invalid_name");
+        return ESP_OK;
+    }
+
+    locations_snapshot_t *snap = app_locations_snapshot_acquire();
+    const location_t *loc = locations_model_find(locations_snapshot_model(snap), name);
+    if (loc == NULL)
+    {
+        locations_snapshot_release(snap);
+        http_send_err(req, (snap == NULL) ? 500 : 404, (snap == NULL) ? "load_failed" : "not_found");
+        return ESP_OK;
+    }
+
+    char etag[ETAG_STR_MAX];
+    send_location(req, loc, etag);
+    locations_snapshot_release(snap);
+    return ESP_OK;
+}
+
+// PATCH /api/locations/{name} — JSON Merge Patch (RFC 7396), alles in einem Writer-Durchlauf
+// Body: {"name":"Home","latitude":52.52,"longitude":13.405,"is_active":true} (jedes Feld optional)
+// If-Match: "<etag>" -> 412 wenn die Location inzwischen geändert wurde
+static esp_err_t api_locations_patch(httpd_req_t *req)
+{
+    char name[32] = {0};
+    if (!name_from_uri(req, name, sizeof(name)))
+    {
+        http_send_err(req, 400, "invalid_name");
+        return ESP_OK;
+    }
+
+    bool check = false;
+    uint32_t etag = 0;
+    if (!read_if_match(req, &check, &etag))
+    {
+        http_send_err(req, 400, "invalid_if_match");
+        return ESP_OK;
+    }
+
+    char *body = app_buf_borrow(APP_BUF_SMALL);
+    if (body == NULL)
+    {
+        http_send_err(req, 503, "busy");
+        return ESP_OK;
+    }
+
+    const bool body_ok = http_read_body(req, body, APP_BUF_SMALL, NULL);
+    cJSON *root = body_ok ? cJSON_Parse(body) : NULL;
+    app_buf_return(body);
+
+    if (!body_ok)
+    {
+        http_send_err(req, 400, "invalid_body");
+        return ESP_OK;
+    }
+    if (!cJSON_IsObject(root))
+    {
+        cJSON_Delete(root);
+        http_send_err(req, 400, "invalid_json");
         return ESP_OK;
     }
 
-    // Alle deaktivieren, gesuchte aktivieren
-    bool found = false;
-    for (size_t i = 0; i < model.count; i++)
+    // Reihenfolge: Prüfung, Koordinaten, Aktiv-Flag, zuletzt Umbenennen (alle adressieren den alten Namen)
+    locations_batch_op_t ops[PATCH_MAX_OPS];
+    size_t n = 0;
+    memset(ops, 0, sizeof(ops));
+
+    if (check)
     {
-        if (strcmp(model.items[i].name, name_val) == 0)
+        ops[n].type = LOCATIONS_BATCH_CHECK_ETAG;
+        ops[n++].etag = etag;
+    }
+
+    locations_batch_op_t coords = {.type = LOCATIONS_BATCH_SET_COORDS};
+    coords.loc.latitude_e6 = LOCATIONS_BATCH_KEEP_COORD;
+    coords.loc.longitude_e6 = LOCATIONS_BATCH_KEEP_COORD;
+    bool has_coords = false;
+    int active = -1;
+    const char *new_name = NULL;
+    const char *bad = NULL;
+
+    // null würde ein Pflichtfeld löschen -> invalid_patch; unbekannte Felder -> unknown_field
+    const cJSON *item = NULL;
+    cJSON_ArrayForEach(item, root)
+    {
+        if (strcmp(item->string, "name") == 0)
+        {
+            if (!cJSON_IsString(item) || item->valuestring[0] == '\0')
+                bad = "invalid_patch";
+            else
+                new_name = item->valuestring;
+        }
+        else if (strcmp(item->string, "latitude") == 0)
+        {
+            if (!cJSON_IsNumber(item) || !locations_coord_from_double(item->valuedouble, &coords.loc.latitude_e6) ||
+                !locations_coord_lat_valid(coords.loc.latitude_e6))
+                bad = "invalid_coordinates";
+            has_coords = true;
+        }
+        else if (strcmp(item->string, "longitude") == 0)
+        {
+            if (!cJSON_IsNumber(item) || !locations_coord_from_double(item->valuedouble, &coords.loc.longitude_e6))
+                bad = "invalid_coordinates";
+            has_coords = true;
+        }
+        else if (strcmp(item->string, "is_active") == 0)
         {
-            model.items[i].is_active = true;
-            found = true;
+            if (!cJSON_IsBool(item))
+                bad = "invalid_patch";
+            active = cJSON_IsTrue(item) ? 1 : 0;
         }
         else
         {
-            model.items[i].is_active = false;
+            bad = "unknown_field";
         }
+
+        if (bad != NULL)
+            break;
     }
 
-    if (!found)
+    if (bad == NULL && has_coords)
+        ops[n++] = coords;
+    if (bad == NULL && active >= 0)
+        ops[n++].type = (active == 1) ? LOCATIONS_BATCH_SET_ACTIVE : LOCATIONS_BATCH_DEACTIVATE;
+    if (bad == NULL && new_name != NULL && strcmp(new_name, name) != 0)
     {
-        http_send_err(req, 404, "not_found");
+        ops[n].type = LOCATIONS_BATCH_RENAME;
+        snprintf(ops[n++].new_name, sizeof(ops[0].new_name), "%s", new_name);
+    }
+    char final_name[32];
+    snprintf(final_name, sizeof(final_name), "%s", (bad == NULL && new_name != NULL) ? new_name : name);
+    cJSON_Delete(root);
+
+    if (bad != NULL)
+    {
+        http_send_err(req, 400, bad);
         return ESP_OK;
     }
 
-    err = app_locations_save(&model);
+    for (size_t i = 0; i < n; i++)
+        snprintf(ops[i].loc.name, sizeof(ops[i].loc.name), "%s", name);
+
+    size_t failed = 0;
+    esp_err_t err = (n > 0) ? app_locations_writer_submit(ops, n, &failed) : ESP_OK;
+
+    // Antwort aus dem frischen Snapshot (enthält mindestens diese Änderung)
+    locations_snapshot_t *snap = app_locations_snapshot_acquire();
+    const location_t *loc = locations_model_find(locations_snapshot_model(snap), (err == ESP_OK) ? final_name : name);
+
+    if (err == ESP_ERR_INVALID_ARG && loc != NULL)
+    {
+        const locations_batch_op_type_t type = ops[failed].type;
+        locations_snapshot_release(snap);
+        if (type == LOCATIONS_BATCH_CHECK_ETAG)
+            http_send_err(req, 412, "etag_mismatch");
+        else if (type == LOCATIONS_BATCH_RENAME)
+            http_send_err(req, 409, "name_taken");
+        else
+            http_send_err(req, 400, "invalid_patch");
+        return ESP_OK;
+    }
+    if (err == ESP_ERR_INVALID_ARG || (err == ESP_OK && loc == NULL))
+    {
+        locations_snapshot_release(snap);
+        http_send_err(req, 404, "not_found");
+        return ESP_OK;
+    }
     if (err != ESP_OK)
     {
-        ESP_LOGE(TAG, "save failed: %s", esp_err_to_name(err));
-        http_send_err(req, 500, "save_failed");
+        locations_snapshot_release(snap);
+        send_mutation_err(req, err, 409, "op_rejected");
         return ESP_OK;
     }
 
-    ESP_LOGI(TAG, "PUT active location: '%s'", name_val);
-    http_send_json(req, 200, "{\"ok\":true}");
+    ESP_LOGI(TAG, "PATCH location '%s': %u op(s)", name, (unsigned)n);
+    char etag_buf[ETAG_STR_MAX];
+    send_location(req, loc, etag_buf);
+    locations_snapshot_release(snap);
     return ESP_OK;
 }
 
-static const httpd_uri_t uri_get = {.uri = "/api/locations", .method = HTTP_GET, .handler = api_locations_get};
-static const httpd_uri_t uri_post = {.uri = "/api/locations", .method = HTTP_POST, .handler = api_locations_post};
+// Handler mit cJSON oder Pool-Puffern: Request-Arena + Leak-Check (http_scoped)
+HTTP_SCOPED_HANDLER(api_locations_get)
+HTTP_SCOPED_HANDLER(api_locations_post)
+HTTP_SCOPED_HANDLER(api_locations_nearest)
+HTTP_SCOPED_HANDLER(api_locations_batch)
+HTTP_SCOPED_HANDLER(api_locations_patch)
+HTTP_SCOPED_HANDLER(api_locations_search)
+
+static const httpd_uri_t uri_get = {.uri = "/api/locations", .method = HTTP_GET, .handler = api_locations_get_scoped};
+static const httpd_uri_t uri_post = {.uri = "/api/locations", .method = HTTP_POST, .handler = api_locations_post_scoped};
 static const httpd_uri_t uri_delete = {.uri = "/api/locations", .method = HTTP_DELETE, .handler = api_locations_delete};
 static const httpd_uri_t uri_active = {.uri = "/api/locations/active", .method = HTTP_PUT, .handler = api_locations_set_active};
+static const httpd_uri_t uri_nearest = {.uri = "/api/locations/nearest", .method = HTTP_GET, .handler = api_locations_nearest_scoped};
+static const httpd_uri_t uri_batch = {.uri = "/api/locations/batch", .method = HTTP_POST, .handler = api_locations_batch_scoped};
+static const httpd_uri_t uri_search = {.uri = "/api/locations/search", .method = HTTP_GET, .handler = api_locations_search_scoped};
+// Wildcards zuletzt registrieren: feste Pfade (nearest, search, ...) gewinnen
+static const httpd_uri_t uri_get_one = {.uri = LOCATIONS_URI_PREFIX "*", .method = HTTP_GET, .handler = api_locations_get_one};
+static const httpd_uri_t uri_patch = {.uri = LOCATIONS_URI_PREFIX "*", .method = HTTP_PATCH, .handler = api_locations_patch_scoped};
 
 void routes_api_locations_register(httpd_handle_t server)
 {
     ESP_LOGI(TAG, "register locations API routes");
-    httpd_register_uri_handler(server, &uri_get);
-    httpd_register_uri_handler(server, &uri_post);
-    httpd_register_uri_handler(server, &uri_delete);
-    httpd_register_uri_handler(server, &uri_active);
+    http_register_uri(server, &uri_get);
+    http_register_uri(server, &uri_post);
+    http_register_uri(server, &uri_delete);
+    http_register_uri(server, &uri_active);
+    http_register_uri(server, &uri_nearest);
+    http_register_uri(server, &uri_batch);
+    http_register_uri(server, &uri_search);
+    http_register_uri(server, &uri_get_one);
+    http_register_uri(server, &uri_patch);
 }
\ No newline at end of file
@@ -0,0 +1,271 @@
+#include "http/routes_api_system.h"
+#include "http/http_helpers.h"
+#include "http/http_conn.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_http_server.h"
+#include "esp_log.h"
+#include "nvs.h"
+
+#include "latency_hist.h"
+#include "app/app_buf_pool.h"
+#include "app/app_settings_persistence.h"
+#include "app/nvs_helpers.h"
+#include "core_config.h"
+
+static const char *TAG = "routes_api_system";
+
+// Schlüsselliste kommt aus dem Puffer-Pool; mehr Schlüssel werden nur gezählt
+#define STORAGE_MAX_KEYS (APP_BUF_LARGE / sizeof(nvs_key_usage_t))
+#define STORAGE_MAX_NAMESPACES 16
+
+typedef struct
+{
+    const char *ns;
+    uint32_t keys;
+    uint32_t entries;
+    uint32_t bytes;
+} ns_usage_t;
+
+static const char *type_name(nvs_type_t type)
+{
+    switch (type)
+    {
+    case NVS_TYPE_U8:
+        return "u8";
+    case NVS_TYPE_I8:
+        return "i8";
+    case NVS_TYPE_U16:
+        return "u16";
+    case NVS_TYPE_I16:
+        return "i16";
+    case NVS_TYPE_U32:
+        return "u32";
+    case NVS_TYPE_I32:
+        return "i32";
+    case NVS_TYPE_U64:
+        return "u64";
+    case NVS_TYPE_I64:
+        return "i64";
+    case NVS_TYPE_STR:
+        return "str";
+    case NVS_TYPE_BLOB:
+        return "blob";
+    default:
+        return "any";
+    }
+}
+
+// NVS-Namen sind kurz und praktisch immer ASCII; alles, was escaped werden müsste, wird '?'
+static void write_name(http_stream_t *s, const char *name)
+{
+    char out[NVS_KEY_NAME_MAX_SIZE + 2];
+    size_t n = 0;
+
+    out[n++] = '"';
+    for (size_t i = 0; name[i] != '\0' && i < NVS_KEY_NAME_MAX_SIZE - 1; i++)
+    {
+        const unsigned char c = (unsigned char)name[i];
+        out[n++] = (c < 0x20 || c >= 0x7F || c == '"' || c == '\\') ? '?' : (char)c;
+    }
+    out[n++] = '"';
+    http_stream_write(s, out, n);
+}
+
+static void write_hist(http_stream_t *s, const char *name, const latency_hist_t *h)
+{
+    char line[96];
+
+    snprintf(line, sizeof(line), "\"%s\":{\"count\":%lu,\"mean\":%lu,\"p99\":%lu,\"max\":%lu,\"hist\":[", name,
+             (unsigned long)h->samples, (unsigned long)latency_hist_mean(h),
+             (unsigned long)latency_hist_percentile(h, 99), (unsigned long)h->max_us);
+    http_stream_write_str(s, line);
+    for (size_t i = 0; i < LATENCY_HIST_BUCKETS; i++)
+    {
+        snprintf(line, sizeof(line), i ? ",%lu" : "%lu", (unsigned long)h->count[i]);
+        http_stream_write_str(s, line);
+    }
+    http_stream_write_str(s, "]}");
+}
+
+// Summen je Namespace; Namen zeigen in keys[] und bleiben gültig, solange die Liste lebt
+static size_t sum_namespaces(const nvs_key_usage_t *keys, size_t count, ns_usage_t *out, size_t max)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t j = 0;
+        while (j < n && strcmp(out[j].ns, keys[i].ns) != 0)
+            j++;
+        if (j == n)
+        {
+            if (n == max)
+                continue;
+            out[n++] = (ns_usage_t){.ns = keys[i].ns};
+        }
+        out[j].keys++;
+        out[j].entries += keys[i].entries;
+        out[j].bytes += keys[i].bytes;
+    }
+
+    return n;
+}
+
+// GET /api/system/storage: Belegung der NVS-Partition, Schlüssel mit Größe,
+// Journal-Zähler und Latenzen von nvs_helpers (Partitionsgröße planen,
+// Schreibverstärkung im Feld erkennen)
+static esp_err_t api_system_storage_get(httpd_req_t *req)
+{
+    nvs_stats_t part = {0};
+    const esp_err_t part_err = nvs_get_stats(NVS_DEFAULT_PART_NAME, &part);
+
+    nvs_key_usage_t *keys = app_buf_borrow(STORAGE_MAX_KEYS * sizeof(nvs_key_usage_t));
+    if (keys == NULL)
+    {
+        http_send_err(req, 503, "busy");
+        return ESP_OK;
+    }
+
+    size_t total = 0;
+    esp_err_t err = nvs_usage_keys(keys, STORAGE_MAX_KEYS, &total);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "key walk failed: %s", esp_err_to_name(err));
+        app_buf_return(keys);
+        http_send_err(req, 500, "load_failed");
+        return ESP_OK;
+    }
+    const size_t listed = (total < STORAGE_MAX_KEYS) ? total : STORAGE_MAX_KEYS;
+
+    ns_usage_t ns[STORAGE_MAX_NAMESPACES];
+    const size_t ns_count = sum_namespaces(keys, listed, ns, STORAGE_MAX_NAMESPACES);
+
+    nvs_cfg_stats_t st;
+    nvs_cfg_stats(&st);
+    app_settings_cache_stats_t cache;
+    app_settings_cache_stats(&cache);
+
+    http_stream_t stream;
+    http_stream_begin(&stream, req, 200);
+    if (stream.err == ESP_ERR_NO_MEM)
+    {
+        app_buf_return(keys);
+        http_send_err(req, 503, "busy");
+        return ESP_OK;
+    }
+
+    char line[192];
+
+    // Partition (Einträge zu 32 Byte); ohne Statistik nur null
+    if (part_err == ESP_OK)
+        snprintf(line, sizeof(line),
+                 "{\"partition\":{\"total_entries\":%u,\"used_entries\":%u,\"free_entries\":%u,"
+                 "\"available_entries\":%u,\"namespaces\":%u}",
+                 (unsigned)part.total_entries, (unsigned)part.used_entries, (unsigned)part.free_entries,
+                 (unsigned)part.available_entries, (unsigned)part.namespace_count);
+    else
+        snprintf(line, sizeof(line), "{\"partition\":null");
+    http_stream_write_str(&stream, line);
+
+    http_stream_write_str(&stream, ",\"namespaces\":[");
+    for (size_t i = 0; i < ns_count; i++)
+    {
+        http_stream_write_str(&stream, i ? ",{\"name\":" : "{\"name\":");
+        write_name(&stream, ns[i].ns);
+        snprintf(line, sizeof(line), ",\"keys\":%lu,\"used_entries\":%lu,\"bytes\":%lu}", (unsigned long)ns[i].keys,
+                 (unsigned long)ns[i].entries, (unsigned long)ns[i].bytes);
+        http_stream_write_str(&stream, line);
+    }
+
+    http_stream_write_str(&stream, "],\"keys\":[");
+    for (size_t i = 0; i < listed && stream.err == ESP_OK; i++)
+    {
+        http_stream_write_str(&stream, i ? ",{\"ns\":" : "{\"ns\":");
+        write_name(&stream, keys[i].ns);
+        http_stream_write_str(&stream, ",\"key\":");
+        write_name(&stream, keys[i].key);
+        snprintf(line, sizeof(line), ",\"type\":\"%s\",\"bytes\":%lu,\"entries\":%u}", type_name(keys[i].type),
+                 (unsigned long)keys[i].bytes, (unsigned)keys[i].entries);
+        http_stream_write_str(&stream, line);
+    }
+    // mehr Schlüssel als Platz: Liste ist abgeschnitten, Summen zählen nur die gelisteten
+    snprintf(line, sizeof(line), "],\"key_count\":%u,\"truncated\":%s", (unsigned)total,
+             (total > listed) ? "true" : "false");
+    http_stream_write_str(&stream, line);
+
+    // puts - commits = gesparte Commits
+    snprintf(line, sizeof(line),
+             ",\"journal\":{\"puts\":%lu,\"coalesced\":%lu,\"flushes\":%lu,\"commits\":%lu,"
+             "\"direct_commits\":%lu,\"failures\":%lu,\"pending\":%u}",
+             (unsigned long)st.journal.puts, (unsigned long)st.journal.coalesced, (unsigned long)st.journal.flushes,
+             (unsigned long)st.journal.commits, (unsigned long)st.direct_commits,
+             (unsigned long)st.journal.failures, (unsigned)st.pending);
+    http_stream_write_str(&stream, line);
+
+    // Obergrenzen der Buckets in µs, der letzte ist offen
+    http_stream_write_str(&stream, ",\"latency_us\":{\"bounds\":[");
+    for (size_t i = 0; i + 1 < LATENCY_HIST_BUCKETS; i++)
+    {
+        snprintf(line, sizeof(line), i ? ",%lu" : "%lu", (unsigned long)latency_hist_bound(i));
+        http_stream_write_str(&stream, line);
+    }
+    http_stream_write_str(&stream, "],");
+    write_hist(&stream, "read", &st.read);
+    http_stream_write_str(&stream, ",");
+    write_hist(&stream, "write", &st.write);
+    http_stream_write_str(&stream, ",");
+    write_hist(&stream, "flush", &st.flush);
+
+    snprintf(line, sizeof(line), "},\"settings_cache\":{\"hits\":%lu,\"misses\":%lu,\"invalidations\":%lu}}",
+             (unsigned long)cache.hits, (unsigned long)cache.misses, (unsigned long)cache.invalidations);
+    http_stream_write_str(&stream, line);
+
+    app_buf_return(keys);
+
+    // Header sind schon raus — Fehler nur noch loggen, Verbindung schließen
+    if (http_stream_end(&stream) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "GET storage: stream aborted: %s", esp_err_to_name(stream.err));
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "GET storage: %u key(s), %u namespace(s)", (unsigned)total, (unsigned)ns_count);
+    return ESP_OK;
+}
+
+HTTP_SCOPED_HANDLER(api_system_storage_get)
+
+// GET /api/system/http: Keep-Alive-Zähler (wie oft Verbindungen wiederverwendet
+// werden, wer sie schließt); reused/requests ist die Wiederverwendungsquote
+static esp_err_t api_system_http_get(httpd_req_t *req)
+{
+    http_conn_stats_t st;
+    char json[320];
+
+    http_conn_stats(&st);
+    snprintf(json, sizeof(json),
+             "{\"ok\":true,\"keepalive\":{\"idle_s\":%u,\"max_requests\":%u},"
+             "\"sockets\":{\"open\":%lu,\"peak\":%lu,\"max\":%u,\"opened\":%lu,\"closed\":%lu,"
+             "\"closed_idle\":%lu,\"closed_cap\":%lu},"
+             "\"requests\":{\"total\":%lu,\"reused\":%lu}}",
+             (unsigned)CORE_HTTP_KEEPALIVE_IDLE_S, (unsigned)CORE_HTTP_KEEPALIVE_MAX_REQUESTS, (unsigned long)st.open,
+             (unsigned long)st.peak_open, (unsigned)HTTP_CONN_MAX_SOCKETS, (unsigned long)st.opened,
+             (unsigned long)st.closed, (unsigned long)st.closed_idle, (unsigned long)st.closed_cap,
+             (unsigned long)st.requests, (unsigned long)st.reused);
+
+    // diese Anfrage ist schon mitgezählt (http_register_uri)
+    http_send_json(req, 200, json);
+    return ESP_OK;
+}
+
+static const httpd_uri_t uri_storage = {.uri = "/api/system/storage", .method = HTTP_GET, .handler = api_system_storage_get_scoped};
+static const httpd_uri_t uri_http = {.uri = "/api/system/http", .method = HTTP_GET, .handler = api_system_http_get};
+
+void routes_api_system_register(httpd_handle_t server)
+{
+    http_register_uri(server, &uri_storage);
+    http_register_uri(server, &uri_http);
+}
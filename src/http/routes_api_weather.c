@@ -4,25 +4,35 @@
 #include "esp_log.h"
 #include "esp_http_server.h"
 
-#include "app/app_locations_persistence.h"
+#include "app/app_buf_pool.h"
+#include "app/app_locations_writer.h"
 #include "locations_model.h"
+#include "locations_snapshot.h"
 #include "openmeteo_client.h"
 
 static const char *TAG = "routes_api_weather";
 
-static const location_t *get_active_location(locations_model_t *model)
+// Antwortpuffer aus dem Pool statt 2 x statisch
+_Static_assert(OPENMETEO_BUF_SIZE <= APP_BUF_LARGE, "weather response exceeds pool block");
+
+// copies the active location into *out; false if none is set
+static bool get_active_location(location_t *out)
 {
-    esp_err_t err = app_locations_load(model);
-    if (err != ESP_OK)
-        return NULL;
-    return locations_model_get_active(model);
+    locations_snapshot_t *snap = app_locations_snapshot_acquire();
+    const location_t *active = locations_model_get_active(locations_snapshot_model(snap));
+
+    if (active != NULL)
+        *out = *active;
+
+    locations_snapshot_release(snap);
+    return active != NULL;
 }
 
 // GET /api/weather/current
 static esp_err_t api_weather_current(httpd_req_t *req)
 {
-    locations_model_t model = {0};
-    const location_t *loc = get_active_location(&model);
+    location_t active;
+    const location_t *loc = get_active_location(&active) ? &active : NULL;
 
     if (loc == NULL)
     {
@@ -30,32 +40,34 @@ static esp_err_t api_weather_current(httpd_req_t *req)
         return ESP_OK;
     }
 
-    ESP_LOGI(TAG, "GET current weather for '%s' (%.4f, %.4f)",
-             loc->name, loc->latitude, loc->longitude);
+    ESP_LOGI(TAG, "GET current weather for '%s' (%ld, %ld e-6)",
+             loc->name, (long)loc->latitude_e6, (long)loc->longitude_e6);
 
-    static char buf[OPENMETEO_BUF_SIZE];
-    openmeteo_status_t status = openmeteo_fetch_current(loc->latitude, loc->longitude, buf, sizeof(buf));
-
-    if (status == OPENMETEO_ERR_BUF_TOO_SMALL)
+    char *buf = app_buf_borrow(APP_BUF_LARGE);
+    if (buf == NULL)
     {
-        http_send_err(req, 500, "response_too_large");
+        http_send_err(req, 503, "busy");
         return ESP_OK;
     }
-    if (status != OPENMETEO_OK)
-    {
+
+    openmeteo_status_t status = openmeteo_fetch_current(loc->latitude_e6, loc->longitude_e6, buf, APP_BUF_LARGE);
+
+    if (status == OPENMETEO_ERR_BUF_TOO_SMALL)
+        http_send_err(req, 500, "response_too_large");
+    else if (status != OPENMETEO_OK)
         http_send_err(req, 502, "upstream_error");
-        return ESP_OK;
-    }
+    else
+        http_send_json(req, 200, buf);
 
-    http_send_json(req, 200, buf);
+    app_buf_return(buf);
     return ESP_OK;
 }
 
 // GET /api/weather/forecast
 static esp_err_t api_weather_forecast(httpd_req_t *req)
 {
-    locations_model_t model = {0};
-    const location_t *loc = get_active_location(&model);
+    location_t active;
+    const location_t *loc = get_active_location(&active) ? &active : NULL;
 
     if (loc == NULL)
     {
@@ -63,33 +75,38 @@ static esp_err_t api_weather_forecast(httpd_req_t *req)
         return ESP_OK;
     }
 
-    ESP_LOGI(TAG, "GET forecast weather for '%s' (%.4f, %.4f)",
-             loc->name, loc->latitude, loc->longitude);
-
-    static char buf[OPENMETEO_BUF_SIZE];
-    openmeteo_status_t status = openmeteo_fetch_forecast(loc->latitude, loc->longitude, 7, buf, sizeof(buf));
+    ESP_LOGI(TAG, "GET forecast weather for '%s' (%ld, %ld e-6)",
+             loc->name, (long)loc->latitude_e6, (long)loc->longitude_e6);
 
-    if (status == OPENMETEO_ERR_BUF_TOO_SMALL)
+    char *buf = app_buf_borrow(APP_BUF_LARGE);
+    if (buf == NULL)
     {
-        http_send_err(req, 500, "response_too_large");
+        http_send_err(req, 503, "busy");
         return ESP_OK;
     }
-    if (status != OPENMETEO_OK)
-    {
+
+    openmeteo_status_t status = openmeteo_fetch_forecast(loc->latitude_e6, loc->longitude_e6, 7, buf, APP_BUF_LARGE);
+
+    if (status == OPENMETEO_ERR_BUF_TOO_SMALL)
+        http_send_err(req, 500, "response_too_large");
+    else if (status != OPENMETEO_OK)
         http_send_err(req, 502, "upstream_error");
-        return ESP_OK;
-    }
+    else
+        http_send_json(req, 200, buf);
 
-    http_send_json(req, 200, buf);
+    app_buf_return(buf);
     return ESP_OK;
 }
 
-static const httpd_uri_t uri_current = {.uri = "/api/weather/current", .method = HTTP_GET, .handler = api_weather_current};
-static const httpd_uri_t uri_forecast = {.uri = "/api/weather/forecast", .method = HTTP_GET, .handler = api_weather_forecast};
+HTTP_SCOPED_HANDLER(api_weather_current)
+HTTP_SCOPED_HANDLER(api_weather_forecast)
+
+static const httpd_uri_t uri_current = {.uri = "/api/weather/current", .method = HTTP_GET, .handler = api_weather_current_scoped};
+static const httpd_uri_t uri_forecast = {.uri = "/api/weather/forecast", .method = HTTP_GET, .handler = api_weather_forecast_scoped};
 
 void routes_api_weather_register(httpd_handle_t server)
 {
     ESP_LOGI(TAG, "register weather API routes");
-    httpd_register_uri_handler(server, &uri_current);
-    httpd_register_uri_handler(server, &uri_forecast);
+    http_register_uri(server, &uri_current);
+    http_register_uri(server, &uri_forecast);
 }
\ No newline at end of file
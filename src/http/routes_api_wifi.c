@@ -4,23 +4,36 @@
 #include <stdlib.h>
 #include <string.h>
 
+
 #include "esp_http_server.h"
 #include "esp_log.h"
 
 #include "settings_storage.h"
+#include "wifi_profiles.h"
+#include "app/app_buf_pool.h"
 #include "app/app_settings_persistence.h"
 #include "wifi_sta.h"
 
 static const char *TAG = "routes_api_wifi";
 
+// Objekt ohne das schließende }, damit weitere Felder angehängt werden können
+static void write_open_object(http_stream_t *stream, const char *json)
+{
+    const size_t len = strlen(json);
+    if (len > 0)
+        http_stream_write(stream, json, len - 1);
+}
+
+// {"ssid":..,"pass_len":..,<sta status>,"profiles":[{"ssid":..,"pass_len":..,"channel":..},..]}
+// ssid / pass_len sind das erste Profil (höchste Priorität), channel der gemerkte Kanal oder null
 static esp_err_t api_wifi_get(httpd_req_t *req)
 {
-    settings_wifi_t s = {0};
-    esp_err_t err = app_settings_load_wifi(&s);
+    wifi_profiles_t list = {0};
+    esp_err_t err = app_settings_load_wifi_profiles(&list);
 
     if (err == ESP_ERR_NOT_FOUND)
     {
-        memset(&s, 0, sizeof(s));
+        memset(&list, 0, sizeof(list));
     }
     else if (err != ESP_OK)
     {
@@ -34,53 +47,127 @@ static esp_err_t api_wifi_get(httpd_req_t *req)
     wifi_sta_status_to_json(&sta, sta_buf, sizeof(sta_buf));
 
     // sta_buf enthält jetzt {"sta_state":"connected","ip":"192.168.x.x"}
-    // Wir bauen das finale JSON manuell zusammen
-    char buf[320];
     size_t sta_len = strlen(sta_buf);
     if (sta_len > 0)
         sta_buf[sta_len - 1] = '\0'; // letztes } entfernen
 
-    snprintf(buf, sizeof(buf),
-             "{\"ssid\":\"%s\",\"pass_len\":%u,%s}",
-             s.ssid,
-             (unsigned)strlen(s.pass),
-             sta_buf + 1);
+    http_stream_t stream;
+    http_stream_begin(&stream, req, 200);
+    if (stream.err == ESP_ERR_NO_MEM)
+    {
+        memset(&list, 0, sizeof(list));
+        http_send_err(req, 503, "busy");
+        return ESP_OK;
+    }
+
+    // Passwort nur als Länge (settings_storage: secret)
+    char item[SETTINGS_WIFI_SSID_MAX_LEN * 6 + 64];
+    settings_wifi_t s = {0};
+    if (list.count > 0)
+    {
+        memcpy(s.ssid, list.items[0].ssid, sizeof(s.ssid));
+        memcpy(s.pass, list.items[0].pass, sizeof(s.pass));
+    }
+    if (!settings_storage_wifi_to_json(&s, false, item, sizeof(item)))
+        stream.err = ESP_FAIL;
+    write_open_object(&stream, item);
+    http_stream_write_str(&stream, ",");
+    http_stream_write_str(&stream, sta_buf + 1); // ohne {
+    http_stream_write_str(&stream, ",\"profiles\":[");
+
+    for (size_t i = 0; i < list.count && stream.err == ESP_OK; i++)
+    {
+        const wifi_profile_t *p = &list.items[i];
+        memcpy(s.ssid, p->ssid, sizeof(s.ssid));
+        memcpy(s.pass, p->pass, sizeof(s.pass));
+        s.priority = (uint8_t)i;
+        if (!settings_storage_wifi_to_json(&s, false, item, sizeof(item)))
+        {
+            stream.err = ESP_FAIL;
+            break;
+        }
+
+        if (i > 0)
+            http_stream_write(&stream, ",", 1);
+        write_open_object(&stream, item);
+
+        char tail[24];
+        if (p->hint.valid)
+            snprintf(tail, sizeof(tail), ",\"channel\":%u}", (unsigned)p->hint.channel);
+        else
+            snprintf(tail, sizeof(tail), ",\"channel\":null}");
+        http_stream_write_str(&stream, tail);
+    }
+    http_stream_write_str(&stream, "]}");
 
-    ESP_LOGI(TAG, "GET wifi config: SSID='%s' (password withheld)", s.ssid);
+    const size_t count = list.count;
+    memset(&s, 0, sizeof(s));
+    memset(&list, 0, sizeof(list));
 
-    http_send_json(req, 200, buf);
+    // Header sind schon raus — Fehler nur noch loggen, Verbindung schließen
+    if (http_stream_end(&stream) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "GET wifi config: stream aborted: %s", esp_err_to_name(stream.err));
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "GET wifi config: %u profile(s) (passwords withheld)", (unsigned)count);
     return ESP_OK;
 }
 
 static esp_err_t api_wifi_post(httpd_req_t *req)
 {
-    char body[512];
-    size_t n = 0;
-    if (!http_read_body(req, body, sizeof(body), &n))
+    char *body = app_buf_borrow(APP_BUF_SMALL);
+    if (body == NULL)
     {
-        http_send_err(req, 400, "invalid_body");
+        http_send_err(req, 503, "busy");
         return ESP_OK;
     }
 
     settings_wifi_t s = {0};
-    if (!settings_storage_wifi_from_json(body, &s))
+    const bool body_ok = http_read_body(req, body, APP_BUF_SMALL, NULL);
+    // optional "priority" (Schema, 0..255): 0 = zuerst (Standard), größer als die Liste = zuletzt
+    const bool json_ok = body_ok && settings_storage_wifi_from_json(body, &s);
+    app_buf_return(body);
+    const unsigned priority = s.priority;
+
+    if (!body_ok)
+    {
+        http_send_err(req, 400, "invalid_body");
+        return ESP_OK;
+    }
+    if (!json_ok)
     {
         http_send_err(req, 400, "invalid_json");
         return ESP_OK;
     }
 
-    esp_err_t err = app_settings_save_wifi(&s);
+    // ohne Priorität wie bisher: vorne, eine volle Liste verliert das letzte Profil
+    esp_err_t err = (priority == 0) ? app_settings_save_wifi(&s) : app_settings_put_wifi(&s, (size_t)priority);
+    if (err == ESP_ERR_NO_MEM)
+    {
+        memset(&s, 0, sizeof(s));
+        http_send_err(req, 409, "profiles_full");
+        return ESP_OK;
+    }
     if (err != ESP_OK)
     {
+        memset(&s, 0, sizeof(s));
         ESP_LOGE(TAG, "save failed: %s", esp_err_to_name(err));
         http_send_err(req, 500, "save_failed");
         return ESP_OK;
     }
 
-    ESP_LOGI(TAG, "WiFi credentials saved: SSID='%s' (pass_len=%u)",
-             s.ssid, (unsigned)strlen(s.pass));
+    ESP_LOGI(TAG, "WiFi credentials saved: SSID='%s' (pass_len=%u, priority=%u)",
+             s.ssid, (unsigned)strlen(s.pass), priority);
 
-    esp_err_t conn_err = wifi_sta_connect(s.ssid, s.pass);
+    // erstes Profil: sofort verbinden; sonst nur, falls gerade keine Verbindung besteht
+    esp_err_t conn_err = ESP_ERR_INVALID_STATE;
+    if (priority == 0)
+        conn_err = wifi_sta_connect(s.ssid, s.pass);
+    else if (!wifi_sta_is_connected())
+        conn_err = wifi_sta_connect_from_nvs();
+    memset(&s, 0, sizeof(s));
 
     if (conn_err == ESP_OK)
         http_send_json(req, 200, "{\"ok\":true,\"connect_started\":true}");
@@ -90,25 +177,56 @@ static esp_err_t api_wifi_post(httpd_req_t *req)
     return ESP_OK;
 }
 
+// ?ssid=<name>: nur dieses Profil, sonst alle
 static esp_err_t api_wifi_delete(httpd_req_t *req)
 {
-    esp_err_t err = app_settings_clear_wifi();
+    char query[128] = {0};
+    char ssid[SETTINGS_WIFI_SSID_MAX_LEN * 3 + 1] = {0}; // bis zu %XX je Byte
+    bool one = false;
+
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK)
+    {
+        const esp_err_t q = httpd_query_key_value(query, "ssid", ssid, sizeof(ssid));
+        if (q == ESP_OK && (!http_url_decode(ssid) || ssid[0] == '\0'))
+        {
+            http_send_err(req, 400, "invalid_ssid");
+            return ESP_OK;
+        }
+        if (q != ESP_OK && q != ESP_ERR_NOT_FOUND)
+        {
+            http_send_err(req, 400, "invalid_query");
+            return ESP_OK;
+        }
+        one = (q == ESP_OK);
+    }
+
+    esp_err_t err = one ? app_settings_remove_wifi(ssid) : app_settings_clear_wifi();
+    if (err == ESP_ERR_NOT_FOUND)
+    {
+        http_send_err(req, 404, "not_found");
+        return ESP_OK;
+    }
     if (err != ESP_OK)
     {
         http_send_err(req, 500, "clear_failed");
         return ESP_OK;
     }
+
+    ESP_LOGI(TAG, "DELETE wifi config: %s", one ? "one profile" : "all profiles");
     http_send_json(req, 200, "{\"ok\":true}");
     return ESP_OK;
 }
 
-static const httpd_uri_t uri_get = {.uri = "/api/config/wifi", .method = HTTP_GET, .handler = api_wifi_get};
-static const httpd_uri_t uri_post = {.uri = "/api/config/wifi", .method = HTTP_POST, .handler = api_wifi_post};
+HTTP_SCOPED_HANDLER(api_wifi_get)
+HTTP_SCOPED_HANDLER(api_wifi_post)
+
+static const httpd_uri_t uri_get = {.uri = "/api/config/wifi", .method = HTTP_GET, .handler = api_wifi_get_scoped};
+static const httpd_uri_t uri_post = {.uri = "/api/config/wifi", .method = HTTP_POST, .handler = api_wifi_post_scoped};
 static const httpd_uri_t uri_del = {.uri = "/api/config/wifi", .method = HTTP_DELETE, .handler = api_wifi_delete};
 
 void routes_api_wifi_register(httpd_handle_t server)
 {
-    httpd_register_uri_handler(server, &uri_get);
-    httpd_register_uri_handler(server, &uri_post);
-    httpd_register_uri_handler(server, &uri_del);
+    http_register_uri(server, &uri_get);
+    http_register_uri(server, &uri_post);
+    http_register_uri(server, &uri_del);
 }
@@ -1,6 +1,8 @@
 #include "esp_log.h"
 
 #include "http/routes_portal.h"
+#include "http/http_conn.h"
+#include "http/http_helpers.h"
 
 static const char *TAG = "routes_portal";
 
@@ -15,10 +17,8 @@ static esp_err_t redirect_to_root(httpd_req_t *req)
 }
 
 // 404 handler: redirect everything EXCEPT /api/* (keep API 404 as JSON)
-static esp_err_t captive_404_handler(httpd_req_t *req, httpd_err_code_t err)
+static esp_err_t captive_404(httpd_req_t *req)
 {
-    (void)err;
-
     const char *uri = req->uri;
     if (strncmp(uri, "/api/", 5) == 0)
     {
@@ -31,6 +31,17 @@ static esp_err_t captive_404_handler(httpd_req_t *req, httpd_err_code_t err)
     return redirect_to_root(req);
 }
 
+// Fehler-Handler laufen nicht über http_register_uri — Aktivität hier selbst melden
+static esp_err_t captive_404_handler(httpd_req_t *req, httpd_err_code_t err)
+{
+    (void)err;
+
+    http_conn_request_begin(req);
+    const esp_err_t ret = captive_404(req);
+    http_conn_request_end(req);
+    return ret;
+}
+
 // GET routes
 static const httpd_uri_t uri_generate_204 = {.uri = "/generate_204", .method = HTTP_GET, .handler = redirect_to_root};
 static const httpd_uri_t uri_hotspot_detect = {.uri = "/hotspot-detect.html", .method = HTTP_GET, .handler = redirect_to_root};
@@ -50,18 +61,18 @@ void routes_portal_register(httpd_handle_t server)
     ESP_LOGI(TAG, "register captive portal probe routes");
 
     // GET
-    httpd_register_uri_handler(server, &uri_generate_204);
-    httpd_register_uri_handler(server, &uri_hotspot_detect);
-    httpd_register_uri_handler(server, &uri_connecttest);
-    httpd_register_uri_handler(server, &uri_204);
-    httpd_register_uri_handler(server, &uri_ipv6check);
+    http_register_uri(server, &uri_generate_204);
+    http_register_uri(server, &uri_hotspot_detect);
+    http_register_uri(server, &uri_connecttest);
+    http_register_uri(server, &uri_204);
+    http_register_uri(server, &uri_ipv6check);
 
     // HEAD
-    httpd_register_uri_handler(server, &uri_generate_204_head);
-    httpd_register_uri_handler(server, &uri_hotspot_detect_head);
-    httpd_register_uri_handler(server, &uri_connecttest_head);
-    httpd_register_uri_handler(server, &uri_204_head);
-    httpd_register_uri_handler(server, &uri_ipv6check_head);
+    http_register_uri(server, &uri_generate_204_head);
+    http_register_uri(server, &uri_hotspot_detect_head);
+    http_register_uri(server, &uri_connecttest_head);
+    http_register_uri(server, &uri_204_head);
+    http_register_uri(server, &uri_ipv6check_head);
 
     httpd_register_err_handler(server, HTTPD_404_NOT_FOUND, captive_404_handler);
 }
\ No newline at end of file
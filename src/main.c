@@ -18,6 +18,13 @@
 #include "esp_err.h"
 
 #include "wifi_sta.h"
+#include "app/app_buf_pool.h"
+#include "app/app_config.h"
+#include "app/app_gazetteer.h"
+#include "app/app_json_arena.h"
+#include "app/app_settings_persistence.h"
+#include "app/nvs_helpers.h"
+#include "app/app_locations_writer.h"
 
 static const char *TAG = "main";
 
@@ -74,9 +81,32 @@ void app_main(void)
     // WiFi AP
     ESP_ERROR_CHECK(wifi_init_ap());
 
+    // NVS write-behind journal (flush timer + flush on esp_restart); writes before this commit directly
+    if (nvs_cfg_init() != ESP_OK)
+        ESP_LOGW(TAG, "NVS write-behind unavailable, committing every write");
+
+    // stored runtime settings (log level)
+    app_config_init();
+
+    // no-op unless CONFIG_CORE_NVS_BENCH
+    nvs_cfg_bench();
+
+    // WiFi settings into RAM once; later reads (status, reconnects) skip NVS
+    (void)app_settings_init();
+
     // STA subsystem (AP stays active)
     ESP_ERROR_CHECK(wifi_sta_init());
 
+    // cJSON allocator hooks (per-request arena) and shared scratch buffers; before anything parses JSON
+    app_json_arena_init();
+    app_buf_pool_init();
+
+    // Locations writer (single task for all list mutations); needs NVS from wifi_init_ap()
+    ESP_ERROR_CHECK(app_locations_writer_start());
+
+    // Offline gazetteer (place search); runs without it if the partition is empty
+    (void)app_gazetteer_init();
+
     // HTTP server (Web UI / endpoints)
     http_server_start();
 
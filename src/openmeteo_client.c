@@ -7,6 +7,8 @@
 #include "esp_http_client.h"
 #include "esp_log.h"
 
+#include "locations_coord.h"
+
 static const char *TAG = "openmeteo";
 
 typedef struct
@@ -90,29 +92,39 @@ static openmeteo_status_t http_get(const char *url, char *out_buf, size_t out_le
     return OPENMETEO_OK;
 }
 
-openmeteo_status_t openmeteo_fetch_current(double lat, double lon, char *out_buf, size_t out_len)
+openmeteo_status_t openmeteo_fetch_current(int32_t lat_e6, int32_t lon_e6, char *out_buf, size_t out_len)
 {
     if (!out_buf || out_len == 0)
         return OPENMETEO_ERR_INVALID_ARG;
 
+    char lat[LOCATIONS_COORD_STR_MAX];
+    char lon[LOCATIONS_COORD_STR_MAX];
+    locations_coord_format(lat_e6, lat, sizeof(lat));
+    locations_coord_format(lon_e6, lon, sizeof(lon));
+
     char url[512];
     snprintf(url, sizeof(url),
              "http://api.open-meteo.com/v1/forecast"
-             "?latitude=%.5f&longitude=%.5f"
+             "?latitude=%s&longitude=%s"
              "&current=temperature_2m,apparent_temperature,"
              "relative_humidity_2m,weather_code,"
              "wind_speed_10m,wind_direction_10m",
              lat, lon);
 
-    ESP_LOGI(TAG, "fetch current: lat=%.4f lon=%.4f", lat, lon);
+    ESP_LOGI(TAG, "fetch current: lat=%s lon=%s", lat, lon);
     return http_get(url, out_buf, out_len);
 }
 
-openmeteo_status_t openmeteo_fetch_forecast(double lat, double lon, int days, char *out_buf, size_t out_len)
+openmeteo_status_t openmeteo_fetch_forecast(int32_t lat_e6, int32_t lon_e6, int days, char *out_buf, size_t out_len)
 {
     if (!out_buf || out_len == 0)
         return OPENMETEO_ERR_INVALID_ARG;
 
+    char lat[LOCATIONS_COORD_STR_MAX];
+    char lon[LOCATIONS_COORD_STR_MAX];
+    locations_coord_format(lat_e6, lat, sizeof(lat));
+    locations_coord_format(lon_e6, lon, sizeof(lon));
+
     if (days <= 0)
         days = 7;
     if (days > 16)
@@ -121,12 +133,12 @@ openmeteo_status_t openmeteo_fetch_forecast(double lat, double lon, int days, ch
     char url[640];
     snprintf(url, sizeof(url),
              "http://api.open-meteo.com/v1/forecast"
-             "?latitude=%.5f&longitude=%.5f"
+             "?latitude=%s&longitude=%s"
              "&daily=weather_code,temperature_2m_max,"
              "temperature_2m_min,precipitation_sum"
              "&forecast_days=%d",
              lat, lon, days);
 
-    ESP_LOGI(TAG, "fetch forecast: lat=%.4f lon=%.4f days=%d", lat, lon, days);
+    ESP_LOGI(TAG, "fetch forecast: lat=%s lon=%s days=%d", lat, lon, days);
     return http_get(url, out_buf, out_len);
 }
\ No newline at end of file
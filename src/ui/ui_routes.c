@@ -1,5 +1,6 @@
 #include "ui/ui_routes.h"
 #include "ui/ui_assets.h"
+#include "http/http_helpers.h"
 
 #include "esp_log.h"
 #include "esp_http_server.h"
@@ -26,6 +27,6 @@ static const httpd_uri_t uri_favicon = {.uri = "/favicon.ico", .method = HTTP_GE
 void ui_routes_register(httpd_handle_t server)
 {
     ESP_LOGI(TAG, "register UI routes");
-    httpd_register_uri_handler(server, &uri_index);
-    httpd_register_uri_handler(server, &uri_favicon);
+    http_register_uri(server, &uri_index);
+    http_register_uri(server, &uri_favicon);
 }
@@ -9,6 +9,7 @@
 #include "esp_timer.h"
 
 #include "app/app_settings_persistence.h"
+#include "wifi_profiles.h"
 
 #include "lwip/inet.h"
 
@@ -24,6 +25,43 @@ static wifi_sta_status_t s_status = {
 };
 
 static esp_timer_handle_t s_retry_timer = NULL;
+static esp_timer_handle_t s_hint_timer = NULL;
+
+// pause before the next network / full scan of the same round
+#define STA_ATTEMPT_GAP_MS 100U
+
+// Networks of the current connect run, tried in rounds (wifi_profiles_attempt):
+// cached channel + BSSID first, then full scans. A round that ends without an
+// IP counts as one retry.
+static wifi_profiles_t s_profiles;
+static size_t s_step = 0;
+
+// where the last connect landed (WIFI_EVENT_STA_CONNECTED), saved once the IP is there
+static char s_joined_ssid[SETTINGS_WIFI_SSID_MAX_LEN + 1];
+static wifi_profile_hint_t s_joined;
+
+static esp_err_t apply_and_connect_sta(const wifi_profile_t *p, bool fast);
+
+// next attempt of the round; ESP_ERR_NOT_FOUND once every network was tried
+static esp_err_t start_attempt(void)
+{
+    wifi_profiles_attempt_t a;
+    if (!wifi_profiles_attempt(&s_profiles, s_step, &a))
+        return ESP_ERR_NOT_FOUND;
+    s_step++;
+
+    const wifi_profile_t *p = &s_profiles.items[a.profile];
+    strncpy(s_status.ssid, p->ssid, sizeof(s_status.ssid));
+    s_status.ssid[sizeof(s_status.ssid) - 1] = '\0';
+
+    if (a.fast)
+        ESP_LOGI(TAG, "Connecting to SSID='%s' on cached channel %u (retry=%u)", p->ssid,
+                 (unsigned)p->hint.channel, (unsigned)s_status.retry_count);
+    else
+        ESP_LOGI(TAG, "Connecting to SSID='%s' with scan (retry=%u)", p->ssid, (unsigned)s_status.retry_count);
+
+    return apply_and_connect_sta(p, a.fast);
+}
 
 static void retry_timer_cb(void *arg)
 {
@@ -34,17 +72,11 @@ static void retry_timer_cb(void *arg)
         return;
     }
 
-    ESP_LOGW(TAG, "Retrying WiFi connect (retry=%u)", (unsigned)s_status.retry_count);
-    esp_wifi_connect();
+    (void)start_attempt();
 }
 
-static void schedule_retry(uint32_t retry_count)
+static void schedule_retry(uint32_t delay_ms)
 {
-    // simple backoff: 1s, 2s, 3s... capped at 10s
-    uint32_t delay_ms = 1000U * (retry_count + 1U);
-    if (delay_ms > 10000U)
-        delay_ms = 10000U;
-
     if (!s_retry_timer)
         return;
 
@@ -52,6 +84,20 @@ static void schedule_retry(uint32_t retry_count)
     esp_timer_start_once(s_retry_timer, (uint64_t)delay_ms * 1000ULL);
 }
 
+// off the event task: the NVS write needs more stack than it has
+static void hint_timer_cb(void *arg)
+{
+    (void)arg;
+
+    const wifi_profile_hint_t hint = s_joined;
+    char ssid[sizeof(s_joined_ssid)];
+    memcpy(ssid, s_joined_ssid, sizeof(ssid));
+
+    esp_err_t err = app_settings_wifi_connected(ssid, &hint);
+    if (err != ESP_OK)
+        ESP_LOGW(TAG, "Caching channel of SSID='%s' failed: %s", ssid, esp_err_to_name(err));
+}
+
 static void wifi_event_handler(void *arg,
                                esp_event_base_t event_base,
                                int32_t event_id,
@@ -71,25 +117,55 @@ static void wifi_event_handler(void *arg,
         break;
 
     case WIFI_EVENT_STA_CONNECTED:
-        ESP_LOGI(TAG, "WIFI_EVENT_STA_CONNECTED");
-        // Got IP comes via IP_EVENT_STA_GOT_IP
+    {
+        const wifi_event_sta_connected_t *e = (const wifi_event_sta_connected_t *)event_data;
+        ESP_LOGI(TAG, "WIFI_EVENT_STA_CONNECTED (channel %u)", (unsigned)e->channel);
+
+        // Got IP comes via IP_EVENT_STA_GOT_IP; the hint is saved only then
+        memcpy(s_joined_ssid, s_status.ssid, sizeof(s_joined_ssid));
+        s_joined.valid = true;
+        memcpy(s_joined.bssid, e->bssid, sizeof(s_joined.bssid));
+        s_joined.channel = e->channel;
+        s_joined.authmode = (uint8_t)e->authmode;
         break;
+    }
 
     case WIFI_EVENT_STA_DISCONNECTED:
-        ESP_LOGW(TAG, "WIFI_EVENT_STA_DISCONNECTED");
+    {
+        const wifi_event_sta_disconnected_t *e = (const wifi_event_sta_disconnected_t *)event_data;
+        ESP_LOGW(TAG, "WIFI_EVENT_STA_DISCONNECTED (reason %u)", (unsigned)e->reason);
+
+        // our own esp_wifi_disconnect() before a new attempt, not a failed one
+        if (e->reason == WIFI_REASON_ASSOC_LEAVE && s_status.state == WIFI_STA_STATE_CONNECTING)
+            break;
 
         if (s_status.state == WIFI_STA_STATE_CONNECTED)
         {
-            // lost connection -> go back to connecting
+            // lost connection -> go back to connecting, cached channels first
             s_status.state = WIFI_STA_STATE_CONNECTING;
             memset(s_status.ip, 0, sizeof(s_status.ip));
+            s_step = 0;
         }
 
-        // Retry policy (MVP): retry up to 10 times, then mark FAILED.
-        if (s_status.retry_count < 10)
+        if (s_status.state != WIFI_STA_STATE_CONNECTING)
+            break;
+
+        // Retry policy: next network of the round right away; after a full
+        // round back off (1s, 2s, 3s... capped at 10s), 10 rounds, then FAILED.
+        wifi_profiles_attempt_t next;
+        if (wifi_profiles_attempt(&s_profiles, s_step, &next))
+        {
+            schedule_retry(STA_ATTEMPT_GAP_MS);
+        }
+        else if (s_status.retry_count < 10)
         {
             s_status.retry_count++;
-            schedule_retry(s_status.retry_count);
+            s_step = 0;
+
+            uint32_t delay_ms = 1000U * (s_status.retry_count + 1U);
+            if (delay_ms > 10000U)
+                delay_ms = 10000U;
+            schedule_retry(delay_ms);
         }
         else
         {
@@ -97,6 +173,7 @@ static void wifi_event_handler(void *arg,
             s_status.state = WIFI_STA_STATE_FAILED;
         }
         break;
+    }
 
     default:
         break;
@@ -128,21 +205,20 @@ static void ip_event_handler(void *arg,
         char ip_str[16] = {0};
         inet_ntoa_r(e->ip_info.ip, ip_str, sizeof(ip_str));
         ESP_LOGI(TAG, "STA GOT IP: %s", ip_str);
+
+        if (s_hint_timer && s_joined.valid)
+            esp_timer_start_once(s_hint_timer, 0);
     }
 }
 
-static esp_err_t apply_and_connect_sta(const char *ssid, const char *pass)
+// fast: join the cached BSSID on its channel instead of scanning every channel
+static esp_err_t apply_and_connect_sta(const wifi_profile_t *p, bool fast)
 {
-    if ((ssid == NULL) || (ssid[0] == '\0'))
+    if (p->ssid[0] == '\0')
     {
         ESP_LOGE(TAG, "apply_and_connect_sta: SSID missing");
         return ESP_ERR_INVALID_ARG;
     }
-    if (pass == NULL)
-    {
-        ESP_LOGE(TAG, "apply_and_connect_sta: pass is NULL");
-        return ESP_ERR_INVALID_ARG;
-    }
 
     // We require APSTA to be set by wifi_init_ap() once at boot.
     wifi_mode_t mode = WIFI_MODE_NULL;
@@ -163,11 +239,19 @@ static esp_err_t apply_and_connect_sta(const char *ssid, const char *pass)
 
     wifi_config_t sta_cfg = {0};
 
-    strncpy((char *)sta_cfg.sta.ssid, ssid, sizeof(sta_cfg.sta.ssid));
-    sta_cfg.sta.ssid[sizeof(sta_cfg.sta.ssid) - 1] = '\0';
+    // not NUL terminated at full length (32 / 64), as esp_wifi expects
+    strncpy((char *)sta_cfg.sta.ssid, p->ssid, sizeof(sta_cfg.sta.ssid));
+    strncpy((char *)sta_cfg.sta.password, p->pass, sizeof(sta_cfg.sta.password));
 
-    strncpy((char *)sta_cfg.sta.password, pass, sizeof(sta_cfg.sta.password));
-    sta_cfg.sta.password[sizeof(sta_cfg.sta.password) - 1] = '\0';
+    if (fast)
+    {
+        sta_cfg.sta.scan_method = WIFI_FAST_SCAN;
+        sta_cfg.sta.channel = p->hint.channel;
+        sta_cfg.sta.bssid_set = true;
+        memcpy(sta_cfg.sta.bssid, p->hint.bssid, sizeof(sta_cfg.sta.bssid));
+        // no weaker security than last time
+        sta_cfg.sta.threshold.authmode = (wifi_auth_mode_t)p->hint.authmode;
+    }
 
     // ensure we start from a clean state
     (void)esp_wifi_disconnect();
@@ -217,17 +301,42 @@ esp_err_t wifi_sta_init(void)
             .name = "sta_retry"};
         ESP_ERROR_CHECK(esp_timer_create(&targs, &s_retry_timer));
     }
+    if (!s_hint_timer)
+    {
+        const esp_timer_create_args_t targs = {
+            .callback = &hint_timer_cb,
+            .arg = NULL,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = "sta_hint"};
+        ESP_ERROR_CHECK(esp_timer_create(&targs, &s_hint_timer));
+    }
 
     ESP_LOGI(TAG, "STA subsystem initialized");
     return ESP_OK;
 }
 
+// starts a connect run over s_profiles
+static esp_err_t start_run(void)
+{
+    // Stop any pending retry from a previous attempt.
+    if (s_retry_timer)
+    {
+        esp_timer_stop(s_retry_timer);
+    }
+
+    memset(s_status.ip, 0, sizeof(s_status.ip));
+    s_status.retry_count = 0;
+    s_status.state = WIFI_STA_STATE_CONNECTING;
+    s_step = 0;
+
+    return start_attempt();
+}
+
 esp_err_t wifi_sta_connect_from_nvs(void)
 {
-    settings_wifi_t s;
-    esp_err_t err = app_settings_load_wifi(&s);
+    esp_err_t err = app_settings_load_wifi_profiles(&s_profiles);
 
-    if (err == ESP_ERR_NOT_FOUND || s.ssid[0] == '\0')
+    if (err == ESP_ERR_NOT_FOUND)
     {
         ESP_LOGI(TAG, "No STA SSID stored; staying in AP-only mode");
         s_status.state = WIFI_STA_STATE_IDLE;
@@ -240,7 +349,8 @@ esp_err_t wifi_sta_connect_from_nvs(void)
         return err;
     }
 
-    return wifi_sta_connect(s.ssid, s.pass);
+    ESP_LOGI(TAG, "Starting STA connect over %u saved network(s)", (unsigned)s_profiles.count);
+    return start_run();
 }
 
 esp_err_t wifi_sta_connect(const char *ssid, const char *pass)
@@ -264,19 +374,22 @@ esp_err_t wifi_sta_connect(const char *ssid, const char *pass)
                  ssid, (unsigned)strlen(pass_str));
     }
 
-    // Stop any pending retry from a previous attempt.
-    if (s_retry_timer)
+    // just this network; the cached channel of a saved profile still applies
+    wifi_profiles_t saved;
+    const bool have_saved = (app_settings_load_wifi_profiles(&saved) == ESP_OK);
+    const size_t idx = have_saved ? wifi_profiles_find(&saved, ssid) : 0;
+
+    memset(&s_profiles, 0, sizeof(s_profiles));
+    if (!wifi_profiles_put(&s_profiles, ssid, pass_str, 0))
     {
-        esp_timer_stop(s_retry_timer);
+        memset(&saved, 0, sizeof(saved));
+        return ESP_ERR_INVALID_ARG;
     }
+    if (have_saved && idx < saved.count && strcmp(saved.items[idx].pass, pass_str) == 0)
+        s_profiles.items[0].hint = saved.items[idx].hint;
+    memset(&saved, 0, sizeof(saved));
 
-    strncpy(s_status.ssid, ssid, sizeof(s_status.ssid));
-    s_status.ssid[sizeof(s_status.ssid) - 1] = '\0';
-    memset(s_status.ip, 0, sizeof(s_status.ip));
-    s_status.retry_count = 0;
-    s_status.state = WIFI_STA_STATE_CONNECTING;
-
-    return apply_and_connect_sta(ssid, pass_str);
+    return start_run();
 }
 
 wifi_sta_status_t wifi_sta_get_status(void)
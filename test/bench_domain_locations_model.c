@@ -0,0 +1,161 @@
+#include <unity.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "test_api.h"
+
+#include "locations_model.h"
+
+/*
+    helpers
+*/
+
+#define BENCH_OPS_PER_SIZE 200000U
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    (void)timespec_get(&ts, TIME_UTC);
+    return ((double)ts.tv_sec * 1e9) + (double)ts.tv_nsec;
+}
+
+static void make_name(char *out, size_t out_len, size_t i)
+{
+    (void)snprintf(out, out_len, "Location %u", (unsigned)i);
+}
+
+static void bench_report(const char *op, size_t n, double total_ns, size_t ops)
+{
+    char line[128];
+    (void)snprintf(line, sizeof(line), "  %-18s n=%-4u %9.1f ns/op", op, (unsigned)n, total_ns / (double)ops);
+    UnityPrint(line);
+    UNITY_OUTPUT_CHAR('\n');
+}
+
+/* reference: the former fixed-array layout with strcmp scans */
+static location_t s_linear[LOCATIONS_MODEL_MAX_NUMBER];
+
+static const location_t *linear_find(size_t n, const char *name)
+{
+    const location_t *found = NULL;
+
+    for (size_t i = 0U; i < n; i++)
+    {
+        if (strcmp(s_linear[i].name, name) == 0)
+        {
+            found = &s_linear[i];
+            break;
+        }
+    }
+
+    return found;
+}
+
+static void bench_size(size_t n)
+{
+    locations_model_t m;
+    TEST_ASSERT_TRUE(locations_model_init(&m, n));
+
+    static char names[LOCATIONS_MODEL_MAX_NUMBER][32];
+    for (size_t i = 0U; i < n; i++)
+    {
+        make_name(names[i], sizeof(names[i]), i);
+    }
+
+    const size_t rounds = (BENCH_OPS_PER_SIZE + n - 1U) / n;
+    const size_t ops = rounds * n;
+    double t_add = 0.0;
+    double t_remove = 0.0;
+    double t_find = 0.0;
+    double t_linear = 0.0;
+    volatile size_t sink = 0U;
+
+    for (size_t r = 0U; r < rounds; r++)
+    {
+        double t0 = now_ns();
+        for (size_t i = 0U; i < n; i++)
+        {
+            location_t loc = {0};
+            (void)memcpy(loc.name, names[i], sizeof(loc.name));
+            (void)locations_model_add(&m, &loc);
+        }
+        t_add += now_ns() - t0;
+
+        t0 = now_ns();
+        for (size_t i = 0U; i < n; i++)
+        {
+            sink += (locations_model_find(&m, names[(i * 7U) % n]) != NULL) ? 1U : 0U;
+        }
+        t_find += now_ns() - t0;
+
+        /* remove from the middle outwards: worst case for the former shift-left */
+        t0 = now_ns();
+        for (size_t i = 0U; i < n; i++)
+        {
+            (void)locations_model_remove(&m, names[(i + (n / 2U)) % n]);
+        }
+        t_remove += now_ns() - t0;
+    }
+
+    for (size_t i = 0U; i < n; i++)
+    {
+        (void)memcpy(s_linear[i].name, names[i], sizeof(s_linear[i].name));
+    }
+
+    double t0 = now_ns();
+    for (size_t r = 0U; r < rounds; r++)
+    {
+        for (size_t i = 0U; i < n; i++)
+        {
+            sink += (linear_find(n, names[(i * 7U) % n]) != NULL) ? 1U : 0U;
+        }
+    }
+    t_linear = now_ns() - t0;
+
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)(2U * ops), (uint32_t)sink);
+    TEST_ASSERT_EQUAL_UINT32(0U, (uint32_t)m.count);
+
+    bench_report("add", n, t_add, ops);
+    bench_report("find", n, t_find, ops);
+    bench_report("remove", n, t_remove, ops);
+    bench_report("find (linear ref)", n, t_linear, ops);
+
+    locations_model_deinit(&m);
+}
+
+/*
+    benchmarks
+*/
+
+static void bench_locations_model_8(void)
+{
+    bench_size(8U);
+}
+
+static void bench_locations_model_64(void)
+{
+    bench_size(64U);
+}
+
+static void bench_locations_model_512(void)
+{
+    bench_size(512U);
+}
+
+/*
+    bench runner
+*/
+
+void run_bench_domain_locations_model(void)
+{
+    UnityPrint("=== bench domain/locations_model : add / find / remove ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UNITY_OUTPUT_CHAR('\n');
+
+    RUN_TEST(bench_locations_model_8);
+    RUN_TEST(bench_locations_model_64);
+    RUN_TEST(bench_locations_model_512);
+
+    UNITY_OUTPUT_CHAR('\n');
+}
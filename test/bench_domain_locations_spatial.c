@@ -0,0 +1,140 @@
+#include <unity.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "test_api.h"
+
+#include "locations_model.h"
+#include "locations_spatial.h"
+
+/*
+    helpers
+*/
+
+#define BENCH_QUERIES 20000U
+#define BENCH_K 3U
+
+static uint32_t s_rng = 4711U;
+
+/* random microdegrees in [lo, hi] degrees */
+static int32_t rand_range(int32_t lo, int32_t hi)
+{
+    s_rng = (s_rng * 1103515245U) + 12345U;
+    return (lo * 1000000) + (int32_t)(((int64_t)(hi - lo) * 1000000 * ((s_rng >> 8) & 0xFFFFU)) / 65535);
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    (void)timespec_get(&ts, TIME_UTC);
+    return ((double)ts.tv_sec * 1e9) + (double)ts.tv_nsec;
+}
+
+static void bench_report(const char *op, size_t n, double total_ns, size_t ops)
+{
+    char line[128];
+    (void)snprintf(line, sizeof(line), "  %-18s n=%-4u %9.1f ns/op", op, (unsigned)n, total_ns / (double)ops);
+    UnityPrint(line);
+    UNITY_OUTPUT_CHAR('\n');
+}
+
+/* reference: rank every entry */
+static float full_scan_best(const locations_model_t *m, int32_t lat, int32_t lon)
+{
+    float best = 1e12f;
+
+    for (const location_t *loc = locations_model_first(m); loc != NULL; loc = locations_model_next(m, loc))
+    {
+        const float d = locations_spatial_distance_m(lat, lon, loc->latitude_e6, loc->longitude_e6);
+        if (d < best)
+        {
+            best = d;
+        }
+    }
+
+    return best;
+}
+
+static void bench_size(size_t n)
+{
+    locations_model_t m;
+    TEST_ASSERT_TRUE(locations_model_init(&m, n));
+
+    /* locations spread over central Europe, queries inside the same area */
+    for (size_t i = 0U; i < n; i++)
+    {
+        location_t loc = {0};
+        (void)snprintf(loc.name, sizeof(loc.name), "L%u", (unsigned)i);
+        loc.latitude_e6 = rand_range(45, 55);
+        loc.longitude_e6 = rand_range(5, 20);
+        TEST_ASSERT_TRUE(locations_model_add(&m, &loc));
+    }
+
+    volatile double sink = 0.0;
+    locations_spatial_hit_t hits[BENCH_K];
+
+    double t0 = now_ns();
+    for (size_t q = 0U; q < BENCH_QUERIES; q++)
+    {
+        const int32_t lat = 45000000 + ((int32_t)(q % 100U) * 100000);
+        const int32_t lon = 5000000 + ((int32_t)(q % 150U) * 100000);
+        (void)locations_spatial_nearest(&m, lat, lon, hits, BENCH_K);
+        sink += hits[0].distance_m;
+    }
+    const double t_grid = now_ns() - t0;
+
+    t0 = now_ns();
+    for (size_t q = 0U; q < BENCH_QUERIES; q++)
+    {
+        const int32_t lat = 45000000 + ((int32_t)(q % 100U) * 100000);
+        const int32_t lon = 5000000 + ((int32_t)(q % 150U) * 100000);
+        sink -= full_scan_best(&m, lat, lon);
+    }
+    const double t_scan = now_ns() - t0;
+
+    /* grid and scan agree on the nearest distance */
+    TEST_ASSERT_DOUBLE_WITHIN(1.0, 0.0, sink);
+
+    bench_report("nearest k=3", n, t_grid, BENCH_QUERIES);
+    bench_report("full scan ref", n, t_scan, BENCH_QUERIES);
+
+    locations_model_deinit(&m);
+}
+
+/*
+    benchmarks
+*/
+
+static void bench_locations_spatial_8(void)
+{
+    bench_size(8U);
+}
+
+static void bench_locations_spatial_64(void)
+{
+    bench_size(64U);
+}
+
+static void bench_locations_spatial_512(void)
+{
+    bench_size(512U);
+}
+
+/*
+    bench runner
+*/
+
+void run_bench_domain_locations_spatial(void)
+{
+    UnityPrint("=== bench domain/locations_spatial : nearest ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UNITY_OUTPUT_CHAR('\n');
+
+    RUN_TEST(bench_locations_spatial_8);
+    RUN_TEST(bench_locations_spatial_64);
+    RUN_TEST(bench_locations_spatial_512);
+
+    UNITY_OUTPUT_CHAR('\n');
+}
@@ -0,0 +1,118 @@
+#include <unity.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "test_api.h"
+
+#include "locations_model.h"
+#include "locations_storage.h"
+#include "lzss.h"
+
+/*
+    helpers
+*/
+
+#define BENCH_ROUNDS 200U
+#define BENCH_JSON_MAX 8192U
+
+static char s_json[BENCH_JSON_MAX];
+static uint8_t s_packed[BENCH_JSON_MAX];
+static char s_plain[BENCH_JSON_MAX];
+
+static const char *const CITIES[] = {"Berlin", "Hamburg", "Munich", "Cologne", "Frankfurt", "Stuttgart",
+                                     "Dresden", "Leipzig", "Bremen", "Hannover", "Nuremberg", "Kiel"};
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    (void)timespec_get(&ts, TIME_UTC);
+    return ((double)ts.tv_sec * 1e9) + (double)ts.tv_nsec;
+}
+
+/* what the legacy "locations" NVS string looked like for n entries */
+static size_t build_json(size_t n)
+{
+    locations_model_t m;
+    TEST_ASSERT_TRUE(locations_model_init(&m, n));
+
+    for (size_t i = 0U; i < n; i++)
+    {
+        location_t loc = {0};
+        (void)snprintf(loc.name, sizeof(loc.name), "%s %u", CITIES[i % 12U], (unsigned)(i / 12U));
+        loc.latitude_e6 = 47000000 + (int32_t)((i * 7919U) % 8000000U);
+        loc.longitude_e6 = 6000000 + (int32_t)((i * 104729U) % 9000000U);
+        loc.is_active = (i == 0U);
+        TEST_ASSERT_TRUE(locations_model_add(&m, &loc));
+    }
+
+    TEST_ASSERT_TRUE(locations_storage_to_json(&m, s_json, sizeof(s_json)));
+    locations_model_deinit(&m);
+    return strlen(s_json) + 1U;
+}
+
+static void bench_size(size_t n)
+{
+    const size_t len = build_json(n);
+    size_t packed = 0U;
+
+    double t0 = now_ns();
+    for (size_t r = 0U; r < BENCH_ROUNDS; r++)
+    {
+        packed = lzss_pack(s_json, len, LZSS_FLAG_STR, s_packed, sizeof(s_packed));
+    }
+    const double t_pack = now_ns() - t0;
+    TEST_ASSERT_TRUE(packed > 0U);
+
+    t0 = now_ns();
+    for (size_t r = 0U; r < BENCH_ROUNDS; r++)
+    {
+        TEST_ASSERT_TRUE(lzss_unpack(s_packed, packed, s_plain, len));
+    }
+    const double t_unpack = now_ns() - t0;
+    TEST_ASSERT_EQUAL_STRING(s_json, s_plain);
+
+    char line[160];
+    (void)snprintf(line, sizeof(line), "  n=%-3u %5u -> %5u bytes (%3.0f %%)  pack %7.1f ns/B  unpack %5.1f ns/B",
+                   (unsigned)n, (unsigned)len, (unsigned)packed, (100.0 * (double)packed) / (double)len,
+                   t_pack / ((double)BENCH_ROUNDS * (double)len), t_unpack / ((double)BENCH_ROUNDS * (double)len));
+    UnityPrint(line);
+    UNITY_OUTPUT_CHAR('\n');
+}
+
+/*
+    benchmarks
+*/
+
+static void bench_lzss_locations_4(void)
+{
+    bench_size(4U);
+}
+
+static void bench_lzss_locations_16(void)
+{
+    bench_size(16U);
+}
+
+static void bench_lzss_locations_64(void)
+{
+    bench_size(64U);
+}
+
+/*
+    bench runner
+*/
+
+void run_bench_storage_lzss(void)
+{
+    UnityPrint("=== bench storage/lzss : locations JSON ratio and cost ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UNITY_OUTPUT_CHAR('\n');
+
+    RUN_TEST(bench_lzss_locations_4);
+    RUN_TEST(bench_lzss_locations_16);
+    RUN_TEST(bench_lzss_locations_64);
+
+    UNITY_OUTPUT_CHAR('\n');
+}
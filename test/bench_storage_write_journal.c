@@ -0,0 +1,147 @@
+#include <unity.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include "test_api.h"
+
+#include "nvs.h"
+#include "nvs_host.h"
+#include "write_journal.h"
+
+/*
+    helpers
+*/
+
+#define BENCH_EDITS 20000U
+#define BENCH_LOCATIONS 8U
+#define BENCH_INDEX_LEN 24U
+#define BENCH_RECORD_LEN 48U
+
+static uint8_t s_journal_mem[2048];
+
+static int nvs_apply(void *ctx, const char *key, write_journal_kind_t kind, const void *data, size_t len)
+{
+    const nvs_handle_t h = *(const nvs_handle_t *)ctx;
+    esp_err_t err = ESP_OK;
+
+    if (kind == WRITE_JOURNAL_STR)
+    {
+        err = nvs_set_str(h, key, (const char *)data);
+    }
+    else if (kind == WRITE_JOURNAL_BLOB)
+    {
+        err = nvs_set_blob(h, key, data, len);
+    }
+    else
+    {
+        err = nvs_erase_key(h, key);
+        err = (err == ESP_ERR_NVS_NOT_FOUND) ? ESP_OK : err;
+    }
+
+    return err;
+}
+
+static int nvs_commit_cb(void *ctx)
+{
+    return nvs_commit(*(const nvs_handle_t *)ctx);
+}
+
+/* full: flush and retry, as nvs_helpers.c does */
+static void put_or_flush(write_journal_t *j, const write_journal_backend_t *backend, const char *key,
+                         const void *data, size_t len)
+{
+    if (write_journal_put(j, key, WRITE_JOURNAL_BLOB, data, len) == false)
+    {
+        TEST_ASSERT_EQUAL_INT(0, write_journal_flush(j, backend));
+        TEST_ASSERT_TRUE(write_journal_put(j, key, WRITE_JOURNAL_BLOB, data, len));
+    }
+}
+
+/*
+ * One edit as the locations writer does it: the touched record, then the
+ * index (its order / active flag changes too). A burst is the edits that
+ * land inside one quiet period; burst 1 is write-through.
+ */
+static void bench_bursts(uint32_t burst)
+{
+    nvs_handle_t h = 0U;
+    write_journal_t j;
+    const write_journal_backend_t backend = {nvs_apply, nvs_commit_cb, &h};
+    uint8_t index[BENCH_INDEX_LEN];
+    uint8_t record[BENCH_RECORD_LEN];
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    nvs_host_stats_t st;
+
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_host_mount(NULL, NVS_HOST_DEFAULT_PAGES));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_open("cfg", NVS_READWRITE, &h));
+    write_journal_init(&j, s_journal_mem, sizeof(s_journal_mem));
+    nvs_host_reset_stats();
+
+    for (uint32_t i = 0U; i < BENCH_EDITS; i++)
+    {
+        const uint32_t loc = (i / burst) % BENCH_LOCATIONS; /* a burst edits one location */
+
+        (void)memset(record, (int)(i & 0xFFU), sizeof(record));
+        (void)memset(index, (int)((i * 7U) & 0xFFU), sizeof(index));
+        (void)snprintf(key, sizeof(key), "loc_%u", (unsigned)loc);
+
+        put_or_flush(&j, &backend, key, record, sizeof(record));
+        put_or_flush(&j, &backend, "loc_idx", index, sizeof(index));
+        if (((i + 1U) % burst) == 0U)
+        {
+            TEST_ASSERT_EQUAL_INT(0, write_journal_flush(&j, &backend));
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(0, write_journal_flush(&j, &backend));
+
+    nvs_host_stats(&st);
+    nvs_close(h);
+    nvs_host_unmount();
+
+    char line[160];
+    (void)snprintf(line, sizeof(line),
+                   "  burst=%-2u entries/edit %5.2f (moved %4.2f)  page erases/1000 edits %6.1f  commits/edit %4.2f",
+                   (unsigned)burst, (double)st.entries_written / (double)BENCH_EDITS,
+                   (double)st.entries_moved / (double)BENCH_EDITS,
+                   (1000.0 * (double)st.page_erases) / (double)BENCH_EDITS,
+                   (double)st.commits / (double)BENCH_EDITS);
+    UnityPrint(line);
+    UNITY_OUTPUT_CHAR('\n');
+}
+
+/*
+    benchmarks
+*/
+
+static void bench_journal_write_through(void)
+{
+    bench_bursts(1U);
+}
+
+static void bench_journal_burst_4(void)
+{
+    bench_bursts(4U);
+}
+
+static void bench_journal_burst_16(void)
+{
+    bench_bursts(16U);
+}
+
+/*
+    bench runner
+*/
+
+void run_bench_storage_write_journal(void)
+{
+    UnityPrint("=== bench storage/write_journal : flash wear on the host NVS emulator ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UNITY_OUTPUT_CHAR('\n');
+
+    RUN_TEST(bench_journal_write_through);
+    RUN_TEST(bench_journal_burst_4);
+    RUN_TEST(bench_journal_burst_16);
+
+    UNITY_OUTPUT_CHAR('\n');
+}
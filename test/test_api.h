@@ -4,11 +4,63 @@
 void run_test_domain_locations_model_add(void);
 void run_test_domain_locations_model_remove(void);
 void run_test_domain_locations_model_get_active(void);
+void run_test_domain_locations_model_init(void);
+void run_test_domain_locations_model_find_and_set_active(void);
+void run_test_domain_locations_model_rename_and_copy(void);
+void run_test_domain_locations_model_handles(void);
 void run_test_domain_locations_model_invariants(void);
 
+/* domain/locations_batch */
+void run_test_domain_locations_batch_apply(void);
+
+/* domain/locations_snapshot */
+void run_test_domain_locations_snapshot(void);
+
+/* domain/locations_coord */
+void run_test_domain_locations_coord_parse(void);
+void run_test_domain_locations_coord_format(void);
+
+/* domain/locations_spatial */
+void run_test_domain_locations_spatial_distance(void);
+void run_test_domain_locations_spatial_nearest(void);
+
 /* storage/locations_storage */
 void run_test_storage_locations_storage_from_json(void);
 void run_test_storage_locations_storage_to_json_and_measure_json(void);
+void run_test_storage_locations_storage_item_to_json(void);
+
+/* storage/json_codec */
+void run_test_storage_json_codec_reader(void);
+void run_test_storage_json_codec_schemas(void);
+
+/* storage/buf_pool */
+void run_test_storage_buf_pool(void);
+
+/* storage/json_arena */
+void run_test_storage_json_arena(void);
+
+/* storage/locations_records */
+void run_test_storage_locations_records_record(void);
+void run_test_storage_locations_records_index(void);
+
+/* storage/write_journal */
+void run_test_storage_write_journal(void);
+
+/* storage/config_registry */
+void run_test_storage_config_registry(void);
+
+/* storage/ab_txn */
+void run_test_storage_ab_txn(void);
+
+/* storage/latency_hist */
+void run_test_storage_latency_hist(void);
+
+/* storage/lzss */
+void run_test_storage_lzss(void);
+
+/* storage/gazetteer */
+void run_test_storage_gazetteer_open(void);
+void run_test_storage_gazetteer_search(void);
 
 /* storage/settings_storage */
 void run_test_storage_settings_storage_wifi_from_json(void);
@@ -16,4 +68,16 @@ void run_test_storage_settings_storage_wifi_to_json_and_measure_json(void);
 
 /* storage/weather_storage */
 void run_test_storage_weather_storage_validate_json(void);
-void run_test_storage_weather_storage_compact_json_and_measure_json(void);
\ No newline at end of file
+void run_test_storage_weather_storage_compact_json_and_measure_json(void);
+
+/* storage/wifi_profiles */
+void run_test_storage_wifi_profiles(void);
+
+/* host/nvs */
+void run_test_host_nvs(void);
+
+/* benchmarks (pio test -e native_bench) */
+void run_bench_domain_locations_model(void);
+void run_bench_domain_locations_spatial(void);
+void run_bench_storage_lzss(void);
+void run_bench_storage_write_journal(void);
\ No newline at end of file
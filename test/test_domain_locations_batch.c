@@ -0,0 +1,211 @@
+#include <unity.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include "test_api.h"
+
+#include "locations_batch.h"
+#include "locations_model.h"
+
+static locations_model_t model;
+
+/*
+    helpers
+*/
+
+static void reset_model(void)
+{
+    locations_model_deinit(&model);
+    TEST_ASSERT_TRUE(locations_model_init(&model, 4U));
+}
+
+static locations_batch_op_t make_op(locations_batch_op_type_t type, const char *name, const char *new_name)
+{
+    locations_batch_op_t op;
+    (void)memset(&op, 0, sizeof(op));
+
+    op.type = type;
+    (void)snprintf(op.loc.name, sizeof(op.loc.name), "%s", name);
+    (void)snprintf(op.new_name, sizeof(op.new_name), "%s", (new_name != NULL) ? new_name : "");
+
+    return op;
+}
+
+static void add_loc(const char *name)
+{
+    location_t loc = {0};
+    (void)snprintf(loc.name, sizeof(loc.name), "%s", name);
+
+    TEST_ASSERT_TRUE(locations_model_add(&model, &loc));
+}
+
+/*
+    locations_batch_apply
+*/
+
+static void test_apply_ordered_ops(void)
+{
+    add_loc("Munich");
+
+    const locations_batch_op_t ops[] = {
+        make_op(LOCATIONS_BATCH_ADD, "Berlin", NULL),
+        make_op(LOCATIONS_BATCH_RENAME, "Berlin", "Home"),
+        make_op(LOCATIONS_BATCH_SET_ACTIVE, "Home", NULL),
+        make_op(LOCATIONS_BATCH_REMOVE, "Munich", NULL),
+        /* name freed by the rename is usable again */
+        make_op(LOCATIONS_BATCH_ADD, "Berlin", NULL),
+    };
+    size_t failed = 99U;
+
+    TEST_ASSERT_TRUE(locations_batch_apply(&model, ops, sizeof(ops) / sizeof(ops[0]), &failed));
+    TEST_ASSERT_EQUAL_UINT32(99U, (uint32_t)failed);
+
+    TEST_ASSERT_EQUAL_UINT32(2U, (uint32_t)model.count);
+    TEST_ASSERT_NULL(locations_model_find(&model, "Munich"));
+    TEST_ASSERT_EQUAL_STRING("Home", locations_model_first(&model)->name);
+    TEST_ASSERT_EQUAL_STRING("Home", locations_model_get_active(&model)->name);
+    TEST_ASSERT_NOT_NULL(locations_model_find(&model, "Berlin"));
+}
+
+static void test_apply_failing_op_leaves_model_unchanged(void)
+{
+    add_loc("A");
+    TEST_ASSERT_TRUE(locations_model_set_active(&model, "A"));
+
+    const locations_batch_op_t ops[] = {
+        make_op(LOCATIONS_BATCH_REMOVE, "A", NULL),
+        make_op(LOCATIONS_BATCH_ADD, "B", NULL),
+        make_op(LOCATIONS_BATCH_RENAME, "X", "Y"),
+        make_op(LOCATIONS_BATCH_ADD, "C", NULL),
+    };
+    size_t failed = 0U;
+
+    TEST_ASSERT_FALSE(locations_batch_apply(&model, ops, sizeof(ops) / sizeof(ops[0]), &failed));
+    TEST_ASSERT_EQUAL_UINT32(2U, (uint32_t)failed);
+
+    TEST_ASSERT_EQUAL_UINT32(1U, (uint32_t)model.count);
+    TEST_ASSERT_NOT_NULL(locations_model_find(&model, "A"));
+    TEST_ASSERT_NULL(locations_model_find(&model, "B"));
+    TEST_ASSERT_EQUAL_STRING("A", locations_model_get_active(&model)->name);
+}
+
+static void test_apply_respects_capacity(void)
+{
+    const locations_batch_op_t ops[] = {
+        make_op(LOCATIONS_BATCH_ADD, "A", NULL),
+        make_op(LOCATIONS_BATCH_ADD, "B", NULL),
+        make_op(LOCATIONS_BATCH_ADD, "C", NULL),
+        make_op(LOCATIONS_BATCH_ADD, "D", NULL),
+        make_op(LOCATIONS_BATCH_ADD, "E", NULL),
+    };
+    size_t failed = 0U;
+
+    TEST_ASSERT_FALSE(locations_batch_apply(&model, ops, sizeof(ops) / sizeof(ops[0]), &failed));
+    TEST_ASSERT_EQUAL_UINT32(4U, (uint32_t)failed);
+    TEST_ASSERT_EQUAL_UINT32(0U, (uint32_t)model.count);
+
+    /* room made inside the same batch counts */
+    const locations_batch_op_t ops2[] = {
+        make_op(LOCATIONS_BATCH_ADD, "A", NULL),
+        make_op(LOCATIONS_BATCH_ADD, "B", NULL),
+        make_op(LOCATIONS_BATCH_ADD, "C", NULL),
+        make_op(LOCATIONS_BATCH_ADD, "D", NULL),
+        make_op(LOCATIONS_BATCH_REMOVE, "A", NULL),
+        make_op(LOCATIONS_BATCH_ADD, "E", NULL),
+    };
+
+    TEST_ASSERT_TRUE(locations_batch_apply(&model, ops2, sizeof(ops2) / sizeof(ops2[0]), NULL));
+    TEST_ASSERT_EQUAL_UINT32(4U, (uint32_t)model.count);
+}
+
+static void test_apply_update_ops(void)
+{
+    add_loc("A");
+    add_loc("B");
+    TEST_ASSERT_TRUE(locations_model_set_active(&model, "A"));
+
+    const uint32_t tag = locations_model_etag(locations_model_find(&model, "A"));
+
+    locations_batch_op_t check = make_op(LOCATIONS_BATCH_CHECK_ETAG, "A", NULL);
+    check.etag = tag;
+    locations_batch_op_t move = make_op(LOCATIONS_BATCH_SET_COORDS, "A", NULL);
+    move.loc.latitude_e6 = 52520000;
+    move.loc.longitude_e6 = LOCATIONS_BATCH_KEEP_COORD;
+
+    const locations_batch_op_t ops[] = {
+        check,
+        move,
+        make_op(LOCATIONS_BATCH_DEACTIVATE, "A", NULL),
+        /* B is not active: nothing to do, still succeeds */
+        make_op(LOCATIONS_BATCH_DEACTIVATE, "B", NULL),
+        make_op(LOCATIONS_BATCH_RENAME, "A", "Home"),
+    };
+
+    TEST_ASSERT_TRUE(locations_batch_apply(&model, ops, sizeof(ops) / sizeof(ops[0]), NULL));
+
+    const location_t *home = locations_model_find(&model, "Home");
+    TEST_ASSERT_NOT_NULL(home);
+    TEST_ASSERT_EQUAL_INT32(52520000, home->latitude_e6);
+    TEST_ASSERT_EQUAL_INT32(0, home->longitude_e6);
+    TEST_ASSERT_NULL(locations_model_get_active(&model));
+
+    /* the same etag is stale now; nothing after it is applied */
+    const locations_batch_op_t stale[] = {
+        make_op(LOCATIONS_BATCH_RENAME, "Home", "X"),
+        check,
+    };
+    size_t failed = 99U;
+
+    TEST_ASSERT_FALSE(locations_batch_apply(&model, stale, sizeof(stale) / sizeof(stale[0]), &failed));
+    TEST_ASSERT_EQUAL_UINT32(1U, (uint32_t)failed);
+    TEST_ASSERT_NOT_NULL(locations_model_find(&model, "Home"));
+
+    /* unknown names fail */
+    const locations_batch_op_t unknown = make_op(LOCATIONS_BATCH_DEACTIVATE, "X", NULL);
+    TEST_ASSERT_FALSE(locations_batch_apply(&model, &unknown, 1U, NULL));
+    move.loc.name[0] = 'X';
+    TEST_ASSERT_FALSE(locations_batch_apply(&model, &move, 1U, NULL));
+}
+
+static void test_apply_invalid_args_fail(void)
+{
+    const locations_batch_op_t op = make_op(LOCATIONS_BATCH_ADD, "A", NULL);
+
+    TEST_ASSERT_FALSE(locations_batch_apply(NULL, &op, 1U, NULL));
+    TEST_ASSERT_FALSE(locations_batch_apply(&model, NULL, 1U, NULL));
+
+    /* empty batch is a no-op */
+    TEST_ASSERT_TRUE(locations_batch_apply(&model, NULL, 0U, NULL));
+    TEST_ASSERT_EQUAL_UINT32(0U, (uint32_t)model.count);
+}
+
+/*
+    test runners
+*/
+
+void run_test_domain_locations_batch_apply(void)
+{
+    UnityPrint("=== domain/locations_batch : locations_batch_apply() ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UNITY_OUTPUT_CHAR('\n');
+
+    reset_model();
+    RUN_TEST(test_apply_ordered_ops);
+
+    reset_model();
+    RUN_TEST(test_apply_failing_op_leaves_model_unchanged);
+
+    reset_model();
+    RUN_TEST(test_apply_respects_capacity);
+
+    reset_model();
+    RUN_TEST(test_apply_update_ops);
+
+    reset_model();
+    RUN_TEST(test_apply_invalid_args_fail);
+
+    locations_model_deinit(&model);
+
+    UNITY_OUTPUT_CHAR('\n');
+}
@@ -0,0 +1,176 @@
+#include <unity.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "test_api.h"
+
+#include "locations_coord.h"
+
+/*
+    helpers
+*/
+
+static bool parse(const char *text, int32_t *out_e6)
+{
+    return locations_coord_parse(text, strlen(text), out_e6);
+}
+
+static void assert_format(const char *expected, int32_t e6)
+{
+    char buf[LOCATIONS_COORD_STR_MAX];
+
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)strlen(expected), (uint32_t)locations_coord_format(e6, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING(expected, buf);
+}
+
+/*
+    locations_coord_parse
+*/
+
+static void test_parse_exact_decimals(void)
+{
+    int32_t e6 = 0;
+
+    TEST_ASSERT_TRUE(parse("52.52", &e6));
+    TEST_ASSERT_EQUAL_INT32(52520000, e6);
+
+    TEST_ASSERT_TRUE(parse("-13.405", &e6));
+    TEST_ASSERT_EQUAL_INT32(-13405000, e6);
+
+    TEST_ASSERT_TRUE(parse("+0.000001", &e6));
+    TEST_ASSERT_EQUAL_INT32(1, e6);
+
+    TEST_ASSERT_TRUE(parse("180", &e6));
+    TEST_ASSERT_EQUAL_INT32(180000000, e6);
+
+    TEST_ASSERT_TRUE(parse(".5", &e6));
+    TEST_ASSERT_EQUAL_INT32(500000, e6);
+}
+
+static void test_parse_rounds_half_away_from_zero(void)
+{
+    int32_t e6 = 0;
+
+    TEST_ASSERT_TRUE(parse("1.0000005", &e6));
+    TEST_ASSERT_EQUAL_INT32(1000001, e6);
+
+    TEST_ASSERT_TRUE(parse("-1.0000005", &e6));
+    TEST_ASSERT_EQUAL_INT32(-1000001, e6);
+
+    TEST_ASSERT_TRUE(parse("1.00000049999", &e6));
+    TEST_ASSERT_EQUAL_INT32(1000000, e6);
+}
+
+static void test_parse_invalid_fails(void)
+{
+    int32_t e6 = 42;
+
+    TEST_ASSERT_FALSE(parse("", &e6));
+    TEST_ASSERT_FALSE(parse("-", &e6));
+    TEST_ASSERT_FALSE(parse(".", &e6));
+    TEST_ASSERT_FALSE(parse("1.2.3", &e6));
+    TEST_ASSERT_FALSE(parse("1e2", &e6));
+    TEST_ASSERT_FALSE(parse("12a", &e6));
+    TEST_ASSERT_FALSE(parse("180.000001", &e6));
+    TEST_ASSERT_FALSE(parse("99999999999", &e6));
+    TEST_ASSERT_FALSE(locations_coord_parse(NULL, 1U, &e6));
+
+    /* output untouched on failure */
+    TEST_ASSERT_EQUAL_INT32(42, e6);
+}
+
+static void test_parse_respects_len(void)
+{
+    int32_t e6 = 0;
+
+    /* "12.5&lon=3" -> only "12.5" */
+    TEST_ASSERT_TRUE(locations_coord_parse("12.5&lon=3", 4U, &e6));
+    TEST_ASSERT_EQUAL_INT32(12500000, e6);
+}
+
+/*
+    locations_coord_from_double
+*/
+
+static void test_from_double_rounds_to_nearest(void)
+{
+    int32_t e6 = 0;
+
+    TEST_ASSERT_TRUE(locations_coord_from_double(52.52, &e6));
+    TEST_ASSERT_EQUAL_INT32(52520000, e6);
+
+    TEST_ASSERT_TRUE(locations_coord_from_double(-33.8688197, &e6));
+    TEST_ASSERT_EQUAL_INT32(-33868820, e6);
+
+    TEST_ASSERT_FALSE(locations_coord_from_double(180.5, &e6));
+    TEST_ASSERT_FALSE(locations_coord_from_double(-1.0 / 0.0, &e6));
+}
+
+/*
+    locations_coord_format
+*/
+
+static void test_format_shortest_exact(void)
+{
+    assert_format("52.52", 52520000);
+    assert_format("-13.405", -13405000);
+    assert_format("0", 0);
+    assert_format("-0.000001", -1);
+    assert_format("180", 180000000);
+    assert_format("-2147.483648", INT32_MIN);
+}
+
+static void test_format_round_trips_through_parse(void)
+{
+    const int32_t values[] = {1, -1, 999999, 52520000, -89999999, 179999999, -180000000};
+
+    for (size_t i = 0U; i < (sizeof(values) / sizeof(values[0])); i++)
+    {
+        char buf[LOCATIONS_COORD_STR_MAX];
+        int32_t e6 = 0;
+        const size_t len = locations_coord_format(values[i], buf, sizeof(buf));
+
+        TEST_ASSERT_TRUE(locations_coord_parse(buf, len, &e6));
+        TEST_ASSERT_EQUAL_INT32(values[i], e6);
+    }
+}
+
+static void test_format_buffer_too_small_fails(void)
+{
+    char buf[4];
+
+    TEST_ASSERT_EQUAL_UINT32(0U, (uint32_t)locations_coord_format(1, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_UINT32(0U, (uint32_t)locations_coord_format(1, NULL, LOCATIONS_COORD_STR_MAX));
+}
+
+/*
+    test runners
+*/
+
+void run_test_domain_locations_coord_parse(void)
+{
+    UnityPrint("=== domain/locations_coord : locations_coord_parse() / from_double() ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UNITY_OUTPUT_CHAR('\n');
+
+    RUN_TEST(test_parse_exact_decimals);
+    RUN_TEST(test_parse_rounds_half_away_from_zero);
+    RUN_TEST(test_parse_invalid_fails);
+    RUN_TEST(test_parse_respects_len);
+    RUN_TEST(test_from_double_rounds_to_nearest);
+
+    UNITY_OUTPUT_CHAR('\n');
+}
+
+void run_test_domain_locations_coord_format(void)
+{
+    UnityPrint("=== domain/locations_coord : locations_coord_format() ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UNITY_OUTPUT_CHAR('\n');
+
+    RUN_TEST(test_format_shortest_exact);
+    RUN_TEST(test_format_round_trips_through_parse);
+    RUN_TEST(test_format_buffer_too_small_fails);
+
+    UNITY_OUTPUT_CHAR('\n');
+}
@@ -6,6 +6,8 @@
 
 #include "locations_model.h"
 
+#define TEST_MODEL_CAPACITY 8U
+
 static locations_model_t model;
 
 /*
@@ -14,11 +16,25 @@ static locations_model_t model;
 
 static void reset_model(void)
 {
-    model.count = 0U;
-    (void)memset(model.items, 0, sizeof(model.items));
+    locations_model_deinit(&model);
+    TEST_ASSERT_TRUE(locations_model_init(&model, TEST_MODEL_CAPACITY));
+}
+
+/* n-th location in iteration order */
+static const location_t *loc_at(const locations_model_t *m, size_t pos)
+{
+    const location_t *loc = locations_model_first(m);
+
+    while ((loc != NULL) && (pos > 0U))
+    {
+        loc = locations_model_next(m, loc);
+        pos--;
+    }
+
+    return loc;
 }
 
-static location_t make_loc(const char *name, double lat, double lon, bool active)
+static location_t make_loc(const char *name, int32_t lat_e6, int32_t lon_e6, bool active)
 {
     location_t loc;
     (void)memset(&loc, 0, sizeof(loc));
@@ -26,8 +42,8 @@ static location_t make_loc(const char *name, double lat, double lon, bool active
     (void)strncpy(loc.name, name, sizeof(loc.name) - 1U);
     loc.name[sizeof(loc.name) - 1U] = '\0';
 
-    loc.latitude = lat;
-    loc.longitude = lon;
+    loc.latitude_e6 = lat_e6;
+    loc.longitude_e6 = lon_e6;
     loc.is_active = active;
 
     return loc;
@@ -36,16 +52,27 @@ static location_t make_loc(const char *name, double lat, double lon, bool active
 static void assert_model_invariants(const locations_model_t *m)
 {
     TEST_ASSERT_NOT_NULL(m);
-    TEST_ASSERT_TRUE(m->count <= (size_t)LOCATIONS_MODEL_MAX_NUMBER);
+    TEST_ASSERT_TRUE(m->count <= m->capacity);
+
+    size_t iterated = 0U;
 
-    for (size_t i = 0U; i < m->count; i++)
+    for (const location_t *a = locations_model_first(m); a != NULL; a = locations_model_next(m, a))
     {
-        for (size_t j = i + 1U; j < m->count; j++)
+        for (const location_t *b = locations_model_next(m, a); b != NULL; b = locations_model_next(m, b))
         {
             /* names must be unique */
-            TEST_ASSERT_NOT_EQUAL(0, strcmp(m->items[i].name, m->items[j].name));
+            TEST_ASSERT_NOT_EQUAL(0, strcmp(a->name, b->name));
         }
+
+        /* every iterated entry must be reachable through the name index */
+        TEST_ASSERT_TRUE(locations_model_find(m, a->name) == a);
+
+        /* the flag is set exactly on the tracked active entry */
+        TEST_ASSERT_EQUAL(a->is_active, (locations_model_get_active(m) == a));
+        iterated++;
     }
+
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)m->count, (uint32_t)iterated);
 }
 /*
     locations_model_add
@@ -53,18 +80,18 @@ static void assert_model_invariants(const locations_model_t *m)
 
 static void test_add_success(void)
 {
-    location_t loc = make_loc("Berlin", 52.52, 13.405, false);
+    location_t loc = make_loc("Berlin", 52520000, 13405000, false);
 
     bool result = locations_model_add(&model, &loc);
 
     TEST_ASSERT_TRUE(result);
     TEST_ASSERT_EQUAL_UINT32(1U, model.count);
-    TEST_ASSERT_EQUAL_STRING("Berlin", model.items[0].name);
+    TEST_ASSERT_EQUAL_STRING("Berlin", loc_at(&model, 0U)->name);
 }
 
 static void test_add_duplicate_fails(void)
 {
-    location_t loc = make_loc("Berlin", 52.52, 13.405, false);
+    location_t loc = make_loc("Berlin", 52520000, 13405000, false);
 
     TEST_ASSERT_TRUE(locations_model_add(&model, &loc));
     TEST_ASSERT_FALSE(locations_model_add(&model, &loc));
@@ -73,7 +100,7 @@ static void test_add_duplicate_fails(void)
 
 static void test_add_null_model_fails(void)
 {
-    location_t loc = make_loc("Berlin", 52.52, 13.405, false);
+    location_t loc = make_loc("Berlin", 52520000, 13405000, false);
 
     bool result = locations_model_add(NULL, &loc);
 
@@ -90,50 +117,65 @@ static void test_add_null_location_fails(void)
 
 static void test_add_when_full_fails(void)
 {
-    for (size_t i = 0U; i < (size_t)LOCATIONS_MODEL_MAX_NUMBER; i++)
+    for (size_t i = 0U; i < model.capacity; i++)
     {
         location_t loc = {0};
         // create unique names: "L0", "L1", ...
         (void)snprintf(loc.name, sizeof(loc.name), "L%u", (unsigned)i);
-        loc.latitude = (double)i;
-        loc.longitude = (double)i;
+        loc.latitude_e6 = (int32_t)i * 1000000;
+        loc.longitude_e6 = (int32_t)i * 1000000;
         loc.is_active = false;
 
         TEST_ASSERT_TRUE(locations_model_add(&model, &loc));
     }
 
-    TEST_ASSERT_EQUAL_UINT32((uint32_t)LOCATIONS_MODEL_MAX_NUMBER, (uint32_t)model.count);
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)model.capacity, (uint32_t)model.count);
 
     // one more must fails
-    location_t extra = make_loc("Overflow", 0.0, 0.0, false);
+    location_t extra = make_loc("Overflow", 0, 0, false);
 
     bool result = locations_model_add(&model, &extra);
     TEST_ASSERT_FALSE(result);
 
     // count must not change
-    TEST_ASSERT_EQUAL_UINT32((uint32_t)LOCATIONS_MODEL_MAX_NUMBER, (uint32_t)model.count);
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)model.capacity, (uint32_t)model.count);
 }
 
 static void test_add_duplicate_has_no_side_effects(void)
 {
-    location_t loc1 = make_loc("Berlin", 52.52, 13.405, false);
+    location_t loc1 = make_loc("Berlin", 52520000, 13405000, false);
 
-    location_t loc2_same_name_different_data = make_loc("Berlin", 1.0, 2.0, false);
+    location_t loc2_same_name_different_data = make_loc("Berlin", 1000000, 2000000, false);
 
     TEST_ASSERT_TRUE(locations_model_add(&model, &loc1));
     TEST_ASSERT_EQUAL_UINT32(1U, model.count);
 
     // snapshot existing stored entry
-    location_t snapshot = model.items[0];
+    location_t snapshot = *loc_at(&model, 0U);
 
     TEST_ASSERT_FALSE(locations_model_add(&model, &loc2_same_name_different_data));
     TEST_ASSERT_EQUAL_UINT32(1U, model.count);
 
     // ensure nothing got overwritten
-    TEST_ASSERT_EQUAL_STRING(snapshot.name, model.items[0].name);
-    TEST_ASSERT_EQUAL_FLOAT((float)snapshot.latitude, (float)model.items[0].latitude);
-    TEST_ASSERT_EQUAL_FLOAT((float)snapshot.longitude, (float)model.items[0].longitude);
-    TEST_ASSERT_EQUAL_UINT8(snapshot.is_active, model.items[0].is_active);
+    const location_t *stored = loc_at(&model, 0U);
+    TEST_ASSERT_EQUAL_STRING(snapshot.name, stored->name);
+    TEST_ASSERT_EQUAL_INT32(snapshot.latitude_e6, stored->latitude_e6);
+    TEST_ASSERT_EQUAL_INT32(snapshot.longitude_e6, stored->longitude_e6);
+    TEST_ASSERT_EQUAL_UINT8(snapshot.is_active, stored->is_active);
+}
+
+static void test_add_out_of_range_fails(void)
+{
+    location_t lat_high = make_loc("North", 90000001, 0, false);
+    location_t lon_low = make_loc("West", 0, -180000001, false);
+    location_t edge = make_loc("Edge", -90000000, 180000000, false);
+
+    TEST_ASSERT_FALSE(locations_model_add(&model, &lat_high));
+    TEST_ASSERT_FALSE(locations_model_add(&model, &lon_low));
+    TEST_ASSERT_EQUAL_UINT32(0U, model.count);
+
+    TEST_ASSERT_TRUE(locations_model_add(&model, &edge));
+    TEST_ASSERT_EQUAL_UINT32(1U, model.count);
 }
 
 /*
@@ -166,24 +208,24 @@ static void test_remove_from_empty_model_fails(void)
 
 static void test_remove_unknown_name_has_no_side_effects(void)
 {
-    location_t a = make_loc("A", 1.0, 1.0, false);
+    location_t a = make_loc("A", 1000000, 1000000, false);
     TEST_ASSERT_TRUE(locations_model_add(&model, &a));
     TEST_ASSERT_EQUAL_UINT32(1U, (uint32_t)model.count);
 
-    location_t snapshot = model.items[0];
+    location_t snapshot = *loc_at(&model, 0U);
 
     bool result = locations_model_remove(&model, "X");
     TEST_ASSERT_FALSE(result);
 
     TEST_ASSERT_EQUAL_UINT32(1U, (uint32_t)model.count);
-    TEST_ASSERT_EQUAL_STRING(snapshot.name, model.items[0].name);
+    TEST_ASSERT_EQUAL_STRING(snapshot.name, loc_at(&model, 0U)->name);
 }
 
 static void test_remove_success_shifts_items(void)
 {
-    location_t a = make_loc("A", 1.0, 1.0, false);
-    location_t b = make_loc("B", 2.0, 2.0, false);
-    location_t c = make_loc("C", 3.0, 3.0, false);
+    location_t a = make_loc("A", 1000000, 1000000, false);
+    location_t b = make_loc("B", 2000000, 2000000, false);
+    location_t c = make_loc("C", 3000000, 3000000, false);
 
     TEST_ASSERT_TRUE(locations_model_add(&model, &a));
     TEST_ASSERT_TRUE(locations_model_add(&model, &b));
@@ -194,27 +236,27 @@ static void test_remove_success_shifts_items(void)
     TEST_ASSERT_TRUE(result);
 
     TEST_ASSERT_EQUAL_UINT32(2U, (uint32_t)model.count);
-    TEST_ASSERT_EQUAL_STRING("A", model.items[0].name);
-    TEST_ASSERT_EQUAL_STRING("C", model.items[1].name);
+    TEST_ASSERT_EQUAL_STRING("A", loc_at(&model, 0U)->name);
+    TEST_ASSERT_EQUAL_STRING("C", loc_at(&model, 1U)->name);
 }
 
 static void test_remove_active_clears_all_active_flags(void)
 {
-    location_t a = make_loc("A", 1.0, 1.0, false);
-    location_t b = make_loc("B", 2.0, 2.0, false);
+    location_t a = make_loc("A", 1000000, 1000000, false);
+    location_t b = make_loc("B", 2000000, 2000000, false);
 
     TEST_ASSERT_TRUE(locations_model_add(&model, &a));
     TEST_ASSERT_TRUE(locations_model_add(&model, &b));
 
     /* mark B active */
-    model.items[1].is_active = true;
+    TEST_ASSERT_TRUE(locations_model_set_active(&model, "B"));
 
     /* remove ative item */
     TEST_ASSERT_TRUE(locations_model_remove(&model, "B"));
 
     /* by design: if active removed, all remaining must be inactive */
     TEST_ASSERT_EQUAL_UINT32(1U, (uint32_t)model.count);
-    TEST_ASSERT_FALSE(model.items[0].is_active);
+    TEST_ASSERT_FALSE(loc_at(&model, 0U)->is_active);
 
     const location_t *active = locations_model_get_active(&model);
     TEST_ASSERT_NULL(active);
@@ -222,9 +264,9 @@ static void test_remove_active_clears_all_active_flags(void)
 
 static void test_remove_first_item_shifts_correctly(void)
 {
-    location_t a = make_loc("A", 1.0, 1.0, false);
-    location_t b = make_loc("B", 2.0, 2.0, false);
-    location_t c = make_loc("C", 3.0, 3.0, false);
+    location_t a = make_loc("A", 1000000, 1000000, false);
+    location_t b = make_loc("B", 2000000, 2000000, false);
+    location_t c = make_loc("C", 3000000, 3000000, false);
 
     TEST_ASSERT_TRUE(locations_model_add(&model, &a));
     TEST_ASSERT_TRUE(locations_model_add(&model, &b));
@@ -233,15 +275,15 @@ static void test_remove_first_item_shifts_correctly(void)
     TEST_ASSERT_TRUE(locations_model_remove(&model, "A"));
 
     TEST_ASSERT_EQUAL_UINT32(2U, (uint32_t)model.count);
-    TEST_ASSERT_EQUAL_STRING("B", model.items[0].name);
-    TEST_ASSERT_EQUAL_STRING("C", model.items[1].name);
+    TEST_ASSERT_EQUAL_STRING("B", loc_at(&model, 0U)->name);
+    TEST_ASSERT_EQUAL_STRING("C", loc_at(&model, 1U)->name);
 }
 
 static void test_remove_last_item_does_not_shift_others(void)
 {
-    location_t a = make_loc("A", 1.0, 1.0, false);
-    location_t b = make_loc("B", 2.0, 2.0, false);
-    location_t c = make_loc("C", 3.0, 3.0, false);
+    location_t a = make_loc("A", 1000000, 1000000, false);
+    location_t b = make_loc("B", 2000000, 2000000, false);
+    location_t c = make_loc("C", 3000000, 3000000, false);
 
     TEST_ASSERT_TRUE(locations_model_add(&model, &a));
     TEST_ASSERT_TRUE(locations_model_add(&model, &b));
@@ -250,13 +292,13 @@ static void test_remove_last_item_does_not_shift_others(void)
     TEST_ASSERT_TRUE(locations_model_remove(&model, "C"));
 
     TEST_ASSERT_EQUAL_UINT32(2U, (uint32_t)model.count);
-    TEST_ASSERT_EQUAL_STRING("A", model.items[0].name);
-    TEST_ASSERT_EQUAL_STRING("B", model.items[1].name);
+    TEST_ASSERT_EQUAL_STRING("A", loc_at(&model, 0U)->name);
+    TEST_ASSERT_EQUAL_STRING("B", loc_at(&model, 1U)->name);
 }
 
 static void test_remove_single_item_results_in_empty_model(void)
 {
-    location_t a = make_loc("A", 1.0, 1.0, false);
+    location_t a = make_loc("A", 1000000, 1000000, false);
     TEST_ASSERT_TRUE(locations_model_add(&model, &a));
 
     TEST_ASSERT_TRUE(locations_model_remove(&model, "A"));
@@ -267,16 +309,16 @@ static void test_remove_single_item_results_in_empty_model(void)
 
 static void test_remove_inactive_keeps_existing_active(void)
 {
-    location_t a = make_loc("A", 1.0, 1.0, false);
-    location_t b = make_loc("B", 2.0, 2.0, false);
-    location_t c = make_loc("C", 3.0, 3.0, false);
+    location_t a = make_loc("A", 1000000, 1000000, false);
+    location_t b = make_loc("B", 2000000, 2000000, false);
+    location_t c = make_loc("C", 3000000, 3000000, false);
 
     TEST_ASSERT_TRUE(locations_model_add(&model, &a));
     TEST_ASSERT_TRUE(locations_model_add(&model, &b));
     TEST_ASSERT_TRUE(locations_model_add(&model, &c));
 
     /* mark B active */
-    model.items[1].is_active = true;
+    TEST_ASSERT_TRUE(locations_model_set_active(&model, "B"));
 
     /* remove inactive C */
     TEST_ASSERT_TRUE(locations_model_remove(&model, "C"));
@@ -304,7 +346,7 @@ static void test_get_active_empty_model_returns_null(void)
 
 static void test_get_active_none_active_returns_null(void)
 {
-    location_t a = make_loc("A", 1.0, 1.0, false);
+    location_t a = make_loc("A", 1000000, 1000000, false);
     TEST_ASSERT_TRUE(locations_model_add(&model, &a));
 
     const location_t *active = locations_model_get_active(&model);
@@ -313,8 +355,8 @@ static void test_get_active_none_active_returns_null(void)
 
 static void test_get_active_returns_first_active(void)
 {
-    location_t a = make_loc("A", 1.0, 1.0, true);
-    location_t b = make_loc("B", 2.0, 2.0, true);
+    location_t a = make_loc("A", 1000000, 1000000, true);
+    location_t b = make_loc("B", 2000000, 2000000, true);
 
     TEST_ASSERT_TRUE(locations_model_add(&model, &a));
     TEST_ASSERT_TRUE(locations_model_add(&model, &b));
@@ -325,17 +367,415 @@ static void test_get_active_returns_first_active(void)
     TEST_ASSERT_EQUAL_STRING("A", active->name);
 }
 
+/*
+    locations_model_init
+*/
+
+static void test_init_invalid_capacity_fails(void)
+{
+    locations_model_t m;
+
+    TEST_ASSERT_FALSE(locations_model_init(NULL, 8U));
+    TEST_ASSERT_FALSE(locations_model_init(&m, 0U));
+    TEST_ASSERT_FALSE(locations_model_init(&m, (size_t)LOCATIONS_MODEL_MAX_NUMBER + 1U));
+}
+
+static void test_init_max_capacity_fill_and_drain(void)
+{
+    locations_model_t m;
+    TEST_ASSERT_TRUE(locations_model_init(&m, (size_t)LOCATIONS_MODEL_MAX_NUMBER));
+
+    for (size_t i = 0U; i < (size_t)LOCATIONS_MODEL_MAX_NUMBER; i++)
+    {
+        location_t loc = {0};
+        (void)snprintf(loc.name, sizeof(loc.name), "City %u", (unsigned)i);
+        TEST_ASSERT_TRUE(locations_model_add(&m, &loc));
+    }
+
+    assert_model_invariants(&m);
+
+    /* remove every other entry, remaining order must be untouched */
+    for (size_t i = 0U; i < (size_t)LOCATIONS_MODEL_MAX_NUMBER; i += 2U)
+    {
+        char name[32];
+        (void)snprintf(name, sizeof(name), "City %u", (unsigned)i);
+        TEST_ASSERT_TRUE(locations_model_remove(&m, name));
+    }
+
+    assert_model_invariants(&m);
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)LOCATIONS_MODEL_MAX_NUMBER / 2U, (uint32_t)m.count);
+    TEST_ASSERT_EQUAL_STRING("City 1", loc_at(&m, 0U)->name);
+    TEST_ASSERT_EQUAL_STRING("City 3", loc_at(&m, 1U)->name);
+
+    locations_model_deinit(&m);
+}
+
+/*
+    locations_model_find
+    locations_model_set_active
+*/
+
+static void test_find_returns_stored_entry(void)
+{
+    location_t a = make_loc("A", 1000000, 1000000, false);
+    location_t b = make_loc("B", 2000000, 2000000, false);
+
+    TEST_ASSERT_TRUE(locations_model_add(&model, &a));
+    TEST_ASSERT_TRUE(locations_model_add(&model, &b));
+
+    const location_t *found = locations_model_find(&model, "B");
+    TEST_ASSERT_NOT_NULL(found);
+    TEST_ASSERT_EQUAL_STRING("B", found->name);
+    TEST_ASSERT_EQUAL_INT32(2000000, found->latitude_e6);
+}
+
+static void test_find_unknown_or_removed_returns_null(void)
+{
+    location_t a = make_loc("A", 1000000, 1000000, false);
+
+    TEST_ASSERT_NULL(locations_model_find(&model, "A"));
+    TEST_ASSERT_TRUE(locations_model_add(&model, &a));
+    TEST_ASSERT_NULL(locations_model_find(&model, "X"));
+    TEST_ASSERT_TRUE(locations_model_remove(&model, "A"));
+    TEST_ASSERT_NULL(locations_model_find(&model, "A"));
+    TEST_ASSERT_NULL(locations_model_find(NULL, "A"));
+    TEST_ASSERT_NULL(locations_model_find(&model, NULL));
+}
+
+static void test_set_active_switches_single_active(void)
+{
+    location_t a = make_loc("A", 1000000, 1000000, true);
+    location_t b = make_loc("B", 2000000, 2000000, false);
+
+    TEST_ASSERT_TRUE(locations_model_add(&model, &a));
+    TEST_ASSERT_TRUE(locations_model_add(&model, &b));
+
+    TEST_ASSERT_TRUE(locations_model_set_active(&model, "B"));
+
+    TEST_ASSERT_FALSE(locations_model_find(&model, "A")->is_active);
+    TEST_ASSERT_TRUE(locations_model_find(&model, "B")->is_active);
+    TEST_ASSERT_EQUAL_STRING("B", locations_model_get_active(&model)->name);
+}
+
+static void test_set_active_after_remove_and_reuse(void)
+{
+    location_t a = make_loc("A", 1000000, 1000000, true);
+    location_t b = make_loc("B", 2000000, 2000000, true);
+    location_t c = make_loc("C", 3000000, 3000000, false);
+
+    TEST_ASSERT_TRUE(locations_model_add(&model, &a));
+    TEST_ASSERT_TRUE(locations_model_add(&model, &b));
+    TEST_ASSERT_TRUE(locations_model_add(&model, &c));
+
+    /* first active entry wins on add */
+    TEST_ASSERT_EQUAL_STRING("A", locations_model_get_active(&model)->name);
+    TEST_ASSERT_FALSE(locations_model_find(&model, "B")->is_active);
+    assert_model_invariants(&model);
+
+    /* removed active: none active, the next active add takes over */
+    TEST_ASSERT_TRUE(locations_model_remove(&model, "A"));
+    TEST_ASSERT_NULL(locations_model_get_active(&model));
+    TEST_ASSERT_TRUE(locations_model_add(&model, &b) == false);
+    location_t d = make_loc("D", 4000000, 4000000, true);
+    TEST_ASSERT_TRUE(locations_model_add(&model, &d));
+    TEST_ASSERT_EQUAL_STRING("D", locations_model_get_active(&model)->name);
+    assert_model_invariants(&model);
+
+    /* rename keeps the active entry */
+    TEST_ASSERT_TRUE(locations_model_set_active(&model, "C"));
+    TEST_ASSERT_TRUE(locations_model_rename(&model, "C", "Home"));
+    TEST_ASSERT_EQUAL_STRING("Home", locations_model_get_active(&model)->name);
+    TEST_ASSERT_FALSE(locations_model_find(&model, "D")->is_active);
+    assert_model_invariants(&model);
+
+    /* clear drops it */
+    locations_model_clear(&model);
+    TEST_ASSERT_NULL(locations_model_get_active(&model));
+}
+
+static void test_set_active_unknown_has_no_side_effects(void)
+{
+    location_t a = make_loc("A", 1000000, 1000000, true);
+
+    TEST_ASSERT_TRUE(locations_model_add(&model, &a));
+
+    TEST_ASSERT_FALSE(locations_model_set_active(&model, "X"));
+    TEST_ASSERT_EQUAL_STRING("A", locations_model_get_active(&model)->name);
+}
+
+static void test_slot_reuse_appends_at_end(void)
+{
+    location_t a = make_loc("A", 1000000, 1000000, false);
+    location_t b = make_loc("B", 2000000, 2000000, false);
+    location_t c = make_loc("C", 3000000, 3000000, false);
+
+    TEST_ASSERT_TRUE(locations_model_add(&model, &a));
+    TEST_ASSERT_TRUE(locations_model_add(&model, &b));
+    TEST_ASSERT_TRUE(locations_model_remove(&model, "A"));
+
+    /* C reuses A's slot but must iterate after B */
+    TEST_ASSERT_TRUE(locations_model_add(&model, &c));
+    TEST_ASSERT_EQUAL_STRING("B", loc_at(&model, 0U)->name);
+    TEST_ASSERT_EQUAL_STRING("C", loc_at(&model, 1U)->name);
+    TEST_ASSERT_NULL(loc_at(&model, 2U));
+}
+
+/*
+    locations_model_rename
+    locations_model_copy
+*/
+
+static void test_rename_keeps_position_and_data(void)
+{
+    location_t a = make_loc("A", 1000000, 1000000, false);
+    location_t b = make_loc("B", 2000000, 2000000, true);
+    location_t c = make_loc("C", 3000000, 3000000, false);
+
+    TEST_ASSERT_TRUE(locations_model_add(&model, &a));
+    TEST_ASSERT_TRUE(locations_model_add(&model, &b));
+    TEST_ASSERT_TRUE(locations_model_add(&model, &c));
+
+    TEST_ASSERT_TRUE(locations_model_rename(&model, "B", "Home"));
+
+    TEST_ASSERT_NULL(locations_model_find(&model, "B"));
+    TEST_ASSERT_EQUAL_STRING("Home", loc_at(&model, 1U)->name);
+    TEST_ASSERT_EQUAL_INT32(2000000, locations_model_find(&model, "Home")->latitude_e6);
+    TEST_ASSERT_EQUAL_STRING("Home", locations_model_get_active(&model)->name);
+    TEST_ASSERT_NOT_NULL(locations_model_find(&model, "A"));
+    TEST_ASSERT_NOT_NULL(locations_model_find(&model, "C"));
+    assert_model_invariants(&model);
+}
+
+static void test_rename_to_taken_or_empty_fails(void)
+{
+    location_t a = make_loc("A", 1000000, 1000000, false);
+    location_t b = make_loc("B", 2000000, 2000000, false);
+
+    TEST_ASSERT_TRUE(locations_model_add(&model, &a));
+    TEST_ASSERT_TRUE(locations_model_add(&model, &b));
+
+    TEST_ASSERT_FALSE(locations_model_rename(&model, "A", "B"));
+    TEST_ASSERT_FALSE(locations_model_rename(&model, "A", "A"));
+    TEST_ASSERT_FALSE(locations_model_rename(&model, "A", ""));
+    TEST_ASSERT_FALSE(locations_model_rename(&model, "X", "Y"));
+    TEST_ASSERT_FALSE(locations_model_rename(NULL, "A", "Y"));
+
+    TEST_ASSERT_NOT_NULL(locations_model_find(&model, "A"));
+    TEST_ASSERT_NOT_NULL(locations_model_find(&model, "B"));
+    TEST_ASSERT_NULL(locations_model_find(&model, "Y"));
+    assert_model_invariants(&model);
+}
+
+static void test_copy_is_independent(void)
+{
+    location_t a = make_loc("A", 1000000, 1000000, true);
+    location_t b = make_loc("B", 2000000, 2000000, false);
+    locations_model_t copy = {0};
+
+    TEST_ASSERT_TRUE(locations_model_add(&model, &a));
+    TEST_ASSERT_TRUE(locations_model_add(&model, &b));
+
+    TEST_ASSERT_TRUE(locations_model_init(&copy, TEST_MODEL_CAPACITY));
+    TEST_ASSERT_TRUE(locations_model_copy(&copy, &model));
+
+    TEST_ASSERT_TRUE(locations_model_remove(&copy, "A"));
+
+    TEST_ASSERT_EQUAL_UINT32(2U, (uint32_t)model.count);
+    TEST_ASSERT_EQUAL_UINT32(1U, (uint32_t)copy.count);
+    TEST_ASSERT_NOT_NULL(locations_model_find(&model, "A"));
+    TEST_ASSERT_NULL(locations_model_find(&copy, "A"));
+    assert_model_invariants(&model);
+    assert_model_invariants(&copy);
+
+    locations_model_deinit(&copy);
+}
+
+static void test_copy_capacity_mismatch_fails(void)
+{
+    locations_model_t copy = {0};
+
+    TEST_ASSERT_TRUE(locations_model_init(&copy, TEST_MODEL_CAPACITY + 1U));
+    TEST_ASSERT_FALSE(locations_model_copy(&copy, &model));
+    TEST_ASSERT_FALSE(locations_model_copy(NULL, &model));
+
+    locations_model_deinit(&copy);
+}
+
+static void test_set_coords_keeps_everything_else(void)
+{
+    location_t a = make_loc("A", 1000000, 1000000, true);
+    location_t b = make_loc("B", 2000000, 2000000, false);
+
+    TEST_ASSERT_TRUE(locations_model_add(&model, &a));
+    TEST_ASSERT_TRUE(locations_model_add(&model, &b));
+
+    TEST_ASSERT_TRUE(locations_model_set_coords(&model, "A", -33868800, 151209300));
+
+    const location_t *loc = loc_at(&model, 0U);
+    TEST_ASSERT_EQUAL_STRING("A", loc->name);
+    TEST_ASSERT_EQUAL_INT32(-33868800, loc->latitude_e6);
+    TEST_ASSERT_EQUAL_INT32(151209300, loc->longitude_e6);
+    TEST_ASSERT_TRUE(loc->is_active);
+
+    TEST_ASSERT_FALSE(locations_model_set_coords(&model, "X", 0, 0));
+    TEST_ASSERT_FALSE(locations_model_set_coords(&model, "B", 90000001, 0));
+    TEST_ASSERT_FALSE(locations_model_set_coords(&model, "B", 0, 180000001));
+    TEST_ASSERT_EQUAL_INT32(2000000, locations_model_find(&model, "B")->latitude_e6);
+    assert_model_invariants(&model);
+}
+
+static void test_clear_active(void)
+{
+    location_t a = make_loc("A", 1000000, 1000000, true);
+
+    TEST_ASSERT_TRUE(locations_model_add(&model, &a));
+
+    locations_model_clear_active(&model);
+    TEST_ASSERT_NULL(locations_model_get_active(&model));
+    TEST_ASSERT_FALSE(loc_at(&model, 0U)->is_active);
+    assert_model_invariants(&model);
+
+    locations_model_clear_active(NULL);
+}
+
+static void test_etag_tracks_content(void)
+{
+    location_t a = make_loc("A", 1000000, 1000000, false);
+    location_t b = make_loc("B", 1000000, 1000000, false);
+
+    TEST_ASSERT_TRUE(locations_model_add(&model, &a));
+    TEST_ASSERT_TRUE(locations_model_add(&model, &b));
+
+    const uint32_t tag = locations_model_etag(locations_model_find(&model, "A"));
+
+    /* same content, different slot or model: same tag */
+    TEST_ASSERT_EQUAL_HEX32(tag, locations_model_etag(&a));
+    TEST_ASSERT_NOT_EQUAL(tag, locations_model_etag(locations_model_find(&model, "B")));
+
+    TEST_ASSERT_TRUE(locations_model_set_active(&model, "A"));
+    const uint32_t active_tag = locations_model_etag(locations_model_find(&model, "A"));
+    TEST_ASSERT_NOT_EQUAL(tag, active_tag);
+
+    TEST_ASSERT_TRUE(locations_model_set_coords(&model, "A", 1000001, 1000000));
+    TEST_ASSERT_NOT_EQUAL(active_tag, locations_model_etag(locations_model_find(&model, "A")));
+
+    TEST_ASSERT_EQUAL_HEX32(0U, locations_model_etag(NULL));
+}
+
+/*
+    handle tests
+*/
+
+static void test_handle_survives_other_mutations(void)
+{
+    location_t a = make_loc("A", 1000000, 1000000, false);
+    location_t b = make_loc("B", 2000000, 2000000, false);
+    location_t c = make_loc("C", 3000000, 3000000, false);
+
+    TEST_ASSERT_TRUE(locations_model_add(&model, &a));
+    TEST_ASSERT_TRUE(locations_model_add(&model, &b));
+
+    const locations_handle_t hb = locations_model_handle(&model, locations_model_find(&model, "B"));
+    TEST_ASSERT_NOT_EQUAL(LOCATIONS_MODEL_NO_SLOT, hb.slot);
+
+    TEST_ASSERT_TRUE(locations_model_remove(&model, "A"));
+    TEST_ASSERT_TRUE(locations_model_add(&model, &c));
+    TEST_ASSERT_TRUE(locations_model_rename(&model, "B", "Home"));
+    TEST_ASSERT_TRUE(locations_model_set_active(&model, "Home"));
+
+    const location_t *loc = locations_model_resolve(&model, hb);
+    TEST_ASSERT_NOT_NULL(loc);
+    TEST_ASSERT_EQUAL_STRING("Home", loc->name);
+    TEST_ASSERT_TRUE(loc->is_active);
+    assert_model_invariants(&model);
+}
+
+static void test_handle_stale_after_remove_and_reuse(void)
+{
+    location_t a = make_loc("A", 1000000, 1000000, false);
+    location_t b = make_loc("B", 2000000, 2000000, false);
+
+    TEST_ASSERT_TRUE(locations_model_add(&model, &a));
+    const locations_handle_t ha = locations_model_handle(&model, locations_model_find(&model, "A"));
+
+    TEST_ASSERT_TRUE(locations_model_remove(&model, "A"));
+    TEST_ASSERT_NULL(locations_model_resolve(&model, ha));
+
+    /* B lands in the freed slot; the old handle must not resolve to it */
+    TEST_ASSERT_TRUE(locations_model_add(&model, &b));
+    const locations_handle_t hb = locations_model_handle(&model, locations_model_find(&model, "B"));
+    TEST_ASSERT_EQUAL_UINT16(ha.slot, hb.slot);
+    TEST_ASSERT_NULL(locations_model_resolve(&model, ha));
+    TEST_ASSERT_EQUAL_STRING("B", locations_model_resolve(&model, hb)->name);
+
+    /* same name re-added is a new entry too */
+    TEST_ASSERT_TRUE(locations_model_remove(&model, "B"));
+    TEST_ASSERT_TRUE(locations_model_add(&model, &b));
+    TEST_ASSERT_NULL(locations_model_resolve(&model, hb));
+}
+
+static void test_handle_stale_after_clear(void)
+{
+    location_t a = make_loc("A", 1000000, 1000000, false);
+
+    TEST_ASSERT_TRUE(locations_model_add(&model, &a));
+    const locations_handle_t ha = locations_model_handle(&model, locations_model_find(&model, "A"));
+
+    locations_model_clear(&model);
+    TEST_ASSERT_TRUE(locations_model_add(&model, &a));
+
+    TEST_ASSERT_NULL(locations_model_resolve(&model, ha));
+    assert_model_invariants(&model);
+}
+
+static void test_handle_resolves_in_copy(void)
+{
+    location_t a = make_loc("A", 1000000, 1000000, false);
+    locations_model_t copy = {0};
+
+    TEST_ASSERT_TRUE(locations_model_add(&model, &a));
+    const locations_handle_t ha = locations_model_handle(&model, locations_model_find(&model, "A"));
+
+    TEST_ASSERT_TRUE(locations_model_init(&copy, TEST_MODEL_CAPACITY));
+    TEST_ASSERT_TRUE(locations_model_copy(&copy, &model));
+
+    const location_t *in_copy = locations_model_resolve(&copy, ha);
+    TEST_ASSERT_NOT_NULL(in_copy);
+    TEST_ASSERT_TRUE(in_copy != locations_model_find(&model, "A"));
+    TEST_ASSERT_EQUAL_STRING("A", in_copy->name);
+
+    /* pointer into the copy is not a location of model */
+    TEST_ASSERT_EQUAL_UINT16(LOCATIONS_MODEL_NO_SLOT, locations_model_handle(&model, in_copy).slot);
+
+    locations_model_deinit(&copy);
+}
+
+static void test_handle_invalid_args(void)
+{
+    const locations_handle_t bogus = {(uint16_t)TEST_MODEL_CAPACITY, 1U};
+    const locations_handle_t free_slot = {0U, 0U};
+    const location_t outside = make_loc("X", 0, 0, false);
+
+    TEST_ASSERT_EQUAL_UINT16(LOCATIONS_MODEL_NO_SLOT, locations_model_handle(&model, NULL).slot);
+    TEST_ASSERT_EQUAL_UINT16(LOCATIONS_MODEL_NO_SLOT, locations_model_handle(NULL, &outside).slot);
+    TEST_ASSERT_EQUAL_UINT16(LOCATIONS_MODEL_NO_SLOT, locations_model_handle(&model, &outside).slot);
+
+    TEST_ASSERT_NULL(locations_model_resolve(&model, bogus));
+    TEST_ASSERT_NULL(locations_model_resolve(&model, free_slot));
+    TEST_ASSERT_NULL(locations_model_resolve(NULL, free_slot));
+}
+
 /*
     invariant tests
 */
 
 static void test_sequence_add_remove_add_keeps_invariants(void)
 {
-    location_t a = make_loc("A", 1.0, 1.0, false);
-    location_t b = make_loc("B", 2.0, 2.0, false);
-    location_t c = make_loc("C", 3.0, 3.0, false);
-    location_t d = make_loc("D", 4.0, 4.0, false);
-    location_t e = make_loc("E", 5.0, 5.0, false);
+    location_t a = make_loc("A", 1000000, 1000000, false);
+    location_t b = make_loc("B", 2000000, 2000000, false);
+    location_t c = make_loc("C", 3000000, 3000000, false);
+    location_t d = make_loc("D", 4000000, 4000000, false);
+    location_t e = make_loc("E", 5000000, 5000000, false);
 
     TEST_ASSERT_TRUE(locations_model_add(&model, &a));
     TEST_ASSERT_TRUE(locations_model_add(&model, &b));
@@ -385,6 +825,9 @@ void run_test_domain_locations_model_add(void)
     reset_model();
     RUN_TEST(test_add_duplicate_has_no_side_effects);
 
+    reset_model();
+    RUN_TEST(test_add_out_of_range_fails);
+
     UNITY_OUTPUT_CHAR('\n');
 }
 
@@ -451,6 +894,105 @@ void run_test_domain_locations_model_get_active(void)
     UNITY_OUTPUT_CHAR('\n');
 }
 
+void run_test_domain_locations_model_init(void)
+{
+    UnityPrint("=== domain/locations_model : locations_model_init() ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UNITY_OUTPUT_CHAR('\n');
+
+    RUN_TEST(test_init_invalid_capacity_fails);
+    RUN_TEST(test_init_max_capacity_fill_and_drain);
+
+    UNITY_OUTPUT_CHAR('\n');
+}
+
+void run_test_domain_locations_model_find_and_set_active(void)
+{
+    UnityPrint("=== domain/locations_model : locations_model_find() ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UnityPrint("=== domain/locations_model : locations_model_set_active() ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UNITY_OUTPUT_CHAR('\n');
+
+    reset_model();
+    RUN_TEST(test_find_returns_stored_entry);
+
+    reset_model();
+    RUN_TEST(test_find_unknown_or_removed_returns_null);
+
+    reset_model();
+    RUN_TEST(test_set_active_switches_single_active);
+
+    reset_model();
+    RUN_TEST(test_set_active_after_remove_and_reuse);
+
+    reset_model();
+    RUN_TEST(test_set_active_unknown_has_no_side_effects);
+
+    reset_model();
+    RUN_TEST(test_slot_reuse_appends_at_end);
+
+    UNITY_OUTPUT_CHAR('\n');
+}
+
+void run_test_domain_locations_model_rename_and_copy(void)
+{
+    UnityPrint("=== domain/locations_model : locations_model_rename() ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UnityPrint("=== domain/locations_model : locations_model_copy() ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UnityPrint("=== domain/locations_model : set_coords() / clear_active() / etag() ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UNITY_OUTPUT_CHAR('\n');
+
+    reset_model();
+    RUN_TEST(test_rename_keeps_position_and_data);
+
+    reset_model();
+    RUN_TEST(test_rename_to_taken_or_empty_fails);
+
+    reset_model();
+    RUN_TEST(test_copy_is_independent);
+
+    reset_model();
+    RUN_TEST(test_copy_capacity_mismatch_fails);
+
+    reset_model();
+    RUN_TEST(test_set_coords_keeps_everything_else);
+
+    reset_model();
+    RUN_TEST(test_clear_active);
+
+    reset_model();
+    RUN_TEST(test_etag_tracks_content);
+
+    UNITY_OUTPUT_CHAR('\n');
+}
+
+void run_test_domain_locations_model_handles(void)
+{
+    UnityPrint("=== domain/locations_model : locations_model_handle() / resolve() ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UNITY_OUTPUT_CHAR('\n');
+
+    reset_model();
+    RUN_TEST(test_handle_survives_other_mutations);
+
+    reset_model();
+    RUN_TEST(test_handle_stale_after_remove_and_reuse);
+
+    reset_model();
+    RUN_TEST(test_handle_stale_after_clear);
+
+    reset_model();
+    RUN_TEST(test_handle_resolves_in_copy);
+
+    reset_model();
+    RUN_TEST(test_handle_invalid_args);
+
+    UNITY_OUTPUT_CHAR('\n');
+}
+
 void run_test_domain_locations_model_invariants(void)
 {
     UnityPrint("=== domain/locations_model : invariants ===");
@@ -460,5 +1002,7 @@ void run_test_domain_locations_model_invariants(void)
     reset_model();
     RUN_TEST(test_sequence_add_remove_add_keeps_invariants);
 
+    locations_model_deinit(&model);
+
     UNITY_OUTPUT_CHAR('\n');
 }
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include <unity.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include "test_api.h"
+
+#include "locations_model.h"
+#include "locations_snapshot.h"
+
+static locations_model_t model;
+
+/*
+    helpers
+*/
+
+static void reset_model(void)
+{
+    locations_model_deinit(&model);
+    TEST_ASSERT_TRUE(locations_model_init(&model, 4U));
+}
+
+static void add_loc(const char *name, int32_t lat_e6)
+{
+    location_t loc = {0};
+    (void)snprintf(loc.name, sizeof(loc.name), "%s", name);
+    loc.latitude_e6 = lat_e6;
+
+    TEST_ASSERT_TRUE(locations_model_add(&model, &loc));
+}
+
+/*
+    locations_snapshot
+*/
+
+static void test_create_copies_model(void)
+{
+    add_loc("Berlin", 52520000);
+    add_loc("Munich", 48137000);
+    TEST_ASSERT_TRUE(locations_model_set_active(&model, "Munich"));
+
+    locations_snapshot_t *snap = locations_snapshot_create(&model);
+    TEST_ASSERT_NOT_NULL(snap);
+
+    const locations_model_t *copy = locations_snapshot_model(snap);
+    TEST_ASSERT_EQUAL_UINT(2U, copy->count);
+    TEST_ASSERT_EQUAL_INT32(52520000, locations_model_find(copy, "Berlin")->latitude_e6);
+    TEST_ASSERT_EQUAL_STRING("Munich", locations_model_get_active(copy)->name);
+
+    locations_snapshot_release(snap);
+}
+
+static void test_snapshot_unaffected_by_later_writes(void)
+{
+    add_loc("Berlin", 52520000);
+    add_loc("Munich", 48137000);
+
+    locations_snapshot_t *snap = locations_snapshot_create(&model);
+    TEST_ASSERT_NOT_NULL(snap);
+
+    /* remove relinks slots, add reuses the freed one */
+    TEST_ASSERT_TRUE(locations_model_remove(&model, "Berlin"));
+    add_loc("Hamburg", 53551000);
+
+    const locations_model_t *copy = locations_snapshot_model(snap);
+    const location_t *first = locations_model_first(copy);
+    TEST_ASSERT_EQUAL_UINT(2U, copy->count);
+    TEST_ASSERT_EQUAL_STRING("Berlin", first->name);
+    TEST_ASSERT_EQUAL_STRING("Munich", locations_model_next(copy, first)->name);
+    TEST_ASSERT_NULL(locations_model_find(copy, "Hamburg"));
+
+    locations_snapshot_release(snap);
+}
+
+static void test_retain_and_release_count_references(void)
+{
+    add_loc("Berlin", 52520000);
+
+    locations_snapshot_t *snap = locations_snapshot_create(&model);
+    TEST_ASSERT_NOT_NULL(snap);
+    TEST_ASSERT_EQUAL_UINT(1U, atomic_load(&snap->refs));
+
+    locations_snapshot_retain(snap);
+    locations_snapshot_retain(snap);
+    TEST_ASSERT_EQUAL_UINT(3U, atomic_load(&snap->refs));
+
+    locations_snapshot_release(snap);
+    locations_snapshot_release(snap);
+    TEST_ASSERT_EQUAL_UINT(1U, atomic_load(&snap->refs));
+    TEST_ASSERT_NOT_NULL(locations_model_find(locations_snapshot_model(snap), "Berlin"));
+
+    /* last reference frees model and snapshot */
+    locations_snapshot_release(snap);
+}
+
+static void test_invalid_args(void)
+{
+    locations_model_t empty = {0};
+
+    TEST_ASSERT_NULL(locations_snapshot_create(NULL));
+    TEST_ASSERT_NULL(locations_snapshot_create(&empty));
+    TEST_ASSERT_NULL(locations_snapshot_model(NULL));
+
+    locations_snapshot_retain(NULL);
+    locations_snapshot_release(NULL);
+}
+
+void run_test_domain_locations_snapshot(void)
+{
+    UnityPrint("=== domain/locations_snapshot : create / retain / release ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UNITY_OUTPUT_CHAR('\n');
+
+    reset_model();
+    RUN_TEST(test_create_copies_model);
+
+    reset_model();
+    RUN_TEST(test_snapshot_unaffected_by_later_writes);
+
+    reset_model();
+    RUN_TEST(test_retain_and_release_count_references);
+
+    reset_model();
+    RUN_TEST(test_invalid_args);
+
+    locations_model_deinit(&model);
+
+    UNITY_OUTPUT_CHAR('\n');
+}
@@ -0,0 +1,259 @@
+#include <unity.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include "test_api.h"
+
+#include "locations_model.h"
+#include "locations_spatial.h"
+
+static locations_model_t model;
+
+/*
+    helpers
+*/
+
+static void reset_model(size_t capacity)
+{
+    locations_model_deinit(&model);
+    TEST_ASSERT_TRUE(locations_model_init(&model, capacity));
+}
+
+static void add_loc(const char *name, int32_t lat_e6, int32_t lon_e6)
+{
+    location_t loc = {0};
+
+    (void)snprintf(loc.name, sizeof(loc.name), "%s", name);
+    loc.latitude_e6 = lat_e6;
+    loc.longitude_e6 = lon_e6;
+
+    TEST_ASSERT_TRUE(locations_model_add(&model, &loc));
+}
+
+static uint32_t s_rng = 12345U;
+
+/* random microdegrees in [lo, hi] degrees */
+static int32_t rand_range(int32_t lo, int32_t hi)
+{
+    s_rng = (s_rng * 1103515245U) + 12345U;
+    return (lo * 1000000) + (int32_t)(((int64_t)(hi - lo) * 1000000 * ((s_rng >> 8) & 0xFFFFU)) / 65535);
+}
+
+/*
+    locations_spatial_distance_m
+*/
+
+static void test_distance_berlin_munich(void)
+{
+    const float d = locations_spatial_distance_m(52520000, 13405000, 48137000, 11575000);
+
+    /* ~504 km */
+    TEST_ASSERT_FLOAT_WITHIN(2000.0f, 504000.0f, d);
+}
+
+static void test_distance_same_point_is_zero(void)
+{
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, locations_spatial_distance_m(10000000, 20000000, 10000000, 20000000));
+}
+
+static void test_distance_short_range_precision(void)
+{
+    /* 1e-5 deg of latitude ~1.11 m; single precision must still resolve it */
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 1.112f, locations_spatial_distance_m(52520000, 13405000, 52520010, 13405000));
+}
+
+static void test_distance_across_antimeridian(void)
+{
+    /* 0.2 deg of longitude on the equator ~22.2 km */
+    TEST_ASSERT_FLOAT_WITHIN(50.0f, 22239.0f, locations_spatial_distance_m(0, 179900000, 0, -179900000));
+}
+
+/*
+    locations_spatial_nearest
+*/
+
+static void test_nearest_returns_sorted_hits(void)
+{
+    add_loc("Berlin", 52520000, 13405000);
+    add_loc("Munich", 48137000, 11575000);
+    add_loc("Hamburg", 53551000, 9993000);
+
+    locations_spatial_hit_t hits[3];
+
+    /* Potsdam */
+    const size_t n = locations_spatial_nearest(&model, 52390000, 13060000, hits, 3U);
+
+    TEST_ASSERT_EQUAL_UINT32(3U, (uint32_t)n);
+    TEST_ASSERT_EQUAL_STRING("Berlin", hits[0].loc->name);
+    TEST_ASSERT_EQUAL_STRING("Hamburg", hits[1].loc->name);
+    TEST_ASSERT_EQUAL_STRING("Munich", hits[2].loc->name);
+    TEST_ASSERT_TRUE(hits[0].distance_m <= hits[1].distance_m);
+    TEST_ASSERT_TRUE(hits[1].distance_m <= hits[2].distance_m);
+}
+
+static void test_nearest_k_clamped_to_count(void)
+{
+    add_loc("A", 1000000, 1000000);
+
+    locations_spatial_hit_t hits[4];
+
+    TEST_ASSERT_EQUAL_UINT32(1U, (uint32_t)locations_spatial_nearest(&model, 0, 0, hits, 4U));
+    TEST_ASSERT_EQUAL_STRING("A", hits[0].loc->name);
+}
+
+static void test_nearest_empty_or_invalid_returns_zero(void)
+{
+    locations_spatial_hit_t hits[1];
+
+    TEST_ASSERT_EQUAL_UINT32(0U, (uint32_t)locations_spatial_nearest(&model, 0, 0, hits, 1U));
+
+    add_loc("A", 1000000, 1000000);
+
+    TEST_ASSERT_EQUAL_UINT32(0U, (uint32_t)locations_spatial_nearest(&model, 0, 0, hits, 0U));
+    TEST_ASSERT_EQUAL_UINT32(0U, (uint32_t)locations_spatial_nearest(NULL, 0, 0, hits, 1U));
+    TEST_ASSERT_EQUAL_UINT32(0U, (uint32_t)locations_spatial_nearest(&model, 90000001, 0, hits, 1U));
+    TEST_ASSERT_EQUAL_UINT32(0U, (uint32_t)locations_spatial_nearest(&model, 0, 0, NULL, 1U));
+}
+
+static void test_nearest_wraps_antimeridian(void)
+{
+    add_loc("East", 0, 179900000);
+    add_loc("Middle", 0, 170000000);
+
+    locations_spatial_hit_t hits[1];
+
+    TEST_ASSERT_EQUAL_UINT32(1U, (uint32_t)locations_spatial_nearest(&model, 0, -179900000, hits, 1U));
+    TEST_ASSERT_EQUAL_STRING("East", hits[0].loc->name);
+}
+
+static void test_nearest_follows_remove_and_add(void)
+{
+    add_loc("Berlin", 52520000, 13405000);
+    add_loc("Munich", 48137000, 11575000);
+
+    locations_spatial_hit_t hits[1];
+
+    TEST_ASSERT_TRUE(locations_model_remove(&model, "Berlin"));
+    TEST_ASSERT_EQUAL_UINT32(1U, (uint32_t)locations_spatial_nearest(&model, 52500000, 13400000, hits, 1U));
+    TEST_ASSERT_EQUAL_STRING("Munich", hits[0].loc->name);
+
+    add_loc("Potsdam", 52390000, 13060000);
+    TEST_ASSERT_EQUAL_UINT32(1U, (uint32_t)locations_spatial_nearest(&model, 52500000, 13400000, hits, 1U));
+    TEST_ASSERT_EQUAL_STRING("Potsdam", hits[0].loc->name);
+}
+
+static void test_nearest_follows_set_coords(void)
+{
+    add_loc("Berlin", 52520000, 13405000);
+    add_loc("Home", 48137000, 11575000);
+
+    locations_spatial_hit_t hits[1];
+
+    /* moved into another grid cell */
+    TEST_ASSERT_TRUE(locations_model_set_coords(&model, "Home", 52400000, 13100000));
+    TEST_ASSERT_EQUAL_UINT32(1U, (uint32_t)locations_spatial_nearest(&model, 52390000, 13060000, hits, 1U));
+    TEST_ASSERT_EQUAL_STRING("Home", hits[0].loc->name);
+
+    TEST_ASSERT_EQUAL_UINT32(1U, (uint32_t)locations_spatial_nearest(&model, 48137000, 11575000, hits, 1U));
+    TEST_ASSERT_EQUAL_STRING("Home", hits[0].loc->name);
+    TEST_ASSERT_TRUE(hits[0].distance_m > 400000.0f);
+}
+
+static void test_nearest_matches_full_scan(void)
+{
+    /* dense cluster plus world-wide scatter */
+    for (size_t i = 0U; i < 400U; i++)
+    {
+        char name[32];
+        (void)snprintf(name, sizeof(name), "C%u", (unsigned)i);
+        add_loc(name, rand_range(47, 55), rand_range(5, 15));
+    }
+    for (size_t i = 0U; i < 112U; i++)
+    {
+        char name[32];
+        (void)snprintf(name, sizeof(name), "W%u", (unsigned)i);
+        add_loc(name, rand_range(-89, 89), rand_range(-180, 180));
+    }
+
+    for (size_t q = 0U; q < 200U; q++)
+    {
+        const int32_t lat = (q < 100U) ? rand_range(46, 56) : rand_range(-90, 90);
+        const int32_t lon = (q < 100U) ? rand_range(4, 16) : rand_range(-180, 180);
+
+        locations_spatial_hit_t hits[5];
+        const size_t n = locations_spatial_nearest(&model, lat, lon, hits, 5U);
+        TEST_ASSERT_EQUAL_UINT32(5U, (uint32_t)n);
+
+        /* reference: k-th smallest distance over all entries */
+        float best[5] = {1e12f, 1e12f, 1e12f, 1e12f, 1e12f};
+        for (const location_t *loc = locations_model_first(&model); loc != NULL; loc = locations_model_next(&model, loc))
+        {
+            float d = locations_spatial_distance_m(lat, lon, loc->latitude_e6, loc->longitude_e6);
+            for (size_t i = 0U; i < 5U; i++)
+            {
+                if (d < best[i])
+                {
+                    const float tmp = best[i];
+                    best[i] = d;
+                    d = tmp;
+                }
+            }
+        }
+
+        for (size_t i = 0U; i < 5U; i++)
+        {
+            TEST_ASSERT_FLOAT_WITHIN(0.001f, best[i], hits[i].distance_m);
+        }
+    }
+}
+
+/*
+    test runners
+*/
+
+void run_test_domain_locations_spatial_distance(void)
+{
+    UnityPrint("=== domain/locations_spatial : locations_spatial_distance_m() ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UNITY_OUTPUT_CHAR('\n');
+
+    RUN_TEST(test_distance_berlin_munich);
+    RUN_TEST(test_distance_same_point_is_zero);
+    RUN_TEST(test_distance_short_range_precision);
+    RUN_TEST(test_distance_across_antimeridian);
+
+    UNITY_OUTPUT_CHAR('\n');
+}
+
+void run_test_domain_locations_spatial_nearest(void)
+{
+    UnityPrint("=== domain/locations_spatial : locations_spatial_nearest() ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UNITY_OUTPUT_CHAR('\n');
+
+    reset_model(8U);
+    RUN_TEST(test_nearest_returns_sorted_hits);
+
+    reset_model(8U);
+    RUN_TEST(test_nearest_k_clamped_to_count);
+
+    reset_model(8U);
+    RUN_TEST(test_nearest_empty_or_invalid_returns_zero);
+
+    reset_model(8U);
+    RUN_TEST(test_nearest_wraps_antimeridian);
+
+    reset_model(8U);
+    RUN_TEST(test_nearest_follows_remove_and_add);
+
+    reset_model(8U);
+    RUN_TEST(test_nearest_follows_set_coords);
+
+    reset_model((size_t)LOCATIONS_MODEL_MAX_NUMBER);
+    RUN_TEST(test_nearest_matches_full_scan);
+
+    locations_model_deinit(&model);
+
+    UNITY_OUTPUT_CHAR('\n');
+}
@@ -0,0 +1,253 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "test_api.h"
+
+#include "nvs.h"
+#include "nvs_flash.h"
+#include "nvs_host.h"
+
+/*
+    helpers
+*/
+
+#define TEST_NVS_FILE "test_host_nvs.bin"
+
+static nvs_handle_t open_rw(const char *ns)
+{
+    nvs_handle_t h = 0U;
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_open(ns, NVS_READWRITE, &h));
+    return h;
+}
+
+static void mount_ram(size_t pages)
+{
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_host_mount(NULL, pages));
+}
+
+/*
+    nvs_host
+*/
+
+static void test_str_and_blob_contracts(void)
+{
+    mount_ram(NVS_HOST_DEFAULT_PAGES);
+    const nvs_handle_t h = open_rw("cfg");
+
+    char buf[16];
+    size_t len = 0U;
+
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_NVS_NOT_FOUND, nvs_get_str(h, "name", NULL, &len));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_set_str(h, "name", "Berlin"));
+
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_get_str(h, "name", NULL, &len));
+    TEST_ASSERT_EQUAL_UINT(7U, len);
+    len = 4U;
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_NVS_INVALID_LENGTH, nvs_get_str(h, "name", buf, &len));
+    len = sizeof(buf);
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_get_str(h, "name", buf, &len));
+    TEST_ASSERT_EQUAL_STRING("Berlin", buf);
+    TEST_ASSERT_EQUAL_UINT(7U, len);
+
+    const uint8_t blob[40] = {1U, 2U, 3U, [39] = 0xA5U};
+    uint8_t back[40];
+    len = sizeof(back);
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_set_blob(h, "rec", blob, sizeof(blob)));
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_NVS_TYPE_MISMATCH, nvs_get_str(h, "rec", buf, &len));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_get_blob(h, "rec", back, &len));
+    TEST_ASSERT_EQUAL_MEMORY(blob, back, sizeof(blob));
+
+    uint32_t u = 0U;
+    int8_t i8 = 0;
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_set_u32(h, "u", 0xDEADBEEFU));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_set_i8(h, "i8", -5));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_get_u32(h, "u", &u));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_get_i8(h, "i8", &i8));
+    TEST_ASSERT_EQUAL_HEX32(0xDEADBEEFU, u);
+    TEST_ASSERT_EQUAL_INT8(-5, i8);
+
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_erase_key(h, "name"));
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_NVS_NOT_FOUND, nvs_erase_key(h, "name"));
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_NVS_NOT_FOUND, nvs_get_str(h, "name", NULL, &len));
+
+    nvs_close(h);
+    nvs_host_unmount();
+}
+
+static void test_handles_and_names(void)
+{
+    nvs_handle_t h = 0U;
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_NVS_NOT_INITIALIZED, nvs_open("cfg", NVS_READWRITE, &h));
+
+    mount_ram(NVS_HOST_DEFAULT_PAGES);
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_NVS_NOT_FOUND, nvs_open("cfg", NVS_READONLY, &h));
+
+    const nvs_handle_t a = open_rw("cfg");
+    const nvs_handle_t b = open_rw("wifi");
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_set_str(a, "k", "a"));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_set_str(b, "k", "b"));
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_NVS_KEY_TOO_LONG, nvs_set_str(a, "sixteen_chars_xx", "x"));
+
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_open("cfg", NVS_READONLY, &h));
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_NVS_READ_ONLY, nvs_set_str(h, "k", "c"));
+
+    char buf[4];
+    size_t len = sizeof(buf);
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_get_str(h, "k", buf, &len));
+    TEST_ASSERT_EQUAL_STRING("a", buf);
+
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_erase_all(a));
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_NVS_NOT_FOUND, nvs_get_str(h, "k", NULL, &len));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_get_str(b, "k", NULL, &len));
+
+    nvs_close(h);
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_NVS_INVALID_HANDLE, nvs_commit(h));
+    nvs_host_unmount();
+}
+
+static void test_entry_accounting(void)
+{
+    mount_ram(NVS_HOST_DEFAULT_PAGES);
+    const nvs_handle_t h = open_rw("cfg");
+    nvs_host_stats_t st;
+
+    nvs_host_reset_stats();
+    /* header + 2 data entries; replacing it erases the old 3 */
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_set_str(h, "s", "0123456789012345678901234567890123456789"));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_set_str(h, "s", "0123456789012345678901234567890123456780"));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_set_str(h, "s", "0123456789012345678901234567890123456780"));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_commit(h));
+
+    nvs_host_stats(&st);
+    TEST_ASSERT_EQUAL_UINT32(6U, st.entries_written);
+    TEST_ASSERT_EQUAL_UINT32(3U, st.entries_erased);
+    TEST_ASSERT_EQUAL_UINT32(1U, st.writes_skipped);
+    TEST_ASSERT_EQUAL_UINT32(1U, st.commits);
+    TEST_ASSERT_EQUAL_UINT32(0U, st.page_erases);
+
+    size_t used = 0U;
+    nvs_stats_t ps;
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_get_used_entry_count(h, &used));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_get_stats(NULL, &ps));
+    TEST_ASSERT_EQUAL_UINT(3U, used);
+    TEST_ASSERT_EQUAL_UINT(4U, ps.used_entries); /* + namespace entry */
+    TEST_ASSERT_EQUAL_UINT(1U, ps.namespace_count);
+    TEST_ASSERT_EQUAL_UINT(NVS_HOST_DEFAULT_PAGES * NVS_HOST_ENTRIES_PER_PAGE, ps.total_entries);
+
+    nvs_close(h);
+    nvs_host_unmount();
+}
+
+static void test_garbage_collection_keeps_values(void)
+{
+    mount_ram(3U);
+    const nvs_handle_t h = open_rw("cfg");
+    uint8_t rec[64];
+    nvs_host_stats_t st;
+
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_set_str(h, "keep", "stays"));
+    for (uint32_t i = 0U; i < 500U; i++)
+    {
+        (void)memset(rec, (int)(i & 0xFFU), sizeof(rec));
+        TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_set_blob(h, "rec", rec, sizeof(rec)));
+    }
+
+    nvs_host_stats(&st);
+    TEST_ASSERT_TRUE(st.page_erases > 0U);
+    TEST_ASSERT_TRUE(st.entries_moved > 0U);
+    TEST_ASSERT_EQUAL_UINT32(st.entries_written - st.entries_moved, 500U * 3U + 2U + 1U);
+
+    char buf[8];
+    uint8_t back[64];
+    size_t len = sizeof(buf);
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_get_str(h, "keep", buf, &len));
+    TEST_ASSERT_EQUAL_STRING("stays", buf);
+    len = sizeof(back);
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_get_blob(h, "rec", back, &len));
+    TEST_ASSERT_EQUAL_MEMORY(rec, back, sizeof(rec));
+
+    nvs_close(h);
+    nvs_host_unmount();
+}
+
+static void test_full_partition_fails_cleanly(void)
+{
+    mount_ram(2U);
+    const nvs_handle_t h = open_rw("cfg");
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    esp_err_t err = ESP_OK;
+    uint32_t n = 0U;
+
+    while ((err == ESP_OK) && (n < 1000U))
+    {
+        (void)snprintf(key, sizeof(key), "k%u", (unsigned)n);
+        err = nvs_set_u32(h, key, n);
+        n += (err == ESP_OK) ? 1U : 0U;
+    }
+
+    /* one page usable, the other kept for garbage collection */
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_NVS_NOT_ENOUGH_SPACE, err);
+    TEST_ASSERT_EQUAL_UINT32(NVS_HOST_ENTRIES_PER_PAGE - 1U, n);
+
+    uint32_t v = 0U;
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_get_u32(h, "k0", &v));
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_NVS_VALUE_TOO_LONG, nvs_set_blob(h, "big", key, 4001U));
+
+    /* room again after an erase */
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_erase_key(h, "k0"));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_set_u32(h, "k0", 7U));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_get_u32(h, "k0", &v));
+    TEST_ASSERT_EQUAL_UINT32(7U, v);
+
+    nvs_close(h);
+    nvs_host_unmount();
+}
+
+static void test_file_survives_remount(void)
+{
+    (void)remove(TEST_NVS_FILE);
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_host_mount(TEST_NVS_FILE, 4U));
+    nvs_handle_t h = open_rw("cfg");
+    for (uint32_t i = 0U; i < 300U; i++)
+    {
+        TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_set_u32(h, "count", i));
+    }
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_set_str(h, "name", "Hamburg"));
+    nvs_host_unmount();
+
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_INVALID_SIZE, nvs_host_mount(TEST_NVS_FILE, 3U));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_host_mount(TEST_NVS_FILE, 4U));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_open("cfg", NVS_READONLY, &h));
+
+    uint32_t v = 0U;
+    char buf[16];
+    size_t len = sizeof(buf);
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_get_u32(h, "count", &v));
+    TEST_ASSERT_EQUAL_UINT32(299U, v);
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_get_str(h, "name", buf, &len));
+    TEST_ASSERT_EQUAL_STRING("Hamburg", buf);
+    nvs_close(h);
+
+    /* writes continue in the active page found on mount */
+    h = open_rw("cfg");
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_set_u32(h, "count", 300U));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_get_u32(h, "count", &v));
+    TEST_ASSERT_EQUAL_UINT32(300U, v);
+    nvs_close(h);
+
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_flash_erase());
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_NVS_NOT_FOUND, nvs_open("cfg", NVS_READONLY, &h));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_flash_deinit());
+    (void)remove(TEST_NVS_FILE);
+}
+
+void run_test_host_nvs(void)
+{
+    RUN_TEST(test_str_and_blob_contracts);
+    RUN_TEST(test_handles_and_names);
+    RUN_TEST(test_entry_accounting);
+    RUN_TEST(test_garbage_collection_keeps_values);
+    RUN_TEST(test_full_partition_fails_cleanly);
+    RUN_TEST(test_file_survives_remount);
+}
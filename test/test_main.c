@@ -13,11 +13,63 @@ int main(void)
     run_test_domain_locations_model_add();
     run_test_domain_locations_model_remove();
     run_test_domain_locations_model_get_active();
+    run_test_domain_locations_model_init();
+    run_test_domain_locations_model_find_and_set_active();
+    run_test_domain_locations_model_rename_and_copy();
+    run_test_domain_locations_model_handles();
     run_test_domain_locations_model_invariants();
 
+    /* domain/locations_batch */
+    run_test_domain_locations_batch_apply();
+
+    /* domain/locations_snapshot */
+    run_test_domain_locations_snapshot();
+
+    /* domain/locations_coord */
+    run_test_domain_locations_coord_parse();
+    run_test_domain_locations_coord_format();
+
+    /* domain/locations_spatial */
+    run_test_domain_locations_spatial_distance();
+    run_test_domain_locations_spatial_nearest();
+
     /* storage/locations_storage */
     run_test_storage_locations_storage_from_json();
     run_test_storage_locations_storage_to_json_and_measure_json();
+    run_test_storage_locations_storage_item_to_json();
+
+    /* storage/json_codec */
+    run_test_storage_json_codec_reader();
+    run_test_storage_json_codec_schemas();
+
+    /* storage/buf_pool */
+    run_test_storage_buf_pool();
+
+    /* storage/json_arena */
+    run_test_storage_json_arena();
+
+    /* storage/locations_records */
+    run_test_storage_locations_records_record();
+    run_test_storage_locations_records_index();
+
+    /* storage/write_journal */
+    run_test_storage_write_journal();
+
+    /* storage/config_registry */
+    run_test_storage_config_registry();
+
+    /* storage/ab_txn */
+    run_test_storage_ab_txn();
+
+    /* storage/latency_hist */
+    run_test_storage_latency_hist();
+
+    /* storage/lzss */
+    run_test_storage_lzss();
+
+    /* storage/gazetteer */
+    run_test_storage_gazetteer_open();
+    run_test_storage_gazetteer_search();
 
     /* storage/settings_storage */
     run_test_storage_settings_storage_wifi_from_json();
@@ -27,5 +79,19 @@ int main(void)
     run_test_storage_weather_storage_validate_json();
     run_test_storage_weather_storage_compact_json_and_measure_json();
 
+    /* storage/wifi_profiles */
+    run_test_storage_wifi_profiles();
+
+    /* host/nvs */
+    run_test_host_nvs();
+
+#ifdef CORE_NATIVE_BENCH
+    /* benchmarks */
+    run_bench_domain_locations_model();
+    run_bench_domain_locations_spatial();
+    run_bench_storage_lzss();
+    run_bench_storage_write_journal();
+#endif
+
     return UNITY_END();
 }
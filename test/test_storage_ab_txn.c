@@ -0,0 +1,380 @@
+#include <unity.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "test_api.h"
+
+#include "ab_txn.h"
+#include "nvs.h"
+#include "nvs_host.h"
+#include "write_journal.h"
+
+/*
+    helpers
+*/
+
+#define GROUP "grp_gen"
+
+/* write-behind journal in front of the host NVS, as nvs_helpers.c has it */
+static uint8_t s_mem[512];
+static write_journal_t s_j;
+static nvs_handle_t s_h;
+static size_t s_applied;
+static size_t s_cut_at; /* apply index where the power goes, SIZE_MAX: none */
+
+static int nvs_apply(void *ctx, const char *key, write_journal_kind_t kind, const void *data, size_t len)
+{
+    esp_err_t err = ESP_OK;
+
+    (void)ctx;
+    if (s_applied == s_cut_at)
+    {
+        err = ESP_FAIL;
+    }
+    else if (kind == WRITE_JOURNAL_STR)
+    {
+        err = nvs_set_str(s_h, key, (const char *)data);
+    }
+    else if (kind == WRITE_JOURNAL_BLOB)
+    {
+        err = nvs_set_blob(s_h, key, data, len);
+    }
+    else
+    {
+        err = nvs_erase_key(s_h, key);
+        err = (err == ESP_ERR_NVS_NOT_FOUND) ? ESP_OK : err;
+    }
+
+    s_applied += (err == ESP_OK) ? 1U : 0U;
+    return err;
+}
+
+static int nvs_commit_cb(void *ctx)
+{
+    (void)ctx;
+    return nvs_commit(s_h);
+}
+
+static const write_journal_backend_t s_backend = {nvs_apply, nvs_commit_cb, NULL};
+
+static int store_get(void *ctx, const char *key, write_journal_kind_t kind, bool committed, void *out, size_t *len)
+{
+    write_journal_kind_t pending = WRITE_JOURNAL_ERASE;
+    const void *data = NULL;
+    size_t n = 0U;
+    int err = 0;
+
+    (void)ctx;
+    if ((committed == false) && (write_journal_get(&s_j, key, &pending, &data, &n) == true))
+    {
+        if (pending == WRITE_JOURNAL_ERASE)
+        {
+            err = ESP_ERR_NVS_NOT_FOUND;
+        }
+        else if ((out != NULL) && (*len < n))
+        {
+            err = ESP_ERR_NVS_INVALID_LENGTH;
+        }
+        else
+        {
+            if (out != NULL)
+            {
+                (void)memcpy(out, data, n);
+            }
+            *len = n;
+        }
+    }
+    else
+    {
+        err = (kind == WRITE_JOURNAL_STR) ? nvs_get_str(s_h, key, (char *)out, len) : nvs_get_blob(s_h, key, out, len);
+    }
+
+    return err;
+}
+
+/* full: flush and retry, as nvs_helpers.c does */
+static int store_put(void *ctx, const char *key, write_journal_kind_t kind, const void *data, size_t len)
+{
+    int err = 0;
+
+    (void)ctx;
+    if (write_journal_put(&s_j, key, kind, data, len) == false)
+    {
+        err = write_journal_flush(&s_j, &s_backend);
+        if ((err == 0) && (write_journal_put(&s_j, key, kind, data, len) == false))
+        {
+            err = ESP_ERR_NO_MEM;
+        }
+    }
+
+    return err;
+}
+
+static const ab_txn_store_t s_store = {store_get, store_put, NULL, ESP_ERR_NVS_NOT_FOUND, ESP_FAIL};
+
+static void boot(void)
+{
+    write_journal_init(&s_j, s_mem, sizeof(s_mem));
+    s_applied = 0U;
+    s_cut_at = SIZE_MAX;
+}
+
+static void setup(void)
+{
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_host_mount(NULL, NVS_HOST_DEFAULT_PAGES));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_open("cfg", NVS_READWRITE, &s_h));
+    boot();
+}
+
+static void teardown(void)
+{
+    nvs_close(s_h);
+    nvs_host_unmount();
+}
+
+static void write_pair(const char *ssid, const char *pass)
+{
+    const ab_txn_item_t items[] = {
+        {"ssid", WRITE_JOURNAL_STR, ssid, strlen(ssid) + 1U},
+        {"pass", WRITE_JOURNAL_STR, pass, strlen(pass) + 1U},
+    };
+    TEST_ASSERT_EQUAL_INT(0, ab_txn_write(&s_store, GROUP, items, 2U));
+}
+
+/* "ssid/pass" as readers see it, "-" for a missing key */
+static void read_pair(char *out, size_t out_len)
+{
+    char ssid[16] = "-";
+    char pass[16] = "-";
+    size_t len = sizeof(ssid);
+    uint32_t gen = 0U;
+
+    TEST_ASSERT_EQUAL_INT(0, ab_txn_generation(&s_store, GROUP, false, &gen));
+    if (ab_txn_read(&s_store, gen, "ssid", WRITE_JOURNAL_STR, ssid, &len) != 0)
+    {
+        (void)strcpy(ssid, "-");
+    }
+    len = sizeof(pass);
+    if (ab_txn_read(&s_store, gen, "pass", WRITE_JOURNAL_STR, pass, &len) != 0)
+    {
+        (void)strcpy(pass, "-");
+    }
+    (void)snprintf(out, out_len, "%s/%s", ssid, pass);
+}
+
+/*
+    ab_txn
+*/
+
+static void test_keys_and_generation_word(void)
+{
+    char key[WRITE_JOURNAL_KEY_MAX];
+    uint8_t word[AB_TXN_GEN_LEN];
+    uint32_t gen = 0U;
+
+    TEST_ASSERT_TRUE(ab_txn_slot_key("sta_ssid", 1U, key));
+    TEST_ASSERT_EQUAL_STRING("a:sta_ssid", key);
+    TEST_ASSERT_TRUE(ab_txn_slot_key("sta_ssid", 2U, key));
+    TEST_ASSERT_EQUAL_STRING("b:sta_ssid", key);
+    TEST_ASSERT_TRUE(ab_txn_slot_key("thirteen_char", 2U, key));
+    TEST_ASSERT_FALSE(ab_txn_slot_key("fourteen_chars", 2U, key));
+    TEST_ASSERT_FALSE(ab_txn_slot_key("", 2U, key));
+
+    ab_txn_gen_encode(0x12345679U, word);
+    TEST_ASSERT_TRUE(ab_txn_gen_decode(word, sizeof(word), &gen));
+    TEST_ASSERT_EQUAL_HEX32(0x12345679U, gen);
+    TEST_ASSERT_FALSE(ab_txn_gen_decode(word, sizeof(word) - 1U, &gen));
+    word[5] ^= 0x10U;
+    TEST_ASSERT_FALSE(ab_txn_gen_decode(word, sizeof(word), &gen));
+    ab_txn_gen_encode(0U, word);
+    TEST_ASSERT_FALSE(ab_txn_gen_decode(word, sizeof(word), &gen));
+}
+
+static void test_plain_keys_until_first_write(void)
+{
+    char pair[40];
+    uint32_t gen = 0U;
+
+    setup();
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_set_str(s_h, "ssid", "legacy"));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_set_str(s_h, "pass", "old"));
+
+    read_pair(pair, sizeof(pair));
+    TEST_ASSERT_EQUAL_STRING("legacy/old", pair);
+
+    write_pair("home", "secret");
+    read_pair(pair, sizeof(pair));
+    TEST_ASSERT_EQUAL_STRING("home/secret", pair);
+
+    /* on flash: generation 1 in slot a, plain keys gone */
+    TEST_ASSERT_EQUAL_INT(0, write_journal_flush(&s_j, &s_backend));
+    TEST_ASSERT_EQUAL_INT(0, ab_txn_generation(&s_store, GROUP, true, &gen));
+    TEST_ASSERT_EQUAL_UINT32(1U, gen);
+    size_t len = 0U;
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_NVS_NOT_FOUND, nvs_get_str(s_h, "ssid", NULL, &len));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_get_str(s_h, "a:ssid", NULL, &len));
+
+    write_pair("work", "other");
+    TEST_ASSERT_EQUAL_INT(0, write_journal_flush(&s_j, &s_backend));
+    TEST_ASSERT_EQUAL_INT(0, ab_txn_generation(&s_store, GROUP, true, &gen));
+    TEST_ASSERT_EQUAL_UINT32(2U, gen);
+    boot();
+    read_pair(pair, sizeof(pair));
+    TEST_ASSERT_EQUAL_STRING("work/other", pair);
+
+    teardown();
+}
+
+/* power lost after every possible number of applied journal entries */
+static void test_power_cut_shows_one_generation(void)
+{
+    char pair[40];
+    bool seen_new = false;
+
+    for (size_t cut = 0U; cut < 8U; cut++)
+    {
+        setup();
+        write_pair("old", "oldpass");
+        TEST_ASSERT_EQUAL_INT(0, write_journal_flush(&s_j, &s_backend));
+
+        write_pair("new", "newpass");
+        s_applied = 0U;
+        s_cut_at = cut;
+        (void)write_journal_flush(&s_j, &s_backend);
+
+        boot(); /* journal lost */
+        read_pair(pair, sizeof(pair));
+        if (strcmp(pair, "new/newpass") == 0)
+        {
+            seen_new = true;
+        }
+        else
+        {
+            TEST_ASSERT_FALSE(seen_new); /* once the word is on flash it stays */
+            TEST_ASSERT_EQUAL_STRING("old/oldpass", pair);
+        }
+        teardown();
+    }
+
+    TEST_ASSERT_TRUE(seen_new);
+}
+
+static void test_writes_before_a_flush_take_new_generations(void)
+{
+    char pair[40];
+    uint32_t gen = 0U;
+
+    for (size_t cut = 0U; cut < 8U; cut++)
+    {
+        setup();
+        write_pair("old", "oldpass");
+        TEST_ASSERT_EQUAL_INT(0, write_journal_flush(&s_j, &s_backend));
+
+        /* the third write goes to slot a, behind the word of the second */
+        write_pair("mid", "midpass");
+        write_pair("new", "newpass");
+        TEST_ASSERT_EQUAL_INT(0, ab_txn_generation(&s_store, GROUP, false, &gen));
+        TEST_ASSERT_EQUAL_UINT32(3U, gen);
+        TEST_ASSERT_EQUAL_INT(0, ab_txn_generation(&s_store, GROUP, true, &gen));
+        TEST_ASSERT_EQUAL_UINT32(1U, gen);
+        read_pair(pair, sizeof(pair));
+        TEST_ASSERT_EQUAL_STRING("new/newpass", pair);
+
+        s_applied = 0U;
+        s_cut_at = cut;
+        (void)write_journal_flush(&s_j, &s_backend);
+        boot();
+        read_pair(pair, sizeof(pair));
+        TEST_ASSERT_TRUE((strcmp(pair, "old/oldpass") == 0) || (strcmp(pair, "mid/midpass") == 0) ||
+                         (strcmp(pair, "new/newpass") == 0));
+        teardown();
+    }
+}
+
+/* the journal fills up inside a write while the previous one is still queued */
+static void test_journal_full_inside_a_write(void)
+{
+    const ab_txn_item_t items[] = {
+        {"ssid", WRITE_JOURNAL_STR, "new", 4U},
+        {"pass", WRITE_JOURNAL_STR, "newpass", 8U},
+    };
+    char pair[40];
+    uint32_t gen = 0U;
+
+    for (size_t cut = 0U; cut < 8U; cut++)
+    {
+        setup();
+        write_pair("old", "oldpass");
+        TEST_ASSERT_EQUAL_INT(0, write_journal_flush(&s_j, &s_backend));
+
+        /* room for one write (12 value bytes + 8 word bytes) and a bit */
+        write_journal_init(&s_j, s_mem, 24U);
+        write_pair("mid", "midpass");
+        s_applied = 0U;
+        s_cut_at = cut;
+
+        /* "pass" does not fit: the store flushes "mid" and the new "ssid" first */
+        const int err = ab_txn_write(&s_store, GROUP, items, 2U);
+        if (err == 0)
+        {
+            TEST_ASSERT_EQUAL_INT(0, ab_txn_generation(&s_store, GROUP, false, &gen));
+            TEST_ASSERT_EQUAL_UINT32(3U, gen);
+            (void)write_journal_flush(&s_j, &s_backend);
+        }
+
+        boot();
+        read_pair(pair, sizeof(pair));
+        if (cut >= 6U)
+        {
+            TEST_ASSERT_EQUAL_STRING("new/newpass", pair);
+        }
+        else
+        {
+            TEST_ASSERT_TRUE((strcmp(pair, "old/oldpass") == 0) || (strcmp(pair, "mid/midpass") == 0) ||
+                             (strcmp(pair, "new/newpass") == 0));
+        }
+        teardown();
+    }
+}
+
+static void test_erase_and_corrupt_word(void)
+{
+    char pair[40];
+    uint32_t gen = 0U;
+
+    setup();
+    write_pair("home", "secret");
+
+    const ab_txn_item_t items[] = {
+        {"ssid", WRITE_JOURNAL_STR, "home", 5U},
+        {"pass", WRITE_JOURNAL_ERASE, NULL, 0U},
+    };
+    TEST_ASSERT_EQUAL_INT(0, ab_txn_write(&s_store, GROUP, items, 2U));
+    read_pair(pair, sizeof(pair));
+    TEST_ASSERT_EQUAL_STRING("home/-", pair);
+    TEST_ASSERT_EQUAL_INT(0, write_journal_flush(&s_j, &s_backend));
+
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_set_blob(s_h, GROUP, "garbage!", 8U));
+    TEST_ASSERT_EQUAL_INT(ESP_FAIL, ab_txn_generation(&s_store, GROUP, false, &gen));
+
+    /* nothing readable to protect: the next write starts over */
+    write_pair("fresh", "start");
+    read_pair(pair, sizeof(pair));
+    TEST_ASSERT_EQUAL_STRING("fresh/start", pair);
+    TEST_ASSERT_EQUAL_INT(0, ab_txn_generation(&s_store, GROUP, false, &gen));
+    TEST_ASSERT_EQUAL_UINT32(1U, gen);
+
+    teardown();
+}
+
+void run_test_storage_ab_txn(void)
+{
+    RUN_TEST(test_keys_and_generation_word);
+    RUN_TEST(test_plain_keys_until_first_write);
+    RUN_TEST(test_power_cut_shows_one_generation);
+    RUN_TEST(test_writes_before_a_flush_take_new_generations);
+    RUN_TEST(test_journal_full_inside_a_write);
+    RUN_TEST(test_erase_and_corrupt_word);
+}
@@ -0,0 +1,128 @@
+#include <unity.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "test_api.h"
+
+#include "buf_pool.h"
+
+/*
+    helpers
+*/
+
+static uint8_t s_small[4][64];
+static uint8_t s_large[2][256];
+static buf_pool_t s_pool;
+
+static const int OWNER_A = 1;
+static const int OWNER_B = 2;
+
+static void reset_pool(void)
+{
+    buf_pool_init(&s_pool);
+    TEST_ASSERT_TRUE(buf_pool_add_class(&s_pool, s_small, sizeof(s_small[0]), 4U));
+    TEST_ASSERT_TRUE(buf_pool_add_class(&s_pool, s_large, sizeof(s_large[0]), 2U));
+}
+
+static void count_label(const char *label, size_t block_size, void *ctx)
+{
+    (void)block_size;
+    if ((label != NULL) && (strcmp(label, "leaky") == 0))
+    {
+        (*(size_t *)ctx)++;
+    }
+}
+
+/*
+    buf_pool
+*/
+
+static void test_add_class_rejects_bad_layout(void)
+{
+    buf_pool_init(&s_pool);
+    TEST_ASSERT_TRUE(buf_pool_add_class(&s_pool, s_large, 256U, 2U));
+    TEST_ASSERT_FALSE(buf_pool_add_class(&s_pool, s_small, 64U, 4U));
+    TEST_ASSERT_FALSE(buf_pool_add_class(&s_pool, s_small, 512U, BUF_POOL_MAX_BLOCKS + 1U));
+    TEST_ASSERT_FALSE(buf_pool_add_class(&s_pool, NULL, 512U, 1U));
+}
+
+static void test_borrow_picks_smallest_fit_and_spills_up(void)
+{
+    reset_pool();
+
+    void *small[4];
+    for (size_t i = 0U; i < 4U; i++)
+    {
+        small[i] = buf_pool_borrow(&s_pool, 10U, &OWNER_A, "t");
+        TEST_ASSERT_NOT_NULL(small[i]);
+        TEST_ASSERT_EQUAL_UINT(64U, buf_pool_block_size(&s_pool, small[i]));
+    }
+
+    /* small class exhausted -> next larger class */
+    void *spill = buf_pool_borrow(&s_pool, 10U, &OWNER_A, "t");
+    TEST_ASSERT_EQUAL_UINT(256U, buf_pool_block_size(&s_pool, spill));
+
+    void *big = buf_pool_borrow(&s_pool, 200U, &OWNER_A, "t");
+    TEST_ASSERT_NOT_NULL(big);
+    TEST_ASSERT_NULL(buf_pool_borrow(&s_pool, 200U, &OWNER_A, "t"));
+    TEST_ASSERT_NULL(buf_pool_borrow(&s_pool, 1000U, &OWNER_A, "t"));
+    TEST_ASSERT_EQUAL_UINT32(1U, s_pool.cls[1].misses);
+
+    TEST_ASSERT_EQUAL_UINT(4U, s_pool.cls[0].peak);
+    TEST_ASSERT_EQUAL_UINT(2U, s_pool.cls[1].in_use);
+}
+
+static void test_return_detects_foreign_and_double_return(void)
+{
+    reset_pool();
+
+    uint8_t *a = buf_pool_borrow(&s_pool, 64U, &OWNER_A, "t");
+    TEST_ASSERT_NOT_NULL(a);
+
+    TEST_ASSERT_FALSE(buf_pool_return(&s_pool, &a[1]));
+    TEST_ASSERT_FALSE(buf_pool_return(&s_pool, s_pool.cls[0].mem + 64));
+    TEST_ASSERT_TRUE(buf_pool_return(&s_pool, a));
+    TEST_ASSERT_FALSE(buf_pool_return(&s_pool, a));
+    TEST_ASSERT_EQUAL_UINT(0U, buf_pool_block_size(&s_pool, a));
+    TEST_ASSERT_EQUAL_UINT(0U, s_pool.cls[0].in_use);
+
+    /* freed block is handed out again */
+    TEST_ASSERT_EQUAL_PTR(a, buf_pool_borrow(&s_pool, 1U, &OWNER_A, "t"));
+}
+
+static void test_outstanding_per_owner(void)
+{
+    size_t leaky = 0U;
+
+    reset_pool();
+
+    void *a = buf_pool_borrow(&s_pool, 8U, &OWNER_A, "ok");
+    (void)buf_pool_borrow(&s_pool, 8U, &OWNER_B, "leaky");
+    (void)buf_pool_borrow(&s_pool, 100U, &OWNER_B, "leaky");
+
+    TEST_ASSERT_EQUAL_UINT(3U, buf_pool_outstanding(&s_pool, NULL, NULL, NULL));
+    TEST_ASSERT_EQUAL_UINT(2U, buf_pool_outstanding(&s_pool, &OWNER_B, count_label, &leaky));
+    TEST_ASSERT_EQUAL_UINT(2U, leaky);
+
+    TEST_ASSERT_TRUE(buf_pool_return(&s_pool, a));
+    TEST_ASSERT_EQUAL_UINT(0U, buf_pool_outstanding(&s_pool, &OWNER_A, NULL, NULL));
+}
+
+/*
+    test runners
+*/
+
+void run_test_storage_buf_pool(void)
+{
+    UnityPrint("=== storage/buf_pool : borrow / return / outstanding ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UNITY_OUTPUT_CHAR('\n');
+
+    RUN_TEST(test_add_class_rejects_bad_layout);
+    RUN_TEST(test_borrow_picks_smallest_fit_and_spills_up);
+    RUN_TEST(test_return_detects_foreign_and_double_return);
+    RUN_TEST(test_outstanding_per_owner);
+
+    UNITY_OUTPUT_CHAR('\n');
+}
@@ -0,0 +1,168 @@
+#include <unity.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "test_api.h"
+
+#include "config_registry.h"
+
+/*
+    helpers
+*/
+
+enum
+{
+    KEY_NAME,
+    KEY_PASS,
+    KEY_LEVEL,
+    KEY_FLAG,
+    KEY_COUNT
+};
+
+static const config_def_t s_defs[KEY_COUNT] = {
+    {"dev.name", "dev_name", CONFIG_TYPE_STR, 1U, 8U, 0U, "node", 0U},
+    {"dev.pass", "dev_pass", CONFIG_TYPE_STR, 0U, CONFIG_VALUE_STR_MAX, 0U, "", CONFIG_FLAG_SECRET},
+    {"level", "level", CONFIG_TYPE_U32, 1U, 5U, 3U, NULL, 0U},
+    {"flag", "flag", CONFIG_TYPE_BOOL, 0U, 0U, 1U, NULL, 0U},
+};
+
+static const config_registry_t s_reg = {s_defs, KEY_COUNT};
+
+static config_parse_result_t parse(const char *json, config_entry_t *out, size_t max, size_t *count)
+{
+    return config_registry_from_json(&s_reg, json, out, max, count);
+}
+
+/*
+    config_registry
+*/
+
+static void test_find_and_defaults(void)
+{
+    config_value_t v;
+
+    TEST_ASSERT_EQUAL_UINT(KEY_LEVEL, config_registry_find(&s_reg, "level"));
+    TEST_ASSERT_EQUAL_UINT(KEY_COUNT, config_registry_find(&s_reg, "lvl"));
+
+    config_registry_default(&s_reg, KEY_NAME, &v);
+    TEST_ASSERT_EQUAL_STRING("node", v.str);
+    config_registry_default(&s_reg, KEY_LEVEL, &v);
+    TEST_ASSERT_EQUAL_UINT32(3U, v.num);
+    config_registry_default(&s_reg, KEY_FLAG, &v);
+    TEST_ASSERT_EQUAL_UINT32(1U, v.num);
+}
+
+static void test_text_round_trip_and_bounds(void)
+{
+    config_value_t v;
+    char text[CONFIG_VALUE_STR_MAX + 1U];
+
+    TEST_ASSERT_TRUE(config_registry_parse_text(&s_reg, KEY_LEVEL, "5", &v));
+    TEST_ASSERT_EQUAL_UINT(1U, config_registry_format_text(&s_reg, KEY_LEVEL, &v, text, sizeof(text)));
+    TEST_ASSERT_EQUAL_STRING("5", text);
+
+    TEST_ASSERT_FALSE(config_registry_parse_text(&s_reg, KEY_LEVEL, "6", &v));
+    TEST_ASSERT_FALSE(config_registry_parse_text(&s_reg, KEY_LEVEL, "0", &v));
+    TEST_ASSERT_FALSE(config_registry_parse_text(&s_reg, KEY_LEVEL, "03", &v));
+    TEST_ASSERT_FALSE(config_registry_parse_text(&s_reg, KEY_LEVEL, "4294967296", &v));
+    TEST_ASSERT_FALSE(config_registry_parse_text(&s_reg, KEY_FLAG, "2", &v));
+
+    TEST_ASSERT_TRUE(config_registry_parse_text(&s_reg, KEY_NAME, "abcdefgh", &v));
+    TEST_ASSERT_FALSE(config_registry_parse_text(&s_reg, KEY_NAME, "abcdefghi", &v));
+    TEST_ASSERT_FALSE(config_registry_parse_text(&s_reg, KEY_NAME, "", &v));
+
+    TEST_ASSERT_EQUAL_UINT(0U, config_registry_format_text(&s_reg, KEY_NAME, &v, text, 4U));
+}
+
+static void test_from_json_reads_many_keys(void)
+{
+    config_entry_t e[4];
+    size_t n = 0U;
+
+    TEST_ASSERT_EQUAL_INT(CONFIG_PARSE_OK,
+                          parse("{ \"level\": 4, \"dev.name\": \"a\\u00e9\", \"flag\": false }", e, 4U, &n));
+    TEST_ASSERT_EQUAL_UINT(3U, n);
+    TEST_ASSERT_EQUAL_UINT(KEY_LEVEL, e[0].key);
+    TEST_ASSERT_EQUAL_UINT32(4U, e[0].value.num);
+    TEST_ASSERT_EQUAL_UINT(KEY_NAME, e[1].key);
+    TEST_ASSERT_EQUAL_STRING("a\xc3\xa9", e[1].value.str);
+    TEST_ASSERT_EQUAL_UINT(KEY_FLAG, e[2].key);
+    TEST_ASSERT_EQUAL_UINT32(0U, e[2].value.num);
+
+    TEST_ASSERT_EQUAL_INT(CONFIG_PARSE_OK, parse("{}", e, 4U, &n));
+    TEST_ASSERT_EQUAL_UINT(0U, n);
+}
+
+static void test_from_json_rejects_bad_members(void)
+{
+    config_entry_t e[2];
+    size_t n = 0U;
+
+    TEST_ASSERT_EQUAL_INT(CONFIG_PARSE_UNKNOWN_KEY, parse("{\"level\":2,\"nope\":1}", e, 2U, &n));
+    TEST_ASSERT_EQUAL_UINT(1U, n);
+
+    TEST_ASSERT_EQUAL_INT(CONFIG_PARSE_INVALID_VALUE, parse("{\"level\":\"2\"}", e, 2U, &n));
+    TEST_ASSERT_EQUAL_INT(CONFIG_PARSE_INVALID_VALUE, parse("{\"level\":-1}", e, 2U, &n));
+    TEST_ASSERT_EQUAL_INT(CONFIG_PARSE_INVALID_VALUE, parse("{\"level\":2.5}", e, 2U, &n));
+    TEST_ASSERT_EQUAL_INT(CONFIG_PARSE_INVALID_VALUE, parse("{\"level\":9}", e, 2U, &n));
+    TEST_ASSERT_EQUAL_INT(CONFIG_PARSE_INVALID_VALUE, parse("{\"flag\":1}", e, 2U, &n));
+    TEST_ASSERT_EQUAL_INT(CONFIG_PARSE_INVALID_VALUE, parse("{\"dev.name\":\"123456789\"}", e, 2U, &n));
+
+    TEST_ASSERT_EQUAL_INT(CONFIG_PARSE_DUPLICATE, parse("{\"level\":2,\"level\":3}", e, 2U, &n));
+    TEST_ASSERT_EQUAL_UINT(1U, n);
+    TEST_ASSERT_EQUAL_INT(CONFIG_PARSE_TOO_MANY, parse("{\"level\":2,\"flag\":true}", e, 1U, &n));
+
+    TEST_ASSERT_EQUAL_INT(CONFIG_PARSE_SYNTAX, parse("{\"level\":2", e, 2U, &n));
+    TEST_ASSERT_EQUAL_INT(CONFIG_PARSE_SYNTAX, parse("{\"level\":2} x", e, 2U, &n));
+    TEST_ASSERT_EQUAL_INT(CONFIG_PARSE_SYNTAX, parse("[]", e, 2U, &n));
+}
+
+static void test_from_json_string_length_limit(void)
+{
+    char json[CONFIG_VALUE_STR_MAX + 32U];
+    char value[CONFIG_VALUE_STR_MAX + 2U];
+    config_entry_t e[1];
+    size_t n = 0U;
+
+    (void)memset(value, 'p', sizeof(value));
+    value[CONFIG_VALUE_STR_MAX] = '\0';
+    (void)snprintf(json, sizeof(json), "{\"dev.pass\":\"%s\"}", value);
+    TEST_ASSERT_EQUAL_INT(CONFIG_PARSE_OK, parse(json, e, 1U, &n));
+    TEST_ASSERT_EQUAL_UINT(CONFIG_VALUE_STR_MAX, strlen(e[0].value.str));
+
+    value[CONFIG_VALUE_STR_MAX] = 'p';
+    value[CONFIG_VALUE_STR_MAX + 1U] = '\0';
+    (void)snprintf(json, sizeof(json), "{\"dev.pass\":\"%s\"}", value);
+    TEST_ASSERT_EQUAL_INT(CONFIG_PARSE_INVALID_VALUE, parse(json, e, 1U, &n));
+}
+
+static void test_to_json_hides_secrets(void)
+{
+    config_entry_t e[4];
+    char out[128];
+
+    for (size_t i = 0U; i < KEY_COUNT; i++)
+    {
+        e[i].key = i;
+        config_registry_default(&s_reg, i, &e[i].value);
+    }
+    (void)strcpy(e[KEY_PASS].value.str, "hunter2");
+
+    const size_t len = config_registry_to_json(&s_reg, e, KEY_COUNT, out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("{\"dev.name\":\"node\",\"dev.pass_len\":7,\"level\":3,\"flag\":true}", out);
+    TEST_ASSERT_EQUAL_UINT(strlen(out), len);
+    TEST_ASSERT_EQUAL_UINT(len, config_registry_to_json(&s_reg, e, KEY_COUNT, NULL, 0U));
+    TEST_ASSERT_EQUAL_UINT(0U, config_registry_to_json(&s_reg, e, KEY_COUNT, out, len));
+}
+
+void run_test_storage_config_registry(void)
+{
+    RUN_TEST(test_find_and_defaults);
+    RUN_TEST(test_text_round_trip_and_bounds);
+    RUN_TEST(test_from_json_reads_many_keys);
+    RUN_TEST(test_from_json_rejects_bad_members);
+    RUN_TEST(test_from_json_string_length_limit);
+    RUN_TEST(test_to_json_hides_secrets);
+}
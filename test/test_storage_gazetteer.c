@@ -0,0 +1,273 @@
+#include <unity.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include "test_api.h"
+
+#include "gazetteer.h"
+
+/*
+    helpers
+*/
+
+typedef struct
+{
+    const char *name;
+    int32_t lat_e6;
+    int32_t lon_e6;
+} place_t;
+
+/* key order (ASCII lower case, bytewise), as tools/gazetteer_build.py sorts */
+static const place_t places[] = {
+    {"Berlin", 52520008, 13404954},
+    {"Bern", 46947974, 7447447},
+    {"Bonn", 50737430, 7098207},
+    {"Frankfurt (Oder)", 52347224, 14550567},
+    {"Frankfurt am Main", 50110922, 8682127},
+    {"M\xc3\xb6nchengladbach", 51180457, 6442804},
+    {"M\xc3\xbcnchen", 48135125, 11581981},
+    {"M\xc3\xbcnster", 51960665, 7626135},
+    {"Ulm", 48401082, 9987608},
+};
+#define PLACE_COUNT (sizeof(places) / sizeof(places[0]))
+
+static uint8_t image[2048];
+static size_t image_len;
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v & 0xFFU);
+    p[1] = (uint8_t)((v >> 8) & 0xFFU);
+    p[2] = (uint8_t)((v >> 16) & 0xFFU);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint8_t key_first(const char *name)
+{
+    const uint8_t c = (uint8_t)name[0];
+    return ((c >= (uint8_t)'A') && (c <= (uint8_t)'Z')) ? (uint8_t)(c + 32U) : c;
+}
+
+static void build_image(void)
+{
+    const uint32_t entries_off = GAZETTEER_HEADER_LEN + (4U * GAZETTEER_BUCKETS);
+    const uint32_t names_off = entries_off + ((uint32_t)PLACE_COUNT * GAZETTEER_ENTRY_LEN);
+    uint32_t names_len = 0U;
+
+    (void)memset(image, 0, sizeof(image));
+
+    for (size_t b = 0U; b < GAZETTEER_BUCKETS; b++)
+    {
+        uint32_t first = (uint32_t)PLACE_COUNT;
+        for (size_t i = 0U; i < PLACE_COUNT; i++)
+        {
+            if ((b < 256U) && (key_first(places[i].name) >= b))
+            {
+                first = (uint32_t)i;
+                break;
+            }
+        }
+        put_u32(&image[GAZETTEER_HEADER_LEN + (4U * b)], first);
+    }
+
+    for (size_t i = 0U; i < PLACE_COUNT; i++)
+    {
+        uint8_t *e = &image[entries_off + (i * GAZETTEER_ENTRY_LEN)];
+        const size_t len = strlen(places[i].name);
+
+        put_u32(&e[0], (uint32_t)places[i].lat_e6);
+        put_u32(&e[4], (uint32_t)places[i].lon_e6);
+        put_u32(&e[8], names_len);
+        e[12] = (uint8_t)len;
+
+        (void)memcpy(&image[names_off + names_len], places[i].name, len);
+        names_len += (uint32_t)len;
+    }
+
+    (void)memcpy(image, GAZETTEER_MAGIC, 4U);
+    put_u32(&image[4], (uint32_t)PLACE_COUNT);
+    put_u32(&image[8], entries_off);
+    put_u32(&image[12], names_off);
+    put_u32(&image[16], names_len);
+
+    image_len = names_off + names_len;
+    TEST_ASSERT_TRUE(image_len <= sizeof(image));
+}
+
+static gazetteer_t open_image(void)
+{
+    gazetteer_t gz;
+
+    build_image();
+    TEST_ASSERT_TRUE(gazetteer_open(&gz, image, image_len));
+
+    return gz;
+}
+
+static void assert_name(const char *expected, const gazetteer_entry_t *e)
+{
+    TEST_ASSERT_EQUAL_UINT(strlen(expected), e->name_len);
+    TEST_ASSERT_EQUAL_MEMORY(expected, e->name, e->name_len);
+}
+
+/*
+    gazetteer_open / gazetteer_get
+*/
+
+static void test_open_and_get(void)
+{
+    const gazetteer_t gz = open_image();
+    gazetteer_entry_t e;
+
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)PLACE_COUNT, gz.count);
+
+    TEST_ASSERT_TRUE(gazetteer_get(&gz, 0U, &e));
+    assert_name("Berlin", &e);
+    TEST_ASSERT_EQUAL_INT32(52520008, e.latitude_e6);
+    TEST_ASSERT_EQUAL_INT32(13404954, e.longitude_e6);
+
+    TEST_ASSERT_FALSE(gazetteer_get(&gz, (uint32_t)PLACE_COUNT, &e));
+}
+
+static void test_open_rejects_bad_images(void)
+{
+    gazetteer_t gz;
+
+    build_image();
+    TEST_ASSERT_FALSE(gazetteer_open(&gz, image, GAZETTEER_HEADER_LEN));
+    TEST_ASSERT_FALSE(gazetteer_open(&gz, image, image_len - 1U));
+    TEST_ASSERT_FALSE(gazetteer_open(&gz, NULL, image_len));
+
+    /* erased flash */
+    uint8_t erased[GAZETTEER_HEADER_LEN + (4U * GAZETTEER_BUCKETS)];
+    (void)memset(erased, 0xFF, sizeof(erased));
+    TEST_ASSERT_FALSE(gazetteer_open(&gz, erased, sizeof(erased)));
+
+    /* bucket table must be monotonic */
+    build_image();
+    put_u32(&image[GAZETTEER_HEADER_LEN + (4U * 'b')], 5U);
+    TEST_ASSERT_FALSE(gazetteer_open(&gz, image, image_len));
+
+    /* names section beyond the image */
+    build_image();
+    put_u32(&image[16], 0xFFFFFFFFU);
+    TEST_ASSERT_FALSE(gazetteer_open(&gz, image, image_len));
+}
+
+static void test_get_rejects_malformed_entry(void)
+{
+    gazetteer_t gz = open_image();
+    gazetteer_entry_t e;
+    uint8_t *first = &image[gz.entries_off];
+
+    /* name running past the names section */
+    put_u32(&first[8], gz.names_len - 2U);
+    TEST_ASSERT_FALSE(gazetteer_get(&gz, 0U, &e));
+
+    /* empty name */
+    put_u32(&first[8], 0U);
+    first[12] = 0U;
+    TEST_ASSERT_FALSE(gazetteer_get(&gz, 0U, &e));
+}
+
+/*
+    gazetteer_search / gazetteer_find
+*/
+
+static void test_search_prefix_case_insensitive(void)
+{
+    const gazetteer_t gz = open_image();
+    gazetteer_entry_t hits[4];
+
+    TEST_ASSERT_EQUAL_UINT(2U, gazetteer_search(&gz, "bEr", hits, 4U));
+    assert_name("Berlin", &hits[0]);
+    assert_name("Bern", &hits[1]);
+
+    TEST_ASSERT_EQUAL_UINT(3U, gazetteer_search(&gz, "B", hits, 4U));
+    assert_name("Bonn", &hits[2]);
+
+    TEST_ASSERT_EQUAL_UINT(2U, gazetteer_search(&gz, "frankfurt ", hits, 4U));
+    assert_name("Frankfurt (Oder)", &hits[0]);
+
+    TEST_ASSERT_EQUAL_UINT(1U, gazetteer_search(&gz, "ULM", hits, 4U));
+}
+
+static void test_search_utf8_prefix(void)
+{
+    const gazetteer_t gz = open_image();
+    gazetteer_entry_t hits[4];
+
+    /* umlauts are compared as bytes */
+    TEST_ASSERT_EQUAL_UINT(2U, gazetteer_search(&gz, "m\xc3\xbcn", hits, 4U));
+    assert_name("M\xc3\xbcnchen", &hits[0]);
+    assert_name("M\xc3\xbcnster", &hits[1]);
+
+    TEST_ASSERT_EQUAL_UINT(3U, gazetteer_search(&gz, "M", hits, 4U));
+}
+
+static void test_search_limits_and_misses(void)
+{
+    const gazetteer_t gz = open_image();
+    gazetteer_entry_t hits[4];
+
+    TEST_ASSERT_EQUAL_UINT(1U, gazetteer_search(&gz, "b", hits, 1U));
+    assert_name("Berlin", &hits[0]);
+
+    TEST_ASSERT_EQUAL_UINT(0U, gazetteer_search(&gz, "", hits, 4U));
+    TEST_ASSERT_EQUAL_UINT(0U, gazetteer_search(&gz, "Berlinx", hits, 4U));
+    TEST_ASSERT_EQUAL_UINT(0U, gazetteer_search(&gz, "Aachen", hits, 4U));
+    TEST_ASSERT_EQUAL_UINT(0U, gazetteer_search(&gz, "Zug", hits, 4U));
+    TEST_ASSERT_EQUAL_UINT(0U, gazetteer_search(&gz, NULL, hits, 4U));
+    TEST_ASSERT_EQUAL_UINT(0U, gazetteer_search(&gz, "B", hits, 0U));
+    TEST_ASSERT_EQUAL_UINT(0U, gazetteer_search(NULL, "B", hits, 4U));
+}
+
+static void test_find_exact_name(void)
+{
+    const gazetteer_t gz = open_image();
+    gazetteer_entry_t e;
+
+    TEST_ASSERT_TRUE(gazetteer_find(&gz, "bern", &e));
+    assert_name("Bern", &e);
+    TEST_ASSERT_EQUAL_INT32(46947974, e.latitude_e6);
+
+    TEST_ASSERT_TRUE(gazetteer_find(&gz, "Frankfurt am Main", &e));
+
+    /* prefixes of longer names are not exact matches */
+    TEST_ASSERT_FALSE(gazetteer_find(&gz, "Ber", &e));
+    TEST_ASSERT_FALSE(gazetteer_find(&gz, "Frankfurt", &e));
+    TEST_ASSERT_FALSE(gazetteer_find(&gz, "", &e));
+    TEST_ASSERT_FALSE(gazetteer_find(&gz, "Bern", NULL));
+}
+
+/*
+    test runners
+*/
+
+void run_test_storage_gazetteer_open(void)
+{
+    UnityPrint("=== storage/gazetteer : gazetteer_open() / gazetteer_get() ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UNITY_OUTPUT_CHAR('\n');
+
+    RUN_TEST(test_open_and_get);
+    RUN_TEST(test_open_rejects_bad_images);
+    RUN_TEST(test_get_rejects_malformed_entry);
+
+    UNITY_OUTPUT_CHAR('\n');
+}
+
+void run_test_storage_gazetteer_search(void)
+{
+    UnityPrint("=== storage/gazetteer : gazetteer_search() / gazetteer_find() ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UNITY_OUTPUT_CHAR('\n');
+
+    RUN_TEST(test_search_prefix_case_insensitive);
+    RUN_TEST(test_search_utf8_prefix);
+    RUN_TEST(test_search_limits_and_misses);
+    RUN_TEST(test_find_exact_name);
+
+    UNITY_OUTPUT_CHAR('\n');
+}
@@ -0,0 +1,121 @@
+#include <unity.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <cJSON.h>
+
+#include "test_api.h"
+
+#include "json_arena.h"
+
+static uint8_t s_buf[2048];
+static json_arena_t s_arena;
+
+static void *arena_malloc(size_t size)
+{
+    return json_arena_alloc(&s_arena, size);
+}
+
+static void arena_free(void *ptr)
+{
+    json_arena_free(&s_arena, ptr);
+}
+
+/*
+    json_arena
+*/
+
+static void test_alloc_is_aligned_and_bounded(void)
+{
+    json_arena_init(&s_arena, &s_buf[1], 64U);
+
+    uint8_t *a = json_arena_alloc(&s_arena, 3U);
+    uint8_t *b = json_arena_alloc(&s_arena, 8U);
+
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_EQUAL_UINT(0U, (uintptr_t)a % JSON_ARENA_ALIGN);
+    TEST_ASSERT_EQUAL_UINT(0U, (uintptr_t)b % JSON_ARENA_ALIGN);
+    TEST_ASSERT_TRUE(b >= (a + 3));
+    TEST_ASSERT_TRUE(json_arena_owns(&s_arena, a));
+    TEST_ASSERT_FALSE(json_arena_owns(&s_arena, &s_buf[512]));
+
+    TEST_ASSERT_NULL(json_arena_alloc(&s_arena, 64U));
+    TEST_ASSERT_EQUAL_UINT32(1U, s_arena.overflows);
+}
+
+static void test_free_rolls_back_only_the_last_allocation(void)
+{
+    json_arena_init(&s_arena, s_buf, sizeof(s_buf));
+
+    void *a = json_arena_alloc(&s_arena, 16U);
+    void *b = json_arena_alloc(&s_arena, 16U);
+    const size_t used = s_arena.used;
+
+    json_arena_free(&s_arena, a);
+    TEST_ASSERT_EQUAL_UINT(used, s_arena.used);
+
+    json_arena_free(&s_arena, b);
+    TEST_ASSERT_EQUAL_UINT(16U, s_arena.used);
+    TEST_ASSERT_EQUAL_PTR(b, json_arena_alloc(&s_arena, 8U));
+}
+
+static void test_reset_keeps_high_water(void)
+{
+    json_arena_init(&s_arena, s_buf, sizeof(s_buf));
+
+    (void)json_arena_alloc(&s_arena, 100U);
+    (void)json_arena_alloc(&s_arena, 20U);
+    const size_t peak = s_arena.used;
+
+    json_arena_reset(&s_arena);
+    TEST_ASSERT_EQUAL_UINT(0U, s_arena.used);
+    TEST_ASSERT_EQUAL_UINT(peak, s_arena.high_water);
+
+    (void)json_arena_alloc(&s_arena, 8U);
+    TEST_ASSERT_EQUAL_UINT(peak, s_arena.high_water);
+}
+
+static void test_cjson_parse_and_print_via_hooks(void)
+{
+    cJSON_Hooks hooks = {.malloc_fn = arena_malloc, .free_fn = arena_free};
+
+    json_arena_init(&s_arena, s_buf, sizeof(s_buf));
+    cJSON_InitHooks(&hooks);
+
+    cJSON *root = cJSON_Parse("{\"ops\":[{\"op\":\"add\",\"name\":\"Berlin\"},{\"op\":\"remove\",\"name\":\"Paris\"}]}");
+    TEST_ASSERT_NOT_NULL(root);
+    TEST_ASSERT_TRUE(json_arena_owns(&s_arena, root));
+
+    char *printed = cJSON_PrintUnformatted(root);
+    TEST_ASSERT_NOT_NULL(printed);
+    TEST_ASSERT_TRUE(json_arena_owns(&s_arena, printed));
+    TEST_ASSERT_EQUAL_STRING("{\"ops\":[{\"op\":\"add\",\"name\":\"Berlin\"},{\"op\":\"remove\",\"name\":\"Paris\"}]}", printed);
+
+    cJSON_free(printed);
+    cJSON_Delete(root);
+    cJSON_InitHooks(NULL);
+
+    TEST_ASSERT_TRUE(s_arena.high_water > 0U);
+    TEST_ASSERT_EQUAL_UINT32(0U, s_arena.overflows);
+    json_arena_reset(&s_arena);
+}
+
+/*
+    test runners
+*/
+
+void run_test_storage_json_arena(void)
+{
+    UnityPrint("=== storage/json_arena : alloc / free / reset ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UNITY_OUTPUT_CHAR('\n');
+
+    RUN_TEST(test_alloc_is_aligned_and_bounded);
+    RUN_TEST(test_free_rolls_back_only_the_last_allocation);
+    RUN_TEST(test_reset_keeps_high_water);
+    RUN_TEST(test_cjson_parse_and_print_via_hooks);
+
+    UNITY_OUTPUT_CHAR('\n');
+}
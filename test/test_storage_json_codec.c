@@ -0,0 +1,238 @@
+#include <unity.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "test_api.h"
+
+#include "json_codec.h"
+#include "locations_storage.h"
+#include "settings_storage.h"
+
+/*
+    reader
+*/
+
+static void test_read_str_decodes_escapes(void)
+{
+    json_reader_t r;
+    char out[32];
+
+    json_reader_init(&r, " \"a\\\"b\\\\\\/\\n\\u00e9\\ud83d\\ude00\" ");
+    TEST_ASSERT_TRUE(json_read_str(&r, out, sizeof(out)));
+    TEST_ASSERT_TRUE(json_read_end(&r));
+    TEST_ASSERT_EQUAL_STRING("a\"b\\/\n\xc3\xa9\xf0\x9f\x98\x80", out);
+}
+
+static void test_read_str_truncates_and_rejects_bad_input(void)
+{
+    json_reader_t r;
+    char out[4];
+
+    json_reader_init(&r, "\"abcdef\"");
+    TEST_ASSERT_TRUE(json_read_str(&r, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("abc", out);
+
+    json_reader_init(&r, "\"abc");
+    TEST_ASSERT_FALSE(json_read_str(&r, out, sizeof(out)));
+
+    json_reader_init(&r, "\"\\u0000\"");
+    TEST_ASSERT_FALSE(json_read_str(&r, out, sizeof(out)));
+
+    json_reader_init(&r, "\"\\ud83d\"");
+    TEST_ASSERT_FALSE(json_read_str(&r, out, sizeof(out)));
+
+    json_reader_init(&r, "\"\\x\"");
+    TEST_ASSERT_FALSE(json_read_str(&r, out, sizeof(out)));
+}
+
+static void test_read_number_grammar(void)
+{
+    const char *ok_cases[] = {"0", "-0", "12.5", "-1e3", "5.2E+1", "3.25e-2"};
+    const char *bad_cases[] = {"01", "-", "1.", ".5", "1e", "+1"};
+    json_reader_t r;
+    const char *text = NULL;
+    size_t len = 0U;
+
+    for (size_t i = 0U; i < (sizeof(ok_cases) / sizeof(ok_cases[0])); i++)
+    {
+        json_reader_init(&r, ok_cases[i]);
+        TEST_ASSERT_TRUE(json_read_number(&r, &text, &len));
+        TEST_ASSERT_EQUAL_UINT(strlen(ok_cases[i]), len);
+        TEST_ASSERT_TRUE(json_read_end(&r));
+    }
+
+    for (size_t i = 0U; i < (sizeof(bad_cases) / sizeof(bad_cases[0])); i++)
+    {
+        json_reader_init(&r, bad_cases[i]);
+        TEST_ASSERT_FALSE(json_read_number(&r, &text, &len) && json_read_end(&r));
+    }
+}
+
+static void test_skip_value_nested_and_depth_limit(void)
+{
+    json_reader_t r;
+    char deep[(2U * JSON_CODEC_MAX_DEPTH) + 3U];
+
+    json_reader_init(&r, "{\"a\":[1,{\"b\":null},\"x]\",true],\"c\":{}} ");
+    TEST_ASSERT_TRUE(json_skip_value(&r));
+    TEST_ASSERT_TRUE(json_read_end(&r));
+
+    for (size_t i = 0U; i <= JSON_CODEC_MAX_DEPTH; i++)
+    {
+        deep[i] = '[';
+        deep[(2U * JSON_CODEC_MAX_DEPTH) + 1U - i] = ']';
+    }
+    deep[(2U * JSON_CODEC_MAX_DEPTH) + 2U] = '\0';
+
+    json_reader_init(&r, deep);
+    TEST_ASSERT_FALSE(json_skip_value(&r));
+}
+
+static void test_read_members_rejects_trailing_comma(void)
+{
+    json_reader_t r;
+    char key[8];
+    bool first = true;
+
+    json_reader_init(&r, "{\"a\":1,}");
+    TEST_ASSERT_TRUE(json_read_object_begin(&r));
+    TEST_ASSERT_TRUE(json_read_member(&r, &first, key, sizeof(key)));
+    TEST_ASSERT_EQUAL_STRING("a", key);
+    TEST_ASSERT_TRUE(json_skip_value(&r));
+    TEST_ASSERT_FALSE(json_read_member(&r, &first, key, sizeof(key)));
+    TEST_ASSERT_FALSE(r.ok);
+}
+
+/*
+    writer
+*/
+
+static void test_writer_measure_matches_output(void)
+{
+    json_writer_t w;
+    char out[32];
+
+    json_writer_init(&w, NULL, 0U);
+    json_write_str(&w, "a\"\x01", 3U);
+    const size_t measured = json_writer_len(&w);
+
+    json_writer_init(&w, out, sizeof(out));
+    json_write_str(&w, "a\"\x01", 3U);
+    TEST_ASSERT_EQUAL_UINT(measured, json_writer_len(&w));
+    TEST_ASSERT_EQUAL_STRING("\"a\\\"\\u0001\"", out);
+
+    json_writer_init(&w, out, measured);
+    json_write_str(&w, "a\"\x01", 3U);
+    TEST_ASSERT_EQUAL_UINT(0U, json_writer_len(&w));
+}
+
+/*
+    schema codecs
+*/
+
+static void test_location_codec_skips_unknown_and_keeps_first_duplicate(void)
+{
+    locations_model_t model;
+    const char *json = "{\"version\":{\"x\":[1,2]},\"locations\":["
+                       "{\"name\":\"Berlin\",\"name\":\"Paris\",\"extra\":\"}\","
+                       "\"latitude\":5.252e1,\"longitude\":13.405}]}";
+
+    TEST_ASSERT_TRUE(locations_model_init(&model, 4U));
+    TEST_ASSERT_TRUE(locations_storage_from_json(json, &model));
+    TEST_ASSERT_EQUAL_UINT32(1U, model.count);
+    TEST_ASSERT_EQUAL_STRING("Berlin", locations_model_first(&model)->name);
+    TEST_ASSERT_EQUAL_INT32(52520000, locations_model_first(&model)->latitude_e6);
+    TEST_ASSERT_FALSE(locations_model_first(&model)->is_active);
+
+    /* missing required member, trailing garbage */
+    TEST_ASSERT_FALSE(locations_storage_from_json("{\"locations\":[{\"name\":\"A\",\"latitude\":1}]}", &model));
+    TEST_ASSERT_FALSE(locations_storage_from_json("{\"locations\":[]} x", &model));
+    TEST_ASSERT_EQUAL_UINT32(0U, model.count);
+
+    locations_model_deinit(&model);
+}
+
+static void test_location_codec_round_trip(void)
+{
+    locations_model_t a;
+    locations_model_t b;
+    location_t loc = {0};
+    char buf[256];
+
+    TEST_ASSERT_TRUE(locations_model_init(&a, 4U));
+    TEST_ASSERT_TRUE(locations_model_init(&b, 4U));
+
+    (void)snprintf(loc.name, sizeof(loc.name), "%s", "K\xc3\xb6ln \"Dom\"\t");
+    loc.latitude_e6 = 50941278;
+    loc.longitude_e6 = -6958281;
+    loc.is_active = true;
+    TEST_ASSERT_TRUE(locations_model_add(&a, &loc));
+
+    const size_t needed = locations_storage_measure_json(&a);
+    TEST_ASSERT_TRUE(needed <= sizeof(buf));
+    TEST_ASSERT_TRUE(locations_storage_to_json(&a, buf, needed));
+    TEST_ASSERT_EQUAL_UINT(needed - 1U, strlen(buf));
+    TEST_ASSERT_FALSE(locations_storage_to_json(&a, buf, needed - 1U));
+
+    TEST_ASSERT_TRUE(locations_storage_to_json(&a, buf, sizeof(buf)));
+    TEST_ASSERT_TRUE(locations_storage_from_json(buf, &b));
+    TEST_ASSERT_EQUAL_STRING(loc.name, locations_model_first(&b)->name);
+    TEST_ASSERT_EQUAL_INT32(loc.longitude_e6, locations_model_first(&b)->longitude_e6);
+    TEST_ASSERT_TRUE(locations_model_first(&b)->is_active);
+
+    locations_model_deinit(&a);
+    locations_model_deinit(&b);
+}
+
+static void test_wifi_codec_exact_output(void)
+{
+    settings_wifi_t s;
+    char buf[96];
+
+    (void)memset(&s, 0, sizeof(s));
+    (void)snprintf(s.ssid, sizeof(s.ssid), "%s", "My\"Net");
+    (void)snprintf(s.pass, sizeof(s.pass), "%s", "secret");
+    s.priority = 3U;
+
+    TEST_ASSERT_TRUE(settings_storage_wifi_to_json(&s, true, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("{\"ssid\":\"My\\\"Net\",\"pass\":\"secret\",\"priority\":3}", buf);
+    TEST_ASSERT_EQUAL_UINT(strlen(buf) + 1U, settings_storage_wifi_measure_json(&s, true));
+
+    TEST_ASSERT_TRUE(settings_storage_wifi_to_json(&s, false, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("{\"ssid\":\"My\\\"Net\",\"pass_len\":6,\"priority\":3}", buf);
+    TEST_ASSERT_EQUAL_UINT(strlen(buf) + 1U, settings_storage_wifi_measure_json(&s, false));
+}
+
+/*
+    test runners
+*/
+
+void run_test_storage_json_codec_reader(void)
+{
+    UnityPrint("=== storage/json_codec : reader ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UNITY_OUTPUT_CHAR('\n');
+
+    RUN_TEST(test_read_str_decodes_escapes);
+    RUN_TEST(test_read_str_truncates_and_rejects_bad_input);
+    RUN_TEST(test_read_number_grammar);
+    RUN_TEST(test_skip_value_nested_and_depth_limit);
+    RUN_TEST(test_read_members_rejects_trailing_comma);
+
+    UNITY_OUTPUT_CHAR('\n');
+}
+
+void run_test_storage_json_codec_schemas(void)
+{
+    UnityPrint("=== storage/json_codec : writer / schema codecs ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UNITY_OUTPUT_CHAR('\n');
+
+    RUN_TEST(test_writer_measure_matches_output);
+    RUN_TEST(test_location_codec_skips_unknown_and_keeps_first_duplicate);
+    RUN_TEST(test_location_codec_round_trip);
+    RUN_TEST(test_wifi_codec_exact_output);
+
+    UNITY_OUTPUT_CHAR('\n');
+}
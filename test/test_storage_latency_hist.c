@@ -0,0 +1,63 @@
+#include <unity.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "test_api.h"
+
+#include "latency_hist.h"
+
+/*
+    latency_hist
+*/
+
+static void test_buckets(void)
+{
+    latency_hist_t h;
+    (void)memset(&h, 0, sizeof(h));
+
+    TEST_ASSERT_EQUAL_UINT32(8U, latency_hist_bound(0U));
+    TEST_ASSERT_EQUAL_UINT32(32U, latency_hist_bound(1U));
+    TEST_ASSERT_EQUAL_UINT32(32768U, latency_hist_bound(LATENCY_HIST_BUCKETS - 2U));
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, latency_hist_bound(LATENCY_HIST_BUCKETS - 1U));
+
+    latency_hist_add(&h, 0U);
+    latency_hist_add(&h, 7U);
+    latency_hist_add(&h, 8U);
+    latency_hist_add(&h, 100000U);
+    latency_hist_add(&h, UINT32_MAX);
+
+    TEST_ASSERT_EQUAL_UINT32(2U, h.count[0]);
+    TEST_ASSERT_EQUAL_UINT32(1U, h.count[1]);
+    TEST_ASSERT_EQUAL_UINT32(2U, h.count[LATENCY_HIST_BUCKETS - 1U]);
+    TEST_ASSERT_EQUAL_UINT32(5U, h.samples);
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, h.max_us);
+}
+
+static void test_mean_and_percentiles(void)
+{
+    latency_hist_t h;
+    (void)memset(&h, 0, sizeof(h));
+
+    TEST_ASSERT_EQUAL_UINT32(0U, latency_hist_mean(&h));
+    TEST_ASSERT_EQUAL_UINT32(0U, latency_hist_percentile(&h, 50U));
+
+    for (uint32_t i = 0U; i < 98U; i++)
+    {
+        latency_hist_add(&h, 20U); /* 8..32 */
+    }
+    latency_hist_add(&h, 1000U); /* 512..2048 */
+    latency_hist_add(&h, 1500U);
+
+    TEST_ASSERT_EQUAL_UINT32((98U * 20U + 2500U) / 100U, latency_hist_mean(&h));
+    TEST_ASSERT_EQUAL_UINT32(32U, latency_hist_percentile(&h, 50U));
+    TEST_ASSERT_EQUAL_UINT32(32U, latency_hist_percentile(&h, 98U));
+    /* the slowest bucket reports the real maximum, not its bound */
+    TEST_ASSERT_EQUAL_UINT32(1500U, latency_hist_percentile(&h, 99U));
+    TEST_ASSERT_EQUAL_UINT32(1500U, latency_hist_percentile(&h, 100U));
+}
+
+void run_test_storage_latency_hist(void)
+{
+    RUN_TEST(test_buckets);
+    RUN_TEST(test_mean_and_percentiles);
+}
@@ -0,0 +1,178 @@
+#include <unity.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include "test_api.h"
+
+#include "locations_records.h"
+
+/*
+    helpers
+*/
+
+static location_t make_loc(const char *name, int32_t lat_e6, int32_t lon_e6)
+{
+    location_t loc;
+    (void)memset(&loc, 0, sizeof(loc));
+
+    (void)snprintf(loc.name, sizeof(loc.name), "%s", name);
+    loc.latitude_e6 = lat_e6;
+    loc.longitude_e6 = lon_e6;
+
+    return loc;
+}
+
+/*
+    locations_record_encode / locations_record_decode
+*/
+
+static void test_record_round_trip(void)
+{
+    const location_t in = make_loc("Sydney", -33868820, 151209296);
+    uint8_t buf[LOCATIONS_RECORD_MAX_LEN];
+    location_t out;
+
+    const size_t len = locations_record_encode(&in, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_UINT32(LOCATIONS_RECORD_HEADER_LEN + 6U, (uint32_t)len);
+
+    TEST_ASSERT_TRUE(locations_record_decode(buf, len, &out));
+    TEST_ASSERT_EQUAL_STRING("Sydney", out.name);
+    TEST_ASSERT_EQUAL_INT32(-33868820, out.latitude_e6);
+    TEST_ASSERT_EQUAL_INT32(151209296, out.longitude_e6);
+    TEST_ASSERT_FALSE(out.is_active);
+}
+
+static void test_record_layout_is_little_endian(void)
+{
+    const location_t in = make_loc("A", 0x01020304, -1);
+    uint8_t buf[LOCATIONS_RECORD_MAX_LEN];
+    const uint8_t expected[] = {0x04, 0x03, 0x02, 0x01, 0xFF, 0xFF, 0xFF, 0xFF, 'A'};
+
+    TEST_ASSERT_EQUAL_UINT32(sizeof(expected), (uint32_t)locations_record_encode(&in, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_MEMORY(expected, buf, sizeof(expected));
+}
+
+static void test_record_max_name_round_trip(void)
+{
+    location_t in = make_loc("", 1, 2);
+    uint8_t buf[LOCATIONS_RECORD_MAX_LEN];
+    location_t out;
+
+    (void)memset(in.name, 'x', sizeof(in.name) - 1U);
+
+    const size_t len = locations_record_encode(&in, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_UINT32(LOCATIONS_RECORD_MAX_LEN, (uint32_t)len);
+    TEST_ASSERT_TRUE(locations_record_decode(buf, len, &out));
+    TEST_ASSERT_EQUAL_STRING(in.name, out.name);
+}
+
+static void test_record_invalid_fails(void)
+{
+    const location_t empty = make_loc("", 1, 2);
+    const location_t berlin = make_loc("Berlin", 1, 2);
+    uint8_t buf[LOCATIONS_RECORD_MAX_LEN + 1U];
+    location_t out;
+
+    TEST_ASSERT_EQUAL_UINT32(0U, (uint32_t)locations_record_encode(&empty, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_UINT32(0U, (uint32_t)locations_record_encode(&berlin, buf, LOCATIONS_RECORD_HEADER_LEN + 5U));
+
+    const size_t len = locations_record_encode(&berlin, buf, sizeof(buf));
+
+    /* header only, too long, embedded NUL */
+    TEST_ASSERT_FALSE(locations_record_decode(buf, LOCATIONS_RECORD_HEADER_LEN, &out));
+    TEST_ASSERT_FALSE(locations_record_decode(buf, LOCATIONS_RECORD_MAX_LEN + 1U, &out));
+    buf[LOCATIONS_RECORD_HEADER_LEN + 2U] = 0U;
+    TEST_ASSERT_FALSE(locations_record_decode(buf, len, &out));
+}
+
+/*
+    locations_index_encode / locations_index_decode
+*/
+
+static void test_index_round_trip(void)
+{
+    const uint16_t ids[] = {3U, 0U, 7U};
+    uint8_t buf[32];
+    uint16_t out_ids[4];
+    size_t count = 0U;
+    uint16_t active = 0U;
+
+    const size_t len = locations_index_encode(ids, 3U, 7U, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)locations_index_measure(3U), (uint32_t)len);
+
+    TEST_ASSERT_TRUE(locations_index_decode(buf, len, out_ids, 4U, &count, &active));
+    TEST_ASSERT_EQUAL_UINT32(3U, (uint32_t)count);
+    TEST_ASSERT_EQUAL_UINT16(7U, active);
+    TEST_ASSERT_EQUAL_UINT16(3U, out_ids[0]);
+    TEST_ASSERT_EQUAL_UINT16(0U, out_ids[1]);
+    TEST_ASSERT_EQUAL_UINT16(7U, out_ids[2]);
+}
+
+static void test_index_empty_round_trip(void)
+{
+    uint8_t buf[LOCATIONS_INDEX_HEADER_LEN];
+    size_t count = 1U;
+    uint16_t active = 0U;
+
+    const size_t len = locations_index_encode(NULL, 0U, LOCATIONS_INDEX_NO_ID, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_UINT32(LOCATIONS_INDEX_HEADER_LEN, (uint32_t)len);
+
+    TEST_ASSERT_TRUE(locations_index_decode(buf, len, NULL, 0U, &count, &active));
+    TEST_ASSERT_EQUAL_UINT32(0U, (uint32_t)count);
+    TEST_ASSERT_EQUAL_UINT16(LOCATIONS_INDEX_NO_ID, active);
+}
+
+static void test_index_invalid_fails(void)
+{
+    const uint16_t ids[] = {1U, 2U};
+    uint8_t buf[32];
+    uint16_t out_ids[2];
+    size_t count = 0U;
+    uint16_t active = 0U;
+
+    TEST_ASSERT_EQUAL_UINT32(0U, (uint32_t)locations_index_encode(ids, 2U, 1U, buf, 9U));
+
+    size_t len = locations_index_encode(ids, 2U, 1U, buf, sizeof(buf));
+
+    /* too many ids for the caller, truncated, wrong version */
+    TEST_ASSERT_FALSE(locations_index_decode(buf, len, out_ids, 1U, &count, &active));
+    TEST_ASSERT_FALSE(locations_index_decode(buf, len - 1U, out_ids, 2U, &count, &active));
+    buf[0] = 0U;
+    TEST_ASSERT_FALSE(locations_index_decode(buf, len, out_ids, 2U, &count, &active));
+
+    /* active id not listed */
+    len = locations_index_encode(ids, 2U, 5U, buf, sizeof(buf));
+    TEST_ASSERT_FALSE(locations_index_decode(buf, len, out_ids, 2U, &count, &active));
+}
+
+/*
+    test runners
+*/
+
+void run_test_storage_locations_records_record(void)
+{
+    UnityPrint("=== storage/locations_records : locations_record_encode / decode ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UNITY_OUTPUT_CHAR('\n');
+
+    RUN_TEST(test_record_round_trip);
+    RUN_TEST(test_record_layout_is_little_endian);
+    RUN_TEST(test_record_max_name_round_trip);
+    RUN_TEST(test_record_invalid_fails);
+
+    UNITY_OUTPUT_CHAR('\n');
+}
+
+void run_test_storage_locations_records_index(void)
+{
+    UnityPrint("=== storage/locations_records : locations_index_encode / decode ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UNITY_OUTPUT_CHAR('\n');
+
+    RUN_TEST(test_index_round_trip);
+    RUN_TEST(test_index_empty_round_trip);
+    RUN_TEST(test_index_invalid_fails);
+
+    UNITY_OUTPUT_CHAR('\n');
+}
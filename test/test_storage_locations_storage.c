@@ -13,30 +13,55 @@
     helpers
 */
 
+#define TEST_MODEL_CAPACITY 8U
+
 static void reset_model(locations_model_t *m)
 {
     TEST_ASSERT_NOT_NULL(m);
-    (void)memset(m, 0, sizeof(*m));
+    TEST_ASSERT_TRUE(locations_model_init(m, TEST_MODEL_CAPACITY));
+}
+
+/* n-th location in iteration order */
+static const location_t *loc_at(const locations_model_t *m, size_t pos)
+{
+    const location_t *loc = locations_model_first(m);
+
+    while ((loc != NULL) && (pos > 0U))
+    {
+        loc = locations_model_next(m, loc);
+        pos--;
+    }
+
+    return loc;
 }
 
 static size_t count_active(const locations_model_t *m)
 {
     size_t active = 0U;
 
-    if (m != NULL)
+    for (const location_t *loc = locations_model_first(m); loc != NULL; loc = locations_model_next(m, loc))
     {
-        for (size_t i = 0U; i < m->count; i++)
+        if (loc->is_active)
         {
-            if (m->items[i].is_active)
-            {
-                active++;
-            }
+            active++;
         }
     }
 
     return active;
 }
 
+static void add_berlin(locations_model_t *m)
+{
+    location_t loc = {0};
+
+    (void)snprintf(loc.name, sizeof(loc.name), "%s", "Berlin");
+    loc.latitude_e6 = 52520000;
+    loc.longitude_e6 = 13405000;
+    loc.is_active = false;
+
+    TEST_ASSERT_TRUE(locations_model_add(m, &loc));
+}
+
 /*
     locations_storage_from_json
 */
@@ -56,9 +81,13 @@ static void test_from_json_success(void)
 
     TEST_ASSERT_TRUE(locations_storage_from_json(json, &model));
     TEST_ASSERT_EQUAL_UINT32(2U, model.count);
-    TEST_ASSERT_EQUAL_STRING("Berlin", model.items[0].name);
-    TEST_ASSERT_EQUAL_STRING("Munich", model.items[1].name);
-    TEST_ASSERT_TRUE(model.items[1].is_active);
+    TEST_ASSERT_EQUAL_STRING("Berlin", loc_at(&model, 0U)->name);
+    TEST_ASSERT_EQUAL_STRING("Munich", loc_at(&model, 1U)->name);
+    TEST_ASSERT_TRUE(loc_at(&model, 1U)->is_active);
+    TEST_ASSERT_EQUAL_INT32(52520000, loc_at(&model, 0U)->latitude_e6);
+    TEST_ASSERT_EQUAL_INT32(11575000, loc_at(&model, 1U)->longitude_e6);
+
+    locations_model_deinit(&model);
 }
 
 static void test_from_json_invalid_json_fails(void)
@@ -69,6 +98,8 @@ static void test_from_json_invalid_json_fails(void)
     reset_model(&model);
 
     TEST_ASSERT_FALSE(locations_storage_from_json(json, &model));
+
+    locations_model_deinit(&model);
 }
 
 static void test_from_json_missing_locations_array_fails(void)
@@ -79,6 +110,8 @@ static void test_from_json_missing_locations_array_fails(void)
     reset_model(&model);
 
     TEST_ASSERT_FALSE(locations_storage_from_json(json, &model));
+
+    locations_model_deinit(&model);
 }
 
 static void test_from_json_multiple_active_keeps_first_only(void)
@@ -99,25 +132,27 @@ static void test_from_json_multiple_active_keeps_first_only(void)
     TEST_ASSERT_EQUAL_UINT32(3U, model.count);
 
     TEST_ASSERT_EQUAL_UINT32(1U, (uint32_t)count_active(&model));
-    TEST_ASSERT_TRUE(model.items[0].is_active);
-    TEST_ASSERT_FALSE(model.items[1].is_active);
-    TEST_ASSERT_FALSE(model.items[2].is_active);
+    TEST_ASSERT_TRUE(loc_at(&model, 0U)->is_active);
+    TEST_ASSERT_FALSE(loc_at(&model, 1U)->is_active);
+    TEST_ASSERT_FALSE(loc_at(&model, 2U)->is_active);
+
+    locations_model_deinit(&model);
 }
 
 static void test_from_json_too_many_entries_fails(void)
 {
-    /* build JSON with LOCATIONS_MODEL_MAX_NUMBER + 1 entries */
+    /* build JSON with TEST_MODEL_CAPACITY + 1 entries */
     char json[4096];
     size_t pos = 0U;
 
     pos += (size_t)snprintf(&json[pos], sizeof(json) - pos, "{\"locations\":[");
-    for (size_t i = 0U; i < ((size_t)LOCATIONS_MODEL_MAX_NUMBER + 1U); i++)
+    for (size_t i = 0U; i < ((size_t)TEST_MODEL_CAPACITY + 1U); i++)
     {
         pos += (size_t)snprintf(
             &json[pos], sizeof(json) - pos,
             "{\"name\":\"L%u\",\"latitude\":1.0,\"longitude\":2.0,\"is_active\":false}%s",
             (unsigned)i,
-            (i == ((size_t)LOCATIONS_MODEL_MAX_NUMBER)) ? "" : ",");
+            (i == ((size_t)TEST_MODEL_CAPACITY)) ? "" : ",");
         if (pos >= sizeof(json))
         {
             TEST_FAIL_MESSAGE("Test JSON buffer too small");
@@ -130,6 +165,65 @@ static void test_from_json_too_many_entries_fails(void)
     reset_model(&model);
 
     TEST_ASSERT_FALSE(locations_storage_from_json(json, &model));
+    TEST_ASSERT_EQUAL_UINT32(0U, (uint32_t)model.count);
+
+    locations_model_deinit(&model);
+}
+
+static void test_from_json_duplicate_names_fails(void)
+{
+    const char *json =
+        "{"
+        "  \"locations\": ["
+        "    {\"name\":\"A\",\"latitude\":1.0,\"longitude\":2.0},"
+        "    {\"name\":\"A\",\"latitude\":3.0,\"longitude\":4.0}"
+        "  ]"
+        "}";
+
+    locations_model_t model;
+    reset_model(&model);
+
+    TEST_ASSERT_FALSE(locations_storage_from_json(json, &model));
+    TEST_ASSERT_EQUAL_UINT32(0U, (uint32_t)model.count);
+
+    locations_model_deinit(&model);
+}
+
+static void test_from_json_coordinates_out_of_range_fails(void)
+{
+    const char *json =
+        "{"
+        "  \"locations\": ["
+        "    {\"name\":\"A\",\"latitude\":91.0,\"longitude\":2.0}"
+        "  ]"
+        "}";
+
+    locations_model_t model;
+    reset_model(&model);
+
+    TEST_ASSERT_FALSE(locations_storage_from_json(json, &model));
+    TEST_ASSERT_EQUAL_UINT32(0U, (uint32_t)model.count);
+
+    locations_model_deinit(&model);
+}
+
+static void test_from_json_rounds_to_microdegrees(void)
+{
+    const char *json =
+        "{"
+        "  \"locations\": ["
+        "    {\"name\":\"A\",\"latitude\":-33.8688197,\"longitude\":151.2092955}"
+        "  ]"
+        "}";
+
+    locations_model_t model;
+    reset_model(&model);
+
+    TEST_ASSERT_TRUE(locations_storage_from_json(json, &model));
+    TEST_ASSERT_EQUAL_INT32(-33868820, loc_at(&model, 0U)->latitude_e6);
+    TEST_ASSERT_EQUAL_INT32(151209296, loc_at(&model, 0U)->longitude_e6);
+
+    locations_model_deinit(&model);
 }
 
 /*
@@ -143,11 +237,7 @@ static void test_measure_and_to_json_success(void)
     reset_model(&model);
 
     /* minimal model with 1 item */
-    (void)snprintf(model.items[0].name, sizeof(model.items[0].name), "%s", "Berlin");
-    model.items[0].latitude = 52.52;
-    model.items[0].longitude = 13.405;
-    model.items[0].is_active = false;
-    model.count = 1U;
+    add_berlin(&model);
 
     const size_t needed = locations_storage_measure_json(&model);
     TEST_ASSERT_TRUE(needed > 0U);
@@ -158,8 +248,12 @@ static void test_measure_and_to_json_success(void)
     TEST_ASSERT_TRUE(locations_storage_to_json(&model, buf, needed));
     TEST_ASSERT_TRUE(strstr(buf, "\"locations\"") != NULL);
     TEST_ASSERT_TRUE(strstr(buf, "Berlin") != NULL);
+    /* exact decimal text, no binary float artefacts */
+    TEST_ASSERT_TRUE(strstr(buf, "\"latitude\":52.52,") != NULL);
+    TEST_ASSERT_TRUE(strstr(buf, "\"longitude\":13.405,") != NULL);
 
     free(buf);
+    locations_model_deinit(&model);
 }
 
 static void test_to_json_buffer_too_small_fails(void)
@@ -167,14 +261,85 @@ static void test_to_json_buffer_too_small_fails(void)
     locations_model_t model;
     reset_model(&model);
 
-    (void)snprintf(model.items[0].name, sizeof(model.items[0].name), "%s", "Berlin");
-    model.items[0].latitude = 52.52;
-    model.items[0].longitude = 13.405;
-    model.items[0].is_active = false;
-    model.count = 1U;
+    add_berlin(&model);
 
     char out[8];
     TEST_ASSERT_FALSE(locations_storage_to_json(&model, out, sizeof(out)));
+
+    locations_model_deinit(&model);
+}
+
+/*
+    locations_storage_item_to_json
+    locations_storage_name_to_json
+*/
+
+static void test_item_to_json_matches_to_json(void)
+{
+    locations_model_t model;
+    reset_model(&model);
+
+    add_berlin(&model);
+    TEST_ASSERT_TRUE(locations_model_set_active(&model, "Berlin"));
+
+    const size_t needed = locations_storage_measure_json(&model);
+    char *whole = (char *)malloc(needed);
+    TEST_ASSERT_NOT_NULL(whole);
+    TEST_ASSERT_TRUE(locations_storage_to_json(&model, whole, needed));
+
+    char item[LOCATIONS_STORAGE_ITEM_JSON_MAX];
+    const size_t len = locations_storage_item_to_json(locations_model_first(&model), item, sizeof(item));
+
+    TEST_ASSERT_EQUAL_STRING("{\"name\":\"Berlin\",\"latitude\":52.52,\"longitude\":13.405,\"is_active\":true}", item);
+    TEST_ASSERT_EQUAL_UINT(strlen(item), len);
+    /* identical to the element cJSON writes */
+    TEST_ASSERT_TRUE(strstr(whole, item) != NULL);
+
+    free(whole);
+    locations_model_deinit(&model);
+}
+
+static void test_name_to_json_escapes(void)
+{
+    char out[LOCATIONS_STORAGE_NAME_JSON_MAX];
+
+    TEST_ASSERT_EQUAL_UINT(17U, locations_storage_name_to_json("a\"b\\c\n\x01", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("\"a\\\"b\\\\c\\n\\u0001\"", out);
+
+    /* UTF-8 passes through unchanged */
+    TEST_ASSERT_EQUAL_UINT(7U, locations_storage_name_to_json("K\xc3\xb6ln", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("\"K\xc3\xb6ln\"", out);
+}
+
+static void test_item_to_json_worst_case_fits_max(void)
+{
+    location_t loc;
+    (void)memset(&loc, 0x01, sizeof(loc.name));
+    loc.name[sizeof(loc.name) - 1U] = '\0';
+    loc.latitude_e6 = -89999999;
+    loc.longitude_e6 = -179999999;
+    loc.is_active = false;
+
+    char out[LOCATIONS_STORAGE_ITEM_JSON_MAX];
+    const size_t len = locations_storage_item_to_json(&loc, out, sizeof(out));
+
+    /* 31 x \u0001 plus the longest valid coordinates */
+    TEST_ASSERT_EQUAL_UINT(9U + 186U + 1U + 11U + 10U + 12U + 13U + 13U + 6U, len);
+    TEST_ASSERT_TRUE(len < sizeof(out));
+    /* no room for the NUL -> nothing written */
+    TEST_ASSERT_EQUAL_UINT(0U, locations_storage_item_to_json(&loc, out, len));
+}
+
+static void test_item_to_json_invalid_args(void)
+{
+    location_t loc = {0};
+    char out[8];
+
+    (void)snprintf(loc.name, sizeof(loc.name), "Berlin");
+    TEST_ASSERT_EQUAL_UINT(0U, locations_storage_item_to_json(NULL, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_UINT(0U, locations_storage_item_to_json(&loc, NULL, 0U));
+    TEST_ASSERT_EQUAL_UINT(0U, locations_storage_item_to_json(&loc, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_UINT(0U, locations_storage_name_to_json("Berlin", out, 8U));
 }
 
 /*
@@ -192,6 +357,9 @@ void run_test_storage_locations_storage_from_json(void)
     RUN_TEST(test_from_json_missing_locations_array_fails);
     RUN_TEST(test_from_json_multiple_active_keeps_first_only);
     RUN_TEST(test_from_json_too_many_entries_fails);
+    RUN_TEST(test_from_json_duplicate_names_fails);
+    RUN_TEST(test_from_json_coordinates_out_of_range_fails);
+    RUN_TEST(test_from_json_rounds_to_microdegrees);
 
     UNITY_OUTPUT_CHAR('\n');
 }
@@ -207,5 +375,19 @@ void run_test_storage_locations_storage_to_json_and_measure_json(void)
     RUN_TEST(test_measure_and_to_json_success);
     RUN_TEST(test_to_json_buffer_too_small_fails);
 
+    UNITY_OUTPUT_CHAR('\n');
+}
+
+void run_test_storage_locations_storage_item_to_json(void)
+{
+    UnityPrint("=== storage/locations_storage : locations_storage_item_to_json ===");
+    UNITY_OUTPUT_CHAR('\n');
+    UNITY_OUTPUT_CHAR('\n');
+
+    RUN_TEST(test_item_to_json_matches_to_json);
+    RUN_TEST(test_name_to_json_escapes);
+    RUN_TEST(test_item_to_json_worst_case_fits_max);
+    RUN_TEST(test_item_to_json_invalid_args);
+
     UNITY_OUTPUT_CHAR('\n');
 }
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include <unity.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "test_api.h"
+
+#include "lzss.h"
+
+/*
+    helpers
+*/
+
+static const char JSON_SAMPLE[] =
+    "{\"locations\":[{\"name\":\"Berlin\",\"latitude\":52.520008,\"longitude\":13.404954,\"is_active\":true},"
+    "{\"name\":\"Hamburg\",\"latitude\":53.551086,\"longitude\":9.993682,\"is_active\":false},"
+    "{\"name\":\"Munich\",\"latitude\":48.137154,\"longitude\":11.576124,\"is_active\":false},"
+    "{\"name\":\"Cologne\",\"latitude\":50.937531,\"longitude\":6.960279,\"is_active\":false}]}";
+
+static uint8_t s_packed[1024];
+static uint8_t s_plain[1024];
+
+static void round_trip(const void *in, size_t len)
+{
+    const size_t stream = lzss_compress(in, len, s_packed, sizeof(s_packed));
+
+    TEST_ASSERT_TRUE((stream > 0U) || (len == 0U));
+    TEST_ASSERT_TRUE(stream <= lzss_bound(len));
+    TEST_ASSERT_TRUE(lzss_decompress(s_packed, stream, s_plain, len));
+    TEST_ASSERT_EQUAL_MEMORY(in, s_plain, len);
+}
+
+/*
+    lzss
+*/
+
+static void test_round_trips(void)
+{
+    uint8_t noise[300];
+    uint32_t x = 12345U;
+
+    for (size_t i = 0U; i < sizeof(noise); i++)
+    {
+        x = (x * 1103515245U) + 12345U;
+        noise[i] = (uint8_t)(x >> 16U);
+    }
+
+    round_trip("", 0U);
+    round_trip("a", 1U);
+    round_trip("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", 52U);
+    round_trip(JSON_SAMPLE, sizeof(JSON_SAMPLE));
+    round_trip(noise, sizeof(noise));
+}
+
+static void test_json_compresses(void)
+{
+    const size_t packed = lzss_pack(JSON_SAMPLE, sizeof(JSON_SAMPLE), LZSS_FLAG_STR, s_packed, sizeof(s_packed));
+
+    TEST_ASSERT_TRUE(packed > 0U);
+    TEST_ASSERT_TRUE((packed * 10U) < (sizeof(JSON_SAMPLE) * 8U)); /* better than 80 % */
+
+    size_t len = 0U;
+    uint8_t flags = 0U;
+    TEST_ASSERT_TRUE(lzss_unpack_info(s_packed, packed, &len, &flags));
+    TEST_ASSERT_EQUAL_UINT(sizeof(JSON_SAMPLE), len);
+    TEST_ASSERT_EQUAL_UINT8(LZSS_FLAG_STR, flags);
+
+    TEST_ASSERT_TRUE(lzss_unpack(s_packed, packed, s_plain, len));
+    TEST_ASSERT_EQUAL_STRING(JSON_SAMPLE, (const char *)s_plain);
+    TEST_ASSERT_FALSE(lzss_unpack(s_packed, packed, s_plain, len - 1U));
+}
+
+static void test_pack_refuses_without_gain(void)
+{
+    uint8_t noise[64];
+
+    for (size_t i = 0U; i < sizeof(noise); i++)
+    {
+        noise[i] = (uint8_t)((i * 151U) ^ 0x5AU);
+    }
+
+    TEST_ASSERT_EQUAL_UINT(0U, lzss_pack(noise, sizeof(noise), 0U, s_packed, sizeof(s_packed)));
+    TEST_ASSERT_EQUAL_UINT(0U, lzss_pack("abc", 3U, 0U, s_packed, sizeof(s_packed)));
+    TEST_ASSERT_EQUAL_UINT(0U, lzss_pack(JSON_SAMPLE, sizeof(JSON_SAMPLE), 0U, s_packed, 16U));
+}
+
+static void test_store_keeps_the_value_as_is(void)
+{
+    const size_t stored = lzss_store("abc", 4U, LZSS_FLAG_STR, s_packed, sizeof(s_packed));
+
+    TEST_ASSERT_EQUAL_UINT(LZSS_HEADER_LEN + 4U, stored);
+
+    size_t len = 0U;
+    uint8_t flags = 0U;
+    TEST_ASSERT_TRUE(lzss_unpack_info(s_packed, stored, &len, &flags));
+    TEST_ASSERT_EQUAL_UINT(4U, len);
+    TEST_ASSERT_EQUAL_UINT8(LZSS_FLAG_STR | LZSS_FLAG_STORED, flags);
+
+    TEST_ASSERT_TRUE(lzss_unpack(s_packed, stored, s_plain, len));
+    TEST_ASSERT_EQUAL_STRING("abc", (const char *)s_plain);
+    TEST_ASSERT_FALSE(lzss_unpack(s_packed, stored - 1U, s_plain, len));
+    TEST_ASSERT_FALSE(lzss_unpack(s_packed, stored, s_plain, len - 1U));
+
+    TEST_ASSERT_EQUAL_UINT(0U, lzss_store("abc", 4U, 0U, s_packed, LZSS_HEADER_LEN + 3U));
+}
+
+static void test_plain_values_are_not_containers(void)
+{
+    TEST_ASSERT_FALSE(lzss_unpack_info((const uint8_t *)"{\"a\":1}", 8U, NULL, NULL));
+    TEST_ASSERT_FALSE(lzss_unpack_info((const uint8_t *)"LZ", 2U, NULL, NULL));
+
+    const uint8_t other_version[] = {'L', 'Z', 9U, 0U, 4U, 0U, 0xFFU};
+    TEST_ASSERT_FALSE(lzss_unpack_info(other_version, sizeof(other_version), NULL, NULL));
+}
+
+static void test_corrupt_streams_fail(void)
+{
+    const size_t stream = lzss_compress(JSON_SAMPLE, sizeof(JSON_SAMPLE), s_packed, sizeof(s_packed));
+
+    /* truncated, trailing garbage, wrong expected length */
+    TEST_ASSERT_FALSE(lzss_decompress(s_packed, stream - 1U, s_plain, sizeof(JSON_SAMPLE)));
+    TEST_ASSERT_FALSE(lzss_decompress(s_packed, stream + 1U, s_plain, sizeof(JSON_SAMPLE)));
+    TEST_ASSERT_FALSE(lzss_decompress(s_packed, stream, s_plain, sizeof(JSON_SAMPLE) + 8U));
+
+    /* back reference before the start: '0' + distance 1 with nothing written yet */
+    const uint8_t bad[] = {0x00U, 0x00U};
+    TEST_ASSERT_FALSE(lzss_decompress(bad, sizeof(bad), s_plain, 4U));
+
+    /* compressor output that does not fit */
+    TEST_ASSERT_EQUAL_UINT(0U, lzss_compress(JSON_SAMPLE, sizeof(JSON_SAMPLE), s_packed, 8U));
+}
+
+void run_test_storage_lzss(void)
+{
+    RUN_TEST(test_round_trips);
+    RUN_TEST(test_json_compresses);
+    RUN_TEST(test_pack_refuses_without_gain);
+    RUN_TEST(test_store_keeps_the_value_as_is);
+    RUN_TEST(test_plain_values_are_not_containers);
+    RUN_TEST(test_corrupt_streams_fail);
+}
@@ -66,6 +66,30 @@ static void test_wifi_from_json_invalid_json_fails(void)
     TEST_ASSERT_FALSE(settings_storage_wifi_from_json(json, &out));
 }
 
+static void test_wifi_from_json_priority(void)
+{
+    settings_wifi_t out;
+
+    TEST_ASSERT_TRUE(settings_storage_wifi_from_json("{\"ssid\":\"a\",\"priority\":255}", &out));
+    TEST_ASSERT_EQUAL_UINT8(255U, out.priority);
+    TEST_ASSERT_TRUE(settings_storage_wifi_from_json("{\"ssid\":\"a\",\"priority\":0}", &out));
+    TEST_ASSERT_EQUAL_UINT8(0U, out.priority);
+    TEST_ASSERT_TRUE(settings_storage_wifi_from_json("{\"ssid\":\"a\"}", &out));
+    TEST_ASSERT_EQUAL_UINT8(0U, out.priority);
+}
+
+static void test_wifi_from_json_invalid_priority_fails(void)
+{
+    settings_wifi_t out;
+
+    TEST_ASSERT_FALSE(settings_storage_wifi_from_json("{\"ssid\":\"a\",\"priority\":256}", &out));
+    TEST_ASSERT_FALSE(settings_storage_wifi_from_json("{\"ssid\":\"a\",\"priority\":-1}", &out));
+    TEST_ASSERT_FALSE(settings_storage_wifi_from_json("{\"ssid\":\"a\",\"priority\":1.5}", &out));
+    TEST_ASSERT_FALSE(settings_storage_wifi_from_json("{\"ssid\":\"a\",\"priority\":1e2}", &out));
+    TEST_ASSERT_FALSE(settings_storage_wifi_from_json("{\"ssid\":\"a\",\"priority\":\"1\"}", &out));
+    TEST_ASSERT_FALSE(settings_storage_wifi_from_json("{\"ssid\":\"a\",\"priority\":99999999999}", &out));
+}
+
 /*
     settings_storage_wifi_to_json
     settings_storage_wifi_measure_json
@@ -141,6 +165,8 @@ void run_test_storage_settings_storage_wifi_from_json(void)
     RUN_TEST(test_wifi_from_json_empty_ssid_fails);
     RUN_TEST(test_wifi_from_json_missing_pass_sets_empty);
     RUN_TEST(test_wifi_from_json_invalid_json_fails);
+    RUN_TEST(test_wifi_from_json_priority);
+    RUN_TEST(test_wifi_from_json_invalid_priority_fails);
 
     UNITY_OUTPUT_CHAR('\n');
 }
@@ -0,0 +1,221 @@
+#include <unity.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "test_api.h"
+
+#include "wifi_profiles.h"
+
+/*
+    helpers
+*/
+
+static wifi_profile_hint_t make_hint(uint8_t channel, uint8_t last_bssid_byte)
+{
+    wifi_profile_hint_t h;
+    (void)memset(&h, 0, sizeof(h));
+
+    h.valid = true;
+    h.channel = channel;
+    h.authmode = 3U;
+    h.bssid[0] = 0x24U;
+    h.bssid[5] = last_bssid_byte;
+
+    return h;
+}
+
+static void make_list(wifi_profiles_t *list)
+{
+    (void)memset(list, 0, sizeof(*list));
+    TEST_ASSERT_TRUE(wifi_profiles_put(list, "home", "homepass", SIZE_MAX));
+    TEST_ASSERT_TRUE(wifi_profiles_put(list, "office", "officepass", SIZE_MAX));
+    TEST_ASSERT_TRUE(wifi_profiles_put(list, "phone", "", SIZE_MAX));
+}
+
+/* "ssid,ssid,..." in list order */
+static void order(const wifi_profiles_t *list, char *out, size_t out_len)
+{
+    out[0] = '\0';
+    for (size_t i = 0U; i < list->count; i++)
+    {
+        if (i > 0U)
+        {
+            (void)strncat(out, ",", out_len - strlen(out) - 1U);
+        }
+        (void)strncat(out, list->items[i].ssid, out_len - strlen(out) - 1U);
+    }
+}
+
+/*
+    wifi_profiles_put / remove / set_hint
+*/
+
+static void test_put_orders_and_updates(void)
+{
+    wifi_profiles_t list;
+    char got[64];
+
+    make_list(&list);
+    order(&list, got, sizeof(got));
+    TEST_ASSERT_EQUAL_STRING("home,office,phone", got);
+
+    /* existing profile: new password, moved to the front, hint kept */
+    const wifi_profile_hint_t h = make_hint(6U, 1U);
+    TEST_ASSERT_TRUE(wifi_profiles_set_hint(&list, "phone", &h));
+    TEST_ASSERT_TRUE(wifi_profiles_put(&list, "phone", "tethered", 0U));
+    order(&list, got, sizeof(got));
+    TEST_ASSERT_EQUAL_STRING("phone,home,office", got);
+    TEST_ASSERT_EQUAL_STRING("tethered", list.items[0].pass);
+    TEST_ASSERT_TRUE(list.items[0].hint.valid);
+
+    TEST_ASSERT_TRUE(wifi_profiles_put(&list, "phone", "tethered", 1U));
+    order(&list, got, sizeof(got));
+    TEST_ASSERT_EQUAL_STRING("home,phone,office", got);
+
+    TEST_ASSERT_TRUE(wifi_profiles_put(&list, "cafe", "", 0U));
+    TEST_ASSERT_EQUAL_UINT32(WIFI_PROFILES_MAX, (uint32_t)list.count);
+    TEST_ASSERT_FALSE(wifi_profiles_put(&list, "fifth", "x", 0U));
+    TEST_ASSERT_TRUE(wifi_profiles_put(&list, "home", "changed", SIZE_MAX)); /* full, but saved already */
+    order(&list, got, sizeof(got));
+    TEST_ASSERT_EQUAL_STRING("cafe,phone,office,home", got);
+}
+
+static void test_put_rejects_bad_credentials(void)
+{
+    wifi_profiles_t list;
+    char ssid[SETTINGS_WIFI_SSID_MAX_LEN + 2U];
+    char pass[SETTINGS_WIFI_PASS_MAX_LEN + 2U];
+
+    (void)memset(&list, 0, sizeof(list));
+    (void)memset(ssid, 'S', sizeof(ssid));
+    ssid[sizeof(ssid) - 1U] = '\0';
+    (void)memset(pass, 'p', sizeof(pass));
+    pass[sizeof(pass) - 1U] = '\0';
+
+    TEST_ASSERT_FALSE(wifi_profiles_put(&list, "", "x", 0U));
+    TEST_ASSERT_FALSE(wifi_profiles_put(&list, ssid, "x", 0U));
+    TEST_ASSERT_FALSE(wifi_profiles_put(&list, "home", pass, 0U));
+    TEST_ASSERT_EQUAL_UINT32(0U, (uint32_t)list.count);
+
+    ssid[SETTINGS_WIFI_SSID_MAX_LEN] = '\0';
+    pass[SETTINGS_WIFI_PASS_MAX_LEN] = '\0';
+    TEST_ASSERT_TRUE(wifi_profiles_put(&list, ssid, pass, 0U));
+    TEST_ASSERT_EQUAL_STRING(pass, list.items[0].pass);
+}
+
+static void test_remove_and_hint(void)
+{
+    wifi_profiles_t list;
+    char got[64];
+
+    make_list(&list);
+    TEST_ASSERT_TRUE(wifi_profiles_remove(&list, "home"));
+    TEST_ASSERT_FALSE(wifi_profiles_remove(&list, "home"));
+    order(&list, got, sizeof(got));
+    TEST_ASSERT_EQUAL_STRING("office,phone", got);
+    TEST_ASSERT_EQUAL_STRING("", list.items[2].pass); /* cleared slot */
+
+    const wifi_profile_hint_t h = make_hint(11U, 7U);
+    TEST_ASSERT_TRUE(wifi_profiles_set_hint(&list, "office", &h));
+    TEST_ASSERT_FALSE(wifi_profiles_set_hint(&list, "office", &h)); /* unchanged: nothing to write */
+    TEST_ASSERT_FALSE(wifi_profiles_set_hint(&list, "unknown", &h));
+    TEST_ASSERT_EQUAL_UINT8(11U, list.items[0].hint.channel);
+}
+
+/*
+    wifi_profiles_encode / wifi_profiles_decode
+*/
+
+static void test_encode_round_trip(void)
+{
+    wifi_profiles_t in;
+    wifi_profiles_t out;
+    uint8_t buf[WIFI_PROFILES_MAX_LEN];
+
+    make_list(&in);
+    const wifi_profile_hint_t h = make_hint(13U, 0xA5U);
+    (void)wifi_profiles_set_hint(&in, "office", &h);
+
+    const size_t len = wifi_profiles_encode(&in, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_UINT32(WIFI_PROFILES_HEADER_LEN + (3U * WIFI_PROFILE_HEADER_LEN) + 4U + 8U + 6U + 10U + 5U,
+                             (uint32_t)len);
+    TEST_ASSERT_EQUAL_UINT32(0U, (uint32_t)wifi_profiles_encode(&in, buf, len - 1U));
+
+    TEST_ASSERT_TRUE(wifi_profiles_decode(buf, len, &out));
+    TEST_ASSERT_EQUAL_UINT32(3U, (uint32_t)out.count);
+    TEST_ASSERT_EQUAL_STRING("office", out.items[1].ssid);
+    TEST_ASSERT_EQUAL_STRING("officepass", out.items[1].pass);
+    TEST_ASSERT_TRUE(out.items[1].hint.valid);
+    TEST_ASSERT_EQUAL_UINT8(13U, out.items[1].hint.channel);
+    TEST_ASSERT_EQUAL_MEMORY(h.bssid, out.items[1].hint.bssid, WIFI_PROFILE_BSSID_LEN);
+    TEST_ASSERT_FALSE(out.items[0].hint.valid);
+    TEST_ASSERT_EQUAL_STRING("", out.items[2].pass);
+}
+
+static void test_decode_rejects_corrupt(void)
+{
+    wifi_profiles_t in;
+    wifi_profiles_t out;
+    uint8_t buf[WIFI_PROFILES_MAX_LEN];
+
+    make_list(&in);
+    const size_t len = wifi_profiles_encode(&in, buf, sizeof(buf));
+    out.count = 99U;
+
+    TEST_ASSERT_FALSE(wifi_profiles_decode(buf, len - 1U, &out));
+    TEST_ASSERT_FALSE(wifi_profiles_decode(buf, 1U, &out));
+
+    buf[0] = WIFI_PROFILES_VERSION + 1U;
+    TEST_ASSERT_FALSE(wifi_profiles_decode(buf, len, &out));
+    buf[0] = WIFI_PROFILES_VERSION;
+
+    buf[WIFI_PROFILES_HEADER_LEN + WIFI_PROFILE_HEADER_LEN + 1U] = '\0'; /* inside "home" */
+    TEST_ASSERT_FALSE(wifi_profiles_decode(buf, len, &out));
+    TEST_ASSERT_EQUAL_UINT32(99U, (uint32_t)out.count); /* untouched on failure */
+
+    /* the same ssid twice */
+    (void)memcpy(in.items[1].ssid, "home", 5U);
+    TEST_ASSERT_FALSE(wifi_profiles_decode(buf, wifi_profiles_encode(&in, buf, sizeof(buf)), &out));
+
+    const uint8_t empty[] = {WIFI_PROFILES_VERSION, 0U};
+    TEST_ASSERT_TRUE(wifi_profiles_decode(empty, sizeof(empty), &out));
+    TEST_ASSERT_EQUAL_UINT32(0U, (uint32_t)out.count);
+}
+
+/*
+    wifi_profiles_attempt
+*/
+
+static void test_attempts_fast_first_then_scan(void)
+{
+    wifi_profiles_t list;
+    wifi_profiles_attempt_t a;
+
+    make_list(&list);
+    const wifi_profile_hint_t h = make_hint(1U, 1U);
+    (void)wifi_profiles_set_hint(&list, "phone", &h);
+    (void)wifi_profiles_set_hint(&list, "office", &h);
+
+    const size_t want_profile[] = {1U, 2U, 0U, 1U, 2U};
+    const bool want_fast[] = {true, true, false, false, false};
+    for (size_t step = 0U; step < 5U; step++)
+    {
+        TEST_ASSERT_TRUE(wifi_profiles_attempt(&list, step, &a));
+        TEST_ASSERT_EQUAL_UINT32((uint32_t)want_profile[step], (uint32_t)a.profile);
+        TEST_ASSERT_EQUAL(want_fast[step], a.fast);
+    }
+    TEST_ASSERT_FALSE(wifi_profiles_attempt(&list, 5U, &a));
+
+    list.count = 0U;
+    TEST_ASSERT_FALSE(wifi_profiles_attempt(&list, 0U, &a));
+}
+
+void run_test_storage_wifi_profiles(void)
+{
+    RUN_TEST(test_put_orders_and_updates);
+    RUN_TEST(test_put_rejects_bad_credentials);
+    RUN_TEST(test_remove_and_hint);
+    RUN_TEST(test_encode_round_trip);
+    RUN_TEST(test_decode_rejects_corrupt);
+    RUN_TEST(test_attempts_fast_first_then_scan);
+}
@@ -0,0 +1,309 @@
+#include <unity.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "test_api.h"
+
+#include "nvs.h"
+#include "nvs_host.h"
+#include "write_journal.h"
+
+/*
+    helpers
+*/
+
+static uint8_t s_mem[64];
+static write_journal_t s_j;
+
+/* fake store: records apply order, can fail the n-th apply or the commit */
+typedef struct
+{
+    char log[8][WRITE_JOURNAL_KEY_MAX + 8];
+    size_t applied;
+    size_t commits;
+    size_t fail_at; /* apply index that fails, SIZE_MAX: none */
+    int commit_err;
+} fake_store_t;
+
+static fake_store_t s_store;
+
+static int fake_apply(void *ctx, const char *key, write_journal_kind_t kind, const void *data, size_t len)
+{
+    fake_store_t *st = (fake_store_t *)ctx;
+    int err = 0;
+
+    if (st->applied == st->fail_at)
+    {
+        st->fail_at = SIZE_MAX;
+        err = -1;
+    }
+    else if (st->applied < 8U)
+    {
+        if (kind == WRITE_JOURNAL_ERASE)
+        {
+            (void)snprintf(st->log[st->applied], sizeof(st->log[0]), "-%s", key);
+        }
+        else
+        {
+            (void)snprintf(st->log[st->applied], sizeof(st->log[0]), "%s=%.*s", key, (int)len, (const char *)data);
+        }
+        st->applied++;
+    }
+    else
+    {
+        err = -2;
+    }
+
+    return err;
+}
+
+static int fake_commit(void *ctx)
+{
+    fake_store_t *st = (fake_store_t *)ctx;
+    const int err = st->commit_err;
+
+    st->commit_err = 0;
+    st->commits++;
+    return err;
+}
+
+static const write_journal_backend_t s_backend = {fake_apply, fake_commit, &s_store};
+
+static void reset(void)
+{
+    write_journal_init(&s_j, s_mem, sizeof(s_mem));
+    (void)memset(&s_store, 0, sizeof(s_store));
+    s_store.fail_at = SIZE_MAX;
+}
+
+static void put_blob(const char *key, const char *text)
+{
+    TEST_ASSERT_TRUE(write_journal_put(&s_j, key, WRITE_JOURNAL_BLOB, text, strlen(text)));
+}
+
+/*
+    write_journal
+*/
+
+static void test_put_coalesces_only_the_newest_entry(void)
+{
+    reset();
+    put_blob("a", "1");
+    put_blob("a", "22");
+    put_blob("b", "3");
+    put_blob("a", "44");
+
+    /* a=1 collapsed into a=22; a=44 comes after b and may not overtake it */
+    TEST_ASSERT_EQUAL_UINT(3U, write_journal_pending(&s_j));
+    TEST_ASSERT_EQUAL_INT(0, write_journal_flush(&s_j, &s_backend));
+
+    TEST_ASSERT_EQUAL_UINT(3U, s_store.applied);
+    TEST_ASSERT_EQUAL_STRING("a=22", s_store.log[0]);
+    TEST_ASSERT_EQUAL_STRING("b=3", s_store.log[1]);
+    TEST_ASSERT_EQUAL_STRING("a=44", s_store.log[2]);
+    TEST_ASSERT_EQUAL_UINT(1U, s_store.commits);
+    TEST_ASSERT_EQUAL_UINT(0U, write_journal_pending(&s_j));
+
+    TEST_ASSERT_EQUAL_UINT32(4U, s_j.stats.puts);
+    TEST_ASSERT_EQUAL_UINT32(1U, s_j.stats.coalesced);
+    TEST_ASSERT_EQUAL_UINT32(1U, s_j.stats.commits);
+}
+
+static void test_get_sees_pending_value_and_erase(void)
+{
+    reset();
+    put_blob("a", "1");
+    put_blob("b", "22");
+    put_blob("a", "333");
+    TEST_ASSERT_TRUE(write_journal_put(&s_j, "c", WRITE_JOURNAL_ERASE, NULL, 0U));
+
+    write_journal_kind_t kind;
+    const void *data = NULL;
+    size_t len = 0U;
+
+    TEST_ASSERT_TRUE(write_journal_get(&s_j, "a", &kind, &data, &len));
+    TEST_ASSERT_EQUAL_INT(WRITE_JOURNAL_BLOB, kind);
+    TEST_ASSERT_EQUAL_UINT(3U, len);
+    TEST_ASSERT_EQUAL_MEMORY("333", data, 3U);
+
+    TEST_ASSERT_TRUE(write_journal_get(&s_j, "b", &kind, &data, &len));
+    TEST_ASSERT_EQUAL_MEMORY("22", data, 2U);
+
+    TEST_ASSERT_TRUE(write_journal_get(&s_j, "c", &kind, NULL, &len));
+    TEST_ASSERT_EQUAL_INT(WRITE_JOURNAL_ERASE, kind);
+    TEST_ASSERT_EQUAL_UINT(0U, len);
+
+    TEST_ASSERT_FALSE(write_journal_get(&s_j, "d", NULL, NULL, NULL));
+}
+
+static void test_put_rejects_when_full_and_keeps_old_entry(void)
+{
+    char big[sizeof(s_mem) + 1U];
+    (void)memset(big, 'x', sizeof(big));
+
+    reset();
+    TEST_ASSERT_TRUE(write_journal_put(&s_j, "a", WRITE_JOURNAL_BLOB, big, 40U));
+    TEST_ASSERT_FALSE(write_journal_put(&s_j, "b", WRITE_JOURNAL_BLOB, big, 40U));
+
+    /* replacing frees the old bytes first */
+    TEST_ASSERT_TRUE(write_journal_put(&s_j, "a", WRITE_JOURNAL_BLOB, big, sizeof(s_mem)));
+    TEST_ASSERT_FALSE(write_journal_put(&s_j, "a", WRITE_JOURNAL_BLOB, big, sizeof(s_mem) + 1U));
+
+    size_t len = 0U;
+    TEST_ASSERT_TRUE(write_journal_get(&s_j, "a", NULL, NULL, &len));
+    TEST_ASSERT_EQUAL_UINT(sizeof(s_mem), len);
+
+    TEST_ASSERT_TRUE(write_journal_put(&s_j, "key_is_too_long", WRITE_JOURNAL_ERASE, NULL, 0U));
+    TEST_ASSERT_FALSE(write_journal_put(&s_j, "key_is_too_long!", WRITE_JOURNAL_ERASE, NULL, 0U));
+}
+
+static void test_put_rejects_beyond_max_entries(void)
+{
+    char key[8];
+
+    reset();
+    for (unsigned i = 0U; i < WRITE_JOURNAL_MAX_ENTRIES; i++)
+    {
+        (void)snprintf(key, sizeof(key), "k%u", i);
+        TEST_ASSERT_TRUE(write_journal_put(&s_j, key, WRITE_JOURNAL_ERASE, NULL, 0U));
+    }
+
+    TEST_ASSERT_FALSE(write_journal_put(&s_j, "new", WRITE_JOURNAL_ERASE, NULL, 0U));
+    /* an older key needs an entry of its own, the newest one collapses */
+    TEST_ASSERT_FALSE(write_journal_put(&s_j, "k0", WRITE_JOURNAL_ERASE, NULL, 0U));
+    (void)snprintf(key, sizeof(key), "k%u", WRITE_JOURNAL_MAX_ENTRIES - 1U);
+    TEST_ASSERT_TRUE(write_journal_put(&s_j, key, WRITE_JOURNAL_ERASE, NULL, 0U));
+}
+
+static void test_flush_failure_keeps_unapplied_suffix(void)
+{
+    reset();
+    put_blob("a", "1");
+    put_blob("b", "2");
+    put_blob("c", "3");
+    s_store.fail_at = 1U;
+
+    TEST_ASSERT_NOT_EQUAL(0, write_journal_flush(&s_j, &s_backend));
+    TEST_ASSERT_EQUAL_UINT(1U, s_store.commits);
+    TEST_ASSERT_EQUAL_UINT(2U, write_journal_pending(&s_j));
+    TEST_ASSERT_FALSE(write_journal_get(&s_j, "a", NULL, NULL, NULL));
+    TEST_ASSERT_EQUAL_UINT32(1U, s_j.stats.failures);
+
+    TEST_ASSERT_EQUAL_INT(0, write_journal_flush(&s_j, &s_backend));
+    TEST_ASSERT_EQUAL_UINT(3U, s_store.applied);
+    TEST_ASSERT_EQUAL_STRING("a=1", s_store.log[0]);
+    TEST_ASSERT_EQUAL_STRING("b=2", s_store.log[1]);
+    TEST_ASSERT_EQUAL_STRING("c=3", s_store.log[2]);
+}
+
+static void test_failed_commit_keeps_everything(void)
+{
+    reset();
+    put_blob("a", "1");
+    TEST_ASSERT_TRUE(write_journal_put(&s_j, "b", WRITE_JOURNAL_ERASE, NULL, 0U));
+    s_store.commit_err = 5;
+
+    TEST_ASSERT_EQUAL_INT(5, write_journal_flush(&s_j, &s_backend));
+    TEST_ASSERT_EQUAL_UINT(2U, write_journal_pending(&s_j));
+
+    TEST_ASSERT_EQUAL_INT(0, write_journal_flush(&s_j, &s_backend));
+    TEST_ASSERT_EQUAL_STRING("a=1", s_store.log[2]);
+    TEST_ASSERT_EQUAL_STRING("-b", s_store.log[3]);
+    TEST_ASSERT_EQUAL_UINT(0U, write_journal_pending(&s_j));
+}
+
+static void test_flush_empty_does_not_commit(void)
+{
+    reset();
+    TEST_ASSERT_EQUAL_INT(0, write_journal_flush(&s_j, &s_backend));
+    TEST_ASSERT_EQUAL_UINT(0U, s_store.commits);
+    TEST_ASSERT_EQUAL_UINT32(0U, s_j.stats.flushes);
+}
+
+/* host NVS backend whose power goes after cut_at applied entries */
+typedef struct
+{
+    nvs_handle_t h;
+    size_t applied;
+    size_t cut_at;
+} host_store_t;
+
+static int host_apply(void *ctx, const char *key, write_journal_kind_t kind, const void *data, size_t len)
+{
+    host_store_t *st = (host_store_t *)ctx;
+    esp_err_t err = ESP_FAIL;
+
+    (void)kind;
+    if (st->applied < st->cut_at)
+    {
+        err = nvs_set_blob(st->h, key, data, len);
+        st->applied++;
+    }
+
+    return err;
+}
+
+static int host_commit(void *ctx)
+{
+    return nvs_commit(((host_store_t *)ctx)->h);
+}
+
+/* "<a><b>" as on flash, '-' for a missing key */
+static void host_read(nvs_handle_t h, char out[3])
+{
+    const char *keys[2] = {"a", "b"};
+
+    for (size_t i = 0U; i < 2U; i++)
+    {
+        size_t len = 1U;
+        if (nvs_get_blob(h, keys[i], &out[i], &len) != ESP_OK)
+        {
+            out[i] = '-';
+        }
+    }
+    out[2] = '\0';
+}
+
+static void test_cut_flush_leaves_a_state_that_existed(void)
+{
+    /* a=1, b=1, a=2: every state the puts went through */
+    const char *states[] = {"--", "1-", "11", "21"};
+    host_store_t st;
+    const write_journal_backend_t backend = {host_apply, host_commit, &st};
+    char flash[3];
+
+    for (size_t cut = 0U; cut <= 3U; cut++)
+    {
+        TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_host_mount(NULL, NVS_HOST_DEFAULT_PAGES));
+        TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_open("cfg", NVS_READWRITE, &st.h));
+        st.applied = 0U;
+        st.cut_at = cut;
+
+        reset();
+        put_blob("a", "1");
+        put_blob("b", "1");
+        put_blob("a", "2");
+        (void)write_journal_flush(&s_j, &backend);
+
+        /* journal lost with the power; flash reached state cut */
+        host_read(st.h, flash);
+        TEST_ASSERT_EQUAL_STRING(states[cut], flash);
+
+        nvs_close(st.h);
+        nvs_host_unmount();
+    }
+}
+
+void run_test_storage_write_journal(void)
+{
+    RUN_TEST(test_put_coalesces_only_the_newest_entry);
+    RUN_TEST(test_get_sees_pending_value_and_erase);
+    RUN_TEST(test_put_rejects_when_full_and_keeps_old_entry);
+    RUN_TEST(test_put_rejects_beyond_max_entries);
+    RUN_TEST(test_flush_failure_keeps_unapplied_suffix);
+    RUN_TEST(test_failed_commit_keeps_everything);
+    RUN_TEST(test_flush_empty_does_not_commit);
+    RUN_TEST(test_cut_flush_leaves_a_state_that_existed);
+}
@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""Build the gazetteer flash image from a CSV file.
+
+CSV columns (header row required): name,latitude,longitude
+Coordinates are decimal degrees; they are rounded to microdegrees the same way
+locations_coord_parse() does (half away from zero). Layout: lib/storage/include/gazetteer.h
+
+usage: gazetteer_build.py <in.csv> <out.bin> [--max-size BYTES]
+"""
+
+import argparse
+import bisect
+import csv
+import struct
+import sys
+from decimal import Decimal, InvalidOperation, ROUND_HALF_UP
+
+MAGIC = b"GZT1"
+HEADER_LEN = 20
+BUCKETS = 257
+ENTRY_LEN = 16
+NAME_MAX = 31
+
+
+def key(name):
+    # ASCII letters lowered, every other byte as is (matches key_byte() in gazetteer.c)
+    return bytes(c + 32 if 0x41 <= c <= 0x5A else c for c in name)
+
+
+def to_e6(text, limit, what, line):
+    try:
+        value = Decimal(text.strip())
+    except InvalidOperation:
+        sys.exit(f"line {line}: {what} '{text}' is not a number")
+    if not value.is_finite():
+        sys.exit(f"line {line}: {what} '{text}' is not finite")
+    # ROUND_HALF_UP on the magnitude == half away from zero
+    e6 = int((abs(value) * 1000000).quantize(Decimal(1), rounding=ROUND_HALF_UP))
+    e6 = -e6 if value < 0 else e6
+    if abs(e6) > limit * 1000000:
+        sys.exit(f"line {line}: {what} {text} out of range")
+    return e6
+
+
+def read_csv(path):
+    rows = []
+    with open(path, newline="", encoding="utf-8") as f:
+        reader = csv.DictReader(f)
+        for line, row in enumerate(reader, start=2):
+            name = (row.get("name") or "").strip().encode("utf-8")
+            if not 0 < len(name) <= NAME_MAX:
+                sys.exit(f"line {line}: name must be 1..{NAME_MAX} bytes of UTF-8")
+            if b"\0" in name:
+                sys.exit(f"line {line}: name contains NUL")
+            lat = to_e6(row.get("latitude") or "", 90, "latitude", line)
+            lon = to_e6(row.get("longitude") or "", 180, "longitude", line)
+            rows.append((key(name), name, lat, lon))
+    # key order; ties broken by the original bytes and position so the image is reproducible
+    rows.sort(key=lambda r: (r[0], r[1], r[2], r[3]))
+    return rows
+
+
+def build(rows):
+    firsts = [r[0][0] for r in rows]
+    buckets = [bisect.bisect_left(firsts, b) for b in range(BUCKETS - 1)] + [len(rows)]
+
+    names = bytearray()
+    name_offsets = {}
+    entries = bytearray()
+    for _, name, lat, lon in rows:
+        # identical names share their bytes
+        off = name_offsets.setdefault(name, len(names))
+        if off == len(names):
+            names += name
+        entries += struct.pack("<iiIB3x", lat, lon, off, len(name))
+
+    entries_off = HEADER_LEN + 4 * BUCKETS
+    names_off = entries_off + len(entries)
+
+    image = bytearray()
+    image += MAGIC + struct.pack("<IIII", len(rows), entries_off, names_off, len(names))
+    image += struct.pack(f"<{BUCKETS}I", *buckets)
+    image += entries
+    image += names
+    return bytes(image)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("csv")
+    ap.add_argument("out")
+    ap.add_argument("--max-size", type=lambda s: int(s, 0), default=None,
+                    help="fail if the image exceeds this size (partition size)")
+    args = ap.parse_args()
+
+    image = build(read_csv(args.csv))
+    if args.max_size is not None and len(image) > args.max_size:
+        sys.exit(f"image is {len(image)} bytes, partition holds {args.max_size}")
+
+    with open(args.out, "wb") as f:
+        f.write(image)
+    print(f"gazetteer: {struct.unpack_from('<I', image, 4)[0]} entries, {len(image)} bytes -> {args.out}")
+
+
+if __name__ == "__main__":
+    main()